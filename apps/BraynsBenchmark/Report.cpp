@@ -0,0 +1,151 @@
+/* Copyright (c) 2015-2021, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Report.h"
+
+#include <brayns/network/json/Message.h>
+
+#include <Poco/JSON/Stringifier.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+
+namespace
+{
+BRAYNS_MESSAGE_BEGIN(StageMessage)
+BRAYNS_MESSAGE_ENTRY(size_t, samples, "Number of measured frames")
+BRAYNS_MESSAGE_ENTRY(double, mean_ms, "Mean duration")
+BRAYNS_MESSAGE_ENTRY(double, min_ms, "Shortest duration")
+BRAYNS_MESSAGE_ENTRY(double, p50_ms, "Median duration")
+BRAYNS_MESSAGE_ENTRY(double, p90_ms, "90th percentile of the durations")
+BRAYNS_MESSAGE_ENTRY(double, p99_ms, "99th percentile of the durations")
+BRAYNS_MESSAGE_ENTRY(double, max_ms, "Longest duration")
+BRAYNS_MESSAGE_END()
+
+BRAYNS_MESSAGE_BEGIN(SceneMessage)
+BRAYNS_MESSAGE_ENTRY(std::string, scene, "Scene name")
+BRAYNS_MESSAGE_ENTRY(size_t, primitives, "Number of primitives")
+BRAYNS_MESSAGE_ENTRY(size_t, memory_bytes, "Memory used by the scene")
+BRAYNS_MESSAGE_ENTRY(double, load_ms, "Duration of the scene creation")
+BRAYNS_MESSAGE_ENTRY(brayns::StringMap<StageMessage>, stages,
+                     "Durations of the stages of the frame loop")
+BRAYNS_MESSAGE_END()
+
+BRAYNS_MESSAGE_BEGIN(ReportMessage)
+BRAYNS_MESSAGE_ENTRY(brayns::StringMap<std::string>, settings,
+                     "Settings of the run")
+BRAYNS_MESSAGE_ENTRY(std::vector<SceneMessage>, scenes, "Scene results")
+BRAYNS_MESSAGE_END()
+
+struct Percentiles
+{
+    size_t count{0};
+    double mean{0.};
+    double min{0.};
+    double p50{0.};
+    double p90{0.};
+    double p99{0.};
+    double max{0.};
+};
+
+double _toMilliseconds(const int64_t microseconds)
+{
+    return microseconds / 1000.;
+}
+
+// Nearest-rank percentile of sorted samples
+double _getPercentile(const std::vector<int64_t>& sorted, const double rank)
+{
+    const auto index = size_t(std::ceil(rank / 100. * sorted.size()));
+    return _toMilliseconds(sorted[std::max<size_t>(index, 1) - 1]);
+}
+
+Percentiles _getPercentiles(std::vector<int64_t> samples)
+{
+    Percentiles result;
+    if (samples.empty())
+        return result;
+
+    std::sort(samples.begin(), samples.end());
+    result.count = samples.size();
+    result.mean = _toMilliseconds(
+                      std::accumulate(samples.begin(), samples.end(),
+                                      int64_t(0))) /
+                  samples.size();
+    result.min = _toMilliseconds(samples.front());
+    result.p50 = _getPercentile(samples, 50.);
+    result.p90 = _getPercentile(samples, 90.);
+    result.p99 = _getPercentile(samples, 99.);
+    result.max = _toMilliseconds(samples.back());
+    return result;
+}
+} // namespace
+
+namespace benchmark
+{
+void writeJson(std::ostream& stream, const RunSettings& settings,
+               const std::vector<SceneResult>& results)
+{
+    ReportMessage report;
+    for (const auto& value : settings.values)
+        report.settings[value.first] = value.second;
+    for (const auto& result : results)
+    {
+        SceneMessage scene;
+        scene.scene = result.scene;
+        scene.primitives = result.primitives;
+        scene.memory_bytes = result.memoryBytes;
+        scene.load_ms = _toMilliseconds(result.loadMicroseconds);
+        for (const auto& stage : result.stages)
+        {
+            const auto p = _getPercentiles(stage.getSamples());
+            auto& message = scene.stages[stage.getName()];
+            message.samples = p.count;
+            message.mean_ms = p.mean;
+            message.min_ms = p.min;
+            message.p50_ms = p.p50;
+            message.p90_ms = p.p90;
+            message.p99_ms = p.p99;
+            message.max_ms = p.max;
+        }
+        report.scenes.push_back(std::move(scene));
+    }
+    Poco::JSON::Stringifier::stringify(brayns::Json::serialize(report), stream,
+                                       2);
+    stream << std::endl;
+}
+
+void writeSummary(std::ostream& stream, const SceneResult& result)
+{
+    stream << std::fixed << std::setprecision(3);
+    stream << "[PERF] " << result.scene << ": " << result.primitives
+           << " primitives, " << result.memoryBytes << " bytes, loaded in "
+           << _toMilliseconds(result.loadMicroseconds) << " ms" << std::endl;
+    for (const auto& stage : result.stages)
+    {
+        const auto p = _getPercentiles(stage.getSamples());
+        stream << "[PERF]   " << std::left << std::setw(14)
+               << stage.getName() << std::right << " p50 " << p.p50
+               << " ms, p90 " << p.p90 << " ms, p99 " << p.p99 << " ms"
+               << std::endl;
+    }
+}
+} // namespace benchmark
@@ -0,0 +1,73 @@
+/* Copyright (c) 2015-2021, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace benchmark
+{
+/** Durations of one stage of the frame loop, in microseconds */
+class StageSamples
+{
+public:
+    explicit StageSamples(std::string name)
+        : _name(std::move(name))
+    {
+    }
+
+    const std::string& getName() const { return _name; }
+    void add(const int64_t microseconds) { _samples.push_back(microseconds); }
+    const std::vector<int64_t>& getSamples() const { return _samples; }
+
+private:
+    std::string _name;
+    std::vector<int64_t> _samples;
+};
+
+/** Result of the benchmark of one scene */
+struct SceneResult
+{
+    std::string scene;
+    size_t primitives{0};
+    size_t memoryBytes{0};
+    int64_t loadMicroseconds{0};
+    std::vector<StageSamples> stages;
+};
+
+/** Settings of a run, written with the results to compare runs */
+struct RunSettings
+{
+    std::vector<std::pair<std::string, std::string>> values;
+};
+
+/**
+ * Writes the results as JSON. Each stage reports the number of samples, the
+ * mean, min, max and the 50th, 90th and 99th percentiles in milliseconds.
+ */
+void writeJson(std::ostream& stream, const RunSettings& settings,
+               const std::vector<SceneResult>& results);
+
+/** Writes one human readable line per stage */
+void writeSummary(std::ostream& stream, const SceneResult& result);
+} // namespace benchmark
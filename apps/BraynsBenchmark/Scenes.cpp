@@ -0,0 +1,277 @@
+/* Copyright (c) 2015-2021, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Scenes.h"
+
+#include <brayns/common/geometry/Cylinder.h>
+#include <brayns/common/geometry/Sphere.h>
+#include <brayns/common/geometry/TriangleMesh.h>
+#include <brayns/common/simulation/AbstractSimulationHandler.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+#include <brayns/engine/SharedDataVolume.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace
+{
+const size_t NB_MATERIALS = 16;
+const uint32_t NB_SIMULATION_FRAMES = 100;
+
+/**
+ * Uniform floats in [0, 1) from the raw output of std::mt19937, which is
+ * specified by the standard unlike the distributions, so that scenes are the
+ * same with any standard library.
+ */
+class Random
+{
+public:
+    explicit Random(const uint32_t seed)
+        : _generator(seed)
+    {
+    }
+
+    float next() { return (_generator() >> 8) * (1.f / 16777216.f); }
+
+    brayns::Vector3f nextPosition(const float extent)
+    {
+        const float x = next();
+        const float y = next();
+        const float z = next();
+        return brayns::Vector3f(x, y, z) * extent;
+    }
+
+private:
+    std::mt19937 _generator;
+};
+
+// Keeps the density of primitives the same whatever the size
+float _getExtent(const size_t size)
+{
+    return std::max(1.f, std::cbrt(float(size)));
+}
+
+void _createMaterials(brayns::Model& model)
+{
+    for (size_t i = 0; i < NB_MATERIALS; ++i)
+        model.createMaterial(i, "material" + std::to_string(i));
+}
+
+class SyntheticSimulationHandler : public brayns::AbstractSimulationHandler
+{
+public:
+    SyntheticSimulationHandler(const size_t frameSize)
+    {
+        _frameSize = frameSize;
+        _nbFrames = NB_SIMULATION_FRAMES;
+        _dt = 1.;
+        _endTime = NB_SIMULATION_FRAMES;
+        _frameData.resize(_frameSize);
+    }
+
+    brayns::AbstractSimulationHandlerPtr clone() const final
+    {
+        return std::make_shared<SyntheticSimulationHandler>(*this);
+    }
+
+    void* getFrameDataImpl(const uint32_t frame) final
+    {
+        if (_currentFrame != frame)
+        {
+            // Travelling wave, so that every frame changes every value
+            for (size_t i = 0; i < _frameData.size(); ++i)
+                _frameData[i] = std::sin(0.01f * float(i) + 0.1f * frame);
+            _currentFrame = frame;
+        }
+        return _frameData.data();
+    }
+};
+
+size_t _createSpheres(brayns::Model& model, const size_t size,
+                      const uint32_t seed)
+{
+    Random random(seed);
+    const auto extent = _getExtent(size);
+    auto& spheres = model.getSpheres();
+    for (size_t i = 0; i < size; ++i)
+    {
+        const auto center = random.nextPosition(extent);
+        const auto radius = 0.1f + 0.2f * random.next();
+        spheres[i % NB_MATERIALS].emplace_back(center, radius, i);
+    }
+    return size;
+}
+
+size_t _createCylinders(brayns::Model& model, const size_t size,
+                        const uint32_t seed)
+{
+    Random random(seed);
+    const auto extent = _getExtent(size);
+    auto& cylinders = model.getCylinders();
+    for (size_t i = 0; i < size; ++i)
+    {
+        const auto center = random.nextPosition(extent);
+        const auto up = center + random.nextPosition(1.f);
+        const auto radius = 0.05f + 0.1f * random.next();
+        cylinders[i % NB_MATERIALS].emplace_back(center, up, radius, i);
+    }
+    return size;
+}
+
+size_t _createMeshes(brayns::Model& model, const size_t size,
+                     const uint32_t seed)
+{
+    Random random(seed);
+    const auto extent = _getExtent(size);
+    auto& meshes = model.getTriangleMeshes();
+    for (size_t i = 0; i < size; ++i)
+    {
+        const auto minCorner = random.nextPosition(extent);
+        const auto maxCorner = minCorner + 0.1f + random.nextPosition(0.4f);
+        const auto box = brayns::createBox(minCorner, maxCorner);
+
+        auto& mesh = meshes[i % NB_MATERIALS];
+        const auto offset = uint32_t(mesh.vertices.size());
+        mesh.vertices.insert(mesh.vertices.end(), box.vertices.begin(),
+                             box.vertices.end());
+        mesh.normals.insert(mesh.normals.end(), box.normals.begin(),
+                            box.normals.end());
+        for (const auto& index : box.indices)
+            mesh.indices.push_back(index + brayns::Vector3ui(offset));
+    }
+    return size;
+}
+
+size_t _createVolume(brayns::Model& model, const size_t size,
+                     const uint32_t seed)
+{
+    const auto side = uint32_t(std::max(2.f, std::cbrt(float(size))));
+    const brayns::Vector3ui dimensions(side);
+
+    // Noisy concentric shells
+    const size_t nbVoxels = size_t(side) * side * side;
+    Random random(seed);
+    brayns::uint8_ts voxels(nbVoxels);
+    const float center = 0.5f * side;
+    size_t i = 0;
+    for (uint32_t z = 0; z < side; ++z)
+        for (uint32_t y = 0; y < side; ++y)
+            for (uint32_t x = 0; x < side; ++x)
+            {
+                const auto distance = glm::length(
+                    brayns::Vector3f(x, y, z) - brayns::Vector3f(center));
+                const float shell = 0.5f + 0.5f * std::cos(distance * 0.5f);
+                const float noise = 0.8f + 0.2f * random.next();
+                voxels[i++] = uint8_t(255.f * shell * noise);
+            }
+
+    auto volume = model.createSharedDataVolume(dimensions, {1.f, 1.f, 1.f},
+                                               brayns::DataType::UINT8);
+    volume->setDataRange({0, 255});
+    volume->mapData(std::move(voxels));
+    model.addVolume(volume);
+    return nbVoxels;
+}
+
+size_t _createSimulation(brayns::Model& model, const size_t size,
+                         const uint32_t seed)
+{
+    _createSpheres(model, size, seed);
+    model.setSimulationHandler(
+        std::make_shared<SyntheticSimulationHandler>(size));
+    return size;
+}
+} // namespace
+
+namespace benchmark
+{
+std::vector<SceneType> getSceneTypes()
+{
+    return {SceneType::loaded,  SceneType::spheres, SceneType::cylinders,
+            SceneType::meshes,  SceneType::volume,  SceneType::simulation};
+}
+
+std::string toString(const SceneType type)
+{
+    switch (type)
+    {
+    case SceneType::loaded:
+        return "loaded";
+    case SceneType::spheres:
+        return "spheres";
+    case SceneType::cylinders:
+        return "cylinders";
+    case SceneType::meshes:
+        return "meshes";
+    case SceneType::volume:
+        return "volume";
+    case SceneType::simulation:
+        return "simulation";
+    }
+    return "unknown";
+}
+
+SceneType toSceneType(const std::string& name)
+{
+    for (const auto type : getSceneTypes())
+        if (toString(type) == name)
+            return type;
+    throw std::runtime_error("Unknown benchmark scene '" + name + "'");
+}
+
+size_t createScene(brayns::Scene& scene, const SceneType type,
+                   const size_t size, const uint32_t seed)
+{
+    if (type == SceneType::loaded)
+        return 0;
+
+    auto model = scene.createModel();
+    _createMaterials(*model);
+
+    size_t count = 0;
+    switch (type)
+    {
+    case SceneType::spheres:
+        count = _createSpheres(*model, size, seed);
+        break;
+    case SceneType::cylinders:
+        count = _createCylinders(*model, size, seed);
+        break;
+    case SceneType::meshes:
+        count = _createMeshes(*model, size, seed);
+        break;
+    case SceneType::volume:
+        count = _createVolume(*model, size, seed);
+        break;
+    case SceneType::simulation:
+        count = _createSimulation(*model, size, seed);
+        break;
+    default:
+        break;
+    }
+    model->updateBounds();
+
+    scene.addModel(std::make_shared<brayns::ModelDescriptor>(std::move(model),
+                                                             toString(type)));
+    return count;
+}
+} // namespace benchmark
@@ -0,0 +1,57 @@
+/* Copyright (c) 2015-2021, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <brayns/common/types.h>
+
+#include <string>
+#include <vector>
+
+namespace benchmark
+{
+/** Procedural scenes, generated the same way for a given size and seed */
+enum class SceneType
+{
+    loaded,     // whatever the command line loaded
+    spheres,    // spheres randomly placed in a cube
+    cylinders,  // cylinders randomly placed in a cube
+    meshes,     // boxes merged in one triangle mesh per material
+    volume,     // shared data volume of 8-bit voxels
+    simulation, // spheres mapped to a synthetic simulation
+};
+
+/** @return all the scene types, in the order they are benchmarked */
+std::vector<SceneType> getSceneTypes();
+
+std::string toString(SceneType type);
+
+/** @throw std::runtime_error if the name matches no scene type */
+SceneType toSceneType(const std::string& name);
+
+/**
+ * Generates a scene of the given type and adds it to the scene.
+ *
+ * @param size number of primitives, voxels for volumes
+ * @param seed seed of the random generator placing the primitives
+ * @return the number of primitives actually created
+ */
+size_t createScene(brayns::Scene& scene, SceneType type, size_t size,
+                   uint32_t seed);
+} // namespace benchmark
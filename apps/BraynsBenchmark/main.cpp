@@ -1,4 +1,4 @@
-/* Copyright (c) 2015-2016, EPFL/Blue Brain Project
+/* Copyright (c) 2015-2021, EPFL/Blue Brain Project
  * All rights reserved. Do not distribute without permission.
  * Responsible Author: Cyrille Favreau <cyrille.favreau@epfl.ch>
  *
@@ -18,50 +18,261 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "Report.h"
+#include "Scenes.h"
+
 #include <brayns/Brayns.h>
 #include <brayns/common/Timer.h>
 #include <brayns/common/log.h>
 #include <brayns/common/types.h>
+#include <brayns/common/utils/ImageGenerator.h>
 #include <brayns/engine/Camera.h>
 #include <brayns/engine/Engine.h>
+#include <brayns/engine/FrameBuffer.h>
 #include <brayns/engine/Scene.h>
+#include <brayns/parameters/ParametersManager.h>
 
-int main(int argc, const char** argv)
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace
 {
-    try
+const char* USAGE =
+    "Usage: braynsBenchmark [benchmark options] [brayns options]\n"
+    "  --scenes <list>   comma separated scenes among loaded, spheres,\n"
+    "                    cylinders, meshes, volume and simulation\n"
+    "                    (default: all but loaded)\n"
+    "  --size <n>        primitives (voxels for volumes) per scene\n"
+    "  --frames <n>      measured frames per scene\n"
+    "  --warmup <n>      frames rendered before measuring\n"
+    "  --seed <n>        seed of the procedural scenes\n"
+    "  --output <file>   JSON results file (required, the standard output\n"
+    "                    holds the logs and the summary)\n";
+
+/** Stages of the frame loop, in the order they run */
+enum Stage
+{
+    sceneCommit,
+    engineCommit,
+    render,
+    readback,
+    jpegEncode,
+    nbStages
+};
+
+const char* STAGE_NAMES[nbStages] = {"scene_commit", "engine_commit",
+                                     "render", "readback", "jpeg_encode"};
+
+struct Options
+{
+    std::vector<benchmark::SceneType> scenes{
+        benchmark::SceneType::spheres, benchmark::SceneType::cylinders,
+        benchmark::SceneType::meshes, benchmark::SceneType::volume,
+        benchmark::SceneType::simulation};
+    size_t size{100000};
+    size_t frames{100};
+    size_t warmup{5};
+    uint32_t seed{0};
+    std::string output;
+    bool help{false};
+    std::vector<const char*> braynsArgs;
+};
+
+std::vector<benchmark::SceneType> _parseScenes(const std::string& list)
+{
+    std::vector<benchmark::SceneType> scenes;
+    std::istringstream stream(list);
+    std::string name;
+    while (std::getline(stream, name, ','))
+        scenes.push_back(benchmark::toSceneType(name));
+    return scenes;
+}
+
+// Benchmark options are removed, the other ones are passed to Brayns
+Options _parseOptions(const int argc, const char** argv)
+{
+    Options options;
+    options.braynsArgs.push_back(argv[0]);
+    for (int i = 1; i < argc; ++i)
     {
-        const size_t nbFrames = 100;
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--scenes" && hasValue)
+            options.scenes = _parseScenes(argv[++i]);
+        else if (arg == "--size" && hasValue)
+            options.size = std::stoull(argv[++i]);
+        else if (arg == "--frames" && hasValue)
+            options.frames = std::stoull(argv[++i]);
+        else if (arg == "--warmup" && hasValue)
+            options.warmup = std::stoull(argv[++i]);
+        else if (arg == "--seed" && hasValue)
+            options.seed = std::stoul(argv[++i]);
+        else if (arg == "--output" && hasValue)
+            options.output = argv[++i];
+        else if (arg == "--help")
+            options.help = true;
+        else
+            options.braynsArgs.push_back(argv[i]);
+    }
+    return options;
+}
+
+// Orbits around the scene, one degree per frame, the same way on every run
+void _setCamera(brayns::Engine& engine, const size_t frame)
+{
+    const auto& bounds = engine.getScene().getBounds();
+    const double radius = glm::compMax(bounds.getSize());
+    const brayns::Vector3d& center = bounds.getCenter();
+    const auto quat = glm::angleAxis(frame * M_PI / 180.0,
+                                     brayns::Vector3d(0.0, 1.0, 0.0));
+    const brayns::Vector3d dir = glm::rotate(quat, brayns::Vector3d(0, 0, -1));
+    engine.getCamera().set(center + radius * -dir, quat);
+}
 
-        brayns::Timer timer;
+benchmark::SceneResult _runScene(const Options& options,
+                                 const benchmark::SceneType type,
+                                 brayns::Vector2ui& windowSize)
+{
+    benchmark::SceneResult result;
+    result.scene = benchmark::toString(type);
+    for (size_t i = 0; i < nbStages; ++i)
+        result.stages.emplace_back(STAGE_NAMES[i]);
+
+    // Data given on the command line is loaded by the constructor
+    brayns::Timer timer;
+    timer.start();
+    brayns::Brayns brayns(int(options.braynsArgs.size()),
+                          options.braynsArgs.data());
+    timer.stop();
+    result.loadMicroseconds = timer.microseconds();
 
+    auto& engine = brayns.getEngine();
+    auto& scene = engine.getScene();
+    if (type != benchmark::SceneType::loaded)
+    {
         timer.start();
-        brayns::Brayns brayns(argc, argv);
+        result.primitives =
+            benchmark::createScene(scene, type, options.size, options.seed);
         timer.stop();
+        result.loadMicroseconds = timer.microseconds();
+    }
 
-        BRAYNS_INFO << "[PERF] Scene initialization took "
-                    << timer.milliseconds() << " milliseconds" << std::endl;
+    scene.commit();
+    result.memoryBytes = scene.getMemoryUsage().getTotal();
 
-        auto& engine = brayns.getEngine();
-        auto& scene = engine.getScene();
-        const auto bounds = scene.getBounds();
-        const double radius = glm::compMax(bounds.getSize());
-        timer.start();
-        for (size_t frame = 0; frame < nbFrames; ++frame)
+    auto& parameters = brayns.getParametersManager();
+    auto& animation = parameters.getAnimationParameters();
+    const auto& application = parameters.getApplicationParameters();
+    const auto quality = uint8_t(application.getJpegCompression());
+    windowSize = application.getWindowSize();
+    brayns::ImageGenerator imageGenerator;
+    brayns::uint8_ts pixels;
+
+    for (size_t frame = 0; frame < options.warmup + options.frames; ++frame)
+    {
+        const bool measured = frame >= options.warmup;
+        const auto measure = [&](const Stage stage, const auto& function) {
+            timer.start();
+            function();
+            timer.stop();
+            if (measured)
+                result.stages[stage].add(timer.microseconds());
+        };
+
+        _setCamera(engine, frame);
+        if (type == benchmark::SceneType::simulation)
+            animation.setFrame(frame % std::max(animation.getNumFrames(), 1u));
+
+        // The scene is committed on its own first, so that the commit of
+        // Brayns only finds the engine and the camera left to commit
+        measure(sceneCommit, [&] { scene.commit(); });
+        measure(engineCommit, [&] { brayns.commit(); });
+        measure(render, [&] { brayns.render(); });
+
+        auto& frameBuffer = engine.getFrameBuffer();
+        measure(readback, [&] {
+            frameBuffer.map();
+            const auto colorBuffer = frameBuffer.getColorBuffer();
+            if (colorBuffer)
+            {
+                const auto size = frameBuffer.getSize();
+                pixels.assign(colorBuffer,
+                              colorBuffer + size.x * size.y *
+                                                frameBuffer.getColorDepth());
+            }
+            frameBuffer.unmap();
+        });
+
+        brayns::ImageGenerator::ImageJPEG image;
+        measure(jpegEncode, [&] {
+            image = imageGenerator.createJPEG(frameBuffer, quality);
+        });
+
+        brayns.postRender();
+    }
+    return result;
+}
+
+benchmark::RunSettings _getSettings(const Options& options,
+                                    const brayns::Vector2ui& windowSize)
+{
+    benchmark::RunSettings settings;
+    auto& values = settings.values;
+    values.emplace_back("size", std::to_string(options.size));
+    values.emplace_back("frames", std::to_string(options.frames));
+    values.emplace_back("warmup", std::to_string(options.warmup));
+    values.emplace_back("seed", std::to_string(options.seed));
+    values.emplace_back("hardware_threads",
+                        std::to_string(std::thread::hardware_concurrency()));
+
+    std::string arguments;
+    for (size_t i = 1; i < options.braynsArgs.size(); ++i)
+        arguments += (i == 1 ? "" : " ") + std::string(options.braynsArgs[i]);
+    values.emplace_back("brayns_arguments", arguments);
+    values.emplace_back("window_size", std::to_string(windowSize.x) + "x" +
+                                           std::to_string(windowSize.y));
+    return settings;
+}
+} // namespace
+
+int main(int argc, const char** argv)
+{
+    try
+    {
+        const auto options = _parseOptions(argc, argv);
+        if (options.help)
         {
-            const brayns::Vector3d& center = bounds.getCenter();
-            const auto quat = glm::angleAxis(frame * M_PI / 180.0,
-                                             brayns::Vector3d(0.0, 1.0, 0.0));
-            const brayns::Vector3d dir =
-                glm::rotate(quat, brayns::Vector3d(0, 0, -1));
-            engine.getCamera().set(center + radius * -dir, quat);
-            brayns.commitAndRender();
+            std::cout << USAGE << std::endl;
+            return 0;
+        }
+        if (options.output.empty())
+        {
+            std::cerr << USAGE << std::endl;
+            return 1;
+        }
+
+        // Opened first to fail before running the benchmark
+        std::ofstream file(options.output);
+        if (!file.is_open())
+            throw std::runtime_error("Could not open " + options.output);
+
+        brayns::Vector2ui windowSize;
+        std::vector<benchmark::SceneResult> results;
+        for (const auto type : options.scenes)
+        {
+            results.push_back(_runScene(options, type, windowSize));
+            benchmark::writeSummary(std::cout, results.back());
         }
-        timer.stop();
 
-        BRAYNS_INFO << "[PERF] Rendering " << nbFrames << " frames took "
-                    << timer.milliseconds() << " milliseconds" << std::endl;
-        BRAYNS_INFO << "[PERF] Frames per second: "
-                    << nbFrames / timer.seconds() << std::endl;
+        const auto settings = _getSettings(options, windowSize);
+        benchmark::writeJson(file, settings, results);
+        if (!file.good())
+            throw std::runtime_error("Could not write " + options.output);
+        BRAYNS_INFO << "[PERF] Results written to " << options.output
+                    << std::endl;
     }
     catch (const std::runtime_error& e)
     {
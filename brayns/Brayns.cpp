@@ -156,7 +156,10 @@ struct Brayns::Impl : public PluginAPI
 
         scene.commit();
 
-        _engine->getStatistics().setSceneSizeInBytes(scene.getSizeInBytes());
+        const auto memoryUsage = scene.getMemoryUsage();
+        auto& statistics = _engine->getStatistics();
+        statistics.setSceneSizeInBytes(memoryUsage.getTotal());
+        statistics.setSceneMemoryUsage(memoryUsage);
 
         _parametersManager.getAnimationParameters().update();
 
@@ -27,6 +27,55 @@ SERIALIZATION_ACCESS(Statistics)
 
 namespace brayns
 {
+/** Memory used by the scene in bytes, by type of data. */
+struct MemoryUsage
+{
+    size_t spheres{0};
+    size_t cylinders{0};
+    size_t cones{0};
+    size_t sdfBeziers{0};
+    size_t triangleMeshes{0};
+    size_t streamlines{0};
+    size_t sdfGeometries{0};
+    size_t metaObjects{0};
+    size_t volumes{0};
+    size_t simulation{0};
+
+    size_t getGeometries() const
+    {
+        return spheres + cylinders + cones + sdfBeziers + triangleMeshes +
+               streamlines + sdfGeometries + metaObjects;
+    }
+
+    size_t getTotal() const { return getGeometries() + volumes + simulation; }
+
+    MemoryUsage& operator+=(const MemoryUsage& rhs)
+    {
+        spheres += rhs.spheres;
+        cylinders += rhs.cylinders;
+        cones += rhs.cones;
+        sdfBeziers += rhs.sdfBeziers;
+        triangleMeshes += rhs.triangleMeshes;
+        streamlines += rhs.streamlines;
+        sdfGeometries += rhs.sdfGeometries;
+        metaObjects += rhs.metaObjects;
+        volumes += rhs.volumes;
+        simulation += rhs.simulation;
+        return *this;
+    }
+
+    bool operator==(const MemoryUsage& rhs) const
+    {
+        return spheres == rhs.spheres && cylinders == rhs.cylinders &&
+               cones == rhs.cones && sdfBeziers == rhs.sdfBeziers &&
+               triangleMeshes == rhs.triangleMeshes &&
+               streamlines == rhs.streamlines &&
+               sdfGeometries == rhs.sdfGeometries &&
+               metaObjects == rhs.metaObjects && volumes == rhs.volumes &&
+               simulation == rhs.simulation;
+    }
+};
+
 /** Captures various statistics about rendering, scenes, etc. */
 class Statistics : public BaseObject
 {
@@ -38,10 +87,19 @@ public:
     {
         _updateValue(_sceneSizeInBytes, sceneSizeInBytes);
     }
+    const MemoryUsage& getSceneMemoryUsage() const
+    {
+        return _sceneMemoryUsage;
+    }
+    void setSceneMemoryUsage(const MemoryUsage& sceneMemoryUsage)
+    {
+        _updateValue(_sceneMemoryUsage, sceneMemoryUsage);
+    }
 
 private:
     double _fps{0.0};
     size_t _sceneSizeInBytes{0};
+    MemoryUsage _sceneMemoryUsage;
 
     SERIALIZATION_FRIEND(Statistics)
 };
@@ -124,6 +124,17 @@ public:
     virtual bool isSupported(const std::string& filename,
                              const std::string& extension) const = 0;
 
+    /**
+     * Query the loader if importFromBlob() can load data of the given
+     * extension concurrently with other loaders. Loaders which need a path,
+     * e.g. to find files referenced by the one being loaded, or which create
+     * engine objects such as volumes, keep the default.
+     */
+    virtual bool isBlobSupported(const std::string& /*extension*/) const
+    {
+        return false;
+    }
+
 protected:
     Scene& _scene;
 };
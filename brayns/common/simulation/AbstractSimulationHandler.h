@@ -53,7 +53,9 @@ public:
 
     /**
      * @brief returns a void pointer to the simulation data for the given frame
-     * or nullptr if the frame is not loaded yet.
+     * or nullptr if the frame is not loaded yet. The returned buffer may be
+     * shared with the engine without a copy, hence it must remain valid until
+     * the next call to getFrameData().
      */
     void* getFrameData(uint32_t frame)
     {
@@ -106,6 +108,11 @@ public:
     virtual bool isReady() const { return true; }
     /** Wait until current frame is ready */
     virtual void waitReady() const {}
+    /** @return the size in bytes of the simulation data held in memory */
+    virtual size_t getSizeInBytes() const
+    {
+        return _frameData.size() * sizeof(float);
+    }
 
 protected:
     uint32_t _getBoundedFrame(const uint32_t frame) const;
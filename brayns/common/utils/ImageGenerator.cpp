@@ -25,12 +25,190 @@
 #include <brayns/engine/FrameBuffer.h>
 #include <brayns/parameters/ApplicationParameters.h>
 
+#include <async++.h>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+const uint8_t JPEG_MARKER = 0xFF;
+const uint8_t JPEG_SOF0 = 0xC0;
+const uint8_t JPEG_SOF2 = 0xC2;
+const uint8_t JPEG_DRI = 0xDD;
+const uint8_t JPEG_SOS = 0xDA;
+const uint8_t JPEG_RST0 = 0xD0;
+const uint8_t JPEG_EOI = 0xD9;
+
+// Strips smaller than this are not worth a task of their own
+const uint32_t MIN_STRIP_HEIGHT = 64;
+
+/**
+ * Offsets of the segments of a baseline JPEG needed to concatenate the
+ * entropy-coded data of several images encoded with the same settings.
+ */
+struct JpegLayout
+{
+    size_t frameOffset{0}; // SOF marker
+    size_t scanOffset{0};  // SOS marker
+    size_t dataOffset{0};  // first byte of entropy-coded data
+    size_t dataEnd{0};     // EOI marker
+    bool valid{false};
+
+    JpegLayout(const uint8_t* data, const size_t size)
+    {
+        if (size < 4 || data[size - 2] != JPEG_MARKER ||
+            data[size - 1] != JPEG_EOI)
+            return;
+
+        size_t offset = 2;
+        while (offset + 4 <= size && data[offset] == JPEG_MARKER)
+        {
+            const uint8_t marker = data[offset + 1];
+            const size_t length = (data[offset + 2] << 8) | data[offset + 3];
+            if (marker == JPEG_DRI || marker == JPEG_SOF2)
+                return;
+            if (marker == JPEG_SOF0)
+                frameOffset = offset;
+            if (marker == JPEG_SOS)
+            {
+                scanOffset = offset;
+                dataOffset = offset + 2 + length;
+                dataEnd = size - 2;
+                valid = frameOffset != 0 && dataOffset <= dataEnd;
+                return;
+            }
+            offset += 2 + length;
+        }
+    }
+
+    void setHeight(uint8_t* data, const uint32_t height) const
+    {
+        data[frameOffset + 5] = uint8_t(height >> 8);
+        data[frameOffset + 6] = uint8_t(height);
+    }
+};
+
+/**
+ * Merge JPEG strips encoded with identical settings into one image where each
+ * strip becomes a restart interval. Returns false if the strips do not share
+ * the same tables and thus cannot be merged.
+ */
+bool mergeStrips(const std::vector<brayns::ImageGenerator::ImageJPEG>& strips,
+                 const uint32_t height, const uint32_t restartInterval,
+                 brayns::ImageGenerator::ImageJPEG& image)
+{
+    std::vector<JpegLayout> layouts;
+    layouts.reserve(strips.size());
+    for (const auto& strip : strips)
+    {
+        layouts.emplace_back(strip.data.get(), strip.size);
+        if (!layouts.back().valid)
+            return false;
+    }
+
+    // Headers must match byte for byte, except for the image height
+    const auto& first = layouts.front();
+    std::vector<uint8_t> header(strips[0].data.get(),
+                                strips[0].data.get() + first.scanOffset);
+    first.setHeight(header.data(), height);
+    for (size_t i = 1; i < strips.size(); ++i)
+    {
+        const auto& layout = layouts[i];
+        if (layout.scanOffset != first.scanOffset ||
+            layout.dataOffset != first.dataOffset)
+            return false;
+        std::vector<uint8_t> stripHeader(strips[i].data.get(),
+                                         strips[i].data.get() +
+                                             layout.scanOffset);
+        layout.setHeight(stripHeader.data(), height);
+        if (stripHeader != header)
+            return false;
+    }
+
+    const uint8_t restart[] = {JPEG_MARKER,
+                               JPEG_DRI,
+                               0,
+                               4,
+                               uint8_t(restartInterval >> 8),
+                               uint8_t(restartInterval)};
+    size_t size = header.size() + sizeof(restart) +
+                  (first.dataOffset - first.scanOffset) + 2;
+    for (size_t i = 0; i < strips.size(); ++i)
+        size += layouts[i].dataEnd - layouts[i].dataOffset + 2;
+
+    image.data.reset(tjAlloc(int(size)));
+    if (!image.data)
+        return false;
+
+    uint8_t* out = image.data.get();
+    const auto append = [&out](const void* src, const size_t count) {
+        memcpy(out, src, count);
+        out += count;
+    };
+    append(header.data(), header.size());
+    append(restart, sizeof(restart));
+    append(strips[0].data.get() + first.scanOffset,
+           first.dataOffset - first.scanOffset);
+    for (size_t i = 0; i < strips.size(); ++i)
+    {
+        const auto& layout = layouts[i];
+        append(strips[i].data.get() + layout.dataOffset,
+               layout.dataEnd - layout.dataOffset);
+        const uint8_t marker[] = {JPEG_MARKER,
+                                  i + 1 < strips.size()
+                                      ? uint8_t(JPEG_RST0 + i % 8)
+                                      : JPEG_EOI};
+        append(marker, sizeof(marker));
+    }
+    image.size = out - image.data.get();
+    return true;
+}
+
+int32_t toTurboJpeg(const brayns::ChromaSubsampling subsampling)
+{
+    switch (subsampling)
+    {
+    case brayns::ChromaSubsampling::yuv420:
+        return TJSAMP_420;
+    case brayns::ChromaSubsampling::yuv422:
+        return TJSAMP_422;
+    case brayns::ChromaSubsampling::yuv444:
+    default:
+        return TJSAMP_444;
+    }
+}
+} // namespace
+
 namespace brayns
 {
-ImageGenerator::~ImageGenerator()
+ImageGenerator::CompressorPool::~CompressorPool()
 {
-    if (_compressor)
-        tjDestroy(_compressor);
+    for (auto compressor : _compressors)
+        tjDestroy(compressor);
+}
+
+tjhandle ImageGenerator::CompressorPool::acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_compressors.empty())
+        {
+            auto compressor = _compressors.back();
+            _compressors.pop_back();
+            return compressor;
+        }
+    }
+    return tjInitCompress();
+}
+
+void ImageGenerator::CompressorPool::release(tjhandle compressor)
+{
+    if (!compressor)
+        return;
+    std::lock_guard<std::mutex> lock(_mutex);
+    _compressors.push_back(compressor);
 }
 
 ImageGenerator::ImageBase64 ImageGenerator::createImage(
@@ -68,7 +246,8 @@ ImageGenerator::ImageBase64 ImageGenerator::createImage(
 }
 
 ImageGenerator::ImageJPEG ImageGenerator::createJPEG(
-    FrameBuffer& frameBuffer BRAYNS_UNUSED, const uint8_t quality BRAYNS_UNUSED)
+    FrameBuffer& frameBuffer BRAYNS_UNUSED, const uint8_t quality BRAYNS_UNUSED,
+    const ChromaSubsampling subsampling)
 {
     frameBuffer.map();
     const auto colorBuffer = frameBuffer.getColorBuffer();
@@ -90,36 +269,96 @@ ImageGenerator::ImageJPEG ImageGenerator::createJPEG(
     }
 
     const auto& frameSize = frameBuffer.getSize();
-    ImageJPEG image;
-    image.data = _encodeJpeg(frameSize.x, frameSize.y, colorBuffer, pixelFormat,
-                             quality, image.size);
+    auto image = _encodeJpeg(frameSize.x, frameSize.y, colorBuffer,
+                             pixelFormat, quality, toTurboJpeg(subsampling));
     frameBuffer.unmap();
     return image;
 }
 
-ImageGenerator::ImageJPEG::JpegData ImageGenerator::_encodeJpeg(
+ImageGenerator::ImageJPEG ImageGenerator::_encodeJpeg(
     const uint32_t width, const uint32_t height, const uint8_t* rawData,
-    const int32_t pixelFormat, const uint8_t quality, unsigned long& dataSize)
+    const int32_t pixelFormat, const uint8_t quality, const int32_t subsampling)
+{
+    // Split the image in strips of whole MCU rows, one restart interval each
+    const uint32_t mcuWidth = tjMCUWidth[subsampling];
+    const uint32_t mcuHeight = tjMCUHeight[subsampling];
+    const uint32_t mcusPerRow = (width + mcuWidth - 1) / mcuWidth;
+    const uint32_t mcuRows = (height + mcuHeight - 1) / mcuHeight;
+    const uint32_t maxMcuRowsPerStrip = 0xFFFF / std::max(mcusPerRow, 1u);
+    const uint32_t threadCount =
+        std::max(std::thread::hardware_concurrency(), 1u);
+    const uint32_t stripCount =
+        std::min(threadCount, std::max(height / MIN_STRIP_HEIGHT, 1u));
+    const uint32_t mcuRowsPerStrip =
+        std::min((mcuRows + stripCount - 1) / stripCount, maxMcuRowsPerStrip);
+
+    if (stripCount == 1 || mcuRowsPerStrip == 0)
+        return _encodeStrip(width, height, 0, height, rawData, pixelFormat,
+                            quality, subsampling);
+
+    const uint32_t stripHeight = mcuRowsPerStrip * mcuHeight;
+    std::vector<ImageJPEG> strips((height + stripHeight - 1) / stripHeight);
+    async::parallel_for(async::irange(size_t(0), strips.size()),
+                        [&](const size_t i) {
+                            const uint32_t y = i * stripHeight;
+                            strips[i] = _encodeStrip(
+                                width, height, y,
+                                std::min(stripHeight, height - y), rawData,
+                                pixelFormat, quality, subsampling);
+                        });
+
+    for (const auto& strip : strips)
+        if (strip.size == 0)
+            return ImageJPEG();
+
+    ImageJPEG image;
+    if (mergeStrips(strips, height, mcusPerRow * mcuRowsPerStrip, image))
+        return image;
+
+    // Encoder settings (e.g. TJ_OPTIMIZE) made strips incompatible
+    return _encodeStrip(width, height, 0, height, rawData, pixelFormat, quality,
+                        subsampling);
+}
+
+ImageGenerator::ImageJPEG ImageGenerator::_encodeStrip(
+    const uint32_t width, const uint32_t height, const uint32_t y,
+    const uint32_t stripHeight, const uint8_t* rawData,
+    const int32_t pixelFormat, const uint8_t quality,
+    const int32_t subsampling)
 {
-    uint8_t* tjSrcBuffer = const_cast<uint8_t*>(rawData);
     const int32_t color_components = 4; // Color Depth
     const int32_t tjPitch = width * color_components;
     const int32_t tjPixelFormat = pixelFormat;
 
+    // Source rows are stored bottom-up: the strip starting at row y of the
+    // image starts at row height - y - stripHeight of the buffer
+    uint8_t* tjSrcBuffer = const_cast<uint8_t*>(rawData) +
+                           size_t(height - y - stripHeight) * tjPitch;
+
     uint8_t* tjJpegBuf = 0;
-    const int32_t tjJpegSubsamp = TJSAMP_444;
     const int32_t tjFlags = TJXOP_ROT180;
 
+    ImageJPEG image;
+    const auto compressor = _compressors.acquire();
+    if (!compressor)
+    {
+        BRAYNS_ERROR << "libjpeg-turbo compressor creation failure"
+                     << std::endl;
+        return image;
+    }
     const int32_t success =
-        tjCompress2(_compressor, tjSrcBuffer, width, tjPitch, height,
-                    tjPixelFormat, &tjJpegBuf, &dataSize, tjJpegSubsamp,
+        tjCompress2(compressor, tjSrcBuffer, width, tjPitch, stripHeight,
+                    tjPixelFormat, &tjJpegBuf, &image.size, subsampling,
                     quality, tjFlags);
+    _compressors.release(compressor);
 
     if (success != 0)
     {
         BRAYNS_ERROR << "libjpeg-turbo image conversion failure" << std::endl;
-        return 0;
+        tjFree(tjJpegBuf);
+        return ImageJPEG();
     }
-    return ImageJPEG::JpegData{tjJpegBuf};
+    image.data.reset(tjJpegBuf);
+    return image;
 }
 } // namespace brayns
@@ -24,16 +24,29 @@
 
 #include <turbojpeg.h>
 
+#include <mutex>
+
 namespace brayns
 {
+/** Chroma subsampling of the JPEG images. */
+enum class ChromaSubsampling
+{
+    yuv444, // full chroma resolution
+    yuv422, // half horizontal chroma resolution
+    yuv420  // half horizontal and vertical chroma resolution
+};
+
 /**
  * A class which creates images for network communication from a FrameBuffer.
+ *
+ * JPEG images are encoded in parallel horizontal strips, each strip being one
+ * restart interval of the resulting image. This object is thread safe.
  */
 class ImageGenerator
 {
 public:
     ImageGenerator() = default;
-    ~ImageGenerator();
+    ~ImageGenerator() = default;
 
     struct ImageBase64
     {
@@ -73,15 +86,35 @@ public:
      *
      * @param frameBuffer the framebuffer to use for getting the pixels
      * @param quality 1..100 JPEG quality
+     * @param subsampling chroma subsampling of the image
      * @return JPEG image with a size > 0 if valid, size == 0 on error.
      */
-    ImageJPEG createJPEG(FrameBuffer& frameBuffer, uint8_t quality);
+    ImageJPEG createJPEG(
+        FrameBuffer& frameBuffer, uint8_t quality,
+        ChromaSubsampling subsampling = ChromaSubsampling::yuv444);
 
 private:
-    tjhandle _compressor{tjInitCompress()};
+    /** Pool of TurboJPEG compressors, one per concurrent encoding. */
+    class CompressorPool
+    {
+    public:
+        ~CompressorPool();
+        tjhandle acquire();
+        void release(tjhandle compressor);
+
+    private:
+        std::mutex _mutex;
+        std::vector<tjhandle> _compressors;
+    };
+
+    CompressorPool _compressors;
 
-    ImageJPEG::JpegData _encodeJpeg(uint32_t width, uint32_t height,
-                                    const uint8_t* rawData, int32_t pixelFormat,
-                                    uint8_t quality, unsigned long& dataSize);
+    ImageJPEG _encodeJpeg(uint32_t width, uint32_t height,
+                          const uint8_t* rawData, int32_t pixelFormat,
+                          uint8_t quality, int32_t subsampling);
+    ImageJPEG _encodeStrip(uint32_t width, uint32_t height, uint32_t y,
+                           uint32_t stripHeight, const uint8_t* rawData,
+                           int32_t pixelFormat, uint8_t quality,
+                           int32_t subsampling);
 };
 } // namespace brayns
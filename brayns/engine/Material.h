@@ -32,6 +32,20 @@ namespace brayns
 {
 typedef std::map<TextureType, Texture2DPtr> TextureDescriptors;
 
+/**
+ * Colors looked up per primitive in place of the diffuse color. The user data
+ * of a primitive selects the last entry whose offset is not greater than it,
+ * or the entry at the same index if there are no offsets. A palette is usually
+ * shared by all the materials of a model, and is meant to be updated in place
+ * so that recoloring does not touch the geometry.
+ */
+struct ColorPalette
+{
+    Vector3fs colors;
+    uint64_ts offsets;
+};
+using ColorPalettePtr = std::shared_ptr<ColorPalette>;
+
 class Material : public PropertyObject
 {
 public:
@@ -105,6 +119,16 @@ public:
     }
     void clearTextures();
 
+    /** Sets the palette used in place of the diffuse color, none if null. */
+    BRAYNS_API void setColorPalette(ColorPalettePtr palette)
+    {
+        _updateValue(_colorPalette, palette);
+    }
+    BRAYNS_API const ColorPalettePtr& getColorPalette() const
+    {
+        return _colorPalette;
+    }
+
 protected:
     bool _loadTexture(const std::string& fileName, const TextureType type);
 
@@ -119,6 +143,7 @@ protected:
     double _glossiness{1.};
     TexturesMap _textures;
     TextureDescriptors _textureDescriptors;
+    ColorPalettePtr _colorPalette;
 
     SERIALIZATION_FRIEND(Material)
 };
@@ -30,6 +30,10 @@
 #include <brayns/common/utils/filesystem.h>
 #include <brayns/parameters/AnimationParameters.h>
 
+#include <async++.h>
+
+#include <algorithm>
+#include <limits>
 #include <set>
 
 namespace brayns
@@ -53,6 +57,95 @@ void _unbindMaterials(const AbstractSimulationHandlerPtr& simulationHandler,
     for (const auto& material : materials)
         simulationHandler->unbind(material.second);
 }
+
+// SDF geometries only have room for 255 neighbours, extra ones are dropped
+uint8_t _clampNeighbourCount(const size_t count)
+{
+    const size_t maxCount = std::numeric_limits<uint8_t>::max();
+    return uint8_t(std::min(count, maxCount));
+}
+
+// Number of primitives merged by one task when updating bounds
+const size_t BOUNDS_CHUNK_SIZE = 1 << 16;
+
+template <typename T, typename BoundsT>
+struct BoundsChunk
+{
+    BoundsT* cache;
+    const T* items;
+    size_t begin;
+    size_t end;
+    Boxd bounds;
+};
+
+// Queues the primitives not merged in the cached bounds yet. The cache is reset
+// if primitives were removed.
+template <typename T, typename BoundsT>
+void _addBoundsChunks(const std::vector<T>& items, BoundsT& cache,
+                      std::vector<BoundsChunk<T, BoundsT>>& chunks)
+{
+    if (cache.count > items.size())
+        cache = BoundsT();
+    for (size_t begin = cache.count; begin < items.size();
+         begin += BOUNDS_CHUNK_SIZE)
+    {
+        const auto end = std::min(begin + BOUNDS_CHUNK_SIZE, items.size());
+        chunks.push_back({&cache, items.data(), begin, end, Boxd()});
+    }
+    cache.count = items.size();
+}
+
+template <typename T, typename BoundsT, typename MergeFunc>
+void _mergeBoundsChunks(std::vector<BoundsChunk<T, BoundsT>>& chunks,
+                        const MergeFunc& merge)
+{
+    const auto mergeChunk = [&](const size_t index) {
+        auto& chunk = chunks[index];
+        for (size_t i = chunk.begin; i < chunk.end; ++i)
+            merge(chunk.bounds, chunk.items[i]);
+    };
+
+    // Small updates, like a few appended primitives, are not worth a task
+    if (chunks.size() > 1)
+        async::parallel_for(async::irange(size_t(0), chunks.size()),
+                            mergeChunk);
+    else if (!chunks.empty())
+        mergeChunk(0);
+
+    for (const auto& chunk : chunks)
+        chunk.cache->bounds.merge(chunk.bounds);
+}
+
+// Updates the cached bounds of each material of a geometry map and returns the
+// bounds of all the materials
+template <typename MapT, typename BoundsMapT, typename ItemsFunc,
+          typename MergeFunc>
+Boxd _updateMaterialBounds(const MapT& map, BoundsMapT& cache,
+                           const bool skipBoundingBox,
+                           const ItemsFunc& getItems, const MergeFunc& merge)
+{
+    using Items = std::decay_t<decltype(getItems(map.begin()->second))>;
+    using Bounds = typename BoundsMapT::mapped_type;
+    std::vector<BoundsChunk<typename Items::value_type, Bounds>> chunks;
+    for (const auto& entry : map)
+        if (!skipBoundingBox || entry.first != BOUNDINGBOX_MATERIAL_ID)
+            _addBoundsChunks(getItems(entry.second), cache[entry.first],
+                             chunks);
+
+    _mergeBoundsChunks(chunks, merge);
+
+    Boxd bounds;
+    for (const auto& entry : map)
+        if (!skipBoundingBox || entry.first != BOUNDINGBOX_MATERIAL_ID)
+            bounds.merge(cache[entry.first].bounds);
+    return bounds;
+}
+
+template <typename T>
+const T& _getItems(const T& items)
+{
+    return items;
+}
 } // namespace
 ModelParams::ModelParams(const std::string& path)
     : _name(fs::path(path).stem())
@@ -206,27 +299,92 @@ bool Model::empty() const
 uint64_t Model::addSphere(const size_t materialId, const Sphere& sphere)
 {
     _spheresDirty = true;
+    _dirtySpheres.mark(materialId);
+    _geometries->_memoryUsage.spheres += sizeof(Sphere);
     _geometries->_spheres[materialId].push_back(sphere);
     return _geometries->_spheres[materialId].size() - 1;
 }
 
+uint64_t Model::addSpheres(const size_t materialId, const Spheres& spheres)
+{
+    if (spheres.empty())
+    {
+        const auto it = _geometries->_spheres.find(materialId);
+        return it == _geometries->_spheres.end() ? 0 : it->second.size();
+    }
+
+    auto& materialSpheres = _geometries->_spheres[materialId];
+    const uint64_t firstIndex = materialSpheres.size();
+    materialSpheres.insert(materialSpheres.end(), spheres.begin(),
+                           spheres.end());
+
+    _spheresDirty = true;
+    _dirtySpheres.mark(materialId);
+    _geometries->_memoryUsage.spheres += spheres.size() * sizeof(Sphere);
+    return firstIndex;
+}
+
 uint64_t Model::addCylinder(const size_t materialId, const Cylinder& cylinder)
 {
     _cylindersDirty = true;
+    _dirtyCylinders.mark(materialId);
+    _geometries->_memoryUsage.cylinders += sizeof(Cylinder);
     _geometries->_cylinders[materialId].push_back(cylinder);
     return _geometries->_cylinders[materialId].size() - 1;
 }
 
+uint64_t Model::addCylinders(const size_t materialId,
+                             const Cylinders& cylinders)
+{
+    if (cylinders.empty())
+    {
+        const auto it = _geometries->_cylinders.find(materialId);
+        return it == _geometries->_cylinders.end() ? 0 : it->second.size();
+    }
+
+    auto& materialCylinders = _geometries->_cylinders[materialId];
+    const uint64_t firstIndex = materialCylinders.size();
+    materialCylinders.insert(materialCylinders.end(), cylinders.begin(),
+                             cylinders.end());
+
+    _cylindersDirty = true;
+    _dirtyCylinders.mark(materialId);
+    _geometries->_memoryUsage.cylinders += cylinders.size() * sizeof(Cylinder);
+    return firstIndex;
+}
+
 uint64_t Model::addCone(const size_t materialId, const Cone& cone)
 {
     _conesDirty = true;
+    _dirtyCones.mark(materialId);
+    _geometries->_memoryUsage.cones += sizeof(Cone);
     _geometries->_cones[materialId].push_back(cone);
     return _geometries->_cones[materialId].size() - 1;
 }
 
+uint64_t Model::addCones(const size_t materialId, const Cones& cones)
+{
+    if (cones.empty())
+    {
+        const auto it = _geometries->_cones.find(materialId);
+        return it == _geometries->_cones.end() ? 0 : it->second.size();
+    }
+
+    auto& materialCones = _geometries->_cones[materialId];
+    const uint64_t firstIndex = materialCones.size();
+    materialCones.insert(materialCones.end(), cones.begin(), cones.end());
+
+    _conesDirty = true;
+    _dirtyCones.mark(materialId);
+    _geometries->_memoryUsage.cones += cones.size() * sizeof(Cone);
+    return firstIndex;
+}
+
 uint64_t Model::addSDFBezier(const size_t materialId, const SDFBezier& bezier)
 {
     _sdfBeziersDirty = true;
+    _dirtySDFBeziers.mark(materialId);
+    _geometries->_memoryUsage.sdfBeziers += sizeof(SDFBezier);
     _geometries->_sdfBeziers[materialId].push_back(bezier);
     return _geometries->_sdfBeziers[materialId].size() - 1;
 }
@@ -259,24 +417,121 @@ void Model::addStreamline(const size_t materialId, const Streamline& streamline)
     for (const auto& color : streamline.color)
         streamlinesData.vertexColor.push_back(color);
 
+    const size_t nbVertices = streamline.position.size();
+    _geometries->_memoryUsage.streamlines +=
+        (nbVertices - 1) * sizeof(int32_t) + nbVertices * 2 * sizeof(Vector4f);
+    _streamlinesDirty = true;
+    _dirtyStreamlines.mark(materialId);
+}
+
+void Model::addStreamlines(const size_t materialId,
+                           const StreamlinesData& streamlines)
+{
+    const size_t nbVertices = streamlines.vertex.size();
+    if (nbVertices != streamlines.vertexColor.size())
+        throw std::runtime_error("Number of vertices and colors do not match.");
+
+    for (const auto index : streamlines.indices)
+        if (index < 0 || size_t(index) + 1 >= nbVertices)
+            throw std::runtime_error("Streamline index out of range.");
+
+    auto& streamlinesData = _geometries->_streamlines[materialId];
+
+    const size_t startIndex = streamlinesData.vertex.size();
+    if (startIndex + nbVertices >
+        size_t(std::numeric_limits<int32_t>::max()))
+        throw std::runtime_error("Too many streamline vertices for material " +
+                                 std::to_string(materialId));
+
+    auto& indices = streamlinesData.indices;
+    indices.reserve(indices.size() + streamlines.indices.size());
+    for (const auto index : streamlines.indices)
+        indices.push_back(startIndex + index);
+
+    streamlinesData.vertex.insert(streamlinesData.vertex.end(),
+                                  streamlines.vertex.begin(),
+                                  streamlines.vertex.end());
+    streamlinesData.vertexColor.insert(streamlinesData.vertexColor.end(),
+                                       streamlines.vertexColor.begin(),
+                                       streamlines.vertexColor.end());
+
+    _geometries->_memoryUsage.streamlines +=
+        streamlines.indices.size() * sizeof(int32_t) +
+        nbVertices * 2 * sizeof(Vector4f);
     _streamlinesDirty = true;
+    _dirtyStreamlines.mark(materialId);
 }
 
 uint64_t Model::addSDFGeometry(const size_t materialId, const SDFGeometry& geom,
                                const std::vector<size_t>& neighbourIndices)
 {
-    const uint64_t geomIdx = _geometries->_sdf.geometries.size();
-    _geometries->_sdf.geometryIndices[materialId].push_back(geomIdx);
-    _geometries->_sdf.neighbours.push_back(neighbourIndices);
-    _geometries->_sdf.geometries.push_back(geom);
+    auto& sdf = _geometries->_sdf;
+    const uint64_t geomIdx = sdf.geometries.size();
+    sdf.geometryIndices[materialId].push_back(geomIdx);
+    sdf.geometries.push_back(geom);
+
+    auto& stored = sdf.geometries.back();
+    stored.neighboursIndex = sdf.neighbours.size();
+    stored.numNeighbours = _clampNeighbourCount(neighbourIndices.size());
+    sdf.neighbours.insert(sdf.neighbours.end(), neighbourIndices.begin(),
+                          neighbourIndices.begin() + stored.numNeighbours);
+
+    _geometries->_memoryUsage.sdfGeometries +=
+        sizeof(SDFGeometry) + sizeof(uint64_t) +
+        stored.numNeighbours * sizeof(uint64_t);
     _sdfGeometriesDirty = true;
     return geomIdx;
 }
 
+uint64_t Model::addSDFGeometries(const std::vector<size_t>& materialIds,
+                                 const std::vector<SDFGeometry>& geometries,
+                                 const std::vector<uint64_t>& neighbourOffsets,
+                                 const std::vector<uint64_t>& neighbours)
+{
+    auto& sdf = _geometries->_sdf;
+    const uint64_t firstIndex = sdf.geometries.size();
+    const size_t nbGeometries = geometries.size();
+    if (nbGeometries == 0)
+        return firstIndex;
+
+    if (materialIds.size() != nbGeometries ||
+        neighbourOffsets.size() != nbGeometries + 1 ||
+        neighbourOffsets.back() != neighbours.size())
+        throw std::runtime_error("SDF geometry batch sizes do not match.");
+    for (size_t i = 0; i < nbGeometries; ++i)
+        if (neighbourOffsets[i] > neighbourOffsets[i + 1])
+            throw std::runtime_error("SDF neighbour offsets are not sorted.");
+    for (const auto index : neighbours)
+        if (index >= nbGeometries)
+            throw std::runtime_error("SDF neighbour index out of range.");
+
+    const size_t firstNeighbour = sdf.neighbours.size();
+    for (size_t i = 0; i < nbGeometries; ++i)
+    {
+        sdf.geometryIndices[materialIds[i]].push_back(firstIndex + i);
+
+        auto geom = geometries[i];
+        const auto begin = neighbourOffsets[i];
+        geom.neighboursIndex = sdf.neighbours.size();
+        geom.numNeighbours =
+            _clampNeighbourCount(neighbourOffsets[i + 1] - begin);
+        for (size_t j = begin; j < begin + geom.numNeighbours; ++j)
+            sdf.neighbours.push_back(firstIndex + neighbours[j]);
+        sdf.geometries.push_back(geom);
+    }
+
+    _geometries->_memoryUsage.sdfGeometries +=
+        nbGeometries * (sizeof(SDFGeometry) + sizeof(uint64_t)) +
+        (sdf.neighbours.size() - firstNeighbour) * sizeof(uint64_t);
+    _sdfGeometriesDirty = true;
+    return firstIndex;
+}
+
 uint64_t Model::addMetaObject(const size_t materialId,
                               const PropertyMap& metaObject)
 {
     _geometries->_metaObjects[materialId].push_back(metaObject);
+    _geometries->_memoryUsage.metaObjects += sizeof(PropertyMap);
     _metaObjectsDirty = true;
     return _geometries->_metaObjects.size() - 1;
 }
@@ -284,7 +539,25 @@ uint64_t Model::addMetaObject(const size_t materialId,
 void Model::updateSDFGeometryNeighbours(
     size_t geometryIdx, const std::vector<size_t>& neighbourIndices)
 {
-    _geometries->_sdf.neighbours[geometryIdx] = neighbourIndices;
+    auto& sdf = _geometries->_sdf;
+    auto& geom = sdf.geometries[geometryIdx];
+    auto& neighbours = sdf.neighbours;
+    const size_t previousSize = neighbours.size();
+
+    // The list is rewritten in place when it fits, otherwise appended and the
+    // previous range is left unused
+    const auto count = _clampNeighbourCount(neighbourIndices.size());
+    if (count > geom.numNeighbours)
+    {
+        geom.neighboursIndex = neighbours.size();
+        neighbours.resize(neighbours.size() + count);
+    }
+    std::copy(neighbourIndices.begin(), neighbourIndices.begin() + count,
+              neighbours.begin() + geom.neighboursIndex);
+    geom.numNeighbours = count;
+
+    _geometries->_memoryUsage.sdfGeometries +=
+        (neighbours.size() - previousSize) * sizeof(uint64_t);
     _sdfGeometriesDirty = true;
 }
 
@@ -401,7 +674,7 @@ void Model::setMaterialsColorMap(const MaterialsColorMap colorMap)
 
 void Model::logInformation()
 {
-    _updateSizeInBytes();
+    const auto sizeInBytes = getSizeInBytes();
 
     uint64_t nbSpheres = 0;
     uint64_t nbCylinders = 0;
@@ -428,8 +701,8 @@ void Model::logInformation()
                  << ", SDFGeometries: " << nbSdfGeoms
                  << ", Meshes: " << nbMeshes
                  << ", Meta Objects: " << nbMetaObjects
-                 << ", Memory: " << _sizeInBytes << " bytes ("
-                 << _sizeInBytes / 1048576 << " MB), Bounds: " << _bounds
+                 << ", Memory: " << sizeInBytes << " bytes ("
+                 << sizeInBytes / 1048576 << " MB), Bounds: " << _bounds
                  << std::endl;
 }
 
@@ -442,42 +715,83 @@ MaterialPtr Model::getMaterial(const size_t materialId) const
     return it->second;
 }
 
-void Model::_updateSizeInBytes()
+void Model::_updateMemoryUsage() const
 {
-    _sizeInBytes = 0;
-    for (const auto& spheres : _geometries->_spheres)
-        _sizeInBytes += spheres.second.size() * sizeof(Sphere);
-    for (const auto& cylinders : _geometries->_cylinders)
-        _sizeInBytes += cylinders.second.size() * sizeof(Cylinder);
-    for (const auto& cones : _geometries->_cones)
-        _sizeInBytes += cones.second.size() * sizeof(Cones);
-    for (const auto& sdfBeziers : _geometries->_sdfBeziers)
-        _sizeInBytes += sdfBeziers.second.size() * sizeof(SDFBeziers);
-    for (const auto& triangleMesh : _geometries->_triangleMeshes)
+    auto& geometries = *_geometries;
+    auto& usage = geometries._memoryUsage;
+    if (geometries._spheresSizeDirty)
+    {
+        usage.spheres = 0;
+        for (const auto& spheres : geometries._spheres)
+            usage.spheres += spheres.second.size() * sizeof(Sphere);
+    }
+    if (geometries._cylindersSizeDirty)
+    {
+        usage.cylinders = 0;
+        for (const auto& cylinders : geometries._cylinders)
+            usage.cylinders += cylinders.second.size() * sizeof(Cylinder);
+    }
+    if (geometries._conesSizeDirty)
     {
-        const auto& mesh = triangleMesh.second;
-        _sizeInBytes += mesh.indices.size() * sizeof(Vector3f);
-        _sizeInBytes += mesh.normals.size() * sizeof(Vector3f);
-        _sizeInBytes += mesh.colors.size() * sizeof(Vector4f);
-        _sizeInBytes += mesh.indices.size() * sizeof(Vector3ui);
-        _sizeInBytes += mesh.textureCoordinates.size() * sizeof(Vector2f);
+        usage.cones = 0;
+        for (const auto& cones : geometries._cones)
+            usage.cones += cones.second.size() * sizeof(Cone);
     }
-    for (const auto& streamline : _geometries->_streamlines)
+    if (geometries._sdfBeziersSizeDirty)
     {
-        _sizeInBytes += streamline.second.indices.size() * sizeof(int32_t);
-        _sizeInBytes += streamline.second.vertex.size() * sizeof(Vector4f);
-        _sizeInBytes += streamline.second.vertexColor.size() * sizeof(Vector4f);
+        usage.sdfBeziers = 0;
+        for (const auto& sdfBeziers : geometries._sdfBeziers)
+            usage.sdfBeziers += sdfBeziers.second.size() * sizeof(SDFBezier);
+    }
+    if (geometries._triangleMeshesSizeDirty)
+    {
+        usage.triangleMeshes = 0;
+        for (const auto& triangleMesh : geometries._triangleMeshes)
+        {
+            const auto& mesh = triangleMesh.second;
+            usage.triangleMeshes += mesh.vertices.size() * sizeof(Vector3f);
+            usage.triangleMeshes += mesh.normals.size() * sizeof(Vector3f);
+            usage.triangleMeshes += mesh.colors.size() * sizeof(Vector4f);
+            usage.triangleMeshes += mesh.indices.size() * sizeof(Vector3ui);
+            usage.triangleMeshes +=
+                mesh.textureCoordinates.size() * sizeof(Vector2f);
+        }
+    }
+    if (geometries._streamlinesSizeDirty)
+    {
+        usage.streamlines = 0;
+        for (const auto& streamline : geometries._streamlines)
+        {
+            const auto& data = streamline.second;
+            usage.streamlines += data.indices.size() * sizeof(int32_t);
+            usage.streamlines += data.vertex.size() * sizeof(Vector4f);
+            usage.streamlines += data.vertexColor.size() * sizeof(Vector4f);
+        }
+    }
+    if (geometries._sdfGeometriesSizeDirty)
+    {
+        const auto& sdf = geometries._sdf;
+        usage.sdfGeometries = sdf.geometries.size() * sizeof(SDFGeometry);
+        for (const auto& sdfIndices : sdf.geometryIndices)
+            usage.sdfGeometries += sdfIndices.second.size() * sizeof(uint64_t);
+        usage.sdfGeometries += sdf.neighbours.size() * sizeof(uint64_t);
+    }
+    if (geometries._metaObjectsSizeDirty)
+    {
+        usage.metaObjects = 0;
+        for (const auto& metaObjects : geometries._metaObjects)
+            usage.metaObjects +=
+                metaObjects.second.size() * sizeof(PropertyMap);
     }
 
-    _sizeInBytes += _geometries->_sdf.geometries.size() * sizeof(SDFGeometry);
-    _sizeInBytes += _geometries->_sdf.neighboursFlat.size() * sizeof(uint64_t);
-    for (const auto& sdfIndices : _geometries->_sdf.geometryIndices)
-        _sizeInBytes += sdfIndices.second.size() * sizeof(uint64_t);
-    for (const auto& sdfNeighbours : _geometries->_sdf.neighbours)
-        _sizeInBytes += sdfNeighbours.size() * sizeof(size_t);
-    for (const auto& metaObjList : _geometries->_metaObjects)
-        for (const auto& metaObj : metaObjList.second)
-            _sizeInBytes += sizeof(metaObj);
+    geometries._spheresSizeDirty = false;
+    geometries._cylindersSizeDirty = false;
+    geometries._conesSizeDirty = false;
+    geometries._sdfBeziersSizeDirty = false;
+    geometries._triangleMeshesSizeDirty = false;
+    geometries._streamlinesSizeDirty = false;
+    geometries._sdfGeometriesSizeDirty = false;
+    geometries._metaObjectsSizeDirty = false;
 }
 
 void Model::copyFrom(const Model& rhs)
@@ -504,7 +818,6 @@ void Model::copyFrom(const Model& rhs)
     }
     _bounds = rhs._bounds;
     _bvhFlags = rhs._bvhFlags;
-    _sizeInBytes = rhs._sizeInBytes;
 
     // reference only to save memory
     _geometries = rhs._geometries;
@@ -518,87 +831,85 @@ void Model::copyFrom(const Model& rhs)
     _sdfGeometriesDirty = !_geometries->_sdf.geometries.empty();
     _volumesDirty = !_geometries->_volumes.empty();
     _metaObjectsDirty = !_geometries->_metaObjects.empty();
+
+    _dirtySpheres.markAll();
+    _dirtyCylinders.markAll();
+    _dirtyCones.markAll();
+    _dirtySDFBeziers.markAll();
+    _dirtyTriangleMeshes.markAll();
+    _dirtyStreamlines.markAll();
 }
 
 void Model::updateBounds()
 {
     if (_spheresDirty)
-    {
-        _geometries->_sphereBounds.reset();
-        for (const auto& spheres : _geometries->_spheres)
-            if (spheres.first != BOUNDINGBOX_MATERIAL_ID)
-                for (const auto& sphere : spheres.second)
-                {
-                    _geometries->_sphereBounds.merge(sphere.center +
-                                                     sphere.radius);
-                    _geometries->_sphereBounds.merge(sphere.center -
-                                                     sphere.radius);
-                }
-    }
+        _geometries->_sphereBounds = _updateMaterialBounds(
+            _geometries->_spheres, _geometries->_sphereMaterialBounds, true,
+            _getItems<Spheres>, [](Boxd& bounds, const Sphere& sphere) {
+                bounds.merge(sphere.center + sphere.radius);
+                bounds.merge(sphere.center - sphere.radius);
+            });
 
     if (_cylindersDirty)
-    {
-        _geometries->_cylindersBounds.reset();
-        for (const auto& cylinders : _geometries->_cylinders)
-            if (cylinders.first != BOUNDINGBOX_MATERIAL_ID)
-                for (const auto& cylinder : cylinders.second)
-                {
-                    _geometries->_cylindersBounds.merge(cylinder.center);
-                    _geometries->_cylindersBounds.merge(cylinder.up);
-                }
-    }
+        _geometries->_cylindersBounds = _updateMaterialBounds(
+            _geometries->_cylinders, _geometries->_cylinderMaterialBounds,
+            true, _getItems<Cylinders>,
+            [](Boxd& bounds, const Cylinder& cylinder) {
+                bounds.merge(cylinder.center);
+                bounds.merge(cylinder.up);
+            });
 
     if (_conesDirty)
-    {
-        _geometries->_conesBounds.reset();
-        for (const auto& cones : _geometries->_cones)
-            if (cones.first != BOUNDINGBOX_MATERIAL_ID)
-                for (const auto& cone : cones.second)
-                {
-                    _geometries->_conesBounds.merge(cone.center);
-                    _geometries->_conesBounds.merge(cone.up);
-                }
-    }
+        _geometries->_conesBounds = _updateMaterialBounds(
+            _geometries->_cones, _geometries->_coneMaterialBounds, true,
+            _getItems<Cones>, [](Boxd& bounds, const Cone& cone) {
+                bounds.merge(cone.center);
+                bounds.merge(cone.up);
+            });
 
     if (_sdfBeziersDirty)
-    {
-        _geometries->_sdfBeziersBounds.reset();
-        for (const auto& sdfBeziers : _geometries->_sdfBeziers)
-            if (sdfBeziers.first != BOUNDINGBOX_MATERIAL_ID)
-                for (const auto& sdfBezier : sdfBeziers.second)
-                    _geometries->_sdfBeziersBounds.merge(
-                        bezierBounds(sdfBezier));
-    }
+        _geometries->_sdfBeziersBounds = _updateMaterialBounds(
+            _geometries->_sdfBeziers, _geometries->_sdfBezierMaterialBounds,
+            true, _getItems<SDFBeziers>,
+            [](Boxd& bounds, const SDFBezier& sdfBezier) {
+                bounds.merge(bezierBounds(sdfBezier));
+            });
 
     if (_triangleMeshesDirty)
-    {
-        _geometries->_triangleMeshesBounds.reset();
-        for (const auto& mesh : _geometries->_triangleMeshes)
-            if (mesh.first != BOUNDINGBOX_MATERIAL_ID)
-                for (const auto& vertex : mesh.second.vertices)
-                    _geometries->_triangleMeshesBounds.merge(vertex);
-    }
+        _geometries->_triangleMeshesBounds = _updateMaterialBounds(
+            _geometries->_triangleMeshes,
+            _geometries->_triangleMeshMaterialBounds, true,
+            [](const TriangleMesh& mesh) -> const Vector3fs& {
+                return mesh.vertices;
+            },
+            [](Boxd& bounds, const Vector3f& vertex) {
+                bounds.merge(vertex);
+            });
 
     if (_streamlinesDirty)
-    {
-        _geometries->_streamlinesBounds.reset();
-        for (const auto& streamline : _geometries->_streamlines)
-            for (size_t index = 0; index < streamline.second.vertex.size();
-                 ++index)
-            {
-                const auto& pos = Vector3f(streamline.second.vertex[index]);
-                const float radius = streamline.second.vertex[index][3];
+        _geometries->_streamlinesBounds = _updateMaterialBounds(
+            _geometries->_streamlines, _geometries->_streamlineMaterialBounds,
+            false,
+            [](const StreamlinesData& data) -> const Vector4fs& {
+                return data.vertex;
+            },
+            [](Boxd& bounds, const Vector4f& vertex) {
+                const Vector3f pos(vertex);
+                const float radius = vertex[3];
                 const auto radiusVec = Vector3f(radius, radius, radius);
-                _geometries->_streamlinesBounds.merge(pos + radiusVec);
-                _geometries->_streamlinesBounds.merge(pos - radiusVec);
-            }
-    }
+                bounds.merge(pos + radiusVec);
+                bounds.merge(pos - radiusVec);
+            });
 
     if (_sdfGeometriesDirty)
     {
-        _geometries->_sdfGeometriesBounds.reset();
-        for (const auto& geom : _geometries->_sdf.geometries)
-            _geometries->_sdfGeometriesBounds.merge(getSDFBoundingBox(geom));
+        auto& cache = _geometries->_sdfGeometryBounds;
+        std::vector<BoundsChunk<SDFGeometry, MaterialBounds>> chunks;
+        _addBoundsChunks(_geometries->_sdf.geometries, cache, chunks);
+        _mergeBoundsChunks(chunks, [](Boxd& bounds, const SDFGeometry& geom) {
+            bounds.merge(getSDFBoundingBox(geom));
+        });
+        _geometries->_sdfGeometriesBounds = cache.bounds;
     }
 
     if (_volumesDirty)
@@ -630,6 +941,13 @@ void Model::_markGeometriesClean()
     _sdfGeometriesDirty = false;
     _volumesDirty = false;
     _metaObjectsDirty = false;
+
+    _dirtySpheres.clear();
+    _dirtyCylinders.clear();
+    _dirtyCones.clear();
+    _dirtySDFBeziers.clear();
+    _dirtyTriangleMeshes.clear();
+    _dirtyStreamlines.clear();
 }
 
 MaterialPtr Model::createMaterial(const size_t materialId,
@@ -654,10 +972,18 @@ void Model::setSimulationHandler(AbstractSimulationHandlerPtr handler)
 
 size_t Model::getSizeInBytes() const
 {
-    size_t volumeSizeInBytes = 0;
+    return getMemoryUsage().getTotal();
+}
+
+MemoryUsage Model::getMemoryUsage() const
+{
+    _updateMemoryUsage();
+    auto usage = _geometries->_memoryUsage;
     for (const auto& volume : _geometries->_volumes)
-        volumeSizeInBytes += volume->getSizeInBytes();
-    return _sizeInBytes + volumeSizeInBytes;
+        usage.volumes += volume->getSizeInBytes();
+    if (_simulationHandler)
+        usage.simulation = _simulationHandler->getSizeInBytes();
+    return usage;
 }
 
 AbstractSimulationHandlerPtr Model::getSimulationHandler() const
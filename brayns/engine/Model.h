@@ -22,6 +22,7 @@
 
 #include <brayns/api.h>
 #include <brayns/common/BaseObject.h>
+#include <brayns/common/Statistics.h>
 #include <brayns/common/Transformation.h>
 #include <brayns/common/geometry/Cone.h>
 #include <brayns/common/geometry/Cylinder.h>
@@ -33,6 +34,7 @@
 #include <brayns/common/propertymap/PropertyMap.h>
 #include <brayns/common/types.h>
 
+#include <map>
 #include <set>
 
 SERIALIZATION_ACCESS(Model)
@@ -47,8 +49,11 @@ struct SDFGeometryData
     std::vector<SDFGeometry> geometries;
     std::map<size_t, std::vector<uint64_t>> geometryIndices;
 
-    std::vector<std::vector<uint64_t>> neighbours;
-    std::vector<uint64_t> neighboursFlat;
+    /** Neighbour indices of all geometries, back to back. Each geometry
+     * references its own list through neighboursIndex and numNeighbours, so
+     * the buffer can be handed to the engine as is.
+     */
+    std::vector<uint64_t> neighbours;
 };
 
 class Scene;
@@ -278,6 +283,9 @@ public:
     SpheresMap& getSpheres()
     {
         _spheresDirty = true;
+        _dirtySpheres.markAll();
+        _geometries->_sphereMaterialBounds.clear();
+        _geometries->_spheresSizeDirty = true;
         return _geometries->_spheres;
     }
     /**
@@ -289,6 +297,15 @@ public:
     BRAYNS_API uint64_t addSphere(const size_t materialId,
                                   const Sphere& sphere);
 
+    /**
+      Adds a set of spheres to the model at once
+      @param materialId Id of the material for the spheres
+      @param spheres Spheres to add
+      @return Index of the first added sphere for the specified material
+      */
+    BRAYNS_API uint64_t addSpheres(const size_t materialId,
+                                   const Spheres& spheres);
+
     /**
         Returns cylinders handled by the model
       */
@@ -296,6 +313,9 @@ public:
     CylindersMap& getCylinders()
     {
         _cylindersDirty = true;
+        _dirtyCylinders.markAll();
+        _geometries->_cylinderMaterialBounds.clear();
+        _geometries->_cylindersSizeDirty = true;
         return _geometries->_cylinders;
     }
     /**
@@ -306,6 +326,16 @@ public:
       */
     BRAYNS_API uint64_t addCylinder(const size_t materialId,
                                     const Cylinder& cylinder);
+
+    /**
+      Adds a set of cylinders to the model at once
+      @param materialId Id of the material for the cylinders
+      @param cylinders Cylinders to add
+      @return Index of the first added cylinder for the specified material
+      */
+    BRAYNS_API uint64_t addCylinders(const size_t materialId,
+                                     const Cylinders& cylinders);
+
     /**
         Returns cones handled by the model
     */
@@ -313,6 +343,9 @@ public:
     ConesMap& getCones()
     {
         _conesDirty = true;
+        _dirtyCones.markAll();
+        _geometries->_coneMaterialBounds.clear();
+        _geometries->_conesSizeDirty = true;
         return _geometries->_cones;
     }
     /**
@@ -323,6 +356,14 @@ public:
       */
     BRAYNS_API uint64_t addCone(const size_t materialId, const Cone& cone);
 
+    /**
+      Adds a set of cones to the model at once
+      @param materialId Id of the material for the cones
+      @param cones Cones to add
+      @return Index of the first added cone for the specified material
+      */
+    BRAYNS_API uint64_t addCones(const size_t materialId, const Cones& cones);
+
     /**
         Returns SDFBezier handled by the model
     */
@@ -334,6 +375,9 @@ public:
     SDFBeziersMap& getSDFBeziers()
     {
         _sdfBeziersDirty = true;
+        _dirtySDFBeziers.markAll();
+        _geometries->_sdfBezierMaterialBounds.clear();
+        _geometries->_sdfBeziersSizeDirty = true;
         return _geometries->_sdfBeziers;
     }
     /**
@@ -353,12 +397,28 @@ public:
     BRAYNS_API void addStreamline(const size_t materialId,
                                   const Streamline& streamline);
 
+    /**
+      Adds a set of streamlines to the model at once
+      @param materialId Id of the material for the streamlines
+      @param streamlines Streamlines to add, their indices refer to their own
+             vertices
+      */
+    BRAYNS_API void addStreamlines(const size_t materialId,
+                                   const StreamlinesData& streamlines);
+
     /**
         Returns streamlines handled by the model
     */
+    const StreamlinesDataMap& getStreamlines() const
+    {
+        return _geometries->_streamlines;
+    }
     StreamlinesDataMap& getStreamlines()
     {
         _streamlinesDirty = true;
+        _dirtyStreamlines.markAll();
+        _geometries->_streamlineMaterialBounds.clear();
+        _geometries->_streamlinesSizeDirty = true;
         return _geometries->_streamlines;
     }
     /**
@@ -372,12 +432,33 @@ public:
     uint64_t addSDFGeometry(const size_t materialId, const SDFGeometry& geom,
                             const std::vector<size_t>& neighbourIndices);
 
+    /**
+      Adds a batch of SDF geometries to the scene
+      @param materialIds Material of each geometry
+      @param geometries Geometries to add
+      @param neighbourOffsets Start of the neighbours of each geometry in
+      neighbours, followed by the total number of neighbours
+      @param neighbours Indices of the geometries to smoothly blend together
+      with, relative to the first geometry of the batch
+      @return Global index of the first geometry of the batch
+      */
+    uint64_t addSDFGeometries(const std::vector<size_t>& materialIds,
+                              const std::vector<SDFGeometry>& geometries,
+                              const std::vector<uint64_t>& neighbourOffsets,
+                              const std::vector<uint64_t>& neighbours);
+
     /**
      * Returns SDF geometry data handled by the model
      */
+    const SDFGeometryData& getSDFGeometryData() const
+    {
+        return _geometries->_sdf;
+    }
     SDFGeometryData& getSDFGeometryData()
     {
         _sdfGeometriesDirty = true;
+        _geometries->_sdfGeometryBounds = {};
+        _geometries->_sdfGeometriesSizeDirty = true;
         return _geometries->_sdf;
     }
 
@@ -397,6 +478,7 @@ public:
     MetaObjects& getMetaObjects()
     {
         _metaObjectsDirty = true;
+        _geometries->_metaObjectsSizeDirty = true;
         return _geometries->_metaObjects;
     }
 
@@ -418,6 +500,9 @@ public:
     TriangleMeshMap& getTriangleMeshes()
     {
         _triangleMeshesDirty = true;
+        _dirtyTriangleMeshes.markAll();
+        _geometries->_triangleMeshMaterialBounds.clear();
+        _geometries->_triangleMeshesSizeDirty = true;
         return _geometries->_triangleMeshes;
     }
 
@@ -465,8 +550,15 @@ public:
     */
     BRAYNS_API void setSimulationHandler(AbstractSimulationHandlerPtr handler);
 
-    /** @return the size in bytes of all geometries. */
+    /** @return the size in bytes of all geometries, volumes and simulation. */
     size_t getSizeInBytes() const;
+
+    /**
+     * @return the memory used by the model by type of data. Geometry sizes are
+     *         maintained by the add* methods, only the geometry types returned
+     *         by a non-const accessor since the last call are recomputed.
+     */
+    BRAYNS_API MemoryUsage getMemoryUsage() const;
     void markInstancesDirty() { _instancesDirty = true; }
     void markInstancesClean() { _instancesDirty = false; }
     const Volumes& getVolumes() const { return _geometries->_volumes; }
@@ -481,12 +573,17 @@ public:
     void setSimulationEnabled(const bool v) { _simulationEnabled = v; }
     bool isSimulationEnabled() const { return _simulationEnabled; }
 
-    void updateBounds();
+    /**
+     * Update the bounds of the dirty geometries. Bounds are cached per
+     * material, primitives added with the add* methods are merged into the
+     * cache, while the non-const geometry accessors invalidate it.
+     */
+    BRAYNS_API void updateBounds();
     /** @internal */
     void copyFrom(const Model& rhs);
 
 protected:
-    void _updateSizeInBytes();
+    void _updateMemoryUsage() const;
 
     /** Factory method to create an engine-specific material. */
     BRAYNS_API virtual MaterialPtr createMaterialImpl(
@@ -503,6 +600,14 @@ protected:
 
     MaterialMap _materials;
 
+    // Bounds of the first count primitives of a material
+    struct MaterialBounds
+    {
+        Boxd bounds;
+        size_t count{0};
+    };
+    using MaterialBoundsMap = std::map<size_t, MaterialBounds>;
+
     struct Geometries
     {
         SpheresMap _spheres;
@@ -525,6 +630,25 @@ protected:
         Boxd _volumesBounds;
         Boxd _metaObjectBounds;
 
+        MaterialBoundsMap _sphereMaterialBounds;
+        MaterialBoundsMap _cylinderMaterialBounds;
+        MaterialBoundsMap _coneMaterialBounds;
+        MaterialBoundsMap _sdfBezierMaterialBounds;
+        MaterialBoundsMap _triangleMeshMaterialBounds;
+        MaterialBoundsMap _streamlineMaterialBounds;
+        MaterialBounds _sdfGeometryBounds;
+
+        // Geometry sizes in bytes, the flags mark the sizes to recompute
+        MemoryUsage _memoryUsage;
+        bool _spheresSizeDirty{false};
+        bool _cylindersSizeDirty{false};
+        bool _conesSizeDirty{false};
+        bool _sdfBeziersSizeDirty{false};
+        bool _triangleMeshesSizeDirty{false};
+        bool _streamlinesSizeDirty{false};
+        bool _sdfGeometriesSizeDirty{false};
+        bool _metaObjectsSizeDirty{false};
+
         bool isEmpty() const
         {
             return _spheres.empty() && _cylinders.empty() && _cones.empty() &&
@@ -539,6 +663,39 @@ protected:
     // commitGeometry()
     std::shared_ptr<Geometries> _geometries{std::make_shared<Geometries>()};
 
+    /** Materials of a geometry type changed since the last commit */
+    struct DirtyMaterials
+    {
+        // The whole map was handed out by a non-const accessor
+        bool all{false};
+        std::set<size_t> ids;
+
+        void mark(const size_t materialId)
+        {
+            if (!all)
+                ids.insert(materialId);
+        }
+        void markAll()
+        {
+            all = true;
+            ids.clear();
+        }
+        void clear()
+        {
+            all = false;
+            ids.clear();
+        }
+    };
+
+    // Engines only need to update the geometries of these materials, the
+    // flags below still tell if anything of a given type changed
+    DirtyMaterials _dirtySpheres;
+    DirtyMaterials _dirtyCylinders;
+    DirtyMaterials _dirtyCones;
+    DirtyMaterials _dirtySDFBeziers;
+    DirtyMaterials _dirtyTriangleMeshes;
+    DirtyMaterials _dirtyStreamlines;
+
     bool _spheresDirty{false};
     bool _cylindersDirty{false};
     bool _conesDirty{false};
@@ -559,7 +716,6 @@ protected:
     Boxd _bounds;
     bool _instancesDirty{true};
     std::set<BVHFlag> _bvhFlags;
-    size_t _sizeInBytes{0};
 
     // Whether this model has set the AnimationParameters "is ready" callback
     bool _isReadyCallbackSet{false};
@@ -124,12 +124,17 @@ void Scene::copyFrom(const Scene& rhs)
 void Scene::commit() {}
 
 size_t Scene::getSizeInBytes() const
+{
+    return getMemoryUsage().getTotal();
+}
+
+MemoryUsage Scene::getMemoryUsage() const
 {
     auto lock = acquireReadAccess();
-    size_t sizeInBytes = 0;
+    MemoryUsage usage;
     for (auto modelDescriptor : _modelDescriptors)
-        sizeInBytes += modelDescriptor->getModel().getSizeInBytes();
-    return sizeInBytes;
+        usage += modelDescriptor->getModel().getMemoryUsage();
+    return usage;
 }
 
 size_t Scene::getNumModels() const
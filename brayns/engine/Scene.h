@@ -22,6 +22,7 @@
 
 #include <brayns/api.h>
 #include <brayns/common/BaseObject.h>
+#include <brayns/common/Statistics.h>
 #include <brayns/common/loader/LoaderRegistry.h>
 #include <brayns/common/transferFunction/TransferFunction.h>
 #include <brayns/common/types.h>
@@ -152,6 +153,9 @@ public:
     /** @return the current size in bytes of the loaded geometry. */
     size_t getSizeInBytes() const;
 
+    /** @return the memory used by all models by type of data. */
+    BRAYNS_API MemoryUsage getMemoryUsage() const;
+
     /** @return the current number of models in the scene. */
     size_t getNumModels() const;
 
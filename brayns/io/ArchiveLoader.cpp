@@ -18,7 +18,6 @@
  * along with this library; if not, write to the Free Software Foundation, Inc.,
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
-
 #include "ArchiveLoader.h"
 
 #include <brayns/common/log.h>
@@ -27,13 +26,23 @@
 #include <brayns/engine/Model.h>
 #include <brayns/engine/Scene.h>
 
+#include <async++.h>
+
+#include <algorithm>
+#include <deque>
 #include <fstream>
+#include <iterator>
+#include <mutex>
+#include <thread>
 
 #include <archive.h>
 #include <archive_entry.h>
 
 namespace
 {
+using ArchivePtr = std::unique_ptr<archive, int (*)(archive*)>;
+using ModelDescriptors = std::vector<brayns::ModelDescriptorPtr>;
+
 bool isSupportedArchiveType(const std::string& extension)
 {
     // No way to get all supported types from libarchive...
@@ -42,48 +51,42 @@ bool isSupportedArchiveType(const std::string& extension)
     return extensions.find(extension) != extensions.end();
 }
 
-archive* _openArchive(const std::string& filename)
+ArchivePtr _newArchive(const std::string& filename)
 {
-    auto archive = archive_read_new();
-    archive_read_support_format_all(archive);
-    archive_read_support_filter_all(archive);
+    ArchivePtr archive(archive_read_new(), archive_read_free);
+    archive_read_support_format_all(archive.get());
+    archive_read_support_filter_all(archive.get());
 
     // non-tar archives like gz, bzip2, ... need to be added as raw
     auto extension = brayns::extractExtension(filename);
     if (!extension.empty())
     {
         if (isSupportedArchiveType(extension))
-            archive_read_support_format_raw(archive);
+            archive_read_support_format_raw(archive.get());
     }
-    if (archive_read_open_filename(archive, filename.c_str(), 10240) ==
+    return archive;
+}
+
+ArchivePtr _openArchive(const std::string& filename)
+{
+    auto archive = _newArchive(filename);
+    if (archive_read_open_filename(archive.get(), filename.c_str(), 10240) !=
         ARCHIVE_OK)
     {
-        return archive;
+        throw std::runtime_error(filename + " is not a supported archive type");
     }
-    archive_read_free(archive);
-    return nullptr;
+    return archive;
 }
 
-archive* _openArchive(const brayns::Blob& blob)
+ArchivePtr _openArchive(const brayns::Blob& blob)
 {
-    auto archive = archive_read_new();
-    archive_read_support_format_all(archive);
-    archive_read_support_filter_all(archive);
-
-    // non-tar archives like gz, bzip2, ... need to be added as raw
-    auto extension = brayns::extractExtension(blob.name);
-    if (!extension.empty())
-    {
-        if (isSupportedArchiveType(extension))
-            archive_read_support_format_raw(archive);
-    }
-    if (archive_read_open_memory(archive, (void*)blob.data.data(),
-                                 blob.data.size()) == ARCHIVE_OK)
+    auto archive = _newArchive(blob.name);
+    if (archive_read_open_memory(archive.get(), (void*)blob.data.data(),
+                                 blob.data.size()) != ARCHIVE_OK)
     {
-        return archive;
+        throw std::runtime_error("Blob is not a supported archive type");
     }
-    archive_read_free(archive);
-    return nullptr;
+    return archive;
 }
 
 int copy_data(struct archive* ar, struct archive* aw)
@@ -108,78 +111,80 @@ int copy_data(struct archive* ar, struct archive* aw)
     }
 }
 
-void _extractArchive(archive* archive, const std::string& filename,
-                     const std::string& destination)
+// Reads the data of the current entry into memory
+brayns::uint8_ts _readEntry(archive* archive, archive_entry* entry)
 {
-    auto writer = archive_write_disk_new();
-    archive_write_disk_set_options(writer, 0);
-    archive_write_disk_set_standard_lookup(writer);
+    brayns::uint8_ts data;
+    if (archive_entry_size_is_set(entry))
+        data.reserve(archive_entry_size(entry));
 
     for (;;)
     {
-        archive_entry* entry;
-        auto r = archive_read_next_header(archive, &entry);
+        const void* buff;
+        size_t size;
+        int64_t offset;
+
+        const auto r = archive_read_data_block(archive, &buff, &size, &offset);
         if (r == ARCHIVE_EOF)
-            break;
+            return data;
         if (r < ARCHIVE_OK)
             std::cerr << archive_error_string(archive) << std::endl;
         if (r < ARCHIVE_WARN)
-        {
             throw std::runtime_error(
                 std::string("Error reading file from archive: ") +
                 archive_error_string(archive));
-        }
-        const char* currentFile = archive_entry_pathname(entry);
-
-        // magic 'data' file for gzip archives is useless to us, so rename it
-        if (std::string(currentFile) == "data")
-            currentFile = filename.c_str();
-        const std::string fullOutputPath = destination + "/" + currentFile;
-        archive_entry_set_pathname(entry, fullOutputPath.c_str());
-        r = archive_write_header(writer, entry);
-        if (r < ARCHIVE_OK)
-            std::cerr << archive_error_string(writer) << std::endl;
-        else if (archive_entry_size(entry) > 0)
-        {
-            r = copy_data(archive, writer);
-            if (r < ARCHIVE_OK)
-                std::cerr << archive_error_string(writer) << std::endl;
-            if (r < ARCHIVE_WARN)
-                throw std::runtime_error(
-                    std::string("Error writing file from archive to disk: ") +
-                    archive_error_string(archive));
-        }
-        r = archive_write_finish_entry(writer);
+
+        // Sparse entries leave holes between the blocks
+        const auto end = size_t(offset) + size;
+        if (data.size() < end)
+            data.resize(end);
+        std::copy_n(static_cast<const uint8_t*>(buff), size,
+                    data.data() + offset);
+    }
+}
+
+// Writes the current entry to the given path on disk
+void _extractEntry(archive* archive, struct archive* writer,
+                   archive_entry* entry, const std::string& fullOutputPath)
+{
+    archive_entry_set_pathname(entry, fullOutputPath.c_str());
+    auto r = archive_write_header(writer, entry);
+    if (r < ARCHIVE_OK)
+        std::cerr << archive_error_string(writer) << std::endl;
+    else if (!archive_entry_size_is_set(entry) ||
+             archive_entry_size(entry) > 0)
+    {
+        r = copy_data(archive, writer);
         if (r < ARCHIVE_OK)
             std::cerr << archive_error_string(writer) << std::endl;
         if (r < ARCHIVE_WARN)
             throw std::runtime_error(
-                std::string("Error finishing current file: ") +
+                std::string("Error writing file from archive to disk: ") +
                 archive_error_string(archive));
     }
-    archive_read_free(archive);
-    archive_write_close(writer);
-    archive_write_free(writer);
+    r = archive_write_finish_entry(writer);
+    if (r < ARCHIVE_OK)
+        std::cerr << archive_error_string(writer) << std::endl;
+    if (r < ARCHIVE_WARN)
+        throw std::runtime_error(std::string("Error finishing current file: ") +
+                                 archive_error_string(archive));
 }
 
-void extractFile(const std::string& filename, const std::string& destination)
-{
-    auto archive = _openArchive(filename);
-    if (!archive)
-        throw std::runtime_error(filename + " is not a supported archive type");
-    _extractArchive(archive, fs::path(filename).stem().string(), destination);
-}
+const auto LOADER_NAME = "archive";
 
-void extractBlob(brayns::Blob&& blob, const std::string& destination)
+const brayns::Property PROP_LOAD_ALL_ENTRIES = {
+    "loadAllEntries",
+    false,
+    {"Load all entries",
+     "Load all the supported files of the archive instead of the first one "
+     "at its root"}};
+
+bool _isTopLevel(const std::string& path)
 {
-    auto archive = _openArchive(blob);
-    if (!archive)
-        throw std::runtime_error("Blob is not a supported archive type");
-    _extractArchive(archive, fs::path(blob.name).stem().string(), destination);
+    const auto parent = fs::path(path).parent_path();
+    return parent.empty() || parent == ".";
 }
 
-const auto LOADER_NAME = "archive";
-
 struct TmpFolder
 {
     TmpFolder()
@@ -190,6 +195,80 @@ struct TmpFolder
     ~TmpFolder() { fs::remove_all(path); }
     std::string path{"/tmp/brayns_extracted_XXXXXX"};
 };
+
+// Destination of the entries whose loader needs a path
+struct DiskExtraction
+{
+    DiskExtraction()
+        : writer(archive_write_disk_new())
+    {
+        archive_write_disk_set_options(writer, 0);
+        archive_write_disk_set_standard_lookup(writer);
+    }
+    ~DiskExtraction()
+    {
+        archive_write_close(writer);
+        archive_write_free(writer);
+    }
+    TmpFolder folder;
+    archive* writer;
+};
+
+struct ArchiveEntry
+{
+    std::string path;
+    const brayns::Loader* loader;
+    async::task<ModelDescriptors> task;
+};
+
+/**
+ * Reports the amount of the archive read so far, also on behalf of the loaders
+ * running concurrently on its entries.
+ */
+class ArchiveProgress
+{
+public:
+    ArchiveProgress(const brayns::LoaderProgress& callback, archive* archive,
+                    const size_t size)
+        : _callback(callback)
+        , _archive(archive)
+        , _size(size)
+    {
+    }
+
+    // Only called from the thread reading the archive
+    void update(const std::string& message)
+    {
+        const auto bytesRead = archive_filter_bytes(_archive, -1);
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_size > 0)
+            _fraction = std::min(1.f, float(bytesRead) / _size);
+        _callback.updateProgress(message, _fraction);
+    }
+
+    brayns::LoaderProgress forEntry()
+    {
+        return brayns::LoaderProgress(
+            [this](const std::string& message, const float) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _callback.updateProgress(message, _fraction);
+            });
+    }
+
+private:
+    const brayns::LoaderProgress& _callback;
+    archive* _archive;
+    const size_t _size;
+    float _fraction{0.f};
+    std::mutex _mutex;
+};
+
+void _waitAll(std::vector<ArchiveEntry>& entries)
+{
+    for (auto& entry : entries)
+        if (entry.task.valid())
+            entry.task.wait();
+}
 } // namespace
 
 namespace brayns
@@ -206,50 +285,173 @@ bool ArchiveLoader::isSupported(const std::string& filename BRAYNS_UNUSED,
     return isSupportedArchiveType(extension);
 }
 
-std::vector<ModelDescriptorPtr> ArchiveLoader::loadExtracted(
-    const std::string& path, const LoaderProgress& callback,
-    const PropertyMap& properties) const
+PropertyMap ArchiveLoader::getProperties() const
+{
+    PropertyMap pm;
+    pm.add(PROP_LOAD_ALL_ENTRIES);
+    return pm;
+}
+
+const Loader* ArchiveLoader::_findLoader(const std::string& path,
+                                         const std::string& loaderName) const
+{
+    if (!loaderName.empty())
+    {
+        const auto& loader = _registry.getSuitableLoader("", "", loaderName);
+        if (loader.isSupported(path, extractExtension(path)))
+            return &loader;
+        return nullptr;
+    }
+    if (_registry.isSupportedFile(path))
+        return &_registry.getSuitableLoader(path, "", "");
+    return nullptr;
+}
+
+std::vector<ModelDescriptorPtr> ArchiveLoader::_loadArchive(
+    archive* archive, const std::string& filename, const size_t size,
+    const LoaderProgress& callback, const PropertyMap& properties) const
 {
     const auto loaderName = properties.valueOr("loaderName", std::string());
-    const Loader* loader =
-        loaderName.empty() ? nullptr
-                           : &_registry.getSuitableLoader("", "", loaderName);
+    const auto loadAllEntries =
+        properties.valueOr(PROP_LOAD_ALL_ENTRIES.getName(), false);
+
+    // Decompression is sequential, so the entries which can be loaded from
+    // memory are handed over to a loader as soon as they are read. The number
+    // of entries in flight is bounded to keep their data from piling up.
+    const size_t maxPendingEntries =
+        std::max(1u, std::thread::hardware_concurrency());
+
+    ArchiveProgress progress(callback, archive, size);
+    std::unique_ptr<DiskExtraction> extraction;
+    std::vector<ArchiveEntry> entries;
+    std::deque<size_t> pendingEntries;
+
+    try
+    {
+        for (;;)
+        {
+            archive_entry* entry;
+            auto r = archive_read_next_header(archive, &entry);
+            if (r == ARCHIVE_EOF)
+                break;
+            if (r < ARCHIVE_OK)
+                std::cerr << archive_error_string(archive) << std::endl;
+            if (r < ARCHIVE_WARN)
+            {
+                throw std::runtime_error(
+                    std::string("Error reading file from archive: ") +
+                    archive_error_string(archive));
+            }
+            if (archive_entry_filetype(entry) != AE_IFREG)
+                continue;
 
-    for (const auto& i : fs::directory_iterator(path))
+            std::string path = archive_entry_pathname(entry);
+
+            // magic 'data' file for gzip archives is useless to us, so rename
+            // it
+            if (path == "data")
+                path = filename;
+            const auto extension = extractExtension(path);
+            auto loader = _findLoader(path, loaderName);
+
+            // By default only the first supported file at the root of the
+            // archive is loaded, the other files are only extracted
+            if (!loadAllEntries && (!entries.empty() || !_isTopLevel(path)))
+                loader = nullptr;
+
+            if (loader && loader->isBlobSupported(extension))
+            {
+                progress.update("Reading " + path + " from archive...");
+                Blob blob{extension, path, _readEntry(archive, entry)};
+
+                while (pendingEntries.size() >= maxPendingEntries)
+                {
+                    entries[pendingEntries.front()].task.wait();
+                    pendingEntries.pop_front();
+                }
+
+                auto task =
+                    async::spawn([loader, blob = std::move(blob),
+                                  entryProgress = progress.forEntry(),
+                                  &properties]() mutable {
+                        return loader->importFromBlob(std::move(blob),
+                                                      entryProgress,
+                                                      properties);
+                    });
+                pendingEntries.push_back(entries.size());
+                entries.push_back({path, loader, std::move(task)});
+                if (!loadAllEntries)
+                    break;
+                continue;
+            }
+
+            // Files that no loader supports may still be referenced by the
+            // ones loaded from disk, e.g. materials or textures
+            if (!extraction)
+                extraction = std::make_unique<DiskExtraction>();
+            progress.update("Extracting " + path + " from archive...");
+            const auto fullOutputPath = extraction->folder.path + "/" + path;
+            _extractEntry(archive, extraction->writer, entry, fullOutputPath);
+            if (loader)
+                entries.push_back({fullOutputPath, loader, {}});
+        }
+    }
+    catch (...)
     {
-        const std::string currPath = i.path().string();
-        const std::string extension = extractExtension(currPath);
+        _waitAll(entries);
+        throw;
+    }
+
+    if (entries.empty())
+        throw std::runtime_error("No loader found for archive.");
 
-        if (loader && loader->isSupported(currPath, extension))
+    // Entries loaded from disk may need files which come after them in the
+    // archive, so they are only loaded once it is fully extracted. Their
+    // loaders may create engine objects, so they run one at a time on this
+    // thread. Models are returned in the order of their entries in the
+    // archive.
+    std::vector<ModelDescriptorPtr> models;
+    std::exception_ptr error;
+    for (auto& entry : entries)
+    {
+        try
         {
-            return loader->importFromFile(currPath, callback, properties);
+            auto entryModels =
+                entry.task.valid()
+                    ? entry.task.get()
+                    : entry.loader->importFromFile(entry.path,
+                                                   progress.forEntry(),
+                                                   properties);
+            std::move(entryModels.begin(), entryModels.end(),
+                      std::back_inserter(models));
         }
-        else if (!loader && _registry.isSupportedFile(currPath))
+        catch (...)
         {
-            const auto& loaderMatch =
-                _registry.getSuitableLoader(currPath, "", "");
-            return loaderMatch.importFromFile(currPath, callback, properties);
+            if (!error)
+                error = std::current_exception();
         }
     }
-    throw std::runtime_error("No loader found for archive.");
+    if (error)
+        std::rethrow_exception(error);
+    return models;
 }
 
 std::vector<ModelDescriptorPtr> ArchiveLoader::importFromBlob(
     Blob&& blob, const LoaderProgress& callback,
     const PropertyMap& properties) const
 {
-    TmpFolder tmpFolder;
-    extractBlob(std::move(blob), tmpFolder.path);
-    return loadExtracted(tmpFolder.path, callback, properties);
+    auto archive = _openArchive(blob);
+    return _loadArchive(archive.get(), fs::path(blob.name).stem().string(),
+                        blob.data.size(), callback, properties);
 }
 
 std::vector<ModelDescriptorPtr> ArchiveLoader::importFromFile(
     const std::string& filename, const LoaderProgress& callback,
     const PropertyMap& properties) const
 {
-    TmpFolder tmpFolder;
-    extractFile(filename, tmpFolder.path);
-    return loadExtracted(tmpFolder.path, callback, properties);
+    auto archive = _openArchive(filename);
+    return _loadArchive(archive.get(), fs::path(filename).stem().string(),
+                        fs::file_size(filename), callback, properties);
 }
 
 std::string ArchiveLoader::getName() const
@@ -26,6 +26,8 @@
 
 #include <set>
 
+struct archive;
+
 namespace brayns
 {
 class ArchiveLoader : public Loader
@@ -36,6 +38,8 @@ public:
     std::vector<std::string> getSupportedExtensions() const final;
     std::string getName() const final;
 
+    PropertyMap getProperties() const final;
+
     bool isSupported(const std::string& filename,
                      const std::string& extension) const final;
     std::vector<ModelDescriptorPtr> importFromBlob(
@@ -47,9 +51,11 @@ public:
         const PropertyMap& properties) const final;
 
 private:
-    std::vector<ModelDescriptorPtr> loadExtracted(
-        const std::string& path, const LoaderProgress& callback,
-        const PropertyMap& properties) const;
+    std::vector<ModelDescriptorPtr> _loadArchive(
+        archive* archive, const std::string& filename, const size_t size,
+        const LoaderProgress& callback, const PropertyMap& properties) const;
+    const Loader* _findLoader(const std::string& path,
+                              const std::string& loaderName) const;
     LoaderRegistry& _registry;
 };
 } // namespace brayns
@@ -0,0 +1,68 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "LineRange.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+// Minimum number of bytes of a range, to keep the tasks worth scheduling
+const size_t MIN_CHUNK_SIZE = 1 << 20;
+} // namespace
+
+namespace brayns
+{
+std::vector<LineRange> splitLines(const char* data, const size_t size,
+                                  const size_t chunksPerThread)
+{
+    const size_t nbThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    const size_t nbChunks = std::max(chunksPerThread, size_t(1)) * nbThreads;
+    const size_t chunkSize = std::max(MIN_CHUNK_SIZE, size / nbChunks + 1);
+
+    std::vector<LineRange> ranges;
+    const char* end = data + size;
+    for (const char* begin = data; begin < end;)
+    {
+        const char* rangeEnd = end;
+        if (size_t(end - begin) > chunkSize)
+        {
+            const char* last = begin + chunkSize - 1;
+            const auto newline = std::memchr(last, '\n', end - last);
+            if (newline)
+                rangeEnd = static_cast<const char*>(newline) + 1;
+        }
+        ranges.push_back({begin, rangeEnd});
+        begin = rangeEnd;
+    }
+    return ranges;
+}
+
+size_t countLines(const LineRange& range)
+{
+    if (range.begin == range.end)
+        return 0;
+    size_t nbLines = std::count(range.begin, range.end, '\n');
+    if (range.end[-1] != '\n')
+        ++nbLines;
+    return nbLines;
+}
+} // namespace brayns
@@ -0,0 +1,48 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace brayns
+{
+/** Whole lines of a text buffer, which is not necessarily null-terminated */
+struct LineRange
+{
+    const char* begin{nullptr};
+    const char* end{nullptr};
+};
+
+/**
+ * Splits a text buffer in ranges ending with a newline, so that no line is
+ * shared by two ranges and each of them can be parsed by a different task.
+ *
+ * @param data Text to split
+ * @param size Size of the text
+ * @param chunksPerThread Number of ranges per hardware thread aimed at, ranges
+ *        are at least 1MB large
+ */
+std::vector<LineRange> splitLines(const char* data, size_t size,
+                                  size_t chunksPerThread);
+
+/** @return the number of lines of a range, an unterminated last one included */
+size_t countLines(const LineRange& range);
+} // namespace brayns
@@ -0,0 +1,74 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace brayns
+{
+MappedFile::MappedFile(const std::string& filename)
+{
+    _descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (_descriptor == -1)
+        throw std::runtime_error("Could not open file " + filename);
+
+    struct stat sb;
+    if (::fstat(_descriptor, &sb) == -1)
+    {
+        ::close(_descriptor);
+        throw std::runtime_error("Could not open file " + filename);
+    }
+
+    _size = sb.st_size;
+    if (_size == 0)
+        return;
+
+    _data = ::mmap(0, _size, PROT_READ, MAP_PRIVATE, _descriptor, 0);
+    if (_data == MAP_FAILED)
+    {
+        ::close(_descriptor);
+        throw std::runtime_error("Could not map file " + filename);
+    }
+    ::madvise(_data, _size, MADV_SEQUENTIAL);
+}
+
+void MappedFile::release(const size_t offset, const size_t size) const
+{
+    const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+    const size_t begin = (offset + pageSize - 1) / pageSize * pageSize;
+    const size_t end = std::min(offset + size, _size) / pageSize * pageSize;
+    if (begin < end)
+        ::madvise(static_cast<char*>(_data) + begin, end - begin,
+                  MADV_DONTNEED);
+}
+
+MappedFile::~MappedFile()
+{
+    if (_data)
+        ::munmap(_data, _size);
+    ::close(_descriptor);
+}
+} // namespace brayns
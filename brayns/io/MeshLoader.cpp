@@ -19,6 +19,8 @@
  */
 
 #include "MeshLoader.h"
+#include "MappedFile.h"
+#include "PlyMeshReader.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/ProgressHandler.hpp>
@@ -27,8 +29,11 @@
 #include <assimp/version.h>
 #include <brayns/common/log.h>
 
+#include <async++.h>
+
 #include <fstream>
 #include <numeric>
+#include <set>
 #include <unordered_map>
 
 #include <brayns/common/utils/filesystem.h>
@@ -54,6 +59,184 @@ constexpr float TOTAL_PROGRESS = 100.f;
 constexpr float LOADING_FRACTION = 50.f;
 constexpr float POST_LOADING_FRACTION = 50.f;
 
+// Number of vertices or faces of a mesh converted by one task
+constexpr size_t CONVERSION_CHUNK_SIZE = 1 << 16;
+
+// Name assimp gives to materials without a name
+constexpr auto PLY_MATERIAL_NAME = "DefaultMaterial";
+
+// Vertices of an assimp mesh and where they go in the buffers of its material.
+// Normals, texture coordinates and colors are only written if the mesh has
+// them, like the vertices they start at an offset of their own buffer.
+struct VertexChunk
+{
+    const aiMesh* mesh;
+    TriangleMesh* output;
+    size_t begin;
+    size_t end;
+    size_t vertex;
+    size_t normal;
+    size_t textureCoordinate;
+    size_t color;
+};
+
+// Faces of an assimp mesh, only triangles are kept
+struct FaceChunk
+{
+    const aiMesh* mesh;
+    TriangleMesh* output;
+    size_t begin;
+    size_t end;
+    size_t nbTriangles;
+    size_t triangle;
+    size_t indexOffset;
+};
+
+// Number of elements already in the buffers of a material
+struct MaterialBuffers
+{
+    TriangleMesh* mesh{nullptr};
+    size_t vertices{0};
+    size_t normals{0};
+    size_t textureCoordinates{0};
+    size_t colors{0};
+    size_t triangles{0};
+};
+
+size_t _countTriangles(const FaceChunk& chunk)
+{
+    size_t count = 0;
+    for (size_t f = chunk.begin; f < chunk.end; ++f)
+        if (chunk.mesh->mFaces[f].mNumIndices == 3)
+            ++count;
+    return count;
+}
+
+void _convertVertices(const VertexChunk& chunk, const Matrix4f& matrix)
+{
+    const auto mesh = chunk.mesh;
+    auto& output = *chunk.output;
+    for (size_t i = chunk.begin; i < chunk.end; ++i)
+    {
+        const auto& v = mesh->mVertices[i];
+        const Vector3f transformedVertex =
+            matrix * Vector4f(v.x, v.y, v.z, 1.f);
+        output.vertices[chunk.vertex + i - chunk.begin] = transformedVertex;
+    }
+
+    if (mesh->HasNormals())
+        for (size_t i = chunk.begin; i < chunk.end; ++i)
+        {
+            const auto& n = mesh->mNormals[i];
+            const Vector4f normal = matrix * Vector4f(n.x, n.y, n.z, 0.f);
+            output.normals[chunk.normal + i - chunk.begin] = {normal.x,
+                                                              normal.y,
+                                                              normal.z};
+        }
+
+    if (mesh->HasTextureCoords(0))
+        for (size_t i = chunk.begin; i < chunk.end; ++i)
+        {
+            const auto& t = mesh->mTextureCoords[0][i];
+            output.textureCoordinates[chunk.textureCoordinate + i -
+                                      chunk.begin] = {t.x, t.y};
+        }
+
+    if (mesh->HasVertexColors(0))
+        for (size_t i = chunk.begin; i < chunk.end; ++i)
+        {
+            const auto& c = mesh->mColors[0][i];
+            output.colors[chunk.color + i - chunk.begin] = {c.r, c.g, c.b,
+                                                            c.a};
+        }
+}
+
+void _convertFaces(const FaceChunk& chunk)
+{
+    const size_t offset = chunk.indexOffset;
+    auto triangle = chunk.output->indices.begin() + chunk.triangle;
+    for (size_t f = chunk.begin; f < chunk.end; ++f)
+    {
+        const auto& face = chunk.mesh->mFaces[f];
+        if (face.mNumIndices == 3)
+            *triangle++ = Vector3ui(offset + face.mIndices[0],
+                                    offset + face.mIndices[1],
+                                    offset + face.mIndices[2]);
+    }
+}
+
+bool _isPly(std::string extension)
+{
+    if (!extension.empty() && extension[0] == '.')
+        extension.erase(0, 1);
+    return string_utils::toLowercase(extension) == "ply";
+}
+
+// Same as the material assimp gives to PLY meshes
+void _createPlyMaterial(Model& model, const size_t materialId)
+{
+    auto material = model.createMaterial(materialId, PLY_MATERIAL_NAME);
+    material->setDiffuseColor({0.6f, 0.6f, 0.6f});
+    material->setSpecularColor({0.6f, 0.6f, 0.6f});
+    material->setOpacity(1.f);
+}
+
+// Same as aiProcess_GenSmoothNormals: each vertex gets the normalized sum of
+// the unit normals of its faces
+void _computeSmoothNormals(TriangleMesh& mesh, const size_t firstVertex,
+                           const size_t firstNormal, const size_t firstTriangle)
+{
+    const size_t nbVertices = mesh.vertices.size() - firstVertex;
+    mesh.normals.resize(firstNormal + nbVertices, Vector3f(0.f));
+    for (size_t i = firstTriangle; i < mesh.indices.size(); ++i)
+    {
+        const auto& triangle = mesh.indices[i];
+        const auto& v0 = mesh.vertices[triangle[0]];
+        const auto normal = glm::cross(mesh.vertices[triangle[1]] - v0,
+                                       mesh.vertices[triangle[2]] - v0);
+        const auto length = glm::length(normal);
+        if (length == 0.f)
+            continue;
+        for (size_t k = 0; k < 3; ++k)
+            mesh.normals[firstNormal + triangle[k] - firstVertex] +=
+                normal / length;
+    }
+
+    for (size_t i = firstNormal; i < mesh.normals.size(); ++i)
+    {
+        const auto length = glm::length(mesh.normals[i]);
+        if (length > 0.f)
+            mesh.normals[i] /= length;
+    }
+}
+
+void _transformVertices(TriangleMesh& mesh, const size_t firstVertex,
+                        const size_t firstNormal, const bool hasNormals,
+                        const Matrix4f& matrix)
+{
+    const size_t nbVertices = mesh.vertices.size() - firstVertex;
+    const size_t nbChunks =
+        (nbVertices + CONVERSION_CHUNK_SIZE - 1) / CONVERSION_CHUNK_SIZE;
+    async::parallel_for(
+        async::irange(size_t(0), nbChunks), [&](const size_t chunk) {
+            const size_t begin = chunk * CONVERSION_CHUNK_SIZE;
+            const size_t end =
+                std::min(begin + CONVERSION_CHUNK_SIZE, nbVertices);
+            for (size_t i = begin; i < end; ++i)
+            {
+                auto& v = mesh.vertices[firstVertex + i];
+                const Vector3f transformedVertex =
+                    matrix * Vector4f(v.x, v.y, v.z, 1.f);
+                v = transformedVertex;
+                if (!hasNormals)
+                    continue;
+                auto& n = mesh.normals[firstNormal + i];
+                const Vector4f normal = matrix * Vector4f(n.x, n.y, n.z, 0.f);
+                n = {normal.x, normal.y, normal.z};
+            }
+        });
+}
+
 class ProgressWatcher : public Assimp::ProgressHandler
 {
 public:
@@ -142,6 +325,13 @@ bool MeshLoader::isSupported(const std::string& filename BRAYNS_UNUSED,
     return std::find(types.begin(), types.end(), extension) != types.end();
 }
 
+bool MeshLoader::isBlobSupported(const std::string& extension) const
+{
+    // Formats which cannot reference materials or textures in other files
+    const std::set<std::string> types = {"ply", "stl", "off"};
+    return types.find(string_utils::toLowercase(extension)) != types.end();
+}
+
 std::vector<ModelDescriptorPtr> MeshLoader::importFromFile(
     const std::string& fileName, const LoaderProgress& callback,
     const PropertyMap& inProperties) const
@@ -179,6 +369,25 @@ std::vector<ModelDescriptorPtr> MeshLoader::importFromBlob(
         properties.valueOr(PROP_GEOMETRY_QUALITY,
                            enumToString(GeometryQuality::high)));
 
+    if (_isPly(blob.type))
+    {
+        auto model = _scene.createModel();
+        ModelMetadata metadata;
+        if (_importPly(reinterpret_cast<const char*>(blob.data.data()),
+                       blob.data.size(), *model, Matrix4f(1), NO_MATERIAL,
+                       geometryQuality, callback, metadata))
+        {
+            Transformation transformation;
+            transformation.setRotationCenter(model->getBounds().getCenter());
+
+            auto modelDescriptor =
+                std::make_shared<ModelDescriptor>(std::move(model), blob.name,
+                                                  metadata);
+            modelDescriptor->setTransformation(transformation);
+            return {modelDescriptor};
+        }
+    }
+
     auto importer_ptr = createImporter(callback, blob.name);
     Assimp::Importer& importer = *(importer_ptr.get());
     const aiScene* aiScene =
@@ -319,7 +528,6 @@ ModelMetadata MeshLoader::_postLoad(const aiScene* aiScene, Model& model,
 
     std::unordered_map<size_t, size_t> nbVertices;
     std::unordered_map<size_t, size_t> nbFaces;
-    std::unordered_map<size_t, size_t> indexOffsets;
 
     const auto trfm = aiScene->mRootNode->mTransformation;
     Matrix4f matrix{trfm.a1, trfm.b1, trfm.c1, trfm.d1, trfm.a2, trfm.b2,
@@ -327,90 +535,121 @@ ModelMetadata MeshLoader::_postLoad(const aiScene* aiScene, Model& model,
                     trfm.a4, trfm.b4, trfm.c4, trfm.d4};
     matrix = matrix * transformation;
 
+    // Split the meshes so that large meshes are converted by several tasks
+    std::vector<VertexChunk> vertexChunks;
+    std::vector<FaceChunk> faceChunks;
     for (size_t m = 0; m < aiScene->mNumMeshes; ++m)
     {
-        auto mesh = aiScene->mMeshes[m];
-        auto id =
-            (materialId != NO_MATERIAL ? materialId : mesh->mMaterialIndex);
-        nbVertices[id] += mesh->mNumVertices;
-        nbFaces[id] += mesh->mNumFaces;
-    }
-
-    for (const auto& i : nbVertices)
-    {
-        auto& triangleMeshes = model.getTriangleMeshes()[i.first];
-        triangleMeshes.vertices.reserve(i.second);
-        triangleMeshes.normals.reserve(i.second);
-        triangleMeshes.textureCoordinates.reserve(i.second);
-        triangleMeshes.colors.reserve(i.second);
-    }
-    for (const auto& i : nbFaces)
-    {
-        auto& triangleMeshes = model.getTriangleMeshes()[i.first];
-        triangleMeshes.indices.reserve(i.second);
+        const auto mesh = aiScene->mMeshes[m];
+        for (size_t begin = 0; begin < mesh->mNumVertices;
+             begin += CONVERSION_CHUNK_SIZE)
+        {
+            const auto end = std::min<size_t>(begin + CONVERSION_CHUNK_SIZE,
+                                               mesh->mNumVertices);
+            vertexChunks.push_back({mesh, nullptr, begin, end, 0, 0, 0, 0});
+        }
+        for (size_t begin = 0; begin < mesh->mNumFaces;
+             begin += CONVERSION_CHUNK_SIZE)
+        {
+            const auto end = std::min<size_t>(begin + CONVERSION_CHUNK_SIZE,
+                                               mesh->mNumFaces);
+            faceChunks.push_back({mesh, nullptr, begin, end, 0, 0, 0});
+        }
     }
 
+    // Non triangular faces are dropped, count the triangles to know where the
+    // triangles of each chunk go
+    async::parallel_for(async::irange(size_t(0), faceChunks.size()),
+                        [&](const size_t i) {
+                            auto& chunk = faceChunks[i];
+                            chunk.nbTriangles = _countTriangles(chunk);
+                        });
+
+    // Meshes of a material are appended in order, after its existing geometry
+    std::unordered_map<size_t, MaterialBuffers> buffers;
+    auto& triangleMeshes = model.getTriangleMeshes();
+    auto vertexChunk = vertexChunks.begin();
+    auto faceChunk = faceChunks.begin();
+    bool nonTriangulatedFaces = false;
     for (size_t m = 0; m < aiScene->mNumMeshes; ++m)
     {
-        auto mesh = aiScene->mMeshes[m];
+        const auto mesh = aiScene->mMeshes[m];
         auto id =
             (materialId != NO_MATERIAL ? materialId : mesh->mMaterialIndex);
-        auto& triangleMeshes = model.getTriangleMeshes()[id];
+        nbVertices[id] += mesh->mNumVertices;
+        nbFaces[id] += mesh->mNumFaces;
 
-        for (size_t i = 0; i < mesh->mNumVertices; ++i)
+        auto& sizes = buffers[id];
+        if (!sizes.mesh)
         {
-            const auto& v = mesh->mVertices[i];
-            const Vector3f transformedVertex =
-                matrix * Vector4f(v.x, v.y, v.z, 1.f);
-            triangleMeshes.vertices.push_back(transformedVertex);
-            if (mesh->HasNormals())
-            {
-                const auto& n = mesh->mNormals[i];
-                const Vector4f normal = matrix * Vector4f(n.x, n.y, n.z, 0.f);
-                const Vector3f transformedNormal = {normal.x, normal.y,
-                                                    normal.z};
-                triangleMeshes.normals.push_back(transformedNormal);
-            }
-
-            if (mesh->HasTextureCoords(0))
-            {
-                const auto& t = mesh->mTextureCoords[0][i];
-                triangleMeshes.textureCoordinates.push_back({t.x, t.y});
-            }
+            auto& output = triangleMeshes[id];
+            sizes.mesh = &output;
+            sizes.vertices = output.vertices.size();
+            sizes.normals = output.normals.size();
+            sizes.textureCoordinates = output.textureCoordinates.size();
+            sizes.colors = output.colors.size();
+            sizes.triangles = output.indices.size();
+        }
 
-            if (mesh->HasVertexColors(0))
-            {
-                const auto& c = mesh->mColors[0][i];
-                triangleMeshes.colors.push_back({c.r, c.g, c.b, c.a});
-            }
+        for (; vertexChunk != vertexChunks.end() && vertexChunk->mesh == mesh;
+             ++vertexChunk)
+        {
+            vertexChunk->output = sizes.mesh;
+            vertexChunk->vertex = sizes.vertices + vertexChunk->begin;
+            vertexChunk->normal = sizes.normals + vertexChunk->begin;
+            vertexChunk->textureCoordinate =
+                sizes.textureCoordinates + vertexChunk->begin;
+            vertexChunk->color = sizes.colors + vertexChunk->begin;
         }
-        bool nonTriangulatedFaces = false;
 
-        const size_t offset = indexOffsets[id];
-        for (size_t f = 0; f < mesh->mNumFaces; ++f)
+        // Indices refer to all the vertices of the material
+        for (; faceChunk != faceChunks.end() && faceChunk->mesh == mesh;
+             ++faceChunk)
         {
-            if (mesh->mFaces[f].mNumIndices == 3)
-            {
-                triangleMeshes.indices.push_back(
-                    Vector3ui(offset + mesh->mFaces[f].mIndices[0],
-                              offset + mesh->mFaces[f].mIndices[1],
-                              offset + mesh->mFaces[f].mIndices[2]));
-            }
-            else
+            faceChunk->output = sizes.mesh;
+            faceChunk->triangle = sizes.triangles;
+            faceChunk->indexOffset = sizes.vertices;
+            sizes.triangles += faceChunk->nbTriangles;
+            if (faceChunk->nbTriangles < faceChunk->end - faceChunk->begin)
                 nonTriangulatedFaces = true;
         }
-        if (nonTriangulatedFaces)
-            BRAYNS_DEBUG
-                << "Some faces are not triangulated and have been removed"
-                << std::endl;
-        indexOffsets[id] += mesh->mNumVertices;
-
-        callback.updateProgress("Post-processing...",
-                                (LOADING_FRACTION +
-                                 (((m + 1) / aiScene->mNumMeshes) *
-                                  POST_LOADING_FRACTION)) /
-                                    TOTAL_PROGRESS);
+
+        sizes.vertices += mesh->mNumVertices;
+        if (mesh->HasNormals())
+            sizes.normals += mesh->mNumVertices;
+        if (mesh->HasTextureCoords(0))
+            sizes.textureCoordinates += mesh->mNumVertices;
+        if (mesh->HasVertexColors(0))
+            sizes.colors += mesh->mNumVertices;
     }
+    if (nonTriangulatedFaces)
+        BRAYNS_DEBUG << "Some faces are not triangulated and have been removed"
+                     << std::endl;
+
+    for (const auto& i : buffers)
+    {
+        const auto& sizes = i.second;
+        sizes.mesh->vertices.resize(sizes.vertices);
+        sizes.mesh->normals.resize(sizes.normals);
+        sizes.mesh->textureCoordinates.resize(sizes.textureCoordinates);
+        sizes.mesh->colors.resize(sizes.colors);
+        sizes.mesh->indices.resize(sizes.triangles);
+    }
+
+    callback.updateProgress("Post-processing...",
+                            (LOADING_FRACTION + 0.1f * POST_LOADING_FRACTION) /
+                                TOTAL_PROGRESS);
+
+    // Every chunk writes its own range of the buffers
+    const size_t nbVertexChunks = vertexChunks.size();
+    async::parallel_for(async::irange(size_t(0),
+                                      nbVertexChunks + faceChunks.size()),
+                        [&](const size_t i) {
+                            if (i < nbVertexChunks)
+                                _convertVertices(vertexChunks[i], matrix);
+                            else
+                                _convertFaces(faceChunks[i - nbVertexChunks]);
+                        });
 
     callback.updateProgress("Post-processing...", 1.f);
 
@@ -463,6 +702,21 @@ ModelMetadata MeshLoader::importMesh(
 {
     const fs::path file = fileName;
 
+    std::ifstream meshFile(fileName, std::ios::in);
+    if (!meshFile.good())
+        throw std::runtime_error("Could not open file " + fileName);
+    meshFile.close();
+
+    if (_isPly(file.extension().string()))
+    {
+        const MappedFile mappedFile(fileName);
+        ModelMetadata metadata;
+        if (_importPly(mappedFile.data(), mappedFile.size(), model,
+                       transformation, defaultMaterialId, geometryQuality,
+                       callback, metadata))
+            return metadata;
+    }
+
     auto importer_ptr = createImporter(callback, fileName);
     Assimp::Importer& importer = *(importer_ptr.get());
     if (!importer.IsExtensionSupported(file.extension().c_str()))
@@ -472,11 +726,6 @@ ModelMetadata MeshLoader::importMesh(
         throw std::runtime_error(msg.str());
     }
 
-    std::ifstream meshFile(fileName, std::ios::in);
-    if (!meshFile.good())
-        throw std::runtime_error("Could not open file " + fileName);
-    meshFile.close();
-
     const aiScene* aiScene =
         importer.ReadFile(fileName.c_str(), _getQuality(geometryQuality));
 
@@ -500,6 +749,60 @@ ModelMetadata MeshLoader::importMesh(
                      filepath.parent_path().string(), callback);
 }
 
+bool MeshLoader::_importPly(const char* data, const size_t size, Model& model,
+                            const Matrix4f& transformation,
+                            const size_t materialId,
+                            const GeometryQuality geometryQuality,
+                            const LoaderProgress& callback,
+                            ModelMetadata& metadata) const
+{
+    // Medium quality runs many assimp post-processing steps, keep them
+    if (geometryQuality == GeometryQuality::medium)
+        return false;
+
+    const PlyMeshReader reader(data, size);
+    if (!reader.isSupported())
+        return false;
+
+    // Like assimp, all the faces use the first material of the file
+    const auto id = materialId != NO_MATERIAL ? materialId : 0;
+    auto& mesh = model.getTriangleMeshes()[id];
+    const size_t firstVertex = mesh.vertices.size();
+    const size_t firstNormal = mesh.normals.size();
+    const size_t firstTriangle = mesh.indices.size();
+    if (!reader.read(mesh))
+        return false;
+
+    callback.updateProgress("Post-processing...",
+                            (LOADING_FRACTION) / TOTAL_PROGRESS);
+
+    const bool generateNormals =
+        !reader.hasNormals() && geometryQuality == GeometryQuality::high;
+    if (generateNormals)
+        _computeSmoothNormals(mesh, firstVertex, firstNormal, firstTriangle);
+    _transformVertices(mesh, firstVertex, firstNormal,
+                       reader.hasNormals() || generateNormals, transformation);
+
+    // Always create placeholder material since it is not guaranteed to exist
+    model.createMaterial(materialId, "default");
+
+    std::string materialInfo;
+    if (materialId == NO_MATERIAL)
+    {
+        _createPlyMaterial(model, id);
+        materialInfo = "[{\"name\":\"" + std::string(PLY_MATERIAL_NAME) +
+                       "\",\"ids\":[" + std::to_string(id) + "]}]";
+    }
+
+    callback.updateProgress("Post-processing...", 1.f);
+
+    metadata = {{"meshes", "1"},
+                {"vertices", std::to_string(reader.getNumVertices())},
+                {"faces", std::to_string(reader.getNumFaces())},
+                {"materialGroups", materialInfo}};
+    return true;
+}
+
 std::string MeshLoader::getName() const
 {
     return LOADER_NAME;
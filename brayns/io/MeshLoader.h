@@ -42,6 +42,7 @@ public:
 
     bool isSupported(const std::string& filename,
                      const std::string& extension) const final;
+    bool isBlobSupported(const std::string& extension) const final;
 
     std::vector<ModelDescriptorPtr> importFromFile(
         const std::string& fileName, const LoaderProgress& callback,
@@ -77,5 +78,12 @@ private:
                             const std::string& folder,
                             const LoaderProgress& callback) const;
     size_t _getQuality(const GeometryQuality geometryQuality) const;
+
+    /** Loads common binary PLY layouts without assimp, false otherwise */
+    bool _importPly(const char* data, const size_t size, Model& model,
+                    const Matrix4f& transformation, const size_t materialId,
+                    const GeometryQuality geometryQuality,
+                    const LoaderProgress& callback,
+                    ModelMetadata& metadata) const;
 };
 } // namespace brayns
@@ -0,0 +1,377 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "PlyMeshReader.h"
+
+#include <async++.h>
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace brayns
+{
+namespace
+{
+// Number of vertices or faces decoded by one task
+constexpr size_t DECODING_CHUNK_SIZE = 1 << 16;
+
+// Size of a face made of a one byte index count followed by 3 indices
+constexpr size_t TRIANGLE_SIZE = 1 + 3 * sizeof(uint32_t);
+
+const char* POSITION_NAMES[] = {"x", "y", "z"};
+const char* NORMAL_NAMES[] = {"nx", "ny", "nz"};
+const char* COLOR_NAMES[] = {"red", "green", "blue", "alpha"};
+
+// Other vertex properties understood by assimp, that are not skipped to give
+// the same result as assimp
+const std::set<std::string> ASSIMP_VERTEX_PROPERTIES{
+    "r", "g", "b", "a", "u", "v", "s", "t", "tx", "ty",
+    "texture_u", "texture_v", "texture_s", "texture_t"};
+
+size_t _getTypeSize(const std::string& type)
+{
+    if (type == "char" || type == "uchar" || type == "int8" ||
+        type == "uint8")
+        return 1;
+    if (type == "short" || type == "ushort" || type == "int16" ||
+        type == "uint16")
+        return 2;
+    if (type == "int" || type == "uint" || type == "int32" ||
+        type == "uint32" || type == "float" || type == "float32")
+        return 4;
+    if (type == "double" || type == "float64")
+        return 8;
+    return 0;
+}
+
+bool _isFloat(const std::string& type)
+{
+    return type == "float" || type == "float32";
+}
+
+bool _isUChar(const std::string& type)
+{
+    return type == "uchar" || type == "uint8";
+}
+
+template <size_t N>
+size_t _findName(const char* (&names)[N], const std::string& name)
+{
+    for (size_t i = 0; i < N; ++i)
+        if (name == names[i])
+            return i;
+    return N;
+}
+
+bool _isLittleEndian()
+{
+    const uint16_t value = 1;
+    uint8_t firstByte;
+    std::memcpy(&firstByte, &value, 1);
+    return firstByte == 1;
+}
+
+template <typename T>
+T _read(const char* data)
+{
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+// Same normalization as assimp
+float _readColor(const char* data, const bool isFloat)
+{
+    return isFloat ? _read<float>(data) : float(_read<uint8_t>(data)) / 255.f;
+}
+
+size_t _getNbChunks(const size_t size)
+{
+    return (size + DECODING_CHUNK_SIZE - 1) / DECODING_CHUNK_SIZE;
+}
+} // namespace
+
+constexpr size_t PlyMeshReader::NO_PROPERTY;
+
+PlyMeshReader::PlyMeshReader(const char* data, const size_t size)
+    : _data(data)
+    , _size(size)
+{
+    if (_isLittleEndian())
+        _parseHeader();
+}
+
+void PlyMeshReader::_parseHeader()
+{
+    // The header is made of text lines, data starts after end_header
+    const char* end = _data + _size;
+    const char* line = _data;
+    size_t nbLines = 0;
+    size_t nbElements = 0;
+    bool binaryLittleEndian = false;
+    while (_dataOffset == 0)
+    {
+        const char* endOfLine = std::find(line, end, '\n');
+        if (endOfLine == end)
+            return;
+
+        std::istringstream stream(std::string(line, endOfLine));
+        line = endOfLine + 1;
+        std::string keyword;
+        stream >> keyword;
+        if (nbLines++ == 0)
+        {
+            if (keyword != "ply")
+                return;
+        }
+        else if (keyword == "format")
+        {
+            std::string format;
+            stream >> format;
+            binaryLittleEndian = format == "binary_little_endian";
+        }
+        else if (keyword == "element")
+        {
+            std::string name;
+            size_t count = 0;
+            stream >> name >> count;
+            if (!stream)
+                return;
+            if (nbElements == 0 && name == "vertex")
+                _nbVertices = count;
+            else if (nbElements == 1 && name == "face")
+                _nbFaces = count;
+            else
+                return;
+            ++nbElements;
+        }
+        else if (keyword == "property")
+        {
+            std::string type;
+            std::string name;
+            stream >> type;
+            if (nbElements == 1)
+            {
+                stream >> name;
+                if (!stream || !_parseVertexProperty(type, name))
+                    return;
+            }
+            else if (nbElements == 2)
+            {
+                // Only a list of indices with a one byte count is supported
+                std::string countType;
+                std::string indexType;
+                stream >> countType >> indexType >> name;
+                if (!stream || _hasIndices || type != "list" ||
+                    _getTypeSize(countType) != 1 ||
+                    _getTypeSize(indexType) != 4 || _isFloat(indexType) ||
+                    (name != "vertex_indices" && name != "vertex_index"))
+                    return;
+                _hasIndices = true;
+            }
+            else
+                return;
+        }
+        else if (keyword == "end_header")
+            _dataOffset = line - _data;
+        else if (keyword != "comment" && keyword != "obj_info" &&
+                 !keyword.empty())
+            return;
+    }
+
+    if (!binaryLittleEndian || nbElements != 2 || !_hasIndices)
+        return;
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        if (_position[i] == NO_PROPERTY)
+            return;
+        if ((_normal[i] == NO_PROPERTY) != (_normal[0] == NO_PROPERTY))
+            return;
+        if ((_color[i] == NO_PROPERTY) != (_color[0] == NO_PROPERTY) ||
+            _colorType[i] != _colorType[0])
+            return;
+    }
+    if (_color[3] != NO_PROPERTY &&
+        (_color[0] == NO_PROPERTY || _colorType[3] != _colorType[0]))
+        return;
+
+    _supported = true;
+}
+
+bool PlyMeshReader::_parseVertexProperty(const std::string& type,
+                                         const std::string& name)
+{
+    const auto size = _getTypeSize(type);
+    if (size == 0)
+        return false;
+
+    const auto offset = _vertexSize;
+    _vertexSize += size;
+
+    const auto position = _findName(POSITION_NAMES, name);
+    if (position < 3)
+    {
+        if (!_isFloat(type) || _position[position] != NO_PROPERTY)
+            return false;
+        _position[position] = offset;
+        return true;
+    }
+
+    const auto normal = _findName(NORMAL_NAMES, name);
+    if (normal < 3)
+    {
+        if (!_isFloat(type) || _normal[normal] != NO_PROPERTY)
+            return false;
+        _normal[normal] = offset;
+        return true;
+    }
+
+    const auto color = _findName(COLOR_NAMES, name);
+    if (color < 4)
+    {
+        if ((!_isFloat(type) && !_isUChar(type)) ||
+            _color[color] != NO_PROPERTY)
+            return false;
+        _color[color] = offset;
+        _colorType[color] = type;
+        return true;
+    }
+
+    // Anything else is skipped
+    return ASSIMP_VERTEX_PROPERTIES.count(name) == 0;
+}
+
+bool PlyMeshReader::read(TriangleMesh& mesh) const
+{
+    if (!_supported)
+        throw std::runtime_error("Unsupported PLY layout");
+
+    // Counts are checked before the multiplications so that corrupted
+    // headers cannot overflow them. Faces with less than 3 indices make the
+    // data shorter
+    const size_t dataSize = _size - _dataOffset;
+    if (_vertexSize == 0 || _nbVertices > dataSize / _vertexSize)
+        return false;
+    const size_t facesSize = dataSize - _nbVertices * _vertexSize;
+    if (_nbFaces > facesSize / TRIANGLE_SIZE)
+        return false;
+
+    const size_t firstVertex = mesh.vertices.size();
+    const size_t firstNormal = mesh.normals.size();
+    const size_t firstColor = mesh.colors.size();
+    const size_t firstTriangle = mesh.indices.size();
+
+    mesh.vertices.resize(firstVertex + _nbVertices);
+    if (hasNormals())
+        mesh.normals.resize(firstNormal + _nbVertices);
+    if (hasColors())
+        mesh.colors.resize(firstColor + _nbVertices);
+    mesh.indices.resize(firstTriangle + _nbFaces);
+
+    auto vertices = mesh.vertices.data() + firstVertex;
+    auto normals = hasNormals() ? mesh.normals.data() + firstNormal : nullptr;
+    auto colors = hasColors() ? mesh.colors.data() + firstColor : nullptr;
+    auto triangles = mesh.indices.data() + firstTriangle;
+
+    // Vertex and face records have a fixed size, every task decodes its own
+    // range of records
+    const size_t nbVertexChunks = _getNbChunks(_nbVertices);
+    const size_t nbFaceChunks = _getNbChunks(_nbFaces);
+    std::vector<uint8_t> validFaces(nbFaceChunks, true);
+    async::parallel_for(
+        async::irange(size_t(0), nbVertexChunks + nbFaceChunks),
+        [&](const size_t i) {
+            const bool isVertexChunk = i < nbVertexChunks;
+            const size_t chunk = isVertexChunk ? i : i - nbVertexChunks;
+            const size_t begin = chunk * DECODING_CHUNK_SIZE;
+            const size_t end =
+                std::min(begin + DECODING_CHUNK_SIZE,
+                         isVertexChunk ? _nbVertices : _nbFaces);
+            if (isVertexChunk)
+                _readVertices(begin, end, vertices, normals, colors);
+            else
+                validFaces[chunk] =
+                    _readFaces(begin, end, firstVertex, triangles);
+        });
+
+    if (std::find(validFaces.begin(), validFaces.end(), false) ==
+        validFaces.end())
+        return true;
+
+    mesh.vertices.resize(firstVertex);
+    mesh.normals.resize(firstNormal);
+    mesh.colors.resize(firstColor);
+    mesh.indices.resize(firstTriangle);
+    return false;
+}
+
+void PlyMeshReader::_readVertices(const size_t begin, const size_t end,
+                                  Vector3f* vertices, Vector3f* normals,
+                                  Vector4f* colors) const
+{
+    const bool floatColors = _isFloat(_colorType[0]);
+    const char* record = _data + _dataOffset + begin * _vertexSize;
+    for (size_t i = begin; i < end; ++i, record += _vertexSize)
+    {
+        vertices[i] = {_read<float>(record + _position[0]),
+                       _read<float>(record + _position[1]),
+                       _read<float>(record + _position[2])};
+        if (normals)
+            normals[i] = {_read<float>(record + _normal[0]),
+                          _read<float>(record + _normal[1]),
+                          _read<float>(record + _normal[2])};
+        if (colors)
+            colors[i] = {_readColor(record + _color[0], floatColors),
+                         _readColor(record + _color[1], floatColors),
+                         _readColor(record + _color[2], floatColors),
+                         _color[3] == NO_PROPERTY
+                             ? 1.f
+                             : _readColor(record + _color[3], floatColors)};
+    }
+}
+
+bool PlyMeshReader::_readFaces(const size_t begin, const size_t end,
+                               const size_t indexOffset,
+                               Vector3ui* triangles) const
+{
+    // Faces that are not triangles change the size of the records, so the
+    // first one found is always read at the right place
+    const char* record = _data + _dataOffset + _nbVertices * _vertexSize +
+                         begin * TRIANGLE_SIZE;
+    for (size_t i = begin; i < end; ++i, record += TRIANGLE_SIZE)
+    {
+        if (_read<uint8_t>(record) != 3)
+            return false;
+
+        // Negative indices are out of range once read as unsigned
+        for (size_t k = 0; k < 3; ++k)
+        {
+            const auto index = _read<uint32_t>(record + 1 + k * 4);
+            if (index >= _nbVertices)
+                return false;
+            triangles[i][k] = indexOffset + index;
+        }
+    }
+    return true;
+}
+} // namespace brayns
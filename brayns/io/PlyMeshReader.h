@@ -0,0 +1,89 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <brayns/common/geometry/TriangleMesh.h>
+
+#include <string>
+
+namespace brayns
+{
+/**
+ * Decodes binary little endian PLY data straight into a triangle mesh.
+ *
+ * Only the layouts written by most mesh processing tools are handled: a vertex
+ * element with float coordinates, optional float normals and optional uchar or
+ * float colors, followed by a face element made of a single list of vertex
+ * indices. Other layouts are reported as unsupported and are left to assimp.
+ *
+ * Unlike assimp, vertices shared by several faces are kept indexed.
+ */
+class PlyMeshReader
+{
+public:
+    /** Parses the header, the data must outlive the reader */
+    PlyMeshReader(const char* data, size_t size);
+
+    bool isSupported() const { return _supported; }
+    size_t getNumVertices() const { return _nbVertices; }
+    size_t getNumFaces() const { return _nbFaces; }
+    bool hasNormals() const { return _normal[0] != NO_PROPERTY; }
+    bool hasColors() const { return _color[0] != NO_PROPERTY; }
+
+    /**
+     * Appends the vertices, normals, colors and triangles to the mesh, indices
+     * being offset by the number of vertices already in it.
+     *
+     * @return false, leaving the mesh untouched, if a face is not a triangle or
+     *         refers to a missing vertex
+     * @throw std::runtime_error if the layout is not supported
+     */
+    bool read(TriangleMesh& mesh) const;
+
+private:
+    static constexpr size_t NO_PROPERTY = size_t(-1);
+
+    void _parseHeader();
+    bool _parseVertexProperty(const std::string& type,
+                              const std::string& name);
+    void _readVertices(size_t begin, size_t end, Vector3f* vertices,
+                       Vector3f* normals, Vector4f* colors) const;
+    bool _readFaces(size_t begin, size_t end, size_t indexOffset,
+                    Vector3ui* triangles) const;
+
+    const char* _data;
+    size_t _size;
+    bool _supported{false};
+
+    size_t _nbVertices{0};
+    size_t _nbFaces{0};
+    bool _hasIndices{false};
+
+    // Offsets of the vertex properties in a vertex record
+    size_t _vertexSize{0};
+    size_t _position[3]{NO_PROPERTY, NO_PROPERTY, NO_PROPERTY};
+    size_t _normal[3]{NO_PROPERTY, NO_PROPERTY, NO_PROPERTY};
+    size_t _color[4]{NO_PROPERTY, NO_PROPERTY, NO_PROPERTY, NO_PROPERTY};
+    std::string _colorType[4];
+
+    // Offset of the first vertex record, faces follow the vertices
+    size_t _dataOffset{0};
+};
+} // namespace brayns
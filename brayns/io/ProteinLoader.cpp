@@ -19,17 +19,24 @@
  */
 
 #include "ProteinLoader.h"
+#include "LineRange.h"
+#include "MappedFile.h"
 
 #include <brayns/common/log.h>
 #include <brayns/common/types.h>
+#include <brayns/common/utils/stringUtils.h>
 #include <brayns/common/utils/utils.h>
 #include <brayns/engine/Engine.h>
 #include <brayns/engine/Material.h>
 #include <brayns/engine/Model.h>
 #include <brayns/engine/Scene.h>
 
-#include <assert.h>
-#include <fstream>
+#include <async++.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
 
 namespace
 {
@@ -49,20 +56,6 @@ struct PDBCellPositions
     Vector3f unknown;
 };
 
-/** Structure defining an atom as it is stored in a PDB file
- */
-struct Atom
-{
-    int processed;
-    int id;
-    int index;
-    Vector3f position;
-    float radius;
-    int materialId;
-    int chainId;
-    int residue;
-};
-
 /** Structure defining an atom radius in microns
  */
 struct AtomicRadius
@@ -315,6 +308,206 @@ static AtomicRadius atomic_radii[colorMapSize] = // atomic radii in microns
      {"OXT", 25.f, 112},
      {"P", 25.f, 113}};
 
+namespace
+{
+// Number of progress updates while parsing a large file
+constexpr size_t PROGRESS_STEPS = 20;
+
+/** Columns [first, last) of a field in the ATOM and HETATM records */
+struct Columns
+{
+    size_t first;
+    size_t last;
+};
+
+constexpr size_t CHAIN_ID_COLUMN = 21;
+constexpr Columns RESIDUE_COLUMNS{22, 26};
+constexpr Columns X_COLUMNS{30, 38};
+constexpr Columns Y_COLUMNS{38, 46};
+constexpr Columns Z_COLUMNS{46, 54};
+constexpr Columns ELEMENT_COLUMNS{76, 78};
+
+constexpr double POWERS_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+                                    1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14,
+                                    1e15};
+
+/** Lines of the input parsed by one task, and their spheres per material */
+struct AtomChunk
+{
+    LineRange lines;
+    SpheresMap spheres;
+};
+
+bool _isDigit(const char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/** Non blank characters of a field, empty if the line is too short */
+struct Field
+{
+    const char* begin;
+    const char* end;
+};
+
+Field _getField(const char* line, const size_t length, const Columns& columns)
+{
+    const char* begin = line + std::min(columns.first, length);
+    const char* end = line + std::min(columns.last, length);
+    while (begin != end && *begin == ' ')
+        ++begin;
+    while (end != begin && end[-1] == ' ')
+        --end;
+    return {begin, end};
+}
+
+int _parseInt(const Field& field)
+{
+    const char* p = field.begin;
+    const bool negative = p != field.end && *p == '-';
+    if (p != field.end && (*p == '-' || *p == '+'))
+        ++p;
+    int value = 0;
+    for (; p != field.end && _isDigit(*p); ++p)
+        value = value * 10 + (*p - '0');
+    return negative ? -value : value;
+}
+
+// The coordinates are fixed point numbers: their digits make an exact double
+// and one division by an exact power of ten rounds it like atof would. Other
+// notations go through atof.
+float _parseCoordinate(const Field& field)
+{
+    const char* p = field.begin;
+    const bool negative = p != field.end && *p == '-';
+    if (p != field.end && (*p == '-' || *p == '+'))
+        ++p;
+
+    uint64_t mantissa = 0;
+    size_t nbDigits = 0;
+    size_t nbDecimals = 0;
+    bool hasPoint = false;
+    for (; p != field.end; ++p)
+    {
+        if (_isDigit(*p))
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            ++nbDigits;
+            if (hasPoint)
+                ++nbDecimals;
+        }
+        else if (*p == '.' && !hasPoint)
+            hasPoint = true;
+        else
+            break;
+    }
+
+    if (p == field.end && nbDigits > 0 && nbDigits < 16)
+    {
+        const double value = mantissa / POWERS_OF_TEN[nbDecimals];
+        return static_cast<float>(negative ? -value : value);
+    }
+
+    char buffer[32] = {};
+    std::memcpy(buffer, field.begin,
+                std::min(size_t(field.end - field.begin), sizeof(buffer) - 1));
+    return static_cast<float>(std::atof(buffer));
+}
+
+// Index of the first entry of the color map for each symbol
+const std::unordered_map<std::string, size_t>& _getColorIndices()
+{
+    static const auto indices = [] {
+        std::unordered_map<std::string, size_t> result;
+        for (size_t i = 0; i < colorMapSize; ++i)
+            result.emplace(colorMap[i].symbol, i);
+        return result;
+    }();
+    return indices;
+}
+
+// Radius of the first entry of the atomic radii for each symbol
+const std::unordered_map<std::string, float>& _getAtomicRadii()
+{
+    static const auto radii = [] {
+        std::unordered_map<std::string, float> result;
+        for (size_t i = 0; i < colorMapSize; ++i)
+            result.emplace(atomic_radii[i].Symbol, atomic_radii[i].radius);
+        return result;
+    }();
+    return radii;
+}
+
+void _parseChunk(AtomChunk& chunk, const ColorScheme colorScheme,
+                 const double radiusMultiplier)
+{
+    const auto& colorIndices = _getColorIndices();
+    const auto& atomicRadii = _getAtomicRadii();
+
+    for (const char* line = chunk.lines.begin; line < chunk.lines.end;)
+    {
+        auto lineEnd = static_cast<const char*>(
+            std::memchr(line, '\n', chunk.lines.end - line));
+        if (!lineEnd)
+            lineEnd = chunk.lines.end;
+        size_t length = lineEnd - line;
+        if (length > 0 && line[length - 1] == '\r')
+            --length;
+
+        const bool isAtom =
+            (length >= 4 && std::memcmp(line, "ATOM", 4) == 0) ||
+            (length >= 6 && std::memcmp(line, "HETATM", 6) == 0);
+        if (isAtom)
+        {
+            const int chainId =
+                length > CHAIN_ID_COLUMN ? int(line[CHAIN_ID_COLUMN]) - 64 : 0;
+            const int residue =
+                _parseInt(_getField(line, length, RESIDUE_COLUMNS));
+            const Vector3f position(
+                _parseCoordinate(_getField(line, length, X_COLUMNS)),
+                _parseCoordinate(_getField(line, length, Y_COLUMNS)),
+                _parseCoordinate(_getField(line, length, Z_COLUMNS)));
+            const auto element = _getField(line, length, ELEMENT_COLUMNS);
+            const std::string atomName(element.begin, element.end);
+
+            // Material
+            size_t materialId = 0;
+            const auto colorIndex = colorIndices.find(atomName);
+            if (colorIndex != colorIndices.end())
+            {
+                switch (colorScheme)
+                {
+                case ColorScheme::protein_chains:
+                    materialId = abs(chainId);
+                    break;
+                case ColorScheme::protein_residues:
+                    materialId = residue;
+                    break;
+                default:
+                    materialId = colorIndex->second;
+                    break;
+                }
+            }
+
+            // Radius
+            const auto atomicRadius = atomicRadii.find(atomName);
+            const float atomRadius = atomicRadius != atomicRadii.end()
+                                         ? atomicRadius->second
+                                         : DEFAULT_RADIUS;
+
+            // Convert position from nanometers
+            const auto center = 0.01f * position;
+
+            // Convert radius from angstrom
+            const float radius = 0.0001f * atomRadius * radiusMultiplier;
+
+            chunk.spheres[materialId].push_back({center, radius});
+        }
+        line = lineEnd + 1;
+    }
+}
+} // namespace
+
 ProteinLoader::ProteinLoader(Scene& scene, const PropertyMap& properties)
     : Loader(scene)
     , _defaults(properties)
@@ -340,9 +533,31 @@ bool ProteinLoader::isSupported(const std::string& filename BRAYNS_UNUSED,
     return types.find(extension) != types.end();
 }
 
+bool ProteinLoader::isBlobSupported(const std::string& extension) const
+{
+    return isSupported("", extension);
+}
+
 std::vector<ModelDescriptorPtr> ProteinLoader::importFromFile(
-    const std::string& fileName, const LoaderProgress&,
-    const PropertyMap& inProperties) const
+    const std::string& fileName, const LoaderProgress& callback,
+    const PropertyMap& properties) const
+{
+    const MappedFile file(fileName);
+    return _importFromData(file.data(), file.size(), fileName, callback,
+                           properties);
+}
+
+std::vector<ModelDescriptorPtr> ProteinLoader::importFromBlob(
+    Blob&& blob, const LoaderProgress& callback,
+    const PropertyMap& properties) const
+{
+    return _importFromData(reinterpret_cast<const char*>(blob.data.data()),
+                           blob.data.size(), blob.name, callback, properties);
+}
+
+std::vector<ModelDescriptorPtr> ProteinLoader::_importFromData(
+    const char* data, const size_t size, const std::string& name,
+    const LoaderProgress& callback, const PropertyMap& inProperties) const
 {
     // Fill property map since the actual property types are known now.
     PropertyMap properties = _defaults;
@@ -354,144 +569,49 @@ std::vector<ModelDescriptorPtr> ProteinLoader::importFromFile(
     const auto colorScheme = stringToEnum<ColorScheme>(
         properties[PROP_COLOR_SCHEME].to<std::string>());
 
-    std::ifstream file(fileName.c_str());
-    if (!file.is_open())
-        throw std::runtime_error("Could not open " + fileName);
-
-    size_t lineIndex{0};
-    std::map<size_t, Spheres> spheres;
+    const auto message =
+        "Loading " + string_utils::shortenString(name) + " ...";
 
-    while (file.good())
+    // Chunks are parsed by batches, to report progress between them
+    std::vector<AtomChunk> chunks;
+    for (const auto& lines : splitLines(data, size, PROGRESS_STEPS))
+        chunks.push_back({lines, {}});
+    const size_t batchSize =
+        std::max(chunks.size() / PROGRESS_STEPS, size_t(1));
+    for (size_t batch = 0; batch < chunks.size(); batch += batchSize)
     {
-        std::string line;
-        std::string value;
-        std::getline(file, line);
-        if (line.find("ATOM") == 0 || line.find("HETATM") == 0)
-        {
-            // Atom
-            Atom atom;
-            atom.chainId = 0;
-            atom.residue = 0;
-            atom.processed = false;
-            atom.index = lineIndex;
-            lineIndex++;
-            std::string atomName;
-            std::string atomCode;
-            size_t i = 0;
-            while (i < line.length())
-            {
-                switch (i)
-                {
-                case 6: // ID
-                case 12:
-                case 76: // Atom name
-                case 22: // ChainID
-                case 30: // x
-                case 38: // y
-                case 46: // z
-                    value = "";
-                    break;
-                case 21:
-                    atom.chainId = (int)line.at(i) - 64;
-                    break;
-                case 11:
-                    atom.id = static_cast<int>(atoi(value.c_str()));
-                    break;
-                case 17:
-                    atomCode = value;
-                    break;
-                case 79:
-                    atomName = value;
-                    break;
-                case 26:
-                    atom.residue = static_cast<int>(atoi(value.c_str()));
-                    break;
-                case 37:
-                    atom.position[0] = static_cast<float>(atof(value.c_str()));
-                    break;
-                case 45:
-                    atom.position[1] = static_cast<float>(atof(value.c_str()));
-                    break;
-                case 53:
-                    atom.position[2] = static_cast<float>(atof(value.c_str()));
-                    break;
-                default:
-                    if (line.at(i) != ' ')
-                        value += line.at(i);
-                    break;
-                }
-                i++;
-            }
-
-            // Material
-            atom.materialId = 0;
-            i = 0;
-            bool found = false;
-            while (!found && i < colorMapSize)
-            {
-                if (atomName == colorMap[i].symbol)
-                {
-                    found = true;
-                    switch (colorScheme)
-                    {
-                    case ColorScheme::protein_chains:
-                        atom.materialId = abs(atom.chainId);
-                        break;
-                    case ColorScheme::protein_residues:
-                        atom.materialId = atom.residue;
-                        break;
-                    default:
-                        atom.materialId = static_cast<int>(i);
-                        break;
-                    }
-                }
-                ++i;
-            }
-
-            // Radius
-            atom.radius = DEFAULT_RADIUS;
-            i = 0;
-            found = false;
-            while (!found && i < colorMapSize)
-            {
-                if (atomName == atomic_radii[i].Symbol)
-                {
-                    atom.radius = atomic_radii[i].radius;
-                    found = true;
-                }
-                ++i;
-            }
-
-            // Convert position from nanometers
-            const auto center = 0.01f * atom.position;
-
-            // Convert radius from angstrom
-            const float radius = 0.0001f * atom.radius * radiusMultiplier;
-
-            spheres[atom.materialId].push_back({center, radius});
-        }
+        const auto batchEnd = std::min(batch + batchSize, chunks.size());
+        async::parallel_for(async::irange(batch, batchEnd),
+                            [&](const size_t i) {
+                                _parseChunk(chunks[i], colorScheme,
+                                            radiusMultiplier);
+                            });
+        callback.updateProgress(message, batchEnd / float(chunks.size()));
     }
-    file.close();
 
     auto model = _scene.createModel();
 
-    // Add materials and spheres
-    for (const auto& spheresPerMaterial : spheres)
+    // Add materials, then the spheres of each chunk in the order of the file
+    std::set<size_t> materialIds;
+    for (const auto& chunk : chunks)
+        for (const auto& spheresPerMaterial : chunk.spheres)
+            materialIds.insert(spheresPerMaterial.first);
+    for (const auto materialId : materialIds)
     {
-        const auto materialId = spheresPerMaterial.first;
-        auto material =
-            model->createMaterial(materialId, colorMap[materialId].symbol);
-        material->setDiffuseColor({colorMap[materialId].R / 255.f,
-                                   colorMap[materialId].G / 255.f,
-                                   colorMap[materialId].B / 255.f});
-        for (const auto& sphere : spheresPerMaterial.second)
-            model->addSphere(materialId, sphere);
+        const auto& color = colorMap[materialId % colorMapSize];
+        auto material = model->createMaterial(materialId, color.symbol);
+        material->setDiffuseColor(
+            {color.R / 255.f, color.G / 255.f, color.B / 255.f});
     }
+    for (const auto& chunk : chunks)
+        for (const auto& spheresPerMaterial : chunk.spheres)
+            model->addSpheres(spheresPerMaterial.first,
+                              spheresPerMaterial.second);
 
     Transformation transformation;
     transformation.setRotationCenter(model->getBounds().getCenter());
     auto modelDescriptor =
-        std::make_shared<ModelDescriptor>(std::move(model), fileName);
+        std::make_shared<ModelDescriptor>(std::move(model), name);
     modelDescriptor->setTransformation(transformation);
     return {modelDescriptor};
 }
@@ -40,17 +40,20 @@ public:
 
     bool isSupported(const std::string& filename,
                      const std::string& extension) const final;
+    bool isBlobSupported(const std::string& extension) const final;
     std::vector<ModelDescriptorPtr> importFromFile(
         const std::string& fileName, const LoaderProgress& callback,
         const PropertyMap& properties) const final;
 
     std::vector<ModelDescriptorPtr> importFromBlob(
-        Blob&&, const LoaderProgress&, const PropertyMap&) const final
-    {
-        throw std::runtime_error("Loading from blob not supported");
-    }
+        Blob&& blob, const LoaderProgress& callback,
+        const PropertyMap& properties) const final;
 
 private:
+    std::vector<ModelDescriptorPtr> _importFromData(
+        const char* data, const size_t size, const std::string& name,
+        const LoaderProgress& callback, const PropertyMap& properties) const;
+
     PropertyMap _defaults;
 };
 } // namespace brayns
@@ -19,6 +19,8 @@
  */
 
 #include "XYZBLoader.h"
+#include "LineRange.h"
+#include "MappedFile.h"
 
 #include <brayns/common/log.h>
 #include <brayns/common/utils/filesystem.h>
@@ -26,7 +28,13 @@
 #include <brayns/engine/Model.h>
 #include <brayns/engine/Scene.h>
 
-#include <fstream>
+#include <async++.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 
 namespace brayns
@@ -36,11 +44,174 @@ namespace
 constexpr auto ALMOST_ZERO = 1e-7f;
 constexpr auto LOADER_NAME = "xyzb";
 
+// Number of progress updates while parsing a large file
+constexpr size_t PROGRESS_STEPS = 20;
+
+// Number of spheres resized by one task
+constexpr size_t RADIUS_CHUNK_SIZE = 1 << 16;
+
 float _computeHalfArea(const Boxf& bbox)
 {
     const auto size = bbox.getSize();
     return size[0] * size[1] + size[0] * size[2] + size[1] * size[2];
 }
+
+/** Lines of the input parsed by one task */
+struct LineChunk
+{
+    LineRange lines;
+    size_t firstLine{0};
+    size_t nbLines{0};
+    Boxf bounds;
+    bool valid{true};
+    size_t invalidLine{0};
+};
+
+const char* _skipSpaces(const char* begin, const char* end)
+{
+    while (begin != end && (*begin == ' ' || *begin == '\t' || *begin == '\r' ||
+                            *begin == '\v' || *begin == '\f'))
+        ++begin;
+    return begin;
+}
+
+bool _isDigit(const char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+const char* _skipDigits(const char* begin, const char* end)
+{
+    while (begin != end && _isDigit(*begin))
+        ++begin;
+    return begin;
+}
+
+// Parses a float the way std::istream does: an optional sign, digits with an
+// optional decimal point and an optional exponent. Returns the end of the
+// number, or begin if there is none.
+const char* _parseFloat(const char* begin, const char* end, float& value)
+{
+    const char* p = begin;
+    if (p != end && (*p == '+' || *p == '-'))
+        ++p;
+    const char* digits = p;
+    p = _skipDigits(p, end);
+    bool hasDigits = p != digits;
+    if (p != end && *p == '.')
+    {
+        const char* decimals = p + 1;
+        p = _skipDigits(decimals, end);
+        hasDigits = hasDigits || p != decimals;
+    }
+    if (!hasDigits)
+        return begin;
+
+    // Like std::istream, an exponent without digits makes the number invalid
+    if (p != end && (*p == 'e' || *p == 'E'))
+    {
+        const char* exponent = p + 1;
+        if (exponent != end && (*exponent == '+' || *exponent == '-'))
+            ++exponent;
+        p = _skipDigits(exponent, end);
+        if (p == exponent)
+            return begin;
+    }
+
+    // strtof needs a null-terminated string, which a mapped file is not
+    char buffer[64];
+    const size_t length = p - begin;
+    std::string longNumber;
+    const char* number = buffer;
+    if (length < sizeof(buffer))
+    {
+        std::memcpy(buffer, begin, length);
+        buffer[length] = '\0';
+    }
+    else
+    {
+        longNumber.assign(begin, length);
+        number = longNumber.c_str();
+    }
+
+    errno = 0;
+    value = std::strtof(number, nullptr);
+    if (errno == ERANGE && std::isinf(value))
+        return begin;
+    return p;
+}
+
+// Parses the lines of a chunk into spheres, stopping at the first invalid line
+void _parseChunk(LineChunk& chunk, Sphere* spheres)
+{
+    const char* end = chunk.lines.end;
+    size_t line = 0;
+    for (const char* begin = chunk.lines.begin; begin < end; ++line)
+    {
+        auto lineEnd =
+            static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+        if (!lineEnd)
+            lineEnd = end;
+
+        // A fourth value makes the line invalid, no need to read further
+        float values[3];
+        size_t nbValues = 0;
+        for (const char* p = _skipSpaces(begin, lineEnd); nbValues <= 3;
+             p = _skipSpaces(p, lineEnd))
+        {
+            float value;
+            const char* next = _parseFloat(p, lineEnd, value);
+            if (next == p)
+                break;
+            if (nbValues < 3)
+                values[nbValues] = value;
+            ++nbValues;
+            p = next;
+        }
+
+        if (nbValues != 3)
+        {
+            chunk.valid = false;
+            chunk.invalidLine = line;
+            return;
+        }
+
+        const Vector3f position(values[0], values[1], values[2]);
+        chunk.bounds.merge(position);
+        // The point radius used here is irrelevant as it's going to be
+        // changed later.
+        spheres[line] = {position, 1};
+        begin = lineEnd + 1;
+    }
+}
+
+std::string _getLine(const LineChunk& chunk, const size_t index)
+{
+    const char* begin = chunk.lines.begin;
+    const char* end = chunk.lines.end;
+    for (size_t i = 0; i < index; ++i)
+        begin =
+            static_cast<const char*>(std::memchr(begin, '\n', end - begin)) + 1;
+    auto lineEnd =
+        static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    return std::string(begin, lineEnd ? lineEnd : end);
+}
+
+void _setRadius(std::vector<Sphere>& spheres, const size_t first,
+                const float radius)
+{
+    const size_t count = spheres.size() - first;
+    const size_t nbChunks = (count + RADIUS_CHUNK_SIZE - 1) / RADIUS_CHUNK_SIZE;
+    async::parallel_for(async::irange(size_t(0), nbChunks),
+                        [&](const size_t chunk) {
+                            const auto begin =
+                                first + chunk * RADIUS_CHUNK_SIZE;
+                            const auto end = std::min(begin + RADIUS_CHUNK_SIZE,
+                                                      spheres.size());
+                            for (size_t i = begin; i < end; ++i)
+                                spheres[i].radius = radius;
+                        });
+}
 } // namespace
 
 XYZBLoader::XYZBLoader(Scene& scene)
@@ -55,62 +226,96 @@ bool XYZBLoader::isSupported(const std::string& filename BRAYNS_UNUSED,
     return types.find(extension) != types.end();
 }
 
+bool XYZBLoader::isBlobSupported(const std::string& extension) const
+{
+    return isSupported("", extension);
+}
+
 std::vector<ModelDescriptorPtr> XYZBLoader::importFromBlob(
     Blob&& blob, const LoaderProgress& callback,
     const PropertyMap& properties BRAYNS_UNUSED) const
 {
-    BRAYNS_INFO << "Loading xyz " << blob.name << std::endl;
+    return _importFromData(reinterpret_cast<const char*>(blob.data.data()),
+                           blob.data.size(), blob.name, callback);
+}
+
+std::vector<ModelDescriptorPtr> XYZBLoader::importFromFile(
+    const std::string& filename, const LoaderProgress& callback,
+    const PropertyMap& properties BRAYNS_UNUSED) const
+{
+    const MappedFile file(filename);
+    return _importFromData(file.data(), file.size(), filename, callback);
+}
+
+std::vector<ModelDescriptorPtr> XYZBLoader::_importFromData(
+    const char* data, const size_t size, const std::string& name,
+    const LoaderProgress& callback) const
+{
+    BRAYNS_INFO << "Loading xyz " << name << std::endl;
+
+    std::stringstream msg;
+    msg << "Loading " << string_utils::shortenString(name) << " ...";
 
-    std::stringstream stream(std::string(blob.data.begin(), blob.data.end()));
+    // Count the lines of each chunk to know where its spheres go
+    std::vector<LineChunk> chunks;
+    for (const auto& lines : splitLines(data, size, PROGRESS_STEPS))
+    {
+        LineChunk chunk;
+        chunk.lines = lines;
+        chunks.push_back(chunk);
+    }
+    async::parallel_for(async::irange(size_t(0), chunks.size()),
+                        [&](const size_t i) {
+                            auto& chunk = chunks[i];
+                            chunk.nbLines = countLines(chunk.lines);
+                        });
     size_t numlines = 0;
+    for (auto& chunk : chunks)
     {
-        numlines = std::count(std::istreambuf_iterator<char>(stream),
-                              std::istreambuf_iterator<char>(), '\n');
+        chunk.firstLine = numlines;
+        numlines += chunk.nbLines;
     }
-    stream.seekg(0);
 
     auto model = _scene.createModel();
 
-    const auto name = fs::path({blob.name}).stem();
     const auto materialId = 0;
-    model->createMaterial(materialId, name);
+    model->createMaterial(materialId, fs::path({name}).stem());
     auto& spheres = model->getSpheres()[materialId];
 
     const size_t startOffset = spheres.size();
-    spheres.reserve(spheres.size() + numlines);
+    spheres.resize(startOffset + numlines);
 
-    Boxf bbox;
-    size_t i = 0;
-    std::string line;
-    std::stringstream msg;
-    msg << "Loading " << string_utils::shortenString(blob.name) << " ...";
-    while (std::getline(stream, line))
+    // Chunks are parsed by batches, to report progress between them
+    const size_t batchSize =
+        std::max(chunks.size() / PROGRESS_STEPS, size_t(1));
+    for (size_t batch = 0; batch < chunks.size(); batch += batchSize)
     {
-        std::vector<float> lineData;
-        std::stringstream lineStream(line);
+        const auto batchEnd = std::min(batch + batchSize, chunks.size());
+        async::parallel_for(async::irange(batch, batchEnd),
+                            [&](const size_t i) {
+                                auto& chunk = chunks[i];
+                                _parseChunk(chunk, &spheres[startOffset +
+                                                            chunk.firstLine]);
+                            });
 
-        float value;
-        while (lineStream >> value)
-            lineData.push_back(value);
-
-        switch (lineData.size())
-        {
-        case 3:
+        for (size_t i = batch; i < batchEnd; ++i)
         {
-            const Vector3f position(lineData[0], lineData[1], lineData[2]);
-            bbox.merge(position);
-            // The point radius used here is irrelevant as it's going to be
-            // changed later.
-            model->addSphere(materialId, {position, 1});
-            break;
-        }
-        default:
-            throw std::runtime_error("Invalid content in line " +
-                                     std::to_string(i + 1) + ": " + line);
+            const auto& chunk = chunks[i];
+            if (!chunk.valid)
+            {
+                const auto line = chunk.firstLine + chunk.invalidLine;
+                throw std::runtime_error(
+                    "Invalid content in line " + std::to_string(line + 1) +
+                    ": " + _getLine(chunk, chunk.invalidLine));
+            }
         }
-        callback.updateProgress(msg.str(), i++ / static_cast<float>(numlines));
+        callback.updateProgress(msg.str(), batchEnd / float(chunks.size()));
     }
 
+    Boxf bbox;
+    for (const auto& chunk : chunks)
+        bbox.merge(chunk.bounds);
+
     // Find an appropriate mean radius to avoid overlaps of the spheres, see
     // https://en.wikipedia.org/wiki/Wigner%E2%80%93Seitz_radius
 
@@ -124,13 +329,12 @@ std::vector<ModelDescriptorPtr> XYZBLoader::importFromBlob(
                                   : std::sqrt(1 / density4PI);
 
     // resize the spheres to the new mean radius
-    for (i = 0; i < numlines; ++i)
-        spheres[i + startOffset].radius = meanRadius;
+    _setRadius(spheres, startOffset, meanRadius);
 
     Transformation transformation;
     transformation.setRotationCenter(model->getBounds().getCenter());
     auto modelDescriptor =
-        std::make_shared<ModelDescriptor>(std::move(model), blob.name);
+        std::make_shared<ModelDescriptor>(std::move(model), name);
     modelDescriptor->setTransformation(transformation);
 
     Property radiusProperty("radius", meanRadius, {"Point size"});
@@ -139,8 +343,8 @@ std::vector<ModelDescriptorPtr> XYZBLoader::importFromBlob(
         if (auto modelDesc_ = modelDesc.lock())
         {
             const auto newRadius = property.as<double>();
-            for (auto& sphere : modelDesc_->getModel().getSpheres()[materialId])
-                sphere.radius = newRadius;
+            _setRadius(modelDesc_->getModel().getSpheres()[materialId], 0,
+                       newRadius);
         }
     });
     PropertyMap modelProperties;
@@ -149,20 +353,6 @@ std::vector<ModelDescriptorPtr> XYZBLoader::importFromBlob(
     return {modelDescriptor};
 }
 
-std::vector<ModelDescriptorPtr> XYZBLoader::importFromFile(
-    const std::string& filename, const LoaderProgress& callback,
-    const PropertyMap& properties) const
-{
-    std::ifstream file(filename);
-    if (!file.good())
-        throw std::runtime_error("Could not open file " + filename);
-    return importFromBlob({"xyz",
-                           filename,
-                           {std::istreambuf_iterator<char>(file),
-                            std::istreambuf_iterator<char>()}},
-                          callback, properties);
-}
-
 std::string XYZBLoader::getName() const
 {
     return LOADER_NAME;
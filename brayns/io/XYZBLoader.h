@@ -34,6 +34,7 @@ public:
 
     bool isSupported(const std::string& filename,
                      const std::string& extension) const final;
+    bool isBlobSupported(const std::string& extension) const final;
     std::vector<ModelDescriptorPtr> importFromBlob(
         Blob&& blob, const LoaderProgress& callback,
         const PropertyMap& properties) const final;
@@ -41,5 +42,10 @@ public:
     std::vector<ModelDescriptorPtr> importFromFile(
         const std::string& filename, const LoaderProgress& callback,
         const PropertyMap& properties) const final;
+
+private:
+    std::vector<ModelDescriptorPtr> _importFromData(
+        const char* data, const size_t size, const std::string& name,
+        const LoaderProgress& callback) const;
 };
 } // namespace brayns
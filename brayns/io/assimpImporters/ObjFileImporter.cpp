@@ -43,7 +43,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ASSIMP_BUILD_NO_OBJ_IMPORTER
 
 #include "ObjFileImporter.h"
-#include "IOStreamBuffer.h"
+#include "../MappedFile.h"
 #include "ObjFileData.h"
 #include "ObjFileParser.h"
 #include <assimp/DefaultLogger.hpp>
@@ -52,6 +52,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/ai_assert.h>
 #include <assimp/importerdesc.h>
 #include <assimp/scene.h>
+#include <brayns/common/utils/filesystem.h>
 #include <memory>
 
 static const aiImporterDesc desc = {"Wavefront Object Importer",
@@ -131,8 +132,26 @@ void ObjFileImporter::InternReadFile(const std::string& file, aiScene* pScene,
         throw DeadlyImportError("OBJ-file is too small.");
     }
 
-    IOStreamBuffer<char> streamedBuffer;
-    streamedBuffer.open(fileStream.get());
+    // Files on disk are mapped, in-memory data is copied from the stream
+    std::unique_ptr<brayns::MappedFile> mappedFile;
+    std::vector<char> buffer;
+    const char* data = nullptr;
+    std::error_code error;
+    if (fs::is_regular_file(file, error))
+    {
+        mappedFile.reset(new brayns::MappedFile(file));
+        data = mappedFile->data();
+        fileSize = mappedFile->size();
+    }
+    else
+    {
+        buffer.resize(fileSize);
+        if (fileStream->Read(buffer.data(), 1, fileSize) != fileSize)
+        {
+            throw DeadlyImportError("Failed to read file " + file + ".");
+        }
+        data = buffer.data();
+    }
 
     // Allocate buffer and read file into it
     // TextFileToBuffer( fileStream.get(),m_Buffer);
@@ -188,14 +207,12 @@ void ObjFileImporter::InternReadFile(const std::string& file, aiScene* pScene,
     m_progress->UpdateFileRead(1, 3);
 
     // parse the file into a temporary representation
-    ObjFileParser parser(streamedBuffer, modelName, pIOHandler, m_progress,
+    ObjFileParser parser(data, fileSize, modelName, pIOHandler, m_progress,
                          file);
 
     // And create the proper return structures out of it
     CreateDataFromImport(parser.GetModel(), pScene);
 
-    streamedBuffer.close();
-
     // Clean up allocated storage for the next import
     m_Buffer.clear();
 
@@ -51,100 +51,224 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/IOSystem.hpp>
 #include <assimp/Importer.hpp>
 #include <assimp/material.h>
+
+#include <async++.h>
+
+#include <algorithm>
 #include <cstdlib>
+#include <memory>
+#include <thread>
 
 namespace Assimp
 {
 const std::string ObjFileParser::DEFAULT_MATERIAL = AI_DEFAULT_MATERIAL_NAME;
 typedef float ai_real;
 
-ObjFileParser::ObjFileParser()
-    : m_DataIt()
-    , m_DataItEnd()
-    , m_pModel(NULL)
-    , m_uiLine(0)
-    , m_pIO(nullptr)
-    , m_progress(nullptr)
-    , m_originalObjFileName()
+namespace
 {
-    // empty
-}
+// Minimum number of bytes parsed by one task
+const size_t MinChunkSize = 1 << 20;
 
-ObjFileParser::ObjFileParser(IOStreamBuffer<char> &streamBuffer,
-                             const std::string &modelName, IOSystem *io,
-                             ProgressHandler *progress,
-                             const std::string &originalObjFileName)
-    : m_DataIt()
-    , m_DataItEnd()
-    , m_pModel(NULL)
-    , m_uiLine(0)
-    , m_pIO(io)
-    , m_progress(progress)
-    , m_originalObjFileName(originalObjFileName)
-{
-    std::fill_n(m_buffer, Buffersize, 0);
+// Number of characters added after the line end of every line. The parsing
+// helpers stop one character before the end of their buffer, and may step a
+// few characters over the line end of a malformed face.
+const size_t LinePadding = 16;
 
-    // Create the model instance to store all the data
-    m_pModel = new ObjFile::Model();
-    m_pModel->m_ModelName = modelName;
+const std::string DefaultObjName = "defaultobject";
 
-    // create default material and store it
-    m_pModel->m_pDefaultMaterial = new ObjFile::Material;
-    m_pModel->m_pDefaultMaterial->MaterialName.Set(DEFAULT_MATERIAL);
-    m_pModel->m_MaterialLib.push_back(DEFAULT_MATERIAL);
-    m_pModel->m_MaterialMap[DEFAULT_MATERIAL] = m_pModel->m_pDefaultMaterial;
-
-    // Start parsing the file
-    parseFile(streamBuffer);
+bool isFace(const char type)
+{
+    return type == 'f' || type == 'l' || type == 'p';
 }
 
-ObjFileParser::~ObjFileParser()
+// Same lines as IOStreamBuffer::getNextDataLine: a backslash joins a line to
+// the next one, and a last line without line end is ignored
+bool getNextDataLine(const char *&it, const char *end, std::vector<char> &line)
 {
-    delete m_pModel;
-    m_pModel = NULL;
+    line.clear();
+    if (it == end)
+    {
+        return false;
+    }
+
+    bool continuationFound = false;
+    while (true)
+    {
+        if (*it == '\\')
+        {
+            continuationFound = true;
+            if (++it == end)
+            {
+                return false;
+            }
+        }
+        if (IsLineEnd(*it))
+        {
+            if (!continuationFound)
+            {
+                break;
+            }
+            // skip line end
+            while (*it != '\n')
+            {
+                if (++it == end)
+                {
+                    return false;
+                }
+            }
+            if (++it == end)
+            {
+                return false;
+            }
+            continuationFound = false;
+        }
+        line.push_back(*it);
+        if (++it == end)
+        {
+            return false;
+        }
+    }
+    ++it;
+
+    line.push_back('\n');
+    line.resize(line.size() + LinePadding - 1, '\0');
+    return true;
 }
 
-void ObjFileParser::setBuffer(std::vector<char> &buffer)
+// Splits the data in chunks of whole lines. A chunk ends with the line feed
+// of a line without backslash, which cannot be continued by the next line.
+std::vector<std::pair<const char *, const char *>> splitLines(const char *data,
+                                                              size_t size)
 {
-    m_DataIt = buffer.begin();
-    m_DataItEnd = buffer.end();
+    const size_t nbThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    const size_t chunkSize = std::max(MinChunkSize, size / (4 * nbThreads) + 1);
+
+    std::vector<std::pair<const char *, const char *>> chunks;
+    const char *end = data + size;
+    const char *begin = data;
+    while (begin != end)
+    {
+        const char *chunkEnd = end;
+        if (size_t(end - begin) > chunkSize)
+        {
+            const char *lineFeed = std::find(begin + chunkSize, end, '\n');
+            while (lineFeed != end)
+            {
+                const char *nextLineFeed = std::find(lineFeed + 1, end, '\n');
+                if (nextLineFeed == end)
+                {
+                    break;
+                }
+                if (std::find(lineFeed + 1, nextLineFeed, '\\') == nextLineFeed)
+                {
+                    chunkEnd = nextLineFeed + 1;
+                    break;
+                }
+                lineFeed = nextLineFeed;
+            }
+        }
+        chunks.emplace_back(begin, chunkEnd);
+        begin = chunkEnd;
+    }
+    return chunks;
 }
 
-ObjFile::Model *ObjFileParser::GetModel() const
+bool isDataDefinitionEnd(const char *tmp)
 {
-    return m_pModel;
+    if (*tmp == '\\')
+    {
+        tmp++;
+        if (IsLineEnd(*tmp))
+        {
+            tmp++;
+            return true;
+        }
+    }
+    return false;
 }
 
-void ObjFileParser::parseFile(IOStreamBuffer<char> &streamBuffer)
+/// Lines of the file parsed by one task. Vertex data is parsed right away,
+/// faces once the vertex data before the chunk is known, and the other
+/// statements are kept to be replayed in file order.
+class ObjFileChunk
 {
-    // only update every 100KB or it'll be too slow
-    // const unsigned int updateProgressEveryBytes = 100 * 1024;
-    unsigned int progressCounter = 0;
-    const unsigned int bytesToProcess =
-        static_cast<unsigned int>(streamBuffer.size());
-    const unsigned int progressTotal = 3 * bytesToProcess;
-    const unsigned int progressOffset = bytesToProcess;
-    unsigned int processed = 0;
-    size_t lastFilePos(0);
+public:
+    typedef ObjFileParser::DataArrayIt DataArrayIt;
 
+    struct Statement
+    {
+        /// First character of the line
+        char type;
+        /// Position of the line in the text of the chunk, or in the face text
+        size_t begin;
+        size_t end;
+        /// Vertex data of the chunk before the statement
+        size_t numVertices;
+        size_t numTextureCoords;
+        size_t numNormals;
+        /// Parsed face, if the statement is a valid face
+        std::unique_ptr<ObjFile::Face> face;
+        bool hasNormal;
+    };
+
+    ObjFileChunk()
+        : m_uiLine(0)
+    {
+        std::fill_n(m_buffer, ObjFileParser::Buffersize, 0);
+    }
+
+    /// Parses the vertex data and stores the other statements
+    void parse(const char *begin, const char *end);
+    /// Parses the faces, given the vertex data before the chunk
+    void parseFaces(size_t numVertices, size_t numTextureCoords,
+                    size_t numNormals);
+
+    std::vector<aiVector3D> m_Vertices;
+    std::vector<aiVector3D> m_VertexColors;
+    std::vector<aiVector3D> m_TextureCoord;
+    std::vector<aiVector3D> m_Normals;
+    std::vector<char> m_Text;
+    std::vector<char> m_FaceText;
+    std::vector<Statement> m_Statements;
+
+private:
+    /// Method to copy the new delimited word in the current line.
+    void copyNextWord(char *pBuffer, size_t length);
+    /// Get the number of components in a line.
+    size_t getNumComponentsInDataDefinition();
+    /// Stores the vector
+    void getVector(std::vector<aiVector3D> &point3d_array);
+    /// Stores the following 3d vector.
+    void getVector3(std::vector<aiVector3D> &point3d_array);
+    /// Stores the following homogeneous vector as a 3D vector
+    void getHomogeneousVector3(std::vector<aiVector3D> &point3d_array);
+    /// Stores the following two 3d vectors on the line.
+    void getTwoVectors3(std::vector<aiVector3D> &point3d_array_a,
+                        std::vector<aiVector3D> &point3d_array_b);
+    /// Parses the following face, null if it is empty.
+    ObjFile::Face *getFace(aiPrimitiveType type, int vSize, int vtSize,
+                           int vnSize, bool &hasNormal);
+    /// Error report in token
+    void reportErrorTokenInFace();
+
+    //! Iterator to current position in buffer
+    DataArrayIt m_DataIt;
+    //! Iterator to end position of buffer
+    DataArrayIt m_DataItEnd;
+    //! Current line (for debugging)
+    unsigned int m_uiLine;
+    //! Helper buffer
+    char m_buffer[ObjFileParser::Buffersize];
+};
+
+void ObjFileChunk::parse(const char *begin, const char *end)
+{
     std::vector<char> buffer;
-    while (streamBuffer.getNextDataLine(buffer, '\\'))
+    while (getNextDataLine(begin, end, buffer))
     {
         m_DataIt = buffer.begin();
         m_DataItEnd = buffer.end();
 
-        // Handle progress reporting
-        const size_t filePos(streamBuffer.getFilePos());
-        if (lastFilePos < filePos)
-        {
-            processed += static_cast<unsigned int>(filePos);
-            lastFilePos = filePos;
-            progressCounter++;
-            m_progress->UpdateFileRead(progressOffset + processed * 2,
-                                       progressTotal);
-        }
-
-        // parse line
         switch (*m_DataIt)
         {
         case 'v': // Parse a vertex texture coordinate
@@ -156,117 +280,89 @@ void ObjFileParser::parseFile(IOStreamBuffer<char> &streamBuffer)
                 if (numComponents == 3)
                 {
                     // read in vertex definition
-                    getVector3(m_pModel->m_Vertices);
+                    getVector3(m_Vertices);
                 }
                 else if (numComponents == 4)
                 {
                     // read in vertex definition (homogeneous coords)
-                    getHomogeneousVector3(m_pModel->m_Vertices);
+                    getHomogeneousVector3(m_Vertices);
                 }
                 else if (numComponents == 6)
                 {
                     // read vertex and vertex-color
-                    getTwoVectors3(m_pModel->m_Vertices,
-                                   m_pModel->m_VertexColors);
+                    getTwoVectors3(m_Vertices, m_VertexColors);
                 }
             }
             else if (*m_DataIt == 't')
             {
                 // read in texture coordinate ( 2D or 3D )
                 ++m_DataIt;
-                getVector(m_pModel->m_TextureCoord);
+                getVector(m_TextureCoord);
             }
             else if (*m_DataIt == 'n')
             {
                 // Read in normal vector definition
                 ++m_DataIt;
-                getVector3(m_pModel->m_Normals);
+                getVector3(m_Normals);
             }
         }
         break;
 
-        case 'p': // Parse a face, line or point statement
+        case 'p': // Faces, lines and points
         case 'l':
         case 'f':
+        case 'u': // Materials, objects and groups
+        case 'm':
+        case 'g':
+        case 'o':
         {
-            getFace(*m_DataIt == 'f'
-                        ? aiPrimitiveType_POLYGON
-                        : (*m_DataIt == 'l' ? aiPrimitiveType_LINE
-                                            : aiPrimitiveType_POINT));
-        }
-        break;
-
-        case '#': // Parse a comment
-        {
-            getComment();
-        }
-        break;
-
-        case 'u': // Parse a material desc. setter
-        {
-            std::string name;
-
-            getNameNoSpace(m_DataIt, m_DataItEnd, name);
-
-            size_t nextSpace = name.find(" ");
-            if (nextSpace != std::string::npos)
-                name = name.substr(0, nextSpace);
-
-            if (name == "usemtl")
-            {
-                getMaterialDesc();
-            }
-        }
-        break;
-
-        case 'm': // Parse a material library or merging group ('mg')
-        {
-            std::string name;
-
-            getNameNoSpace(m_DataIt, m_DataItEnd, name);
-
-            size_t nextSpace = name.find(" ");
-            if (nextSpace != std::string::npos)
-                name = name.substr(0, nextSpace);
-
-            if (name == "mg")
-                getGroupNumberAndResolution();
-            else if (name == "mtllib")
-                getMaterialLib();
-            else
-                goto pf_skip_line;
-        }
-        break;
-
-        case 'g': // Parse group name
-        {
-            getGroupName();
+            const char type = *m_DataIt;
+            auto &text = isFace(type) ? m_FaceText : m_Text;
+            const size_t offset = text.size();
+            text.insert(text.end(), buffer.begin(), buffer.end());
+            m_Statements.push_back({type, offset, text.size(),
+                                    m_Vertices.size(), m_TextureCoord.size(),
+                                    m_Normals.size(), nullptr, false});
         }
         break;
 
-        case 's': // Parse group number
-        {
-            getGroupNumber();
-        }
-        break;
-
-        case 'o': // Parse object name
-        {
-            getObjectName();
+        default: // Comments, smoothing groups and unknown statements
+            break;
         }
-        break;
+    }
+}
 
-        default:
+void ObjFileChunk::parseFaces(size_t numVertices, size_t numTextureCoords,
+                              size_t numNormals)
+{
+    for (auto &statement : m_Statements)
+    {
+        const char type = statement.type;
+        if (!isFace(type))
         {
-        pf_skip_line:
-            m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
-        }
-        break;
+            continue;
         }
+        m_DataIt = m_FaceText.begin() + statement.begin;
+        m_DataItEnd = m_FaceText.begin() + statement.end;
+
+        const int vSize = static_cast<unsigned int>(numVertices +
+                                                    statement.numVertices);
+        const int vtSize = static_cast<unsigned int>(
+            numTextureCoords + statement.numTextureCoords);
+        const int vnSize =
+            static_cast<unsigned int>(numNormals + statement.numNormals);
+        statement.face.reset(
+            getFace(type == 'f' ? aiPrimitiveType_POLYGON
+                                : (type == 'l' ? aiPrimitiveType_LINE
+                                               : aiPrimitiveType_POINT),
+                    vSize, vtSize, vnSize, statement.hasNormal));
     }
+
+    // Only the other statements are needed from now on
+    std::vector<char>().swap(m_FaceText);
 }
 
-void ObjFileParser::copyNextWord(char *pBuffer, size_t length)
+void ObjFileChunk::copyNextWord(char *pBuffer, size_t length)
 {
     size_t index = 0;
     m_DataIt = getNextWord<DataArrayIt>(m_DataIt, m_DataItEnd);
@@ -291,21 +387,7 @@ void ObjFileParser::copyNextWord(char *pBuffer, size_t length)
     pBuffer[index] = '\0';
 }
 
-static bool isDataDefinitionEnd(const char *tmp)
-{
-    if (*tmp == '\\')
-    {
-        tmp++;
-        if (IsLineEnd(*tmp))
-        {
-            tmp++;
-            return true;
-        }
-    }
-    return false;
-}
-
-size_t ObjFileParser::getNumComponentsInDataDefinition()
+size_t ObjFileChunk::getNumComponentsInDataDefinition()
 {
     size_t numComponents(0);
     const char *tmp(&m_DataIt[0]);
@@ -338,28 +420,28 @@ size_t ObjFileParser::getNumComponentsInDataDefinition()
     return numComponents;
 }
 
-void ObjFileParser::getVector(std::vector<aiVector3D> &point3d_array)
+void ObjFileChunk::getVector(std::vector<aiVector3D> &point3d_array)
 {
     size_t numComponents = getNumComponentsInDataDefinition();
     ai_real x, y, z;
     if (2 == numComponents)
     {
-        copyNextWord(m_buffer, Buffersize);
+        copyNextWord(m_buffer, ObjFileParser::Buffersize);
         x = (ai_real)fast_atof(m_buffer);
 
-        copyNextWord(m_buffer, Buffersize);
+        copyNextWord(m_buffer, ObjFileParser::Buffersize);
         y = (ai_real)fast_atof(m_buffer);
         z = 0.0;
     }
     else if (3 == numComponents)
     {
-        copyNextWord(m_buffer, Buffersize);
+        copyNextWord(m_buffer, ObjFileParser::Buffersize);
         x = (ai_real)fast_atof(m_buffer);
 
-        copyNextWord(m_buffer, Buffersize);
+        copyNextWord(m_buffer, ObjFileParser::Buffersize);
         y = (ai_real)fast_atof(m_buffer);
 
-        copyNextWord(m_buffer, Buffersize);
+        copyNextWord(m_buffer, ObjFileParser::Buffersize);
         z = (ai_real)fast_atof(m_buffer);
     }
     else
@@ -370,36 +452,36 @@ void ObjFileParser::getVector(std::vector<aiVector3D> &point3d_array)
     m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
 }
 
-void ObjFileParser::getVector3(std::vector<aiVector3D> &point3d_array)
+void ObjFileChunk::getVector3(std::vector<aiVector3D> &point3d_array)
 {
     ai_real x, y, z;
-    copyNextWord(m_buffer, Buffersize);
+    copyNextWord(m_buffer, ObjFileParser::Buffersize);
     x = (ai_real)fast_atof(m_buffer);
 
-    copyNextWord(m_buffer, Buffersize);
+    copyNextWord(m_buffer, ObjFileParser::Buffersize);
     y = (ai_real)fast_atof(m_buffer);
 
-    copyNextWord(m_buffer, Buffersize);
+    copyNextWord(m_buffer, ObjFileParser::Buffersize);
     z = (ai_real)fast_atof(m_buffer);
 
     point3d_array.push_back(aiVector3D(x, y, z));
     m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
 }
 
-void ObjFileParser::getHomogeneousVector3(
+void ObjFileChunk::getHomogeneousVector3(
     std::vector<aiVector3D> &point3d_array)
 {
     ai_real x, y, z, w;
-    copyNextWord(m_buffer, Buffersize);
+    copyNextWord(m_buffer, ObjFileParser::Buffersize);
     x = (ai_real)fast_atof(m_buffer);
 
-    copyNextWord(m_buffer, Buffersize);
+    copyNextWord(m_buffer, ObjFileParser::Buffersize);
     y = (ai_real)fast_atof(m_buffer);
 
-    copyNextWord(m_buffer, Buffersize);
+    copyNextWord(m_buffer, ObjFileParser::Buffersize);
     z = (ai_real)fast_atof(m_buffer);
 
-    copyNextWord(m_buffer, Buffersize);
+    copyNextWord(m_buffer, ObjFileParser::Buffersize);
     w = (ai_real)fast_atof(m_buffer);
 
     ai_assert(w != 0);
@@ -408,28 +490,28 @@ void ObjFileParser::getHomogeneousVector3(
     m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
 }
 
-void ObjFileParser::getTwoVectors3(std::vector<aiVector3D> &point3d_array_a,
+void ObjFileChunk::getTwoVectors3(std::vector<aiVector3D> &point3d_array_a,
                                    std::vector<aiVector3D> &point3d_array_b)
 {
     ai_real x, y, z;
-    copyNextWord(m_buffer, Buffersize);
+    copyNextWord(m_buffer, ObjFileParser::Buffersize);
     x = (ai_real)fast_atof(m_buffer);
 
-    copyNextWord(m_buffer, Buffersize);
+    copyNextWord(m_buffer, ObjFileParser::Buffersize);
     y = (ai_real)fast_atof(m_buffer);
 
-    copyNextWord(m_buffer, Buffersize);
+    copyNextWord(m_buffer, ObjFileParser::Buffersize);
     z = (ai_real)fast_atof(m_buffer);
 
     point3d_array_a.push_back(aiVector3D(x, y, z));
 
-    copyNextWord(m_buffer, Buffersize);
+    copyNextWord(m_buffer, ObjFileParser::Buffersize);
     x = (ai_real)fast_atof(m_buffer);
 
-    copyNextWord(m_buffer, Buffersize);
+    copyNextWord(m_buffer, ObjFileParser::Buffersize);
     y = (ai_real)fast_atof(m_buffer);
 
-    copyNextWord(m_buffer, Buffersize);
+    copyNextWord(m_buffer, ObjFileParser::Buffersize);
     z = (ai_real)fast_atof(m_buffer);
 
     point3d_array_b.push_back(aiVector3D(x, y, z));
@@ -437,40 +519,20 @@ void ObjFileParser::getTwoVectors3(std::vector<aiVector3D> &point3d_array_a,
     m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
 }
 
-void ObjFileParser::getVector2(std::vector<aiVector2D> &point2d_array)
-{
-    ai_real x, y;
-    copyNextWord(m_buffer, Buffersize);
-    x = (ai_real)fast_atof(m_buffer);
-
-    copyNextWord(m_buffer, Buffersize);
-    y = (ai_real)fast_atof(m_buffer);
-
-    point2d_array.push_back(aiVector2D(x, y));
-
-    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
-}
-
-static const std::string DefaultObjName = "defaultobject";
-
-void ObjFileParser::getFace(aiPrimitiveType type)
+ObjFile::Face *ObjFileChunk::getFace(aiPrimitiveType type, int vSize,
+                                     int vtSize, int vnSize, bool &hasNormal)
 {
     m_DataIt = getNextToken<DataArrayIt>(m_DataIt, m_DataItEnd);
     if (m_DataIt == m_DataItEnd || *m_DataIt == '\0')
     {
-        return;
+        return nullptr;
     }
 
-    ObjFile::Face *face = new ObjFile::Face(type);
-    bool hasNormal = false;
+    std::unique_ptr<ObjFile::Face> face(new ObjFile::Face(type));
+    hasNormal = false;
 
-    const int vSize = static_cast<unsigned int>(m_pModel->m_Vertices.size());
-    const int vtSize =
-        static_cast<unsigned int>(m_pModel->m_TextureCoord.size());
-    const int vnSize = static_cast<unsigned int>(m_pModel->m_Normals.size());
-
-    const bool vt = (!m_pModel->m_TextureCoord.empty());
-    const bool vn = (!m_pModel->m_Normals.empty());
+    const bool vt = vtSize > 0;
+    const bool vn = vnSize > 0;
     int iStep = 0, iPos = 0;
     while (m_DataIt != m_DataItEnd)
     {
@@ -564,9 +626,6 @@ void ObjFileParser::getFace(aiPrimitiveType type)
             else
             {
                 // On error, std::atoi will return 0 which is not a valid value
-                delete face;
-                delete m_pModel;
-                m_pModel = nullptr;
                 throw DeadlyImportError("OBJ: Invalid face indice");
             }
         }
@@ -578,10 +637,206 @@ void ObjFileParser::getFace(aiPrimitiveType type)
         DefaultLogger::get()->error("Obj: Ignoring empty face");
         // skip line and clean up
         m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
-        delete face;
-        return;
+        return nullptr;
+    }
+
+    // Skip the rest of the line
+    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+    return face.release();
+}
+
+void ObjFileChunk::reportErrorTokenInFace()
+{
+    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+    DefaultLogger::get()->error(
+        "OBJ: Not supported token in face description detected");
+}
+} // namespace
+
+ObjFileParser::ObjFileParser()
+    : m_pModel(NULL)
+    , m_uiLine(0)
+    , m_pIO(nullptr)
+    , m_progress(nullptr)
+    , m_originalObjFileName()
+{
+    // empty
+}
+
+ObjFileParser::ObjFileParser(const char *data, size_t size,
+                             const std::string &modelName, IOSystem *io,
+                             ProgressHandler *progress,
+                             const std::string &originalObjFileName)
+    : m_pModel(NULL)
+    , m_uiLine(0)
+    , m_pIO(io)
+    , m_progress(progress)
+    , m_originalObjFileName(originalObjFileName)
+{
+    // Create the model instance to store all the data
+    m_pModel = new ObjFile::Model();
+    m_pModel->m_ModelName = modelName;
+
+    // create default material and store it
+    m_pModel->m_pDefaultMaterial = new ObjFile::Material;
+    m_pModel->m_pDefaultMaterial->MaterialName.Set(DEFAULT_MATERIAL);
+    m_pModel->m_MaterialLib.push_back(DEFAULT_MATERIAL);
+    m_pModel->m_MaterialMap[DEFAULT_MATERIAL] = m_pModel->m_pDefaultMaterial;
+
+    // Start parsing the file
+    try
+    {
+        parseFile(data, size);
+    }
+    catch (...)
+    {
+        delete m_pModel;
+        m_pModel = nullptr;
+        throw;
+    }
+}
+
+ObjFileParser::~ObjFileParser()
+{
+    delete m_pModel;
+    m_pModel = NULL;
+}
+
+ObjFile::Model *ObjFileParser::GetModel() const
+{
+    return m_pModel;
+}
+
+void ObjFileParser::parseFile(const char *data, size_t size)
+{
+    const auto ranges = splitLines(data, size);
+    std::vector<ObjFileChunk> chunks(ranges.size());
+    async::parallel_for(async::irange(size_t(0), chunks.size()),
+                        [&](const size_t i) {
+                            chunks[i].parse(ranges[i].first,
+                                            ranges[i].second);
+                        });
+    m_progress->UpdateFileRead(2, 4);
+
+    // Vertex data is stored in file order, faces refer to the vertex data
+    // defined before them
+    struct Offsets
+    {
+        size_t vertices;
+        size_t vertexColors;
+        size_t textureCoords;
+        size_t normals;
+    };
+    std::vector<Offsets> offsets(chunks.size() + 1, Offsets{0, 0, 0, 0});
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        offsets[i + 1].vertices =
+            offsets[i].vertices + chunks[i].m_Vertices.size();
+        offsets[i + 1].vertexColors =
+            offsets[i].vertexColors + chunks[i].m_VertexColors.size();
+        offsets[i + 1].textureCoords =
+            offsets[i].textureCoords + chunks[i].m_TextureCoord.size();
+        offsets[i + 1].normals =
+            offsets[i].normals + chunks[i].m_Normals.size();
+    }
+    m_pModel->m_Vertices.resize(offsets.back().vertices);
+    m_pModel->m_VertexColors.resize(offsets.back().vertexColors);
+    m_pModel->m_TextureCoord.resize(offsets.back().textureCoords);
+    m_pModel->m_Normals.resize(offsets.back().normals);
+
+    async::parallel_for(
+        async::irange(size_t(0), chunks.size()), [&](const size_t i) {
+            auto &chunk = chunks[i];
+            const auto &offset = offsets[i];
+            std::copy(chunk.m_Vertices.begin(), chunk.m_Vertices.end(),
+                      m_pModel->m_Vertices.begin() + offset.vertices);
+            std::copy(chunk.m_VertexColors.begin(), chunk.m_VertexColors.end(),
+                      m_pModel->m_VertexColors.begin() + offset.vertexColors);
+            std::copy(chunk.m_TextureCoord.begin(), chunk.m_TextureCoord.end(),
+                      m_pModel->m_TextureCoord.begin() + offset.textureCoords);
+            std::copy(chunk.m_Normals.begin(), chunk.m_Normals.end(),
+                      m_pModel->m_Normals.begin() + offset.normals);
+            chunk.parseFaces(offset.vertices, offset.textureCoords,
+                             offset.normals);
+        });
+    m_progress->UpdateFileRead(3, 4);
+
+    // Objects, groups and materials decide which mesh the faces go to
+    for (auto &chunk : chunks)
+    {
+        for (auto &statement : chunk.m_Statements)
+        {
+            if (statement.face)
+            {
+                addFace(statement.face.release(), statement.hasNormal);
+            }
+            else if (!isFace(statement.type))
+            {
+                parseStatement(chunk.m_Text.begin() + statement.begin,
+                               chunk.m_Text.begin() + statement.end);
+            }
+        }
+    }
+}
+
+void ObjFileParser::parseStatement(DataArrayIt dataIt,
+                                   const DataArrayIt dataEnd)
+{
+    switch (*dataIt)
+    {
+    case 'u': // Parse a material desc. setter
+    {
+        std::string name;
+
+        getNameNoSpace(dataIt, dataEnd, name);
+
+        size_t nextSpace = name.find(" ");
+        if (nextSpace != std::string::npos)
+            name = name.substr(0, nextSpace);
+
+        if (name == "usemtl")
+        {
+            getMaterialDesc(dataIt, dataEnd);
+        }
+    }
+    break;
+
+    case 'm': // Parse a material library or merging group ('mg')
+    {
+        std::string name;
+
+        getNameNoSpace(dataIt, dataEnd, name);
+
+        size_t nextSpace = name.find(" ");
+        if (nextSpace != std::string::npos)
+            name = name.substr(0, nextSpace);
+
+        if (name == "mg")
+            getGroupNumberAndResolution(dataIt, dataEnd);
+        else if (name == "mtllib")
+            getMaterialLib(dataIt, dataEnd);
+    }
+    break;
+
+    case 'g': // Parse group name
+    {
+        getGroupName(dataIt, dataEnd);
+    }
+    break;
+
+    case 'o': // Parse object name
+    {
+        getObjectName(dataIt, dataEnd);
     }
+    break;
 
+    default:
+        break;
+    }
+}
+
+void ObjFileParser::addFace(ObjFile::Face *face, bool hasNormal)
+{
     // Set active material, if one set
     if (NULL != m_pModel->m_pCurrentMaterial)
     {
@@ -614,23 +869,22 @@ void ObjFileParser::getFace(aiPrimitiveType type)
     {
         m_pModel->m_pCurrentMesh->m_hasNormals = true;
     }
-    // Skip the rest of the line
-    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
 }
 
-void ObjFileParser::getMaterialDesc()
+void ObjFileParser::getMaterialDesc(DataArrayIt &dataIt,
+                                    const DataArrayIt dataEnd)
 {
     // Get next data for material data
-    m_DataIt = getNextToken<DataArrayIt>(m_DataIt, m_DataItEnd);
-    if (m_DataIt == m_DataItEnd)
+    dataIt = getNextToken<DataArrayIt>(dataIt, dataEnd);
+    if (dataIt == dataEnd)
     {
         return;
     }
 
-    char *pStart = &(*m_DataIt);
-    while (m_DataIt != m_DataItEnd && !IsLineEnd(*m_DataIt))
+    char *pStart = &(*dataIt);
+    while (dataIt != dataEnd && !IsLineEnd(*dataIt))
     {
-        ++m_DataIt;
+        ++dataIt;
     }
 
     // In some cases we should ignore this 'usemtl' command, this variable helps
@@ -638,7 +892,7 @@ void ObjFileParser::getMaterialDesc()
     bool skip = false;
 
     // Get name
-    std::string strName(pStart, &(*m_DataIt));
+    std::string strName(pStart, &(*dataIt));
     strName = trim_whitespaces(strName);
     if (strName.empty())
         skip = true;
@@ -688,35 +942,36 @@ void ObjFileParser::getMaterialDesc()
     }
 
     // Skip rest of line
-    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+    dataIt = skipLine<DataArrayIt>(dataIt, dataEnd, m_uiLine);
 }
 
 // -------------------------------------------------------------------
 //  Get a comment, values will be skipped
-void ObjFileParser::getComment()
+void ObjFileParser::getComment(DataArrayIt &dataIt, const DataArrayIt dataEnd)
 {
-    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+    dataIt = skipLine<DataArrayIt>(dataIt, dataEnd, m_uiLine);
 }
 
 // -------------------------------------------------------------------
 //  Get material library from file.
-void ObjFileParser::getMaterialLib()
+void ObjFileParser::getMaterialLib(DataArrayIt &dataIt,
+                                   const DataArrayIt dataEnd)
 {
     // Translate tuple
-    m_DataIt = getNextToken<DataArrayIt>(m_DataIt, m_DataItEnd);
-    if (m_DataIt == m_DataItEnd)
+    dataIt = getNextToken<DataArrayIt>(dataIt, dataEnd);
+    if (dataIt == dataEnd)
     {
         return;
     }
 
-    char *pStart = &(*m_DataIt);
-    while (m_DataIt != m_DataItEnd && !IsLineEnd(*m_DataIt))
+    char *pStart = &(*dataIt);
+    while (dataIt != dataEnd && !IsLineEnd(*dataIt))
     {
-        ++m_DataIt;
+        ++dataIt;
     }
 
     // Check for existence
-    const std::string strMatName(pStart, &(*m_DataIt));
+    const std::string strMatName(pStart, &(*dataIt));
     std::string absName;
 
     // Check if directive is valid.
@@ -758,7 +1013,7 @@ void ObjFileParser::getMaterialLib()
             DefaultLogger::get()->error(
                 "OBJ: Unable to locate fallback material file " +
                 strMatFallbackName);
-            m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+            dataIt = skipLine<DataArrayIt>(dataIt, dataEnd, m_uiLine);
             return;
         }
     }
@@ -781,20 +1036,21 @@ void ObjFileParser::getMaterialLib()
 
 // -------------------------------------------------------------------
 //  Set a new material definition as the current material.
-void ObjFileParser::getNewMaterial()
+void ObjFileParser::getNewMaterial(DataArrayIt &dataIt,
+                                   const DataArrayIt dataEnd)
 {
-    m_DataIt = getNextToken<DataArrayIt>(m_DataIt, m_DataItEnd);
-    m_DataIt = getNextWord<DataArrayIt>(m_DataIt, m_DataItEnd);
-    if (m_DataIt == m_DataItEnd)
+    dataIt = getNextToken<DataArrayIt>(dataIt, dataEnd);
+    dataIt = getNextWord<DataArrayIt>(dataIt, dataEnd);
+    if (dataIt == dataEnd)
     {
         return;
     }
 
-    char *pStart = &(*m_DataIt);
-    std::string strMat(pStart, *m_DataIt);
-    while (m_DataIt != m_DataItEnd && IsSpaceOrNewLine(*m_DataIt))
+    char *pStart = &(*dataIt);
+    std::string strMat(pStart, *dataIt);
+    while (dataIt != dataEnd && IsSpaceOrNewLine(*dataIt))
     {
-        ++m_DataIt;
+        ++dataIt;
     }
     std::map<std::string, ObjFile::Material *>::iterator it =
         m_pModel->m_MaterialMap.find(strMat);
@@ -815,7 +1071,7 @@ void ObjFileParser::getNewMaterial()
         m_pModel->m_pCurrentMesh->m_uiMaterialIndex = getMaterialIndex(strMat);
     }
 
-    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+    dataIt = skipLine<DataArrayIt>(dataIt, dataEnd, m_uiLine);
 }
 
 // -------------------------------------------------------------------
@@ -839,14 +1095,14 @@ int ObjFileParser::getMaterialIndex(const std::string &strMaterialName)
 
 // -------------------------------------------------------------------
 //  Getter for a group name.
-void ObjFileParser::getGroupName()
+void ObjFileParser::getGroupName(DataArrayIt &dataIt, const DataArrayIt dataEnd)
 {
     std::string groupName;
 
     // here we skip 'g ' from line
-    m_DataIt = getNextToken<DataArrayIt>(m_DataIt, m_DataItEnd);
-    m_DataIt = getName<DataArrayIt>(m_DataIt, m_DataItEnd, groupName);
-    if (isEndOfBuffer(m_DataIt, m_DataItEnd))
+    dataIt = getNextToken<DataArrayIt>(dataIt, dataEnd);
+    dataIt = getName<DataArrayIt>(dataIt, dataEnd, groupName);
+    if (isEndOfBuffer(dataIt, dataEnd))
     {
         return;
     }
@@ -874,44 +1130,47 @@ void ObjFileParser::getGroupName()
         }
         m_pModel->m_strActiveGroup = groupName;
     }
-    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+    dataIt = skipLine<DataArrayIt>(dataIt, dataEnd, m_uiLine);
 }
 
 // -------------------------------------------------------------------
 //  Not supported
-void ObjFileParser::getGroupNumber()
+void ObjFileParser::getGroupNumber(DataArrayIt &dataIt,
+                                   const DataArrayIt dataEnd)
 {
     // Not used
 
-    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+    dataIt = skipLine<DataArrayIt>(dataIt, dataEnd, m_uiLine);
 }
 
 // -------------------------------------------------------------------
 //  Not supported
-void ObjFileParser::getGroupNumberAndResolution()
+void ObjFileParser::getGroupNumberAndResolution(DataArrayIt &dataIt,
+                                                const DataArrayIt dataEnd)
 {
     // Not used
 
-    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+    dataIt = skipLine<DataArrayIt>(dataIt, dataEnd, m_uiLine);
 }
 
 // -------------------------------------------------------------------
 //  Stores values for a new object instance, name will be used to
 //  identify it.
-void ObjFileParser::getObjectName()
+void ObjFileParser::getObjectName(DataArrayIt &dataIt,
+                                  const DataArrayIt dataEnd)
 {
-    m_DataIt = getNextToken<DataArrayIt>(m_DataIt, m_DataItEnd);
-    if (m_DataIt == m_DataItEnd)
+    dataIt = getNextToken<DataArrayIt>(dataIt, dataEnd);
+    if (dataIt == dataEnd)
     {
         return;
     }
-    char *pStart = &(*m_DataIt);
-    while (m_DataIt != m_DataItEnd && !IsSpaceOrNewLine(*m_DataIt))
+    char *pStart = &(*dataIt);
+    while (dataIt != dataEnd && !IsSpaceOrNewLine(*dataIt))
     {
-        ++m_DataIt;
+        ++dataIt;
     }
 
-    std::string strObjectName(pStart, &(*m_DataIt));
+    std::string strObjectName(pStart, &(*dataIt));
     if (!strObjectName.empty())
     {
         // Reset current object
@@ -935,7 +1194,7 @@ void ObjFileParser::getObjectName()
             createObject(strObjectName);
         }
     }
-    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
+    dataIt = skipLine<DataArrayIt>(dataIt, dataEnd, m_uiLine);
 }
 // -------------------------------------------------------------------
 //  Creates a new object instance
@@ -1002,15 +1261,6 @@ bool ObjFileParser::needsNewMesh(const std::string &materialName)
     return newMat;
 }
 
-// -------------------------------------------------------------------
-//  Shows an error in parsing process.
-void ObjFileParser::reportErrorTokenInFace()
-{
-    m_DataIt = skipLine<DataArrayIt>(m_DataIt, m_DataItEnd, m_uiLine);
-    DefaultLogger::get()->error(
-        "OBJ: Not supported token in face description detected");
-}
-
 // -------------------------------------------------------------------
 
 } // Namespace Assimp
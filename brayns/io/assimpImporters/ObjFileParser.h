@@ -41,7 +41,6 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
-#include "IOStreamBuffer.h"
 #include <assimp/mesh.h>
 #include <assimp/vector2.h>
 #include <assimp/vector3.h>
@@ -56,6 +55,7 @@ namespace ObjFile
 struct Model;
 struct Object;
 struct Material;
+struct Face;
 struct Point3;
 struct Point2;
 } // namespace ObjFile
@@ -77,66 +77,46 @@ public:
 public:
     /// @brief  The default constructor.
     ObjFileParser();
-    /// @brief  Constructor with data array.
-    ObjFileParser(IOStreamBuffer<char> &streamBuffer,
-                  const std::string &modelName, IOSystem *io,
-                  ProgressHandler *progress,
+    /// @brief  Constructor with the content of the file.
+    ObjFileParser(const char *data, size_t size, const std::string &modelName,
+                  IOSystem *io, ProgressHandler *progress,
                   const std::string &originalObjFileName);
     /// @brief  Destructor
     ~ObjFileParser();
-    /// @brief  If you want to load in-core data.
-    void setBuffer(std::vector<char> &buffer);
     /// @brief  Model getter.
     ObjFile::Model *GetModel() const;
 
 protected:
-    /// Parse the loaded file
-    void parseFile(IOStreamBuffer<char> &streamBuffer);
-    /// Method to copy the new delimited word in the current line.
-    void copyNextWord(char *pBuffer, size_t length);
-    /// Method to copy the new line.
-    //    void copyNextLine(char *pBuffer, size_t length);
-    /// Get the number of components in a line.
-    size_t getNumComponentsInDataDefinition();
-    /// Stores the vector
-    void getVector(std::vector<aiVector3D> &point3d_array);
-    /// Stores the following 3d vector.
-    void getVector3(std::vector<aiVector3D> &point3d_array);
-    /// Stores the following homogeneous vector as a 3D vector
-    void getHomogeneousVector3(std::vector<aiVector3D> &point3d_array);
-    /// Stores the following two 3d vectors on the line.
-    void getTwoVectors3(std::vector<aiVector3D> &point3d_array_a,
-                        std::vector<aiVector3D> &point3d_array_b);
-    /// Stores the following 3d vector.
-    void getVector2(std::vector<aiVector2D> &point2d_array);
-    /// Stores the following face.
-    void getFace(aiPrimitiveType type);
+    /// Parse the loaded file, several chunks of lines at a time
+    void parseFile(const char *data, size_t size);
+    /// Parse an object, group or material statement
+    void parseStatement(DataArrayIt dataIt, DataArrayIt dataEnd);
+    /// Stores a face parsed from the file
+    void addFace(ObjFile::Face *face, bool hasNormal);
     /// Reads the material description.
-    void getMaterialDesc();
+    void getMaterialDesc(DataArrayIt &dataIt, DataArrayIt dataEnd);
     /// Gets a comment.
-    void getComment();
+    void getComment(DataArrayIt &dataIt, DataArrayIt dataEnd);
     /// Gets a a material library.
-    void getMaterialLib();
+    void getMaterialLib(DataArrayIt &dataIt, DataArrayIt dataEnd);
     /// Creates a new material.
-    void getNewMaterial();
+    void getNewMaterial(DataArrayIt &dataIt, DataArrayIt dataEnd);
     /// Gets the group name from file.
-    void getGroupName();
+    void getGroupName(DataArrayIt &dataIt, DataArrayIt dataEnd);
     /// Gets the group number from file.
-    void getGroupNumber();
+    void getGroupNumber(DataArrayIt &dataIt, DataArrayIt dataEnd);
     /// Gets the group number and resolution from file.
-    void getGroupNumberAndResolution();
+    void getGroupNumberAndResolution(DataArrayIt &dataIt, DataArrayIt dataEnd);
     /// Returns the index of the material. Is -1 if not material was found.
     int getMaterialIndex(const std::string &strMaterialName);
     /// Parse object name
-    void getObjectName();
+    void getObjectName(DataArrayIt &dataIt, DataArrayIt dataEnd);
     /// Creates a new object.
     void createObject(const std::string &strObjectName);
     /// Creates a new mesh.
     void createMesh(const std::string &meshName);
     /// Returns true, if a new mesh instance must be created.
     bool needsNewMesh(const std::string &rMaterialName);
-    /// Error report in token
-    void reportErrorTokenInFace();
 
 private:
     // Copy and assignment constructor should be private
@@ -146,16 +126,10 @@ private:
 
     /// Default material name
     static const std::string DEFAULT_MATERIAL;
-    //! Iterator to current position in buffer
-    DataArrayIt m_DataIt;
-    //! Iterator to end position of buffer
-    DataArrayIt m_DataItEnd;
     //! Pointer to model instance
     ObjFile::Model *m_pModel;
     //! Current line (for debugging)
     unsigned int m_uiLine;
-    //! Helper buffer
-    char m_buffer[Buffersize];
     /// Pointer to IO system instance.
     IOSystem *m_pIO;
     //! Pointer to progress handler
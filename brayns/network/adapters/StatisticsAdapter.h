@@ -27,8 +27,28 @@
 
 namespace brayns
 {
+BRAYNS_ADAPTER_BEGIN(MemoryUsage)
+BRAYNS_ADAPTER_ENTRY(spheres, "Spheres size in bytes")
+BRAYNS_ADAPTER_ENTRY(cylinders, "Cylinders size in bytes")
+BRAYNS_ADAPTER_ENTRY(cones, "Cones size in bytes")
+BRAYNS_ADAPTER_NAMED_ENTRY("sdf_beziers", sdfBeziers,
+                           "SDF beziers size in bytes")
+BRAYNS_ADAPTER_NAMED_ENTRY("triangle_meshes", triangleMeshes,
+                           "Triangle meshes size in bytes")
+BRAYNS_ADAPTER_ENTRY(streamlines, "Streamlines size in bytes")
+BRAYNS_ADAPTER_NAMED_ENTRY("sdf_geometries", sdfGeometries,
+                           "SDF geometries size in bytes")
+BRAYNS_ADAPTER_NAMED_ENTRY("meta_objects", metaObjects,
+                           "Meta objects size in bytes")
+BRAYNS_ADAPTER_ENTRY(volumes, "Volumes size in bytes")
+BRAYNS_ADAPTER_ENTRY(simulation, "Simulation data size in bytes")
+BRAYNS_ADAPTER_GET("total", getTotal, "Total size in bytes")
+BRAYNS_ADAPTER_END()
+
 BRAYNS_ADAPTER_BEGIN(Statistics)
 BRAYNS_ADAPTER_GET("fps", getFPS, "Framerate")
 BRAYNS_ADAPTER_GET("scene_size_in_bytes", getSceneSizeInBytes, "Scene size")
+BRAYNS_ADAPTER_GET("scene_memory_usage", getSceneMemoryUsage,
+                   "Scene size by type of data")
 BRAYNS_ADAPTER_END()
 } // namespace brayns
\ No newline at end of file
@@ -71,9 +71,42 @@ public:
     /**
      * @brief Associate the next binary packet with a model.
      *
+     * If an offset is given, the next packet is written at this offset of the
+     * model to resume an interrupted upload. It cannot be greater than the
+     * number of bytes already received.
+     *
      * @param id Chunks ID of the model.
+     * @param offset Offset of the next packet, negative to append.
      */
-    void setNextChunkId(const std::string& id) { _nextChunkId = id; }
+    void setNextChunkId(const std::string& id, int64_t offset = -1)
+    {
+        if (offset >= 0)
+        {
+            auto& task = _getTask(id);
+            auto currentSize = task.getCurrentSize();
+            if (task.isModelUploaded() || size_t(offset) > currentSize)
+            {
+                throw EntrypointException(
+                    "Cannot resume model upload with chunks ID '" + id +
+                    "' at offset " + std::to_string(offset) + ", " +
+                    std::to_string(currentSize) + " bytes received");
+            }
+        }
+        _nextChunkId = id;
+        _nextOffset = offset;
+    }
+
+    /**
+     * @brief Get the number of bytes received for a model.
+     *
+     * @param id Chunks ID of the model.
+     * @return size_t Offset from which the upload can be resumed.
+     */
+    size_t getUploadOffset(const std::string& id) const
+    {
+        auto& task = _getTask(id);
+        return task.getCurrentSize();
+    }
 
     /**
      * @brief Add a new binary packet to the current model.
@@ -92,7 +125,8 @@ public:
             return;
         }
         auto& task = *i->second;
-        task.addBlob(blob);
+        task.addBlob(blob, _nextOffset);
+        _nextOffset = -1;
     }
 
     /**
@@ -114,7 +148,19 @@ public:
     }
 
 private:
+    ModelUploadTask& _getTask(const std::string& id) const
+    {
+        auto i = _tasks.find(id);
+        if (i == _tasks.end())
+        {
+            throw EntrypointException("No model upload with chunks ID '" +
+                                      id + "'");
+        }
+        return *i->second;
+    }
+
     std::string _nextChunkId;
+    int64_t _nextOffset = -1;
     std::unordered_map<std::string, ModelUploadTaskPtr> _tasks;
 };
 
@@ -161,16 +207,27 @@ public:
      *
      * @param handle Client handle.
      * @param id Model chunks ID given at model upload request.
+     * @param offset Offset of the chunk in the model, negative to append.
      */
-    void setNextChunkId(const ConnectionHandle& handle, const std::string& id)
+    void setNextChunkId(const ConnectionHandle& handle, const std::string& id,
+                        int64_t offset = -1)
     {
-        auto i = _uploaders.find(handle);
-        if (i == _uploaders.end())
-        {
-            throw EntrypointException("No model uploads are running");
-        }
-        auto& uploader = i->second;
-        uploader.setNextChunkId(id);
+        auto& uploader = _getUploader(handle);
+        uploader.setNextChunkId(id, offset);
+    }
+
+    /**
+     * @brief Get the number of bytes of a model received from a client.
+     *
+     * @param handle Client handle.
+     * @param id Model chunks ID given at model upload request.
+     * @return size_t Offset from which the upload can be resumed.
+     */
+    size_t getUploadOffset(const ConnectionHandle& handle,
+                           const std::string& id)
+    {
+        auto& uploader = _getUploader(handle);
+        return uploader.getUploadOffset(id);
     }
 
     /**
@@ -194,6 +251,16 @@ public:
     }
 
 private:
+    ModelUploader& _getUploader(const ConnectionHandle& handle)
+    {
+        auto i = _uploaders.find(handle);
+        if (i == _uploaders.end())
+        {
+            throw EntrypointException("No model uploads are running");
+        }
+        return i->second;
+    }
+
     std::unordered_map<ConnectionHandle, ModelUploader> _uploaders;
 };
 } // namespace brayns
\ No newline at end of file
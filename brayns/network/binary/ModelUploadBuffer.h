@@ -0,0 +1,210 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <string>
+
+#include <brayns/common/log.h>
+#include <brayns/common/types.h>
+#include <brayns/common/utils/filesystem.h>
+
+#include <brayns/network/entrypoint/EntrypointException.h>
+
+namespace brayns
+{
+/**
+ * @brief Storage of the bytes of a model upload.
+ *
+ * Models smaller than the memory limit are stored in a preallocated buffer,
+ * bigger ones are written to a temporary file as they are received so the
+ * memory used by an upload does not depend on the model size. The temporary
+ * file is removed with the buffer.
+ *
+ */
+class ModelUploadBuffer
+{
+public:
+    ModelUploadBuffer() = default;
+
+    ~ModelUploadBuffer() { _removeFile(); }
+
+    ModelUploadBuffer(const ModelUploadBuffer&) = delete;
+    ModelUploadBuffer& operator=(const ModelUploadBuffer&) = delete;
+
+    /**
+     * @brief Prepare the storage of a new model.
+     *
+     * @param size Model size in bytes.
+     * @param type Model type, used as temporary file extension.
+     * @param memoryLimit Max model size stored in memory.
+     * @param folder Folder of the temporary file, system one if empty.
+     */
+    void open(size_t size, const std::string& type, size_t memoryLimit,
+              const std::string& folder)
+    {
+        _removeFile();
+        _data.clear();
+        _size = 0;
+        if (size <= memoryLimit)
+        {
+            _data.reserve(size);
+            return;
+        }
+        _path = _createPath(type, folder);
+        _file.open(_path, std::ios::binary | std::ios::trunc);
+        if (!_file)
+        {
+            _path.clear();
+            throw EntrypointException("Cannot create upload file in '" +
+                                      folder + "'");
+        }
+        BRAYNS_DEBUG << "Writing model upload to '" << _path << "'.\n";
+    }
+
+    /**
+     * @brief Check if the model is written to a file.
+     *
+     * @return true Model is stored in the file at getPath().
+     * @return false Model is stored in memory.
+     */
+    bool isFile() const { return !_path.empty(); }
+
+    /**
+     * @brief Get the path of the temporary file if any.
+     *
+     * @return const std::string& Temporary file path.
+     */
+    const std::string& getPath() const { return _path; }
+
+    /**
+     * @brief Get the number of bytes stored.
+     *
+     * @return size_t Size in bytes.
+     */
+    size_t getSize() const { return _size; }
+
+    /**
+     * @brief Append data to the model.
+     *
+     * @param data Model bytes.
+     */
+    void append(const std::string& data)
+    {
+        if (!isFile())
+        {
+            _data.insert(_data.end(), data.begin(), data.end());
+            _size = _data.size();
+            return;
+        }
+        _file.write(data.data(), data.size());
+        if (!_file)
+        {
+            throw EntrypointException("Cannot write upload file '" + _path +
+                                      "'");
+        }
+        _size += data.size();
+    }
+
+    /**
+     * @brief Drop the bytes after the given size, used to resend chunks.
+     *
+     * @param size New size, must not be greater than the current one.
+     */
+    void truncate(size_t size)
+    {
+        if (size >= _size)
+        {
+            return;
+        }
+        _size = size;
+        if (!isFile())
+        {
+            _data.resize(size);
+            return;
+        }
+        _file.close();
+        fs::resize_file(_path, size);
+        _file.open(_path, std::ios::binary | std::ios::app);
+        if (!_file)
+        {
+            throw EntrypointException("Cannot reopen upload file '" + _path +
+                                      "'");
+        }
+    }
+
+    /**
+     * @brief Flush the temporary file once all bytes are received.
+     *
+     */
+    void close()
+    {
+        if (!_file.is_open())
+        {
+            return;
+        }
+        _file.close();
+        if (_file.fail())
+        {
+            throw EntrypointException("Cannot write upload file '" + _path +
+                                      "'");
+        }
+    }
+
+    /**
+     * @brief Move the model bytes stored in memory.
+     *
+     * @return uint8_ts Model bytes.
+     */
+    uint8_ts takeData() { return std::move(_data); }
+
+private:
+    static std::string _createPath(const std::string& type,
+                                   const std::string& folder)
+    {
+        static std::atomic<uint64_t> counter{0};
+        auto directory = folder.empty() ? fs::temp_directory_path()
+                                        : fs::path(folder);
+        auto time = std::chrono::steady_clock::now().time_since_epoch();
+        auto name = "brayns_upload_" + std::to_string(time.count()) + "_" +
+                    std::to_string(counter++) + "." + type;
+        return (directory / name).string();
+    }
+
+    void _removeFile()
+    {
+        if (_path.empty())
+        {
+            return;
+        }
+        _file.close();
+        std::error_code error;
+        fs::remove(_path, error);
+        _path.clear();
+    }
+
+    uint8_ts _data;
+    size_t _size = 0;
+    std::string _path;
+    std::ofstream _file;
+};
+} // namespace brayns
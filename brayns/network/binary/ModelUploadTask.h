@@ -25,17 +25,23 @@
 
 #include <brayns/engine/Engine.h>
 #include <brayns/engine/Scene.h>
+#include <brayns/parameters/NetworkParameters.h>
 
 #include <brayns/network/adapters/BinaryParamAdapter.h>
 #include <brayns/network/adapters/ModelDescriptorAdapter.h>
 #include <brayns/network/entrypoint/EntrypointTask.h>
-#include <brayns/network/tasks/NetworkTaskMonitor.h>
+
+#include "ModelUploadBuffer.h"
 
 namespace brayns
 {
 /**
  * @brief Task implementation to execute a binary model upload.
  *
+ * Big models are written to a temporary file while they are received (see
+ * ModelUploadBuffer) and loaded from it. The task is deferred: it is given a
+ * worker of the pool only once all the chunks have been received.
+ *
  */
 class ModelUploadTask : public EntrypointTask<BinaryParam, ModelDescriptors>
 {
@@ -44,9 +50,11 @@ public:
      * @brief Construct a new task with engine access.
      *
      * @param engine Engine used to create the model.
+     * @param parameters Network parameters with upload settings.
      */
-    ModelUploadTask(Engine& engine)
+    ModelUploadTask(Engine& engine, const NetworkParameters& parameters)
         : _engine(&engine)
+        , _parameters(&parameters)
     {
     }
 
@@ -69,11 +77,7 @@ public:
      *
      * @return size_t Number of bytes received.
      */
-    size_t getCurrentSize() const
-    {
-        auto& data = _blob.data;
-        return data.size();
-    }
+    size_t getCurrentSize() const { return _buffer.getSize(); }
 
     /**
      * @brief Get the upload percentage progress (bytes received / model size).
@@ -85,16 +89,29 @@ public:
         return double(getCurrentSize()) / double(getModelSize());
     }
 
+    /**
+     * @brief Check if all the bytes of the model have been received.
+     *
+     * @return true Upload is finished, the model is loading.
+     * @return false Chunks are still expected.
+     */
+    bool isModelUploaded() const { return _modelUploaded; }
+
     /**
      * @brief Add a new binary blob to the model source.
      *
+     * If an offset is given, the bytes received after it are discarded and
+     * the blob is written at this offset, allowing clients to resend the
+     * chunks of an interrupted upload.
+     *
      * @param blob Blob binary data.
+     * @param offset Offset of the blob in the model, negative to append.
      */
-    void addBlob(const std::string& blob)
+    void addBlob(const std::string& blob, int64_t offset = -1)
     {
         try
         {
-            _addBlob(blob);
+            _addBlob(blob, offset);
         }
         catch (...)
         {
@@ -103,21 +120,36 @@ public:
     }
 
     /**
-     * @brief Wait for upload finished and perform the model loading.
+     * @brief Load the model once uploaded.
      *
      */
     virtual void run() override
     {
-        _monitor.wait();
         checkCancelled();
         auto& scene = _engine->getScene();
-        _descriptors =
-            scene.loadModels(std::move(_blob), _params,
-                             {[this](const auto& operation, auto amount) {
-                                 _loadingProgress(operation, amount);
-                             }});
+        LoaderProgress callback([this](const auto& operation, auto amount) {
+            _loadingProgress(operation, amount);
+        });
+        if (_buffer.isFile())
+        {
+            _descriptors =
+                scene.loadModels(_buffer.getPath(), _params, callback);
+            return;
+        }
+        Blob blob;
+        blob.type = _params.type;
+        blob.name = _params.getName();
+        blob.data = _buffer.takeData();
+        _descriptors = scene.loadModels(std::move(blob), _params, callback);
     }
 
+    /**
+     * @brief Wait for all the chunks before scheduling the loading.
+     *
+     * @return true Always deferred.
+     */
+    virtual bool isDeferred() const override { return true; }
+
     /**
      * @brief Prepare the model upload using request params.
      *
@@ -127,9 +159,9 @@ public:
         _modelUploaded = false;
         _params = getParams();
         _validateParams();
-        _blob.type = _params.type;
-        _blob.name = _params.getName();
-        _blob.data.clear();
+        _buffer.open(_params.size, _params.type,
+                     _parameters->getUploadMemoryLimit(),
+                     _parameters->getUploadFolder());
     }
 
     /**
@@ -148,12 +180,6 @@ public:
      */
     virtual void onDisconnect() override { cancel(); }
 
-    /**
-     * @brief Stop waiting for upload if cancelled.
-     *
-     */
-    virtual void onCancel() override { _monitor.notify(); }
-
 private:
     void _validateParams()
     {
@@ -174,11 +200,12 @@ private:
         }
     }
 
-    void _addBlob(const std::string& blob)
+    void _addBlob(const std::string& blob, int64_t offset)
     {
         _throwIfModelAlreadyUploaded();
+        _seek(offset);
         _throwIfBlobIsTooBig(blob);
-        _addBlobData(blob);
+        _buffer.append(blob);
         _uploadProgress();
         _checkIfUploadIsFinished();
     }
@@ -206,10 +233,21 @@ private:
         throw EntrypointException(stream.str());
     }
 
-    void _addBlobData(const std::string& blob)
+    void _seek(int64_t offset)
     {
-        auto& data = _blob.data;
-        data.insert(data.end(), blob.begin(), blob.end());
+        if (offset < 0)
+        {
+            return;
+        }
+        auto currentSize = getCurrentSize();
+        if (size_t(offset) > currentSize)
+        {
+            std::ostringstream stream;
+            stream << "Invalid chunk offset: " << offset
+                   << " bytes received = " << currentSize;
+            throw EntrypointException(stream.str());
+        }
+        _buffer.truncate(size_t(offset));
     }
 
     void _checkIfUploadIsFinished()
@@ -218,8 +256,9 @@ private:
         {
             return;
         }
+        _buffer.close();
         _modelUploaded = true;
-        _monitor.notify();
+        resume();
     }
 
     void _uploadProgress()
@@ -234,10 +273,10 @@ private:
     }
 
     Engine* _engine;
+    const NetworkParameters* _parameters;
     BinaryParam _params;
-    Blob _blob;
+    ModelUploadBuffer _buffer;
     ModelDescriptors _descriptors;
-    NetworkTaskMonitor _monitor;
     bool _modelUploaded = false;
 };
 
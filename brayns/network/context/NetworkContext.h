@@ -54,6 +54,9 @@ public:
         : _api(&api)
         , _entrypoints(*this)
         , _stream(*this)
+        , _tasks(api.getParametersManager()
+                     .getNetworkParameters()
+                     .getTaskThreadCount())
     {
     }
 
@@ -42,7 +42,7 @@ public:
         auto& handle = request.getConnectionHandle();
         auto& id = params.id;
         auto& binary = getBinary();
-        binary.setNextChunkId(handle, id);
+        binary.setNextChunkId(handle, id, params.offset);
         request.reply(EmptyMessage());
     }
 };
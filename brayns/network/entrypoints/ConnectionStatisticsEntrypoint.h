@@ -0,0 +1,63 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <brayns/network/entrypoint/Entrypoint.h>
+#include <brayns/network/messages/ConnectionStatisticsMessage.h>
+
+namespace brayns
+{
+class GetConnectionStatisticsEntrypoint
+    : public Entrypoint<EmptyMessage, std::vector<ConnectionStatisticsMessage>>
+{
+public:
+    virtual std::string getName() const override
+    {
+        return "get-connection-statistics";
+    }
+
+    virtual std::string getDescription() const override
+    {
+        return "Get the outbound queue depth and drop counters of each client";
+    }
+
+    virtual void onRequest(const Request& request) override
+    {
+        auto& connections = getConnections();
+        auto statistics = connections.getStatistics();
+        std::vector<ConnectionStatisticsMessage> messages;
+        messages.reserve(statistics.size());
+        for (const auto& pair : statistics)
+        {
+            auto& handle = pair.first;
+            auto& queue = pair.second;
+            ConnectionStatisticsMessage message;
+            message.id = handle.getId();
+            message.queue_size = queue.queueSize;
+            message.dropped_frames = queue.droppedFrames;
+            message.sent_packets = queue.sentPackets;
+            messages.push_back(message);
+        }
+        request.reply(messages);
+    }
+};
+} // namespace brayns
@@ -0,0 +1,52 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <brayns/network/entrypoint/Entrypoint.h>
+#include <brayns/network/messages/ModelUploadOffsetMessage.h>
+
+namespace brayns
+{
+class GetModelUploadOffsetEntrypoint
+    : public Entrypoint<GetModelUploadOffsetMessage, ModelUploadOffsetMessage>
+{
+public:
+    virtual std::string getName() const override
+    {
+        return "get-model-upload-offset";
+    }
+
+    virtual std::string getDescription() const override
+    {
+        return "Get the number of bytes received for a running model upload, "
+               "chunks can be resent from this offset";
+    }
+
+    virtual void onRequest(const Request& request) override
+    {
+        auto params = request.getParams();
+        auto& handle = request.getConnectionHandle();
+        auto& binary = getBinary();
+        ModelUploadOffsetMessage result;
+        result.offset = binary.getUploadOffset(handle, params.chunks_id);
+        request.reply(result);
+    }
+};
+} // namespace brayns
@@ -0,0 +1,59 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <brayns/network/entrypoint/Entrypoint.h>
+#include <brayns/network/messages/ImageStreamSettingsMessage.h>
+
+namespace brayns
+{
+class ImageStreamSettingsEntrypoint
+    : public Entrypoint<ImageStreamSettingsMessage, EmptyMessage>
+{
+public:
+    virtual std::string getName() const override
+    {
+        return "set-image-stream-settings";
+    }
+
+    virtual std::string getDescription() const override
+    {
+        return "Set the JPEG quality and chroma subsampling of the images "
+               "streamed to the calling client";
+    }
+
+    virtual void onRequest(const Request& request) override
+    {
+        auto params = request.getParams();
+        if (params.quality < 1 || params.quality > 100)
+        {
+            throw EntrypointException("Invalid JPEG quality: " +
+                                      std::to_string(params.quality));
+        }
+        ImageStreamSettings settings;
+        settings.quality = uint8_t(params.quality);
+        settings.subsampling = params.subsampling;
+        auto& handle = request.getConnectionHandle();
+        auto& imageStream = getStream().getImageStream();
+        imageStream.setClientSettings(handle, settings);
+        request.reply(EmptyMessage());
+    }
+};
+} // namespace brayns
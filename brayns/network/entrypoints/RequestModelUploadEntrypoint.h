@@ -22,6 +22,7 @@
 #pragma once
 
 #include <brayns/engine/Scene.h>
+#include <brayns/parameters/ParametersManager.h>
 
 #include <brayns/network/binary/ModelUploadTask.h>
 #include <brayns/network/entrypoint/Entrypoint.h>
@@ -47,8 +48,10 @@ public:
 
     virtual void onRequest(const Request& request) override
     {
-        auto& engine = getApi().getEngine();
-        auto task = std::make_shared<ModelUploadTask>(engine);
+        auto& api = getApi();
+        auto& engine = api.getEngine();
+        auto& parameters = api.getParametersManager().getNetworkParameters();
+        auto task = std::make_shared<ModelUploadTask>(engine, parameters);
         launchTask(task, request);
         auto& binary = getBinary();
         auto& handle = request.getConnectionHandle();
@@ -43,6 +43,11 @@ public:
             });
     }
 
+    virtual NetworkTaskPriority getPriority() const override
+    {
+        return NetworkTaskPriority::high;
+    }
+
     virtual void run() override { _image = _functor(); }
 
     virtual void onComplete() override { reply(_image); }
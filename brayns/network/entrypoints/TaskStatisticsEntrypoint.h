@@ -0,0 +1,56 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <brayns/network/entrypoint/Entrypoint.h>
+#include <brayns/network/messages/TaskStatisticsMessage.h>
+
+namespace brayns
+{
+class GetTaskStatisticsEntrypoint
+    : public Entrypoint<EmptyMessage, TaskStatisticsMessage>
+{
+public:
+    virtual std::string getName() const override
+    {
+        return "get-task-statistics";
+    }
+
+    virtual std::string getDescription() const override
+    {
+        return "Get the queue depth and wait times of the task threads";
+    }
+
+    virtual void onRequest(const Request& request) override
+    {
+        auto& tasks = getTasks();
+        auto statistics = tasks.getStatistics();
+        TaskStatisticsMessage message;
+        message.thread_count = statistics.threadCount;
+        message.running_tasks = statistics.runningTasks;
+        message.queue_size = statistics.queueSize;
+        message.started_tasks = statistics.startedTasks;
+        message.cancelled_tasks = statistics.cancelledTasks;
+        message.average_wait_time = statistics.averageWaitTime;
+        message.max_wait_time = statistics.maxWaitTime;
+        request.reply(message);
+    }
+};
+} // namespace brayns
@@ -27,5 +27,10 @@ namespace brayns
 {
 BRAYNS_MESSAGE_BEGIN(ChunkMessage)
 BRAYNS_MESSAGE_ENTRY(std::string, id, "Chunk ID")
+BRAYNS_MESSAGE_PROPERTY(int64_t, offset,
+                        brayns::Description(
+                            "Offset of the chunk in the model to resume an "
+                            "upload, appended to the received bytes if unset"),
+                        brayns::Default(-1))
 BRAYNS_MESSAGE_END()
 } // namespace brayns
\ No newline at end of file
@@ -0,0 +1,33 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <brayns/network/json/Message.h>
+
+namespace brayns
+{
+BRAYNS_MESSAGE_BEGIN(ConnectionStatisticsMessage)
+BRAYNS_MESSAGE_ENTRY(size_t, id, "Client connection ID")
+BRAYNS_MESSAGE_ENTRY(size_t, queue_size, "Number of packets waiting to be sent")
+BRAYNS_MESSAGE_ENTRY(size_t, dropped_frames,
+                     "Number of image frames dropped for this client")
+BRAYNS_MESSAGE_ENTRY(size_t, sent_packets, "Number of packets sent")
+BRAYNS_MESSAGE_END()
+} // namespace brayns
@@ -0,0 +1,36 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <brayns/common/utils/ImageGenerator.h>
+#include <brayns/network/json/Message.h>
+
+namespace brayns
+{
+BRAYNS_ADAPTER_ENUM(ChromaSubsampling, {"444", ChromaSubsampling::yuv444},
+                    {"422", ChromaSubsampling::yuv422},
+                    {"420", ChromaSubsampling::yuv420})
+
+BRAYNS_MESSAGE_BEGIN(ImageStreamSettingsMessage)
+BRAYNS_MESSAGE_ENTRY(int, quality, "JPEG quality (1-100)")
+BRAYNS_MESSAGE_ENTRY(ChromaSubsampling, subsampling,
+                     "JPEG chroma subsampling ('444', '422' or '420')")
+BRAYNS_MESSAGE_END()
+} // namespace brayns
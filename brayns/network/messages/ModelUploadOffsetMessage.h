@@ -0,0 +1,34 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <brayns/network/json/Message.h>
+
+namespace brayns
+{
+BRAYNS_MESSAGE_BEGIN(GetModelUploadOffsetMessage)
+BRAYNS_MESSAGE_ENTRY(std::string, chunks_id, "Chunks ID of the model upload")
+BRAYNS_MESSAGE_END()
+
+BRAYNS_MESSAGE_BEGIN(ModelUploadOffsetMessage)
+BRAYNS_MESSAGE_ENTRY(size_t, offset,
+                     "Number of bytes received, offset of the next chunk")
+BRAYNS_MESSAGE_END()
+} // namespace brayns
@@ -0,0 +1,38 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <brayns/network/json/Message.h>
+
+namespace brayns
+{
+BRAYNS_MESSAGE_BEGIN(TaskStatisticsMessage)
+BRAYNS_MESSAGE_ENTRY(size_t, thread_count, "Number of task threads")
+BRAYNS_MESSAGE_ENTRY(size_t, running_tasks, "Number of tasks running")
+BRAYNS_MESSAGE_ENTRY(size_t, queue_size, "Number of tasks waiting for a thread")
+BRAYNS_MESSAGE_ENTRY(size_t, started_tasks, "Number of tasks started")
+BRAYNS_MESSAGE_ENTRY(size_t, cancelled_tasks,
+                     "Number of tasks cancelled before they started")
+BRAYNS_MESSAGE_ENTRY(double, average_wait_time,
+                     "Mean time spent in queue by started tasks [ms]")
+BRAYNS_MESSAGE_ENTRY(double, max_wait_time,
+                     "Longest time spent in queue by a started task [ms]")
+BRAYNS_MESSAGE_END()
+} // namespace brayns
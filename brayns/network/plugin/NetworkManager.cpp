@@ -175,6 +175,9 @@ private:
     {
         auto& tasks = context.getTasks();
         tasks.disconnect(handle);
+        auto& stream = context.getStream();
+        auto& imageStream = stream.getImageStream();
+        imageStream.removeClient(handle);
         BRAYNS_INFO << "Connection closed: " << handle.getId() << ".\n";
     }
 
@@ -31,6 +31,7 @@
 #include <brayns/network/entrypoints/CancelEntrypoint.h>
 #include <brayns/network/entrypoints/ChunkEntrypoint.h>
 #include <brayns/network/entrypoints/ClearLightsEntrypoint.h>
+#include <brayns/network/entrypoints/ConnectionStatisticsEntrypoint.h>
 #include <brayns/network/entrypoints/EnvironmentMapEntrypoint.h>
 #include <brayns/network/entrypoints/ExitLaterEntrypoint.h>
 #include <brayns/network/entrypoints/GetClipPlanesEntrypoint.h>
@@ -38,7 +39,9 @@
 #include <brayns/network/entrypoints/GetLightsEntrypoint.h>
 #include <brayns/network/entrypoints/GetLoadersEntrypoint.h>
 #include <brayns/network/entrypoints/GetModelEntrypoint.h>
+#include <brayns/network/entrypoints/GetModelUploadOffsetEntrypoint.h>
 #include <brayns/network/entrypoints/ImageJpegEntrypoint.h>
+#include <brayns/network/entrypoints/ImageStreamSettingsEntrypoint.h>
 #include <brayns/network/entrypoints/ImageStreamingModeEntrypoint.h>
 #include <brayns/network/entrypoints/InspectEntrypoint.h>
 #include <brayns/network/entrypoints/LoadersSchemaEntrypoint.h>
@@ -57,6 +60,7 @@
 #include <brayns/network/entrypoints/SchemaEntrypoint.h>
 #include <brayns/network/entrypoints/SnapshotEntrypoint.h>
 #include <brayns/network/entrypoints/StatisticsEntrypoint.h>
+#include <brayns/network/entrypoints/TaskStatisticsEntrypoint.h>
 #include <brayns/network/entrypoints/TriggerJpegStreamEntrypoint.h>
 #include <brayns/network/entrypoints/UpdateClipPlaneEntrypoint.h>
 #include <brayns/network/entrypoints/UpdateInstanceEntrypoint.h>
@@ -89,6 +93,7 @@ public:
         plugin.add<ImageJpegEntrypoint>();
         plugin.add<TriggerJpegStreamEntrypoint>();
         plugin.add<ImageStreamingModeEntrypoint>();
+        plugin.add<ImageStreamSettingsEntrypoint>();
         plugin.add<GetRendererEntrypoint>();
         plugin.add<SetRendererEntrypoint>();
         plugin.add<VersionEntrypoint>();
@@ -99,6 +104,8 @@ public:
         plugin.add<GetSceneEntrypoint>();
         plugin.add<SetSceneEntrypoint>();
         plugin.add<GetStatisticsEntrypoint>();
+        plugin.add<GetConnectionStatisticsEntrypoint>();
+        plugin.add<GetTaskStatisticsEntrypoint>();
         plugin.add<SchemaEntrypoint>();
         plugin.add<InspectEntrypoint>();
         plugin.add<QuitEntrypoint>();
@@ -107,6 +114,7 @@ public:
         plugin.add<SnapshotEntrypoint>();
         plugin.add<RequestModelUploadEntrypoint>();
         plugin.add<ChunkEntrypoint>();
+        plugin.add<GetModelUploadOffsetEntrypoint>();
         plugin.add<GetEnvironmentMapEntrypoint>();
         plugin.add<SetEnvironmentMapEntrypoint>();
         plugin.add<AddModelEntrypoint>();
@@ -23,6 +23,7 @@
 
 #include <vector>
 
+#include "ConnectionQueue.h"
 #include "NetworkSocket.h"
 
 namespace brayns
@@ -61,6 +62,12 @@ struct Connection
      */
     NetworkSocketPtr socket;
 
+    /**
+     * @brief Outbound packet queue sending data to the client asynchronously.
+     *
+     */
+    ConnectionQueuePtr queue;
+
     /**
      * @brief Check if the socket was added after the previous loop iteration.
      *
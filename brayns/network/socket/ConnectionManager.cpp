@@ -61,21 +61,23 @@ class ConnectionUpdater
 {
 public:
     static RequestBuffer update(ConnectionMap& connections,
-                                const ConnectionListener& listener)
+                                const ConnectionListener& listener,
+                                std::vector<Connection>& removed)
     {
         RequestBuffer buffer(connections.getConnectionCount());
-        connections.removeIf([&](const auto& handle, auto& connection) {
-            if (_tryDisconnect(handle, connection, listener))
-            {
-                return true;
-            }
-            if (_tryConnect(handle, connection, listener))
-            {
-                connection.added = false;
-            }
-            buffer.extract(handle, connection);
-            return false;
-        });
+        removed =
+            connections.removeIf([&](const auto& handle, auto& connection) {
+                if (_tryDisconnect(handle, connection, listener))
+                {
+                    return true;
+                }
+                if (_tryConnect(handle, connection, listener))
+                {
+                    connection.added = false;
+                }
+                buffer.extract(handle, connection);
+                return false;
+            });
         return buffer;
     }
 
@@ -159,40 +161,68 @@ void ConnectionManager::send(const ConnectionHandle& handle,
     {
         return;
     }
-    auto& socket = connection->socket;
-    socket->send(packet);
+    auto& queue = connection->queue;
+    queue->push(std::make_shared<QueuedPacket>(packet));
 }
 
 void ConnectionManager::broadcast(const OutputPacket& packet)
 {
+    broadcast([](const auto& handle) { return true; }, packet);
+}
+
+void ConnectionManager::broadcast(const ConnectionHandle& source,
+                                  const OutputPacket& packet)
+{
+    broadcast([&](const auto& handle) { return handle != source; }, packet);
+}
+
+void ConnectionManager::broadcast(
+    const std::function<bool(const ConnectionHandle&)>& filter,
+    const OutputPacket& packet)
+{
+    QueuedPacketPtr queuedPacket;
     std::lock_guard<std::mutex> lock(_mutex);
     _connections.forEach([&](const auto& handle, const auto& connection) {
-        auto& socket = connection.socket;
-        socket->send(packet);
+        if (connection.removed || !filter(handle))
+        {
+            return;
+        }
+        if (!queuedPacket)
+        {
+            queuedPacket = std::make_shared<QueuedPacket>(packet);
+        }
+        auto& queue = connection.queue;
+        queue->push(queuedPacket);
     });
 }
 
-void ConnectionManager::broadcast(const ConnectionHandle& source,
-                                  const OutputPacket& packet)
+std::vector<std::pair<ConnectionHandle, ConnectionStatistics>>
+    ConnectionManager::getStatistics()
 {
+    std::vector<std::pair<ConnectionHandle, ConnectionStatistics>> statistics;
     std::lock_guard<std::mutex> lock(_mutex);
+    statistics.reserve(_connections.getConnectionCount());
     _connections.forEach([&](const auto& handle, const auto& connection) {
-        if (handle == source)
+        if (connection.removed)
         {
             return;
         }
-        auto& socket = connection.socket;
-        socket->send(packet);
+        auto& queue = connection.queue;
+        statistics.emplace_back(handle, queue->getStatistics());
     });
+    return statistics;
 }
 
 void ConnectionManager::update()
 {
     RequestBuffer buffer;
+    std::vector<Connection> removed;
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        buffer = ConnectionUpdater::update(_connections, _listener);
+        buffer = ConnectionUpdater::update(_connections, _listener, removed);
     }
+    // Join the writer threads of removed clients without holding the lock
+    removed.clear();
     if (!_listener.onRequest)
     {
         return;
@@ -207,6 +237,7 @@ void ConnectionManager::closeAll()
     std::lock_guard<std::mutex> lock(_mutex);
     _connections.forEach([](auto& handle, auto& connection) {
         auto& socket = connection.socket;
+        socket->shutdown();
         socket->close();
     });
 }
@@ -21,7 +21,10 @@
 
 #pragma once
 
+#include <functional>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 #include "ConnectionListener.h"
 #include "ConnectionMap.h"
@@ -76,6 +79,9 @@ public:
     /**
      * @brief Send a packet to a client.
      *
+     * The packet is copied in the client outbound queue and sent
+     * asynchronously, this method never blocks on the socket.
+     *
      * @param handle Receiver handle.
      * @param packet Data packet.
      */
@@ -96,6 +102,26 @@ public:
      */
     void broadcast(const ConnectionHandle& source, const OutputPacket& packet);
 
+    /**
+     * @brief Send a packet to all clients accepted by the filter.
+     *
+     * The packet content is copied once and shared by all receivers.
+     *
+     * @param filter Functor returning true if the client must receive it.
+     * @param packet Data packet.
+     */
+    void broadcast(const std::function<bool(const ConnectionHandle&)>& filter,
+                   const OutputPacket& packet);
+
+    /**
+     * @brief Get the outbound queue statistics of each connected client.
+     *
+     * @return std::vector<std::pair<ConnectionHandle, ConnectionStatistics>>
+     * Statistics indexed by client handle.
+     */
+    std::vector<std::pair<ConnectionHandle, ConnectionStatistics>>
+        getStatistics();
+
     /**
      * @brief Update all connections from the main loop.
      *
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 
 #include "Connection.h"
 #include "ConnectionHandle.h"
@@ -50,6 +51,7 @@ public:
     void add(NetworkSocketPtr socket)
     {
         auto& connection = _connections[socket];
+        connection.queue = std::make_shared<ConnectionQueue>(socket);
         connection.socket = std::move(socket);
     }
 
@@ -74,20 +76,32 @@ public:
         }
     }
 
+    /**
+     * @brief Remove the connections matching the given predicate.
+     *
+     * The removed connections are returned so the caller can destroy them
+     * (which joins their writer thread) after releasing its own lock.
+     *
+     * @param functor Predicate called with each handle and connection.
+     * @return std::vector<Connection> Removed connections.
+     */
     template <typename FunctorType>
-    void removeIf(FunctorType functor)
+    std::vector<Connection> removeIf(FunctorType functor)
     {
+        std::vector<Connection> removed;
         for (auto i = _connections.begin(); i != _connections.end();)
         {
             auto& handle = i->first;
             auto& connection = i->second;
             if (functor(handle, connection))
             {
+                removed.push_back(std::move(connection));
                 i = _connections.erase(i);
                 continue;
             }
             ++i;
         }
+        return removed;
     }
 
 private:
@@ -0,0 +1,129 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "ConnectionQueue.h"
+
+#include <brayns/common/log.h>
+
+namespace brayns
+{
+ConnectionQueue::ConnectionQueue(NetworkSocketPtr socket, size_t maxFrameCount)
+    : _socket(std::move(socket))
+    , _maxFrameCount(std::max(maxFrameCount, size_t(1)))
+{
+    _writer = std::thread([this] { _run(); });
+}
+
+ConnectionQueue::~ConnectionQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+    }
+    _condition.notify_one();
+    // Unblock the writer if it is stuck sending to a client not reading
+    _socket->shutdown();
+    _writer.join();
+}
+
+void ConnectionQueue::push(QueuedPacketPtr packet)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_closed)
+        {
+            return;
+        }
+        if (packet->isBinary())
+        {
+            if (_frameCount >= _maxFrameCount)
+            {
+                _dropOldestFrame();
+            }
+            ++_frameCount;
+        }
+        _packets.push_back(std::move(packet));
+        _statistics.queueSize = _packets.size();
+    }
+    _condition.notify_one();
+}
+
+ConnectionStatistics ConnectionQueue::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
+}
+
+void ConnectionQueue::_run()
+{
+    while (auto packet = _pop())
+    {
+        try
+        {
+            _socket->send(packet->getPacket());
+        }
+        catch (const ConnectionClosedException& e)
+        {
+            BRAYNS_DEBUG << "Connection closed during send: " << e.what()
+                         << ".\n";
+            std::lock_guard<std::mutex> lock(_mutex);
+            _closed = true;
+            _packets.clear();
+            _frameCount = 0;
+            _statistics.queueSize = 0;
+            return;
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_statistics.sentPackets;
+    }
+}
+
+QueuedPacketPtr ConnectionQueue::_pop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this] { return _closed || !_packets.empty(); });
+    if (_closed)
+    {
+        return nullptr;
+    }
+    auto packet = std::move(_packets.front());
+    _packets.pop_front();
+    if (packet->isBinary())
+    {
+        --_frameCount;
+    }
+    _statistics.queueSize = _packets.size();
+    return packet;
+}
+
+void ConnectionQueue::_dropOldestFrame()
+{
+    auto i = std::find_if(_packets.begin(), _packets.end(),
+                          [](const auto& packet) {
+                              return packet->isBinary();
+                          });
+    if (i == _packets.end())
+    {
+        return;
+    }
+    _packets.erase(i);
+    --_frameCount;
+    ++_statistics.droppedFrames;
+}
+} // namespace brayns
@@ -0,0 +1,179 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "NetworkSocket.h"
+
+namespace brayns
+{
+/**
+ * @brief Owning copy of an output packet waiting to be sent.
+ *
+ * Shared between the queues of all receivers when broadcasted so the content
+ * is copied only once.
+ *
+ */
+class QueuedPacket
+{
+public:
+    /**
+     * @brief Copy the content of the packet.
+     *
+     * @param packet Packet to store.
+     */
+    QueuedPacket(const OutputPacket& packet)
+        : _data(static_cast<const char*>(packet.getData()),
+                size_t(std::max(packet.getSize(), 0)))
+        , _binary(packet.isBinary())
+    {
+    }
+
+    /**
+     * @brief Check if the packet is a binary packet.
+     *
+     * Binary packets are image frames which can be dropped if the client is
+     * too slow to receive them.
+     *
+     * @return true Binary packet.
+     * @return false Text packet.
+     */
+    bool isBinary() const { return _binary; }
+
+    /**
+     * @brief Create a non owning packet to send the stored content.
+     *
+     * @return OutputPacket Packet referencing the stored content.
+     */
+    OutputPacket getPacket() const
+    {
+        if (_binary)
+        {
+            return {_data.data(), int(_data.size())};
+        }
+        return {_data};
+    }
+
+private:
+    std::string _data;
+    bool _binary = false;
+};
+
+using QueuedPacketPtr = std::shared_ptr<const QueuedPacket>;
+
+/**
+ * @brief Snapshot of the state of a client outbound queue.
+ *
+ */
+struct ConnectionStatistics
+{
+    /**
+     * @brief Number of packets waiting to be sent.
+     *
+     */
+    size_t queueSize = 0;
+
+    /**
+     * @brief Number of image frames dropped because the client was too slow.
+     *
+     */
+    size_t droppedFrames = 0;
+
+    /**
+     * @brief Number of packets sent to the client.
+     *
+     */
+    size_t sentPackets = 0;
+};
+
+/**
+ * @brief Outbound packet queue of a client with its own writer thread.
+ *
+ * Packets are pushed without blocking and sent in order by the writer thread
+ * so a slow client doesn't slow down the others. Text packets (JSON replies
+ * and notifications) are always delivered. Binary packets (image frames) are
+ * bounded: when the limit is reached, the oldest pending frame is dropped.
+ *
+ * This object is thread safe (synchronized).
+ *
+ */
+class ConnectionQueue
+{
+public:
+    /**
+     * @brief Start the writer thread of the given socket.
+     *
+     * @param socket Client socket.
+     * @param maxFrameCount Max number of pending image frames.
+     */
+    ConnectionQueue(NetworkSocketPtr socket, size_t maxFrameCount = 2);
+
+    /**
+     * @brief Stop the writer thread, pending packets are discarded.
+     *
+     * The socket is shut down so a send in progress is interrupted.
+     *
+     */
+    ~ConnectionQueue();
+
+    ConnectionQueue(const ConnectionQueue&) = delete;
+    ConnectionQueue& operator=(const ConnectionQueue&) = delete;
+
+    /**
+     * @brief Queue a packet to send it asynchronously.
+     *
+     * Nothing is queued if the connection has been closed.
+     *
+     * @param packet Packet to send.
+     */
+    void push(QueuedPacketPtr packet);
+
+    /**
+     * @brief Get the current queue depth and counters.
+     *
+     * @return ConnectionStatistics Queue statistics.
+     */
+    ConnectionStatistics getStatistics() const;
+
+private:
+    void _run();
+    QueuedPacketPtr _pop();
+    void _dropOldestFrame();
+
+    NetworkSocketPtr _socket;
+    size_t _maxFrameCount = 0;
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<QueuedPacketPtr> _packets;
+    size_t _frameCount = 0;
+    ConnectionStatistics _statistics;
+    bool _closed = false;
+    std::thread _writer;
+};
+
+using ConnectionQueuePtr = std::shared_ptr<ConnectionQueue>;
+} // namespace brayns
@@ -176,6 +176,17 @@ public:
      */
     int getFlags() const { return _flags; }
 
+    /**
+     * @brief Check if the packet content is in binary format.
+     *
+     * @return true The packet is a binary packet.
+     * @return false The packet is a text packet.
+     */
+    bool isBinary() const
+    {
+        return _flags & Poco::Net::WebSocket::FRAME_OP_BINARY;
+    }
+
 private:
     const void* _data;
     int _size = 0;
@@ -242,6 +253,26 @@ public:
      */
     void close() { _socket.close(); }
 
+    /**
+     * @brief Shut down both directions of the connection.
+     *
+     * Unlike close(), this is safe while another thread is blocked in send()
+     * or receive(): the blocked call returns and throws
+     * ConnectionClosedException.
+     *
+     */
+    void shutdown()
+    {
+        try
+        {
+            _socket.shutdown();
+        }
+        catch (const Poco::Exception&)
+        {
+            // Already closed or disconnected
+        }
+    }
+
     /**
      * @brief Receive an input packet from the connected client.
      *
@@ -21,7 +21,7 @@
 
 #include "StreamManager.h"
 
-#include <brayns/common/log.h>
+#include <algorithm>
 
 #include <brayns/network/context/NetworkContext.h>
 
@@ -35,34 +35,72 @@ public:
     static void broadcast(NetworkContext& context)
     {
         auto& api = context.getApi();
-        auto& engine = api.getEngine();
-        auto& framebuffer = engine.getFrameBuffer();
         auto& manager = api.getParametersManager();
         auto& parameters = manager.getApplicationParameters();
-        auto compression = parameters.getJpegCompression();
-        auto& generator = context.getImageGenerator();
-        const auto image = generator.createJPEG(framebuffer, compression);
-        if (image.size == 0)
+        ImageStreamSettings defaultSettings;
+        defaultSettings.quality = uint8_t(parameters.getJpegCompression());
+        auto& stream = context.getStream();
+        auto& imageStream = stream.getImageStream();
+        auto& clientSettings = imageStream.getClientSettings();
+        auto& connections = context.getConnections();
+        auto settingsList = _getDistinctSettings(clientSettings);
+        if (connections.getConnectionCount() > clientSettings.size())
         {
-            return;
+            _addIfMissing(settingsList, defaultSettings);
+        }
+        for (const auto& settings : settingsList)
+        {
+            _broadcast(context, settings, [&](const auto& handle) {
+                auto i = clientSettings.find(handle);
+                auto& current =
+                    i == clientSettings.end() ? defaultSettings : i->second;
+                return current == settings;
+            });
         }
-        _trySendImage(context, image);
     }
 
 private:
-    static void _trySendImage(NetworkContext& context,
-                              const ImageGenerator::ImageJPEG& image)
+    static std::vector<ImageStreamSettings> _getDistinctSettings(
+        const std::unordered_map<ConnectionHandle, ImageStreamSettings>&
+            clientSettings)
     {
-        auto& connections = context.getConnections();
-        try
+        std::vector<ImageStreamSettings> settingsList;
+        for (const auto& pair : clientSettings)
         {
-            connections.broadcast({image.data.get(), int(image.size)});
+            _addIfMissing(settingsList, pair.second);
         }
-        catch (const ConnectionClosedException& e)
+        return settingsList;
+    }
+
+    static void _addIfMissing(std::vector<ImageStreamSettings>& settingsList,
+                              const ImageStreamSettings& settings)
+    {
+        auto first = settingsList.begin();
+        auto last = settingsList.end();
+        if (std::find(first, last, settings) != last)
         {
-            BRAYNS_DEBUG << "Connection closed during image broadcast: "
-                         << e.what() << ".\n";
+            return;
         }
+        settingsList.push_back(settings);
+    }
+
+    template <typename FilterType>
+    static void _broadcast(NetworkContext& context,
+                           const ImageStreamSettings& settings,
+                           FilterType filter)
+    {
+        auto& api = context.getApi();
+        auto& engine = api.getEngine();
+        auto& framebuffer = engine.getFrameBuffer();
+        auto& generator = context.getImageGenerator();
+        const auto image = generator.createJPEG(framebuffer, settings.quality,
+                                                settings.subsampling);
+        if (image.size == 0)
+        {
+            return;
+        }
+        auto& connections = context.getConnections();
+        connections.broadcast(filter, {image.data.get(), int(image.size)});
     }
 };
 
@@ -21,14 +21,41 @@
 
 #pragma once
 
+#include <brayns/common/utils/ImageGenerator.h>
 #include <brayns/network/common/RateLimiter.h>
+#include <brayns/network/socket/ConnectionHandle.h>
 
 #include <memory>
+#include <unordered_map>
 
 namespace brayns
 {
 class NetworkContext;
 
+/**
+ * @brief JPEG settings of the images streamed to a client.
+ *
+ */
+struct ImageStreamSettings
+{
+    /**
+     * @brief JPEG quality (1-100).
+     *
+     */
+    uint8_t quality = 0;
+
+    /**
+     * @brief JPEG chroma subsampling.
+     *
+     */
+    ChromaSubsampling subsampling = ChromaSubsampling::yuv444;
+
+    bool operator==(const ImageStreamSettings& other) const
+    {
+        return quality == other.quality && subsampling == other.subsampling;
+    }
+};
+
 /**
  * @brief Info to monitor the image stream.
  *
@@ -96,10 +123,47 @@ public:
         _limiter.call(std::move(functor));
     }
 
+    /**
+     * @brief Set the JPEG settings negotiated by a client.
+     *
+     * @param handle Client handle.
+     * @param settings JPEG settings of the images sent to this client.
+     */
+    void setClientSettings(const ConnectionHandle& handle,
+                           const ImageStreamSettings& settings)
+    {
+        _clientSettings[handle] = settings;
+    }
+
+    /**
+     * @brief Forget the settings of a client (when disconnected).
+     *
+     * @param handle Client handle.
+     */
+    void removeClient(const ConnectionHandle& handle)
+    {
+        _clientSettings.erase(handle);
+    }
+
+    /**
+     * @brief Get the JPEG settings negotiated by the clients.
+     *
+     * Clients not in this map use the application defaults.
+     *
+     * @return const std::unordered_map<ConnectionHandle,
+     * ImageStreamSettings>& Settings indexed by client handle.
+     */
+    const std::unordered_map<ConnectionHandle, ImageStreamSettings>&
+        getClientSettings() const
+    {
+        return _clientSettings;
+    }
+
 private:
     RateLimiter _limiter;
     bool _controlled = false;
     bool _triggered = false;
+    std::unordered_map<ConnectionHandle, ImageStreamSettings> _clientSettings;
 };
 
 /**
@@ -28,6 +28,8 @@
 #include <mutex>
 #include <stdexcept>
 
+#include "NetworkTaskPool.h"
+
 namespace brayns
 {
 /**
@@ -97,12 +99,57 @@ private:
  * The task functionality must be implemented by overridding the run() method.
  *
  * Only the content of the run() method will be executed in a separated thread.
+ * It is a worker of the task pool if one is set, a dedicated thread otherwise.
  *
  */
 class NetworkTask
 {
 public:
-    virtual ~NetworkTask() = default;
+    /**
+     * @brief Remove the task from the pool queue and wait for its termination.
+     *
+     */
+    virtual ~NetworkTask()
+    {
+        if (!_result.valid())
+        {
+            return;
+        }
+        _cancelled = true;
+        _removeFromPool();
+        _result.wait();
+    }
+
+    /**
+     * @brief Run the next starts of the task on the given pool.
+     *
+     * @param pool Task pool, the task runs on its own thread if expired.
+     */
+    void setPool(std::weak_ptr<NetworkTaskPool> pool)
+    {
+        _pool = std::move(pool);
+    }
+
+    /**
+     * @brief Order of the task in the pool queue.
+     *
+     * @return NetworkTaskPriority Task priority.
+     */
+    virtual NetworkTaskPriority getPriority() const
+    {
+        return NetworkTaskPriority::normal;
+    }
+
+    /**
+     * @brief Check if start() must leave the task aside until resume().
+     *
+     * Tasks waiting for client data before doing anything are deferred so
+     * they don't hold a worker of the pool meanwhile.
+     *
+     * @return true run() is scheduled by resume().
+     * @return false run() is scheduled by start().
+     */
+    virtual bool isDeferred() const { return false; }
 
     /**
      * @brief Check wether the task result is ready to be retreived.
@@ -115,6 +162,8 @@ public:
     /**
      * @brief Check if the task is running.
      *
+     * A task waiting in the pool queue is considered as running.
+     *
      * @return true Task is running.
      * @return false Task is done or not started.
      */
@@ -148,7 +197,36 @@ public:
         cancelAndWait();
         onStart();
         _cancelled = false;
-        _result = std::async(std::launch::async, [this] { run(); });
+        _deferred = std::packaged_task<void()>([this] {
+            if (!_cancelled)
+            {
+                run();
+            }
+        });
+        _result = _deferred.get_future();
+        if (!isDeferred())
+        {
+            resume();
+        }
+    }
+
+    /**
+     * @brief Schedule run() of a deferred task, no-op if already scheduled.
+     *
+     */
+    void resume()
+    {
+        if (!_deferred.valid())
+        {
+            return;
+        }
+        auto pool = _pool.lock();
+        if (!pool)
+        {
+            _thread = std::async(std::launch::async, std::move(_deferred));
+            return;
+        }
+        _ticket = pool->push(getPriority(), std::move(_deferred));
     }
 
     /**
@@ -180,6 +258,9 @@ public:
     /**
      * @brief Cancel the task if cancellable.
      *
+     * A task still waiting in the pool queue is removed from it and completes
+     * immediately with the cancellation exception.
+     *
      */
     void cancel()
     {
@@ -189,6 +270,7 @@ public:
         }
         onCancel();
         _cancelled = true;
+        _removeFromPool();
     }
 
     /**
@@ -317,6 +399,23 @@ public:
     }
 
 private:
+    void _removeFromPool()
+    {
+        if (_deferred.valid())
+        {
+            // Never scheduled, completes here with the cancellation
+            auto task = std::move(_deferred);
+            task();
+            return;
+        }
+        auto pool = _pool.lock();
+        if (!pool)
+        {
+            return;
+        }
+        pool->cancel(_ticket);
+    }
+
     bool _hasStatus(std::future_status status) const
     {
         if (!_result.valid())
@@ -341,8 +440,12 @@ private:
     }
 
     std::future<void> _result;
+    std::packaged_task<void()> _deferred;
+    std::future<void> _thread;
     std::atomic_bool _cancelled{false};
     NetworkTaskException _e;
+    std::weak_ptr<NetworkTaskPool> _pool;
+    NetworkTaskPool::Ticket _ticket = 0;
 };
 
 using NetworkTaskPtr = std::shared_ptr<NetworkTask>;
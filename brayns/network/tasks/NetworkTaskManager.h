@@ -22,6 +22,7 @@
 #pragma once
 
 #include "NetworkTaskMap.h"
+#include "NetworkTaskPool.h"
 
 namespace brayns
 {
@@ -31,10 +32,22 @@ namespace brayns
  * A task is started by a JSON-RPC request and is hence bound to a client and a
  * request ID. These two objects can be used to retreive and monitor a task.
  *
+ * Registered tasks run on a shared pool of worker threads.
+ *
  */
 class NetworkTaskManager
 {
 public:
+    /**
+     * @brief Create the task pool.
+     *
+     * @param threadCount Number of workers, one per core if 0.
+     */
+    NetworkTaskManager(size_t threadCount)
+        : _pool(std::make_shared<NetworkTaskPool>(threadCount))
+    {
+    }
+
     /**
      * @brief Add a new task and cancel the old one.
      *
@@ -45,6 +58,7 @@ public:
     void addOrReplace(const ConnectionHandle& handle, const RequestId& id,
                       NetworkTaskPtr task)
     {
+        task->setPool(_pool);
         auto oldTask = _tasks.find(handle, id);
         if (oldTask)
         {
@@ -65,6 +79,7 @@ public:
     bool addIfNotPresent(const ConnectionHandle& handle, const RequestId& id,
                          NetworkTaskPtr task)
     {
+        task->setPool(_pool);
         auto oldTask = _tasks.find(handle, id);
         if (oldTask)
         {
@@ -119,7 +134,18 @@ public:
         });
     }
 
+    /**
+     * @brief Get the queue depth and counters of the task pool.
+     *
+     * @return NetworkTaskPoolStatistics Pool statistics.
+     */
+    NetworkTaskPoolStatistics getStatistics() const
+    {
+        return _pool->getStatistics();
+    }
+
 private:
+    NetworkTaskPoolPtr _pool;
     NetworkTaskMap _tasks;
 };
 } // namespace brayns
\ No newline at end of file
@@ -0,0 +1,146 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "NetworkTaskPool.h"
+
+#include <algorithm>
+
+namespace
+{
+double _toMilliseconds(std::chrono::steady_clock::duration duration)
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    return std::chrono::duration_cast<Milliseconds>(duration).count();
+}
+} // namespace
+
+namespace brayns
+{
+NetworkTaskPool::NetworkTaskPool(size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    _statistics.threadCount = threadCount;
+    _workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        _workers.emplace_back([this] { _run(); });
+    }
+}
+
+NetworkTaskPool::~NetworkTaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopped = true;
+        _queue.clear();
+        _keys.clear();
+    }
+    _condition.notify_all();
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+NetworkTaskPool::Ticket NetworkTaskPool::push(NetworkTaskPriority priority,
+                                              std::packaged_task<void()> task)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto ticket = _nextTicket++;
+    Key key(-int(priority), ticket);
+    auto& queuedTask = _queue[key];
+    queuedTask.ticket = ticket;
+    queuedTask.queueTime = Clock::now();
+    queuedTask.task = std::move(task);
+    _keys[ticket] = key;
+    _statistics.queueSize = _queue.size();
+    _condition.notify_one();
+    return ticket;
+}
+
+bool NetworkTaskPool::cancel(Ticket ticket)
+{
+    std::packaged_task<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto i = _keys.find(ticket);
+        if (i == _keys.end())
+        {
+            return false;
+        }
+        auto j = _queue.find(i->second);
+        task = std::move(j->second.task);
+        _queue.erase(j);
+        _keys.erase(i);
+        _statistics.queueSize = _queue.size();
+        ++_statistics.cancelledTasks;
+    }
+    task();
+    return true;
+}
+
+NetworkTaskPoolStatistics NetworkTaskPool::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto statistics = _statistics;
+    if (statistics.startedTasks != 0)
+    {
+        statistics.averageWaitTime =
+            _toMilliseconds(_totalWaitTime) / statistics.startedTasks;
+    }
+    return statistics;
+}
+
+void NetworkTaskPool::_run()
+{
+    while (true)
+    {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock,
+                            [this] { return _stopped || !_queue.empty(); });
+            if (_stopped)
+            {
+                return;
+            }
+            auto first = _queue.begin();
+            auto& queuedTask = first->second;
+            auto waitTime = Clock::now() - queuedTask.queueTime;
+            task = std::move(queuedTask.task);
+            _keys.erase(queuedTask.ticket);
+            _queue.erase(first);
+            _totalWaitTime += waitTime;
+            _statistics.maxWaitTime =
+                std::max(_statistics.maxWaitTime, _toMilliseconds(waitTime));
+            _statistics.queueSize = _queue.size();
+            ++_statistics.startedTasks;
+            ++_statistics.runningTasks;
+        }
+        task();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_statistics.runningTasks;
+        }
+    }
+}
+} // namespace brayns
@@ -0,0 +1,187 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace brayns
+{
+/**
+ * @brief Order in which queued tasks are started.
+ *
+ */
+enum class NetworkTaskPriority
+{
+    low,
+    normal,
+    high
+};
+
+/**
+ * @brief Snapshot of the state of the task pool.
+ *
+ */
+struct NetworkTaskPoolStatistics
+{
+    /**
+     * @brief Number of worker threads.
+     *
+     */
+    size_t threadCount = 0;
+
+    /**
+     * @brief Number of tasks currently running on a worker.
+     *
+     */
+    size_t runningTasks = 0;
+
+    /**
+     * @brief Number of tasks waiting for a worker.
+     *
+     */
+    size_t queueSize = 0;
+
+    /**
+     * @brief Number of tasks started by a worker.
+     *
+     */
+    size_t startedTasks = 0;
+
+    /**
+     * @brief Number of tasks cancelled before a worker started them.
+     *
+     */
+    size_t cancelledTasks = 0;
+
+    /**
+     * @brief Mean time spent in queue by started tasks in milliseconds.
+     *
+     */
+    double averageWaitTime = 0.0;
+
+    /**
+     * @brief Longest time spent in queue by a started task in milliseconds.
+     *
+     */
+    double maxWaitTime = 0.0;
+};
+
+/**
+ * @brief Fixed set of worker threads running the network tasks.
+ *
+ * Tasks are queued by priority, then in submission order, so a burst of
+ * requests cannot spawn more threads than the configured count. A queued task
+ * can be removed before it starts.
+ *
+ * This object is thread safe (synchronized).
+ *
+ */
+class NetworkTaskPool
+{
+public:
+    /**
+     * @brief Identifier of a queued task.
+     *
+     */
+    using Ticket = uint64_t;
+
+    /**
+     * @brief Start the worker threads.
+     *
+     * @param threadCount Number of workers, one per core if 0.
+     */
+    NetworkTaskPool(size_t threadCount);
+
+    /**
+     * @brief Wait for the running tasks and stop the workers.
+     *
+     * Tasks still queued are discarded, their future is broken.
+     *
+     */
+    ~NetworkTaskPool();
+
+    NetworkTaskPool(const NetworkTaskPool&) = delete;
+    NetworkTaskPool& operator=(const NetworkTaskPool&) = delete;
+
+    /**
+     * @brief Queue a task to run it on a worker.
+     *
+     * @param priority Task priority.
+     * @param task Task to run, its future is used to monitor it.
+     * @return Ticket Identifier to cancel the task while queued.
+     */
+    Ticket push(NetworkTaskPriority priority, std::packaged_task<void()> task);
+
+    /**
+     * @brief Remove a task from the queue if it has not started yet.
+     *
+     * The removed task is run on the calling thread so its future is ready.
+     * It must hence check its cancellation before doing anything.
+     *
+     * @param ticket Identifier returned by push().
+     * @return true Task was queued and has been removed.
+     * @return false Task is running or done.
+     */
+    bool cancel(Ticket ticket);
+
+    /**
+     * @brief Get the current queue depth and counters.
+     *
+     * @return NetworkTaskPoolStatistics Pool statistics.
+     */
+    NetworkTaskPoolStatistics getStatistics() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct QueuedTask
+    {
+        Ticket ticket = 0;
+        Clock::time_point queueTime;
+        std::packaged_task<void()> task;
+    };
+
+    // Higher priorities first, then oldest tickets first
+    using Key = std::pair<int, Ticket>;
+
+    void _run();
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    std::map<Key, QueuedTask> _queue;
+    std::map<Ticket, Key> _keys;
+    Ticket _nextTicket = 0;
+    bool _stopped = false;
+    NetworkTaskPoolStatistics _statistics;
+    Clock::duration _totalWaitTime{0};
+    std::vector<std::thread> _workers;
+};
+
+using NetworkTaskPoolPtr = std::shared_ptr<NetworkTaskPool>;
+} // namespace brayns
@@ -50,7 +50,16 @@ NetworkParameters::NetworkParameters()
         "Certificate used for encryption in secure mode")(
         "ca-location", po::value(&_caLocation),
         "Certification Authority file or directory, if not set, default "
-        "OpenSSL ones will be used");
+        "OpenSSL ones will be used")(
+        "upload-memory-limit", po::value(&_uploadMemoryLimit),
+        "Max size in bytes (default = 64MB) of a model upload kept in memory, "
+        "bigger uploads are written to a temporary file")(
+        "upload-folder", po::value(&_uploadFolder),
+        "Folder of the temporary files of model uploads (default = system "
+        "temporary folder)")(
+        "task-threads", po::value(&_taskThreadCount),
+        "Number of threads (default = 4) running long requests like model "
+        "loading, snapshots and uploads, 0 for one per core");
 }
 
 void NetworkParameters::print()
@@ -65,5 +74,8 @@ void NetworkParameters::print()
     BRAYNS_INFO << "\nPrivate key passphrase    :" << _privateKeyPassphrase;
     BRAYNS_INFO << "\nCertificate file          :" << _certificateFile;
     BRAYNS_INFO << "\nCA location               :" << _caLocation;
+    BRAYNS_INFO << "\nUpload memory limit       :" << _uploadMemoryLimit;
+    BRAYNS_INFO << "\nUpload folder             :" << _uploadFolder;
+    BRAYNS_INFO << "\nTask threads              :" << _taskThreadCount;
 }
 } // namespace brayns
\ No newline at end of file
@@ -209,6 +209,64 @@ public:
         _updateValue(_caLocation, caLocation);
     }
 
+    /**
+     * @brief Get the maximum size of a model upload kept in memory, bigger
+     * uploads are written to a temporary file while they are received.
+     *
+     * Default: 64MB.
+     *
+     * @return size_t Max upload size in memory in bytes.
+     */
+    size_t getUploadMemoryLimit() const { return _uploadMemoryLimit; }
+
+    /**
+     * @brief Set the maximum size of a model upload kept in memory.
+     *
+     * @param uploadMemoryLimit Max upload size in memory in bytes.
+     */
+    void setUploadMemoryLimit(size_t uploadMemoryLimit)
+    {
+        _updateValue(_uploadMemoryLimit, uploadMemoryLimit);
+    }
+
+    /**
+     * @brief Get the folder where big model uploads are written, if empty the
+     * system temporary folder is used.
+     *
+     * @return const std::string& Upload folder.
+     */
+    const std::string& getUploadFolder() const { return _uploadFolder; }
+
+    /**
+     * @brief Set the folder where big model uploads are written.
+     *
+     * @param uploadFolder Upload folder.
+     */
+    void setUploadFolder(const std::string& uploadFolder)
+    {
+        _updateValue(_uploadFolder, uploadFolder);
+    }
+
+    /**
+     * @brief Get the number of threads running the network tasks, 0 means one
+     * per core.
+     *
+     * Default: 4.
+     *
+     * @return size_t Number of task threads.
+     */
+    size_t getTaskThreadCount() const { return _taskThreadCount; }
+
+    /**
+     * @brief Set the number of threads running the network tasks.
+     *
+     * @param taskThreadCount Number of task threads, 0 for one per core.
+     */
+    void setTaskThreadCount(size_t taskThreadCount)
+    {
+        _updateValue(_taskThreadCount, taskThreadCount);
+    }
+
 private:
     bool _client = false;
     bool _secure = false;
@@ -219,5 +277,8 @@ private:
     std::string _privateKeyPassphrase;
     std::string _certificateFile;
     std::string _caLocation;
+    size_t _uploadMemoryLimit = 64 * 1024 * 1024;
+    std::string _uploadFolder;
+    size_t _taskThreadCount = 4;
 };
 } // namespace brayns
\ No newline at end of file
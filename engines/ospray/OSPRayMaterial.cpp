@@ -76,6 +76,29 @@ void OSPRayMaterial::commit()
     // Properties
     toOSPRayProperties(*this, _ospMaterial);
 
+    // Color palette, shared with the model so that it is not copied for every
+    // material. It is updated in place, hence the shared buffers.
+    ospSetObject(_ospMaterial, "palette_colors", nullptr);
+    ospSetObject(_ospMaterial, "palette_offsets", nullptr);
+    if (_colorPalette && !_colorPalette->colors.empty())
+    {
+        auto& colors = _colorPalette->colors;
+        auto colorData = ospNewData(colors.size(), OSP_FLOAT3, colors.data(),
+                                    OSP_DATA_SHARED_BUFFER);
+        ospSetObject(_ospMaterial, "palette_colors", colorData);
+        ospRelease(colorData);
+
+        auto& offsets = _colorPalette->offsets;
+        if (!offsets.empty())
+        {
+            auto offsetData = ospNewData(offsets.size(), OSP_ULONG,
+                                         offsets.data(),
+                                         OSP_DATA_SHARED_BUFFER);
+            ospSetObject(_ospMaterial, "palette_offsets", offsetData);
+            ospRelease(offsetData);
+        }
+    }
+
     // Textures
     for (const auto& textureType : textureTypeMaterialAttribute)
         ospSetObject(_ospMaterial, textureType.attribute.c_str(), nullptr);
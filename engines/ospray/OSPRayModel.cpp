@@ -119,26 +119,37 @@ void OSPRayModel::buildBoundingBox()
     addCylinder(BOUNDINGBOX_MATERIAL_ID, {positions[3], positions[7], radius});
 }
 
-void OSPRayModel::_addGeometryToModel(const OSPGeometry geometry,
-                                      const size_t materialId)
+OSPModel OSPRayModel::_getModel(const size_t materialId)
 {
     switch (materialId)
     {
     case BOUNDINGBOX_MATERIAL_ID:
-        ospAddGeometry(_boundingBoxModel, geometry);
-        break;
+        return _boundingBoxModel;
     case SECONDARY_MODEL_MATERIAL_ID:
-    {
         if (!_secondaryModel)
             _secondaryModel = (OSPModel) new OSPRayISPCModel; // ospNewModel();
-        ospAddGeometry(_secondaryModel, geometry);
-        break;
-    }
+        return _secondaryModel;
     default:
-        ospAddGeometry(_primaryModel, geometry);
+        return _primaryModel;
     }
 }
 
+void OSPRayModel::_addGeometryToModel(const OSPGeometry geometry,
+                                      const size_t materialId)
+{
+    auto model = _getModel(materialId);
+    ospAddGeometry(model, geometry);
+    _modelsToCommit.insert(model);
+}
+
+void OSPRayModel::_removeGeometryFromModel(const OSPGeometry geometry,
+                                           const size_t materialId)
+{
+    auto model = _getModel(materialId);
+    ospRemoveGeometry(model, geometry);
+    _modelsToCommit.insert(model);
+}
+
 OSPGeometry& OSPRayModel::_createGeometry(GeometryMap& map,
                                           const size_t materialId,
                                           const char* name)
@@ -146,10 +157,11 @@ OSPGeometry& OSPRayModel::_createGeometry(GeometryMap& map,
     auto& geometry = map[materialId];
     if (geometry)
     {
-        ospRemoveGeometry(_primaryModel, geometry);
+        _removeGeometryFromModel(geometry, materialId);
         ospRelease(geometry);
     }
     geometry = ospNewGeometry(name);
+    ++_numGeometriesCreated;
 
     auto matIt = _materials.find(materialId);
     if (matIt != _materials.end())
@@ -278,7 +290,7 @@ void OSPRayModel::_commitMeshes(const size_t materialId)
 
     ospCommit(geometry);
 
-    ospAddGeometry(_primaryModel, geometry);
+    _addGeometryToModel(geometry, materialId);
 }
 
 void OSPRayModel::_commitStreamlines(const size_t materialId)
@@ -311,7 +323,7 @@ void OSPRayModel::_commitStreamlines(const size_t materialId)
 
     ospCommit(geometry);
 
-    ospAddGeometry(_primaryModel, geometry);
+    _addGeometryToModel(geometry, materialId);
 }
 
 void OSPRayModel::_commitSDFGeometries()
@@ -319,30 +331,15 @@ void OSPRayModel::_commitSDFGeometries()
     auto globalData = allocateVectorData(_geometries->_sdf.geometries, OSP_CHAR,
                                          _memoryManagementFlags);
 
-    // Create and upload flat list of neighbours
-    const size_t numGeoms = _geometries->_sdf.geometries.size();
-    _geometries->_sdf.neighboursFlat.clear();
-
-    for (size_t geomI = 0; geomI < numGeoms; geomI++)
-    {
-        const size_t currOffset = _geometries->_sdf.neighboursFlat.size();
-        const auto& neighsI = _geometries->_sdf.neighbours[geomI];
-        if (!neighsI.empty())
-        {
-            _geometries->_sdf.geometries[geomI].numNeighbours = neighsI.size();
-            _geometries->_sdf.geometries[geomI].neighboursIndex = currOffset;
-            _geometries->_sdf.neighboursFlat.insert(
-                std::end(_geometries->_sdf.neighboursFlat), std::begin(neighsI),
-                std::end(neighsI));
-        }
-    }
-
-    // Make sure we don't create an empty buffer in the case of no neighbours
-    if (_geometries->_sdf.neighboursFlat.empty())
-        _geometries->_sdf.neighboursFlat.resize(1, 0);
-
-    auto neighbourData = allocateVectorData(_geometries->_sdf.neighboursFlat,
-                                            OSP_ULONG, _memoryManagementFlags);
+    // The neighbour lists are already stored flat, make sure we don't create an
+    // empty buffer in the case of no neighbours. The placeholder must outlive
+    // the data as the buffer may be shared.
+    static const std::vector<uint64_t> noNeighbours(1, 0);
+    const auto& neighbours = _geometries->_sdf.neighbours.empty()
+                                 ? noNeighbours
+                                 : _geometries->_sdf.neighbours;
+    auto neighbourData =
+        allocateVectorData(neighbours, OSP_ULONG, _memoryManagementFlags);
 
     for (const auto& mat : _materials)
     {
@@ -366,13 +363,42 @@ void OSPRayModel::_commitSDFGeometries()
 
         ospCommit(geometry);
 
-        ospAddGeometry(_primaryModel, geometry);
+        _addGeometryToModel(geometry, materialId);
     }
 
     ospRelease(globalData);
     ospRelease(neighbourData);
 }
 
+template <typename DataMap>
+void OSPRayModel::_commitDirtyGeometries(
+    const DataMap& data, GeometryMap& geometries, const DirtyMaterials& dirty,
+    void (OSPRayModel::*commit)(const size_t))
+{
+    if (!dirty.all)
+    {
+        for (const auto materialId : dirty.ids)
+            if (data.find(materialId) != data.end())
+                (this->*commit)(materialId);
+        return;
+    }
+
+    // The whole map may have been edited, including removed materials
+    for (auto i = geometries.begin(); i != geometries.end();)
+    {
+        if (data.find(i->first) == data.end())
+        {
+            _removeGeometryFromModel(i->second, i->first);
+            ospRelease(i->second);
+            i = geometries.erase(i);
+        }
+        else
+            ++i;
+    }
+    for (const auto& entry : data)
+        (this->*commit)(entry.first);
+}
+
 void OSPRayModel::_setBVHFlags()
 {
     osphelper::set(_primaryModel, "dynamicScene",
@@ -394,50 +420,53 @@ void OSPRayModel::commitGeometry()
     if (!isDirty())
         return;
 
-    if (!_primaryModel)
-        _primaryModel = (OSPModel) new OSPRayISPCModel;
-
     // Materials
     for (auto material : _materials)
         material.second->commit();
 
-    // Group geometry
-    if (_spheresDirty)
+    // Instances are handled by the scene, no need to rebuild the models
+    if (!isGeometryDirty())
     {
-        for (const auto& spheres : _geometries->_spheres)
-            _commitSpheres(spheres.first);
+        _instancesDirty = false;
+        return;
     }
 
-    if (_cylindersDirty)
+    if (!_primaryModel)
     {
-        for (const auto& cylinders : _geometries->_cylinders)
-            _commitCylinders(cylinders.first);
+        _primaryModel = (OSPModel) new OSPRayISPCModel;
+        _modelsToCommit.insert(_primaryModel);
     }
 
+    // Group geometry, only the materials that changed are recreated
+    if (_spheresDirty)
+        _commitDirtyGeometries(_geometries->_spheres, _ospSpheres,
+                               _dirtySpheres, &OSPRayModel::_commitSpheres);
+
+    if (_cylindersDirty)
+        _commitDirtyGeometries(_geometries->_cylinders, _ospCylinders,
+                               _dirtyCylinders,
+                               &OSPRayModel::_commitCylinders);
+
     if (_conesDirty)
-    {
-        for (const auto& cones : _geometries->_cones)
-            _commitCones(cones.first);
-    }
+        _commitDirtyGeometries(_geometries->_cones, _ospCones, _dirtyCones,
+                               &OSPRayModel::_commitCones);
 
     if (_sdfBeziersDirty)
-    {
-        for (const auto& sdfBeziers : _geometries->_sdfBeziers)
-            _commitSDFBeziers(sdfBeziers.first);
-    }
+        _commitDirtyGeometries(_geometries->_sdfBeziers, _ospSDFBeziers,
+                               _dirtySDFBeziers,
+                               &OSPRayModel::_commitSDFBeziers);
 
     if (_triangleMeshesDirty)
-    {
-        for (const auto& meshes : _geometries->_triangleMeshes)
-            _commitMeshes(meshes.first);
-    }
+        _commitDirtyGeometries(_geometries->_triangleMeshes, _ospMeshes,
+                               _dirtyTriangleMeshes,
+                               &OSPRayModel::_commitMeshes);
 
     if (_streamlinesDirty)
-    {
-        for (const auto& streamlines : _geometries->_streamlines)
-            _commitStreamlines(streamlines.first);
-    }
+        _commitDirtyGeometries(_geometries->_streamlines, _ospStreamlines,
+                               _dirtyStreamlines,
+                               &OSPRayModel::_commitStreamlines);
 
+    // All SDF geometries share the same buffers
     if (_sdfGeometriesDirty)
         _commitSDFGeometries();
 
@@ -448,12 +477,11 @@ void OSPRayModel::commitGeometry()
     // handled by the scene
     _instancesDirty = false;
 
-    // Commit models
-    ospCommit(_primaryModel);
-    if (_secondaryModel)
-        ospCommit(_secondaryModel);
-    if (_boundingBoxModel)
-        ospCommit(_boundingBoxModel);
+    // Commit the models whose geometries changed
+    for (auto model : _modelsToCommit)
+        if (model)
+            ospCommit(model);
+    _modelsToCommit.clear();
 }
 
 void OSPRayModel::commitMaterials(const std::string& renderer)
@@ -498,23 +526,24 @@ void OSPRayModel::commitMaterials(const std::string& renderer)
 
 void OSPRayModel::commitSimulationParams()
 {
-    if (_simulationEnabled)
-    {
-        if (_secondaryModel)
-        {
-            osphelper::set(_secondaryModel, "simEnabled", _simulationEnabled);
-            osphelper::set(_secondaryModel, "simOffset",
-                           static_cast<int32_t>(_simulationOffset));
-            ospCommit(_secondaryModel);
-        }
-        else
-        {
-            osphelper::set(_primaryModel, "simEnabled", _simulationEnabled);
-            osphelper::set(_primaryModel, "simOffset",
-                           static_cast<int32_t>(_simulationOffset));
-            ospCommit(_primaryModel);
-        }
-    }
+    if (!_simulationEnabled)
+        return;
+
+    auto model = _secondaryModel ? _secondaryModel : _primaryModel;
+    if (!model)
+        return;
+
+    // Committing the model rebuilds its acceleration structure, so only do it
+    // if the simulation parameters have actually changed
+    if (model == _simulationModel && _simulationOffset == _committedOffset)
+        return;
+
+    osphelper::set(model, "simEnabled", _simulationEnabled);
+    osphelper::set(model, "simOffset", static_cast<int32_t>(_simulationOffset));
+    ospCommit(model);
+
+    _simulationModel = model;
+    _committedOffset = _simulationOffset;
 }
 
 MaterialPtr OSPRayModel::createMaterialImpl(const PropertyMap& properties)
@@ -42,6 +42,15 @@ public:
     void commitMaterials(const std::string& renderer);
     void commitSimulationParams();
 
+    /**
+     * @return true if the next commitGeometry() rebuilds the OSPRay models,
+     * which invalidates all instances of this model.
+     */
+    bool isGeometryDirty() const
+    {
+        return !_primaryModel || _areGeometriesDirty();
+    }
+
     OSPModel getPrimaryModel() const { return _primaryModel; }
     OSPModel getSecondaryModel() const { return _secondaryModel; }
     OSPModel getBoundingBoxModel() const { return _boundingBoxModel; }
@@ -59,6 +68,13 @@ public:
         _simulationOffset = offset;
     }
 
+    /**
+     * @return the number of OSPRay geometries created since the creation of
+     * the model. Only the geometries of the materials changed since the last
+     * commit are recreated, so this is a measure of the work done by commits.
+     */
+    size_t getNumGeometriesCreated() const { return _numGeometriesCreated; }
+
 private:
     using GeometryMap = std::map<size_t, OSPGeometry>;
 
@@ -71,8 +87,15 @@ private:
     void _commitMeshes(const size_t materialId);
     void _commitStreamlines(const size_t materialId);
     void _commitSDFGeometries();
+    template <typename DataMap>
+    void _commitDirtyGeometries(const DataMap& data, GeometryMap& geometries,
+                                const DirtyMaterials& dirty,
+                                void (OSPRayModel::*commit)(const size_t));
+    OSPModel _getModel(const size_t materialId);
     void _addGeometryToModel(const OSPGeometry geometry,
                              const size_t materialId);
+    void _removeGeometryFromModel(const OSPGeometry geometry,
+                                  const size_t materialId);
     void _setBVHFlags();
 
     // Models
@@ -80,12 +103,20 @@ private:
     OSPModel _secondaryModel{nullptr};
     OSPModel _boundingBoxModel{nullptr};
 
+    // Models whose geometries changed since the last commit
+    std::set<OSPModel> _modelsToCommit;
+    size_t _numGeometriesCreated{0};
+
     // Bounding box
     size_t _boudingBoxMaterialId{0};
 
     // Simulation offset within the simulation buffer
     uint64_t _simulationOffset{0};
 
+    // Model and offset of the last committed simulation parameters
+    OSPModel _simulationModel{nullptr};
+    uint64_t _committedOffset{0};
+
     OSPTransferFunction _ospTransferFunction{nullptr};
 
     // OSPRay data
@@ -35,6 +35,8 @@
 #include <brayns/parameters/GeometryParameters.h>
 #include <brayns/parameters/VolumeParameters.h>
 
+#include <algorithm>
+
 namespace brayns
 {
 OSPRayScene::OSPRayScene(AnimationParameters& animationParameters,
@@ -59,6 +61,10 @@ OSPRayScene::~OSPRayScene()
     ospRelease(_ospTransferFunction);
 
     _destroyLights();
+    for (auto& kv : _rootModelEntries)
+        for (auto ospInstance : kv.second.ospInstances)
+            ospRelease(ospInstance);
+    _rootModelEntries.clear();
     if (_rootModel)
         ospRelease(_rootModel);
 }
@@ -92,69 +98,116 @@ void OSPRayScene::commit()
     _commitTransferFunction();
     _commitSimulationData(modelDescriptors);
 
-    if (!rebuildScene && !addRemoveVolumes)
+    // check for dirty models aka their geometry or instances have been altered
+    const bool doUpdate =
+        rebuildScene || addRemoveVolumes ||
+        std::any_of(modelDescriptors.begin(), modelDescriptors.end(),
+                    [](const ModelDescriptorPtr& modelDescriptor) {
+                        return modelDescriptor->getModel().isDirty();
+                    });
+    if (!doUpdate)
     {
-        // check for dirty models aka their geometry has been altered
-        bool doUpdate = false;
         for (auto& modelDescriptor : modelDescriptors)
         {
             auto& model =
                 static_cast<OSPRayModel&>(modelDescriptor->getModel());
             model.commitSimulationParams();
-            if (model.isDirty())
+        }
+        return;
+    }
+
+    // Only the instances of models that have been added, removed, modified or
+    // moved are updated in the root model. Unchanged models keep their
+    // instances, so the cost of a commit scales with the size of the change.
+    bool rootModified = false;
+    if (!_rootModel)
+    {
+        _rootModel = (OSPModel) new OSPRayISPCModel;
+        rootModified = true;
+    }
+    std::map<size_t, RootModelEntry> rootModelEntries;
+    for (auto modelDescriptor : modelDescriptors)
+    {
+        const auto modelID = modelDescriptor->getModelID();
+        RootModelEntry entry;
+        auto it = _rootModelEntries.find(modelID);
+        if (it != _rootModelEntries.end())
+        {
+            entry = std::move(it->second);
+            _rootModelEntries.erase(it);
+        }
+
+        auto& impl = static_cast<OSPRayModel&>(modelDescriptor->getModel());
+        bool geometryCommitted = false;
+        if (modelDescriptor->getEnabled())
+        {
+            // A committed model gets a new acceleration structure, hence its
+            // instances need to be recreated
+            geometryCommitted = impl.isGeometryDirty();
+            if (impl.isDirty())
             {
-                model.commitGeometry();
-                // need to continue re-adding the models to update the bounding
-                // box model to reflect the new model size
-                doUpdate = true;
+                BRAYNS_DEBUG << "Committing " << modelDescriptor->getName()
+                             << std::endl;
+                impl.commitGeometry();
+                impl.logInformation();
             }
         }
-        if (!doUpdate)
-            return;
-    }
+        impl.commitSimulationParams();
 
-    _activeModels.clear();
+        if (_commitRootModelEntry(modelDescriptor, entry, geometryCommitted))
+            rootModified = true;
 
-    if (_rootModel)
-        ospRelease(_rootModel);
-    _rootModel = (OSPModel) new OSPRayISPCModel;
+        impl.markInstancesClean();
 
-    for (auto modelDescriptor : modelDescriptors)
+        if (modelDescriptor->getEnabled())
+            rootModelEntries[modelID] = std::move(entry);
+    }
+
+    // Remaining entries belong to models that are not part of the scene anymore
+    for (auto& kv : _rootModelEntries)
     {
-        if (!modelDescriptor->getEnabled())
-            continue;
+        _removeFromRootModel(kv.second);
+        rootModified = true;
+    }
+    _rootModelEntries = std::move(rootModelEntries);
 
-        // keep models from being deleted via removeModel() as long as we use
-        // them here
-        _activeModels.push_back(modelDescriptor);
+    if (rootModified)
+    {
+        BRAYNS_DEBUG << "Committing root models" << std::endl;
+        ospCommit(_rootModel);
+    }
 
-        auto& impl = static_cast<OSPRayModel&>(modelDescriptor->getModel());
-        const auto& transformation = modelDescriptor->getTransformation();
+    _computeBounds();
+}
 
-        BRAYNS_DEBUG << "Committing " << modelDescriptor->getName()
-                     << std::endl;
+bool OSPRayScene::_commitRootModelEntry(ModelDescriptorPtr modelDescriptor,
+                                        RootModelEntry& entry,
+                                        const bool geometryCommitted)
+{
+    std::vector<RootInstance> instances;
+    std::vector<OSPVolume> ospVolumes;
 
-        impl.commitGeometry();
-        impl.commitSimulationParams();
-        impl.logInformation();
+    if (modelDescriptor->getEnabled())
+    {
+        auto& impl = static_cast<OSPRayModel&>(modelDescriptor->getModel());
+        const auto& transformation = modelDescriptor->getTransformation();
 
         // add volumes to root model, because scivis renderer does not consider
         // volumes from instances
         if (modelDescriptor->getVisible())
         {
-            modelDescriptor->getModel().commitGeometry();
-            for (auto volume : modelDescriptor->getModel().getVolumes())
+            for (auto volume : impl.getVolumes())
             {
                 auto ospVolume =
                     std::dynamic_pointer_cast<OSPRayVolume>(volume);
-                ospAddVolume(_rootModel, ospVolume->impl());
+                ospVolumes.push_back(ospVolume->impl());
             }
         }
 
-        const auto& instances = modelDescriptor->getInstances();
-        for (size_t i = 0; i < instances.size(); ++i)
+        const auto& modelInstances = modelDescriptor->getInstances();
+        for (size_t i = 0; i < modelInstances.size(); ++i)
         {
-            const auto& instance = instances[i];
+            const auto& instance = modelInstances[i];
 
             // First instance uses model transformation
             const auto instanceTransform =
@@ -164,30 +217,80 @@ void OSPRayScene::commit()
             {
                 // scale and move the unit-sized bounding box geometry to the
                 // model size/scale first, then apply the instance transform
-                const auto& modelBounds =
-                    modelDescriptor->getModel().getBounds();
+                const auto& modelBounds = impl.getBounds();
                 Transformation modelTransform;
                 modelTransform.setTranslation(modelBounds.getCenter() -
                                               .5 * modelBounds.getSize());
                 modelTransform.setScale(modelBounds.getSize());
 
-                addInstance(_rootModel, impl.getBoundingBoxModel(),
-                            transformationToAffine3f(instanceTransform) *
-                                transformationToAffine3f(modelTransform));
+                instances.push_back(
+                    {impl.getBoundingBoxModel(),
+                     transformationToAffine3f(instanceTransform) *
+                         transformationToAffine3f(modelTransform)});
             }
 
             if (modelDescriptor->getVisible() && instance.getVisible())
-                addInstance(_rootModel, impl.getPrimaryModel(),
-                            instanceTransform);
+                instances.push_back(
+                    {impl.getPrimaryModel(),
+                     transformationToAffine3f(instanceTransform)});
         }
+    }
 
-        impl.markInstancesClean();
+    const bool unchanged =
+        !geometryCommitted && entry.modelDescriptor == modelDescriptor &&
+        entry.ospVolumes == ospVolumes &&
+        std::equal(entry.instances.begin(), entry.instances.end(),
+                   instances.begin(), instances.end(),
+                   [](const RootInstance& a, const RootInstance& b) {
+                       return a.model == b.model &&
+                              a.transformation == b.transformation;
+                   });
+    if (unchanged)
+        return false;
+
+    const bool wasEmpty =
+        entry.ospInstances.empty() && entry.ospVolumes.empty();
+    _removeFromRootModel(entry);
+
+    entry.modelDescriptor = modelDescriptor;
+    entry.instances = std::move(instances);
+    entry.ospVolumes = std::move(ospVolumes);
+    _addToRootModel(entry);
+
+    return !wasEmpty || !entry.ospInstances.empty() ||
+           !entry.ospVolumes.empty();
+}
+
+void OSPRayScene::_addToRootModel(RootModelEntry& entry)
+{
+    for (auto ospVolume : entry.ospVolumes)
+        ospAddVolume(_rootModel, ospVolume);
+
+    for (const auto& instance : entry.instances)
+    {
+        OSPGeometry ospInstance =
+            ospNewInstance(instance.model,
+                           (osp::affine3f&)instance.transformation);
+        ospCommit(ospInstance);
+        ospAddGeometry(_rootModel, ospInstance);
+        entry.ospInstances.push_back(ospInstance);
     }
-    BRAYNS_DEBUG << "Committing root models" << std::endl;
+    _numInstancesAdded += entry.ospInstances.size();
+}
 
-    ospCommit(_rootModel);
+void OSPRayScene::_removeFromRootModel(RootModelEntry& entry)
+{
+    for (auto ospVolume : entry.ospVolumes)
+        ospRemoveVolume(_rootModel, ospVolume);
+    entry.ospVolumes.clear();
 
-    _computeBounds();
+    for (auto ospInstance : entry.ospInstances)
+    {
+        ospRemoveGeometry(_rootModel, ospInstance);
+        ospRelease(ospInstance);
+    }
+    entry.ospInstances.clear();
+    entry.instances.clear();
 }
 
 bool OSPRayScene::commitLights()
@@ -338,16 +441,9 @@ bool OSPRayScene::_commitVolumes(ModelDescriptors& modelDescriptors)
 
 void OSPRayScene::_commitSimulationData(ModelDescriptors& modelDescriptors)
 {
-    auto currentFrame = _animationParameters.getFrame();
-
-    // if(_lastFrame == currentFrame && !isModified())
-    //    return;
-
-    //_lastFrame = currentFrame;
-
-    _simData.clear();
+    const auto currentFrame = _animationParameters.getFrame();
 
-    uint64_t offset = 0;
+    std::vector<SimulationFrame> frames;
     for (auto& model : modelDescriptors)
     {
         if (!model->getModel().isSimulationEnabled())
@@ -357,23 +453,95 @@ void OSPRayScene::_commitSimulationData(ModelDescriptors& modelDescriptors)
         if (!handler)
             continue;
 
-        auto& modelImpl = static_cast<OSPRayModel&>(model->getModel());
-        modelImpl.setSimulationOffset(offset);
-
         const float* data =
             static_cast<float*>(handler->getFrameData(currentFrame));
-        const uint64_t dataSize = handler->getFrameSize();
 
-        _simData.insert(_simData.end(), data, data + dataSize);
-        offset += dataSize;
+        // keep the previous frame until the handler has data to provide
+        if (!data)
+            return;
+
+        frames.push_back({handler, &model->getModel(), data,
+                          handler->getFrameSize(), handler->getCurrentFrame()});
+    }
+
+    // Nothing to upload if no handler has changed its frame since the last
+    // commit, e.g. while the animation is paused
+    const auto sameFrame = [](const SimulationFrame& a,
+                              const SimulationFrame& b) {
+        return a.handler == b.handler && a.model == b.model &&
+               a.data == b.data && a.size == b.size && a.frame == b.frame;
+    };
+    if (!isModified() && std::equal(frames.begin(), frames.end(),
+                                    _simulationFrames.begin(),
+                                    _simulationFrames.end(), sameFrame))
+        return;
+    ++_simulationUploads;
+
+    const auto sameLayout = [](const SimulationFrame& a,
+                               const SimulationFrame& b) {
+        return a.handler == b.handler && a.model == b.model &&
+               a.size == b.size;
+    };
+    const bool layoutChanged =
+        isModified() ||
+        !std::equal(frames.begin(), frames.end(), _simulationFrames.begin(),
+                     _simulationFrames.end(), sameLayout);
+
+    uint64_t offset = 0;
+    for (const auto& frame : frames)
+    {
+        static_cast<OSPRayModel*>(frame.model)->setSimulationOffset(offset);
+        offset += frame.size;
+    }
+
+    const float* sharedData = nullptr;
+    if (frames.size() == 1)
+    {
+        // Share the buffer of the only handler with OSPRay, no copy needed
+        _simData.clear();
+        _simData.shrink_to_fit();
+        sharedData = frames[0].data;
+    }
+    else if (!frames.empty())
+    {
+        // Concatenate the frames of all handlers, but only copy the frames
+        // that have changed if the layout of the buffer is the same
+        _simData.resize(offset);
+        offset = 0;
+        for (size_t i = 0; i < frames.size(); ++i)
+        {
+            const auto& frame = frames[i];
+            if (layoutChanged || !sameFrame(frame, _simulationFrames[i]))
+            {
+                std::copy(frame.data, frame.data + frame.size,
+                          _simData.begin() + offset);
+                _simulationBytesCopied += frame.size * sizeof(float);
+            }
+            offset += frame.size;
+        }
+        sharedData = _simData.data();
     }
 
+    _simulationFrames = std::move(frames);
+
+    // The shared OSPRay data reflects any change of the data it points to, it
+    // only needs to be recreated if the buffer has moved or changed size
+    if (_ospSimulationData && sharedData == _ospSimulationDataPtr &&
+        offset == _ospSimulationDataSize)
+        return;
+
     ospRelease(_ospSimulationData);
     _ospSimulationData = nullptr;
-    if (_simData.empty())
+    _ospSimulationDataPtr = sharedData;
+    _ospSimulationDataSize = offset;
+
+    // let the renderer pick up the new buffer
+    markModified(false);
+
+    if (!sharedData)
         return;
 
-    _ospSimulationData = ospNewData(_simData.size(), OSP_FLOAT, _simData.data(),
+    _ospSimulationData = ospNewData(offset, OSP_FLOAT, sharedData,
                                     OSP_DATA_SHARED_BUFFER);
     ospCommit(_ospSimulationData);
 }
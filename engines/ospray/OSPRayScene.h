@@ -27,6 +27,8 @@
 
 #include <ospray.h>
 
+#include <map>
+
 namespace brayns
 {
 /**
@@ -62,17 +64,87 @@ public:
         return _ospTransferFunction;
     }
 
+    /**
+     * @return the number of instances that have been added to the root model
+     * since the creation of the scene. Unchanged models are not re-added on
+     * commit, so this is a measure of the work done by incremental commits.
+     */
+    size_t getNumInstancesAdded() const { return _numInstancesAdded; }
+
+    /**
+     * @return the number of bytes of simulation data that have been copied
+     * since the creation of the scene. Simulation data is only uploaded when
+     * the frame of a simulation handler changes, and the buffer of a single
+     * handler is shared with OSPRay without any copy.
+     */
+    size_t getSimulationBytesCopied() const { return _simulationBytesCopied; }
+
+    /**
+     * @return the number of commits which have uploaded simulation data, at
+     * most one per commit whatever the number of simulation handlers.
+     */
+    size_t getSimulationUploads() const { return _simulationUploads; }
+
+    /**
+     * @return the simulation buffer shared with OSPRay, which is the buffer
+     * of the handler itself if there is only one.
+     */
+    const float* getSimulationData() const { return _ospSimulationDataPtr; }
+
 private:
+    /** An instance of an OSPRay model, as added to the root model. */
+    struct RootInstance
+    {
+        OSPModel model{nullptr};
+        ospcommon::affine3f transformation;
+    };
+
+    /**
+     * The OSPRay objects that have been added to the root model on behalf of
+     * a model descriptor, along with the state they were created from.
+     */
+    struct RootModelEntry
+    {
+        // keep models from being deleted via removeModel() as long as they
+        // are referenced by the root model
+        ModelDescriptorPtr modelDescriptor;
+        std::vector<RootInstance> instances;
+        std::vector<OSPGeometry> ospInstances;
+        std::vector<OSPVolume> ospVolumes;
+    };
+
     bool _commitVolumes(ModelDescriptors& modelDescriptors);
     void _commitTransferFunction();
     void _commitSimulationData(ModelDescriptors& modelDescriptors);
     void _destroyLights();
 
+    bool _commitRootModelEntry(ModelDescriptorPtr modelDescriptor,
+                               RootModelEntry& entry,
+                               const bool geometryCommitted);
+    void _addToRootModel(RootModelEntry& entry);
+    void _removeFromRootModel(RootModelEntry& entry);
+
     OSPModel _rootModel{nullptr};
+    std::map<size_t, RootModelEntry> _rootModelEntries;
+    size_t _numInstancesAdded{0};
 
+    /** The simulation frame of a model, as uploaded to OSPRay. */
+    struct SimulationFrame
+    {
+        AbstractSimulationHandlerPtr handler;
+        Model* model{nullptr};
+        const float* data{nullptr};
+        uint64_t size{0};
+        uint32_t frame{0};
+    };
+
+    std::vector<SimulationFrame> _simulationFrames;
     std::vector<float> _simData;
-    // uint32_t _lastFrame {std::numeric_limits<uint32_t>::max()};
+    size_t _simulationBytesCopied{0};
+    size_t _simulationUploads{0};
     OSPData _ospSimulationData{nullptr};
+    const float* _ospSimulationDataPtr{nullptr};
+    uint64_t _ospSimulationDataSize{0};
     OSPTransferFunction _ospTransferFunction{nullptr};
 
     std::vector<OSPLight> _ospLights;
@@ -80,7 +152,5 @@ private:
     OSPData _ospLightData{nullptr};
 
     size_t _memoryManagementFlags{0};
-
-    ModelDescriptors _activeModels;
 };
 } // namespace brayns
@@ -261,8 +261,8 @@ private:
 
         // TODO don't blend soma if far enough from eye
         const auto nindx = _srcGeom->neighboursIndex;
-        const auto& neighbors = _srcData->neighbours[nindx];
-        const auto numNeigh = neighbors.size();
+        const auto* neighbors = _srcData->neighbours.data() + nindx;
+        const auto numNeigh = _srcGeom->numNeighbours;
 
         if (numNeigh > 0)
         {
@@ -226,6 +226,8 @@ const brayns::Property PROP_SYNCHRONOUS_MODE = {
     "023SynchronousMode", true, {"Synchronous mode"}};
 const brayns::Property PROP_SPIKE_TRANSITION_TIME = {
     "024SpikeTransitionTime", 1.0, {"Growth and fade of spike in seconds"}};
+const brayns::Property PROP_SPIKE_TIME_INTERVAL = {
+    "025SpikeTimeInterval", 0.01, {"Time between two spike frames"}};
 const brayns::Property PROP_CIRCUIT_COLOR_SCHEME = {
     "030CircuitColorScheme", {enumToString(CircuitColorScheme::single_material),
     enumerateNames<CircuitColorScheme>()},
@@ -336,66 +338,35 @@ struct ParallelModelContainer
     {
         sdfMaterials.push_back(materialId);
         sdfGeometries.push_back(geom);
-        sdfNeighbours.push_back(neighbours);
+        sdfNeighbours.insert(sdfNeighbours.end(), neighbours.begin(),
+                             neighbours.end());
+        sdfNeighbourOffsets.push_back(sdfNeighbours.size());
     }
 
     void addSpheresToModel(brayns::Model& model) const
     {
         for (const auto& sphere : spheres)
-        {
-            const auto index = sphere.first;
-            model.getSpheres()[index].insert(model.getSpheres()[index].end(),
-                                             sphere.second.begin(),
-                                             sphere.second.end());
-        }
+            model.addSpheres(sphere.first, sphere.second);
     }
 
     void addCylindersToModel(brayns::Model& model) const
     {
         for (const auto& cylinder : cylinders)
-        {
-            const auto index = cylinder.first;
-            model.getCylinders()[index].insert(
-                model.getCylinders()[index].end(), cylinder.second.begin(),
-                cylinder.second.end());
-        }
+            model.addCylinders(cylinder.first, cylinder.second);
     }
 
     void addConesToModel(brayns::Model& model) const
     {
         for (const auto& cone : cones)
-        {
-            const auto index = cone.first;
-            model.getCones()[index].insert(model.getCones()[index].end(),
-                                           cone.second.begin(),
-                                           cone.second.end());
-        }
+            model.addCones(cone.first, cone.second);
     }
 
     void addSDFGeometriesToModel(brayns::Model& model) const
     {
-        const size_t numGeoms = sdfGeometries.size();
-        std::vector<size_t> localToGlobalIndex(numGeoms, 0);
-
-        // Add geometries to Model. We do not know the indices of the neighbours
-        // yet so we leave them empty.
-        for (size_t i = 0; i < numGeoms; i++)
-            localToGlobalIndex[i] =
-                model.addSDFGeometry(sdfMaterials[i], sdfGeometries[i], {});
-
-        // Write the neighbours using global indices
-        std::vector<size_t> neighboursTmp;
-        for (size_t i = 0; i < numGeoms; i++)
-        {
-            const size_t globalIndex = localToGlobalIndex[i];
-            neighboursTmp.clear();
-
-            for (auto localNeighbourIndex : sdfNeighbours[i])
-                neighboursTmp.push_back(
-                    localToGlobalIndex[localNeighbourIndex]);
-
-            model.updateSDFGeometryNeighbours(globalIndex, neighboursTmp);
-        }
+        // Neighbour indices are local to this container, the model offsets
+        // them when appending the geometries
+        model.addSDFGeometries(sdfMaterials, sdfGeometries, sdfNeighbourOffsets,
+                               sdfNeighbours);
     }
 
     void applyTransformation(const brayns::Matrix4f& transformation)
@@ -436,6 +407,9 @@ struct ParallelModelContainer
     brayns::TriangleMeshMap trianglesMeshes;
     MorphologyInfo morphologyInfo;
     std::vector<brayns::SDFGeometry> sdfGeometries;
-    std::vector<std::vector<size_t>> sdfNeighbours;
+    // Neighbours of geometry i are in [sdfNeighbourOffsets[i],
+    // sdfNeighbourOffsets[i + 1])
+    std::vector<uint64_t> sdfNeighbourOffsets{0};
+    std::vector<uint64_t> sdfNeighbours;
     std::vector<size_t> sdfMaterials;
 };
@@ -95,6 +95,10 @@ void CircuitExplorerMaterial::commit()
     // User parameter
     userParameter = getParam1f(MATERIAL_PROPERTY_USER_PARAMETER.c_str(), 1.f);
 
+    // Color palette
+    paletteColors = getParamData("palette_colors", nullptr);
+    paletteOffsets = getParamData("palette_offsets", nullptr);
+
     ispc::CircuitExplorerMaterial_set(
         getIE(), map_d ? map_d->getIE() : nullptr,
         (const ispc::AffineSpace2f&)xform_d, d,
@@ -113,7 +117,11 @@ void CircuitExplorerMaterial::commit()
         (const ispc::AffineSpace2f&)xform_Bump,
         (const ispc::LinearSpace2f&)rot_Bump,
         (const ispc::MaterialShadingMode&)shadingMode,
-        (const ispc::MaterialClippingMode&)clippingMode, userParameter);
+        (const ispc::MaterialClippingMode&)clippingMode, userParameter,
+        paletteColors ? (ispc::vec3f*)paletteColors->data : nullptr,
+        paletteColors ? paletteColors->size() : 0,
+        paletteOffsets ? (uint64_t*)paletteOffsets->data : nullptr,
+        paletteOffsets ? paletteOffsets->size() : 0);
 }
 
 OSP_REGISTER_MATERIAL(circuit_explorer_basic, CircuitExplorerMaterial, default);
@@ -90,6 +90,10 @@ struct CircuitExplorerMaterial : public ospray::Material
     /*! User parameter */
     float userParameter;
 
+    /*! Per primitive colors, replacing the diffuse color */
+    ospray::Data* paletteColors;
+    ospray::Data* paletteOffsets;
+
     std::string toString() const final { return "default_material"; }
     void commit() final;
 };
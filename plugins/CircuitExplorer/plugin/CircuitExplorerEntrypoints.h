@@ -45,6 +45,7 @@
 #include <plugin/entrypoints/SetMetaballsPerSimulationValueEntrypoint.h>
 #include <plugin/entrypoints/SetSynapsesAttributesEntrypoint.h>
 #include <plugin/entrypoints/TraceAnterogradeEntrypoint.h>
+#include <plugin/entrypoints/VoltageFrameCacheEntrypoint.h>
 
 #include "CircuitExplorerPlugin.h"
 
@@ -67,6 +68,8 @@ public:
         plugin.add<SetOduCameraEntrypoint>();
         plugin.add<AttachCellGrowthHandlerEntrypoint>();
         plugin.add<AttachCircuitSimulationHandlerEntrypoint>();
+        plugin.add<GetVoltageFrameCacheEntrypoint>();
+        plugin.add<SetVoltageFrameCacheEntrypoint>();
         plugin.add<ExportFramesToDiskEntrypoint>(plugin);
         plugin.add<GetExportFramesProgressEntrypoint>(plugin);
         plugin.add<MakeMovieEntrypoint>();
@@ -292,6 +292,14 @@ void CircuitExplorerPlugin::preRender()
         _api->getScene().markModified();
     _dirty = false;
 
+    // Frames are written asynchronously, failures are reported here
+    if (_exportFramesToDiskDirty && !_exportFrameError && _frameExporter &&
+        _frameExporter->getStatistics().failed > 0)
+    {
+        _exportFrameError = true;
+        _exportFrameErrorMessage = _frameExporter->getLastError();
+    }
+
     // If there was an error during the last frame export, stop the export
     // process
     if (_exportFrameError)
@@ -380,6 +388,10 @@ brayns::Message CircuitExplorerPlugin::exportFramesToDisk(
     _exportFrameErrorMessage = "";
     _frameNumber = payload.startFrame;
     _accumulationFrameNumber = 0;
+    if (_frameExporter)
+        _frameExporter->reset();
+    else
+        _frameExporter = std::make_unique<FrameExporter>();
     auto& frameBuffer = _api->getEngine().getFrameBuffer();
     frameBuffer.clear();
 
@@ -451,14 +463,11 @@ brayns::Message CircuitExplorerPlugin::_setCamera(
 void CircuitExplorerPlugin::_doExportFrameToDisk()
 {
     auto& frameBuffer = _api->getEngine().getFrameBuffer();
-    auto image = frameBuffer.getImage();
     auto fif = _exportFramesToDiskPayload.format == "jpg"
                    ? FIF_JPEG
                    : FreeImage_GetFIFFromFormat(
                          _exportFramesToDiskPayload.format.c_str());
-    if (fif == FIF_JPEG)
-        image.reset(FreeImage_ConvertTo24Bits(image.get()));
-    else if (fif == FIF_UNKNOWN)
+    if (fif == FIF_UNKNOWN)
         throw std::runtime_error("Unknown format: " +
                                  _exportFramesToDiskPayload.format);
 
@@ -466,14 +475,6 @@ void CircuitExplorerPlugin::_doExportFrameToDisk()
     if (fif == FIF_TIFF)
         flags = TIFF_NONE;
 
-    brayns::freeimage::MemoryPtr memory(FreeImage_OpenMemory());
-
-    FreeImage_SaveToMemory(fif, image.get(), memory.get(), flags);
-
-    BYTE* pixels = nullptr;
-    DWORD numPixels = 0;
-    FreeImage_AcquireMemory(memory.get(), &pixels, &numPixels);
-
     auto fn = _frameNumber;
     if (_exportFramesToDiskPayload.nameAfterStep)
         fn = _exportFramesToDiskPayload.animationInformation[_frameNumber];
@@ -482,47 +483,29 @@ void CircuitExplorerPlugin::_doExportFrameToDisk()
 
     std::string filename = _exportFramesToDiskPayload.path + '/' + frame + "." +
                            _exportFramesToDiskPayload.format;
-    std::ofstream file;
-
-    try
-    {
-        file.open(filename, std::ios_base::binary);
-    }
-    catch (const std::exception& e)
-    {
-        frameBuffer.clear();
-        _exportFrameError = true;
-        _exportFrameErrorMessage = std::string(e.what());
-        return;
-    }
-
-    if (!file.is_open())
-    {
-        frameBuffer.clear();
-        _exportFrameError = true;
-        _exportFrameErrorMessage = "Failed to create " + filename;
-        return;
-    }
-
-    file.write((char*)pixels, numPixels);
-    file.close();
 
+    // Only the copy of the frame buffer is done on the render thread, encoding
+    // and writing happen in the exporter threads
+    auto image = frameBuffer.getImage();
     frameBuffer.clear();
-
-    PLUGIN_INFO << "Frame saved to " << filename << std::endl;
+    _frameExporter->push(std::move(image), fif, flags, filename);
 }
 
 FrameExportProgress CircuitExplorerPlugin::getFrameExportProgress()
 {
     FrameExportProgress result;
 
+    // An exported frame counts one step per sample and one step once it is
+    // written, so that the export only completes when all files are on disk
+    const size_t numberOfFrames =
+        _exportFramesToDiskPayload.animationInformation.size() -
+        _exportFramesToDiskPayload.startFrame;
     const size_t totalNumberOfFrames =
-        (_exportFramesToDiskPayload.animationInformation.size() -
-         _exportFramesToDiskPayload.startFrame) *
-        _exportFramesToDiskPayload.spp;
+        numberOfFrames * (_exportFramesToDiskPayload.spp + 1);
+    const auto statistics = getFrameExportStatistics();
     const float currentProgress =
         _frameNumber * _exportFramesToDiskPayload.spp +
-        _accumulationFrameNumber;
+        _accumulationFrameNumber + statistics.written + statistics.failed;
 
     result.progress = std::min(static_cast<double>(currentProgress /
                                                    float(totalNumberOfFrames)),
@@ -534,6 +517,13 @@ FrameExportProgress CircuitExplorerPlugin::getFrameExportProgress()
     return result;
 }
 
+FrameExportStatistics CircuitExplorerPlugin::getFrameExportStatistics() const
+{
+    if (!_frameExporter)
+        return {};
+    return _frameExporter->getStatistics();
+}
+
 extern "C" brayns::ExtensionPlugin* brayns_plugin_create(int /*argc*/,
                                                          char** /*argv*/)
 {
@@ -24,6 +24,7 @@
 #include <plugin/api/CellObjectMapper.h>
 #include <plugin/api/CircuitExplorerParams.h>
 #include <plugin/io/AbstractCircuitLoader.h>
+#include <plugin/io/FrameExporter.h>
 
 #include <array>
 #include <brayns/common/types.h>
@@ -72,6 +73,7 @@ public:
     SynapseAttributes& getSynapseAttributes() { return _synapseAttributes; }
     brayns::Message exportFramesToDisk(const ExportFramesToDisk& payload);
     FrameExportProgress getFrameExportProgress();
+    FrameExportStatistics getFrameExportStatistics() const;
 
 private:
     brayns::Message _setCamera(const CameraDefinition&);
@@ -91,6 +93,8 @@ private:
     size_t _prevAccumulationSetting;
     bool _exportFrameError{false};
     std::string _exportFrameErrorMessage;
+    // Encodes and writes the exported frames off the render thread
+    std::unique_ptr<FrameExporter> _frameExporter;
 
     std::vector<std::unique_ptr<CellObjectMapper>> _mappers;
 };
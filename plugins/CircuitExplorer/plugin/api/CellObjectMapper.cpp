@@ -8,8 +8,52 @@
 #include <brayns/common/simulation/AbstractSimulationHandler.h>
 #include <brayns/engine/Material.h>
 
+#include <algorithm>
+#include <map>
+#include <numeric>
+
 #define NB_MATERIALS_PER_INSTANCE 3
 
+namespace
+{
+const std::vector<brayns::Vector3d> DEFAULT_COLORS = {
+    {0.8941176470588236, 0.10196078431372549, 0.10980392156862745},
+    {0.21568627450980393, 0.49411764705882355, 0.7215686274509804},
+    {0.30196078431372547, 0.6862745098039216, 0.2901960784313726},
+    {0.596078431372549, 0.3058823529411765, 0.6392156862745098},
+    {1.0, 0.4980392156862745, 0.0},
+    {1.0, 1.0, 0.2},
+    {0.6509803921568628, 0.33725490196078434, 0.1568627450980392},
+    {0.9686274509803922, 0.5058823529411764, 0.7490196078431373},
+    {0.6, 0.6, 0.6},
+    {0.8941176470588236, 0.10196078431372549, 0.10980392156862745},
+    {0.21568627450980393, 0.49411764705882355, 0.7215686274509804},
+    {0.30196078431372547, 0.6862745098039216, 0.2901960784313726},
+    {0.596078431372549, 0.3058823529411765, 0.6392156862745098},
+    {1.0, 0.4980392156862745, 0.0},
+    {1.0, 1.0, 0.2},
+    {0.6509803921568628, 0.33725490196078434, 0.1568627450980392},
+    {0.9686274509803922, 0.5058823529411764, 0.7490196078431373},
+    {0.6, 0.6, 0.6},
+    {0.8941176470588236, 0.10196078431372549, 0.10980392156862745},
+    {0.21568627450980393, 0.49411764705882355, 0.7215686274509804}};
+
+size_t getCellMaterialId(const MorphologyMap& mm)
+{
+    for (const auto map : {&mm._sphereMap, &mm._cylinderMap, &mm._coneMap,
+                           &mm._sdfBezierMap, &mm._sdfGeometryMap})
+        if (!map->empty())
+            return map->begin()->first;
+    return brayns::NO_MATERIAL;
+}
+
+bool isCircuitMaterial(const size_t materialId)
+{
+    return materialId != brayns::SECONDARY_MODEL_MATERIAL_ID &&
+           materialId != brayns::BOUNDINGBOX_MATERIAL_ID;
+}
+} // namespace
+
 // ------------------------------------------------------------------------------
 
 void CellObjectMapper::setSourceModel(brayns::ModelDescriptorPtr model)
@@ -43,6 +87,9 @@ RemapResult CellObjectMapper::remapCircuitColors(
         return result;
     }
 
+    if (_paletteEnabled)
+        return _remapPaletteColors(scheme);
+
     PLUGIN_INFO << "Remapping circuit..." << std::endl;
 
     // Gather current geometry mapping (material -> geometry list)
@@ -353,6 +400,61 @@ void CellObjectMapper::onCircuitColorFinish(
     }
 }
 
+void CellObjectMapper::enableColorPalette(const brayns::uint64_ts& cellOffsets)
+{
+    _paletteEnabled = true;
+    _paletteOffsets.clear();
+    _paletteEntries.clear();
+    if (cellOffsets.empty())
+        return;
+
+    // Palette offsets must be sorted, cells are reordered accordingly
+    std::vector<size_t> order(cellOffsets.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return cellOffsets[a] < cellOffsets[b];
+    });
+
+    _paletteOffsets.resize(order.size());
+    _paletteEntries.resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        _paletteOffsets[i] = cellOffsets[order[i]];
+        _paletteEntries[order[i]] = i;
+    }
+}
+
+bool CellObjectMapper::setCellColor(const size_t gid,
+                                    const brayns::Vector3f& color)
+{
+    auto it = _cellToRenderableMap.find(gid);
+    if (it == _cellToRenderableMap.end())
+        return false;
+
+    _attachColorPalette();
+    const auto entry = _getPaletteEntry(it->second._linealIndex);
+    if (entry >= _palette->colors.size())
+        return false;
+    _palette->colors[entry] = color;
+    return true;
+}
+
+void CellObjectMapper::commitCellColors()
+{
+    if (!_palette)
+        return;
+
+    // The palette is shared and updated in place, materials only need to
+    // refresh their renderer side copy of its parameters
+    for (auto& material : _model->getModel().getMaterials())
+    {
+        if (material.second->getColorPalette() != _palette)
+            continue;
+        material.second->markModified();
+        material.second->commit();
+    }
+}
+
 CircuitSchemeData& CellObjectMapper::getSchemeData()
 {
     return _data;
@@ -428,38 +530,138 @@ size_t CellObjectMapper::_computeMaterialId(const CircuitColorScheme scheme,
 
 void CellObjectMapper::_applyDefaultColorMap() const
 {
-    const static std::vector<brayns::Vector3d> colors = {
-        {0.8941176470588236, 0.10196078431372549, 0.10980392156862745},
-        {0.21568627450980393, 0.49411764705882355, 0.7215686274509804},
-        {0.30196078431372547, 0.6862745098039216, 0.2901960784313726},
-        {0.596078431372549, 0.3058823529411765, 0.6392156862745098},
-        {1.0, 0.4980392156862745, 0.0},
-        {1.0, 1.0, 0.2},
-        {0.6509803921568628, 0.33725490196078434, 0.1568627450980392},
-        {0.9686274509803922, 0.5058823529411764, 0.7490196078431373},
-        {0.6, 0.6, 0.6},
-        {0.8941176470588236, 0.10196078431372549, 0.10980392156862745},
-        {0.21568627450980393, 0.49411764705882355, 0.7215686274509804},
-        {0.30196078431372547, 0.6862745098039216, 0.2901960784313726},
-        {0.596078431372549, 0.3058823529411765, 0.6392156862745098},
-        {1.0, 0.4980392156862745, 0.0},
-        {1.0, 1.0, 0.2},
-        {0.6509803921568628, 0.33725490196078434, 0.1568627450980392},
-        {0.9686274509803922, 0.5058823529411764, 0.7490196078431373},
-        {0.6, 0.6, 0.6},
-        {0.8941176470588236, 0.10196078431372549, 0.10980392156862745},
-        {0.21568627450980393, 0.49411764705882355, 0.7215686274509804}};
 
     uint64_t i = 0;
     auto& materials = _model->getModel().getMaterials();
     for (auto& material : materials)
     {
-        if (material.first != brayns::SECONDARY_MODEL_MATERIAL_ID &&
-            material.first != brayns::BOUNDINGBOX_MATERIAL_ID)
+        if (isCircuitMaterial(material.first))
         {
-            const auto& color = colors[i % colors.size()];
+            const auto& color = DEFAULT_COLORS[i % DEFAULT_COLORS.size()];
             material.second->setDiffuseColor(color);
             ++i;
         }
     }
 }
+
+RemapResult CellObjectMapper::_remapPaletteColors(
+    const CircuitColorScheme scheme)
+{
+    RemapResult result;
+    result.error = 0;
+    result.message = "";
+    result.updated = true;
+
+    PLUGIN_INFO << "Remapping circuit palette..." << std::endl;
+
+    // Clear current scheme to material mapping
+    _data.etypes.materialMap.clear();
+    _data.layers.materialMap.clear();
+    _data.mtypes.materialMap.clear();
+    _data.targets.materialMap.clear();
+
+    try
+    {
+        if (scheme == CircuitColorScheme::none)
+            // Materials get their own colors back
+            _detachColorPalette();
+        else
+        {
+            _attachColorPalette();
+
+            // Compute the group of every cell, groups being colored like the
+            // default color map would color their materials
+            std::vector<std::pair<size_t, size_t>> cellGroups;
+            cellGroups.reserve(_cellToRenderableMap.size());
+            std::map<size_t, size_t> groupColors;
+            for (const auto& pair : _cellToRenderableMap)
+            {
+                const auto index = pair.second._linealIndex;
+                const auto groupId = _computeMaterialId(scheme, index);
+                cellGroups.emplace_back(index, groupId);
+                groupColors[groupId] = 0;
+            }
+
+            size_t i = 0;
+            for (auto& group : groupColors)
+                group.second = i++ % DEFAULT_COLORS.size();
+
+            auto& colors = _palette->colors;
+            for (const auto& cellGroup : cellGroups)
+            {
+                const auto entry = _getPaletteEntry(cellGroup.first);
+                if (entry < colors.size())
+                    colors[entry] = brayns::Vector3f(
+                        DEFAULT_COLORS[groupColors[cellGroup.second]]);
+            }
+            commitCellColors();
+        }
+
+        onCircuitColorFinish(scheme, MorphologyColorScheme::none);
+
+        _lastScheme = scheme;
+        _lastMorphologyScheme = MorphologyColorScheme::none;
+    }
+    catch (std::exception& e)
+    {
+        result.error = 3;
+        result.message = "An exception occoured: " + std::string(e.what());
+    }
+
+    PLUGIN_INFO << "Remapping done!" << std::endl;
+
+    return result;
+}
+
+size_t CellObjectMapper::_getPaletteEntry(const size_t linealIndex) const
+{
+    if (_paletteEntries.empty())
+        return linealIndex;
+    if (linealIndex >= _paletteEntries.size())
+        return std::numeric_limits<size_t>::max();
+    return _paletteEntries[linealIndex];
+}
+
+void CellObjectMapper::_attachColorPalette()
+{
+    if (_palette)
+        return;
+
+    auto& model = _model->getModel();
+    auto& materials = model.getMaterials();
+
+    // Cells start with the color of their current material, so that attaching
+    // the palette does not change the look of the circuit
+    _palette = std::make_shared<brayns::ColorPalette>();
+    _palette->colors.resize(_cellToRenderableMap.size(), brayns::Vector3f(1.f));
+    _palette->offsets = _paletteOffsets;
+    for (const auto& pair : _cellToRenderableMap)
+    {
+        const auto entry = _getPaletteEntry(pair.second._linealIndex);
+        const auto it = materials.find(getCellMaterialId(pair.second));
+        if (entry < _palette->colors.size() && it != materials.end())
+            _palette->colors[entry] =
+                brayns::Vector3f(it->second->getDiffuseColor());
+    }
+
+    for (auto& material : materials)
+        if (isCircuitMaterial(material.first))
+        {
+            material.second->setColorPalette(_palette);
+            material.second->commit();
+        }
+}
+
+void CellObjectMapper::_detachColorPalette()
+{
+    if (!_palette)
+        return;
+
+    for (auto& material : _model->getModel().getMaterials())
+        if (material.second->getColorPalette() == _palette)
+        {
+            material.second->setColorPalette(nullptr);
+            material.second->commit();
+        }
+    _palette.reset();
+}
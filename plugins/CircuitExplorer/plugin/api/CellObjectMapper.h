@@ -23,6 +23,7 @@
 
 #include <brayns/common/types.h>
 
+#include <brayns/engine/Material.h>
 #include <brayns/engine/Model.h>
 #include <brayns/engine/Scene.h>
 
@@ -82,6 +83,24 @@ public:
     void onCircuitColorFinish(const CircuitColorScheme& scheme,
                               const MorphologyColorScheme& mScheme);
 
+    /**
+     * @brief enableColorPalette allows the circuit to be recolored through a
+     * per-cell color palette looked up with the primitive user data, instead
+     * of rebuilding the model
+     * @param cellOffsets First user data value of each cell, by lineal index.
+     * Empty when the user data of the primitives is the lineal index itself
+     */
+    void enableColorPalette(const brayns::uint64_ts& cellOffsets);
+    bool hasColorPalette() const noexcept { return _paletteEnabled; }
+
+    /**
+     * @brief setCellColor sets the palette color of a cell. Changes are applied
+     * by commitCellColors()
+     * @return false if the cell is not part of the circuit
+     */
+    bool setCellColor(const size_t gid, const brayns::Vector3f& color);
+    void commitCellColors();
+
     CircuitSchemeData& getSchemeData();
     const std::unordered_map<size_t, MorphologyMap>& getMapping() const noexcept
     {
@@ -96,6 +115,11 @@ private:
 
     void _applyDefaultColorMap() const;
 
+    RemapResult _remapPaletteColors(const CircuitColorScheme scheme);
+    size_t _getPaletteEntry(const size_t linealIndex) const;
+    void _attachColorPalette();
+    void _detachColorPalette();
+
 private:
     brayns::ModelDescriptorPtr _model;
 
@@ -106,4 +130,12 @@ private:
 
     // Maps GIDs to all the pieces that forms the morphology of the given cell
     std::unordered_map<size_t, MorphologyMap> _cellToRenderableMap;
+
+    // Per-cell colors shared by the materials of the model. Attached on the
+    // first recoloring, the offsets and entries stay empty when the primitive
+    // user data is the lineal index of the cell
+    bool _paletteEnabled{false};
+    brayns::uint64_ts _paletteOffsets;
+    std::vector<size_t> _paletteEntries;
+    brayns::ColorPalettePtr _palette;
 };
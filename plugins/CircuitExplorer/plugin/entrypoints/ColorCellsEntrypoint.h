@@ -123,6 +123,25 @@ public:
                 9, "Internal error during parsing of cells to color");
         }
 
+        // Color cells through the palette when the circuit supports it, only
+        // the palette entries of the cells are then updated
+        if (mapper->hasColorPalette())
+        {
+            for (size_t i = 0; i < gidBatches.size(); ++i)
+            {
+                const brayns::Vector3f color(gidColors[i]);
+                for (const auto cellGID : gidBatches[i])
+                {
+                    mapper->setCellColor(cellGID, color);
+                }
+            }
+            mapper->commitCellColors();
+            model.markModified();
+            scene.markModified();
+            engine.triggerRender();
+            return;
+        }
+
         // Color cells
         const auto& mapping = mapper->getMapping();
         for (size_t i = 0; i < gidBatches.size(); ++i)
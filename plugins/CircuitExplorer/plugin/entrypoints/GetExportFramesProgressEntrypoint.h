@@ -53,7 +53,14 @@ public:
         auto error = properties.find("error");
         if (!error)
         {
-            request.reply({result.progress});
+            auto statistics = _plugin->getFrameExportStatistics();
+            GetExportFramesProgressMessage reply;
+            reply.progress = result.progress;
+            reply.queued_frames = statistics.queued;
+            reply.encoded_frames = statistics.encoded;
+            reply.written_frames = statistics.written;
+            reply.failed_frames = statistics.failed;
+            request.reply(reply);
             return;
         }
         auto code = error->as<int32_t>();
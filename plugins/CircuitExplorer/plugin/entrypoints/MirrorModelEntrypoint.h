@@ -136,6 +136,8 @@ public:
         const size_t originalOffset = sdfGeometry.geometries.size();
         std::vector<brayns::SDFGeometry> tempBuf;
         tempBuf.reserve(originalOffset);
+        auto& neighbours = sdfGeometry.neighbours;
+        neighbours.reserve(neighbours.size() * 2);
         for (auto& entry : sdfGeometry.geometryIndices)
         {
             std::vector<uint64_t> extraIndices;
@@ -154,16 +156,17 @@ public:
                 // Update geometry indices (materials)
                 extraIndices.push_back(originalOffset + tempBuf.size());
                 // Update neighbours
-                auto newNeighbours = sdfGeometry.neighbours[geomIndex];
-                for (size_t i = 0; i < newNeighbours.size(); ++i)
-                    newNeighbours[i] += originalOffset;
-                sdfGeometry.neighbours.push_back(newNeighbours);
+                const uint64_t neighboursIndex = neighbours.size();
+                for (size_t i = 0; i < geom.numNeighbours; ++i)
+                    neighbours.push_back(neighbours[geom.neighboursIndex + i] +
+                                         originalOffset);
                 // Insert the new geometry
                 tempBuf.emplace_back();
                 brayns::SDFGeometry& last = tempBuf.back();
                 last = geom;
                 last.p0 += toP0;
                 last.p1 += toP1;
+                last.neighboursIndex = neighboursIndex;
             }
             entry.second.insert(entry.second.end(), extraIndices.begin(),
                                 extraIndices.end());
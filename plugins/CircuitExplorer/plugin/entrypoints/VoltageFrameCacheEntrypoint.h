@@ -0,0 +1,118 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <brayns/network/common/ExtractModel.h>
+#include <brayns/network/entrypoint/Entrypoint.h>
+
+#include <plugin/io/VoltageSimulationHandler.h>
+#include <plugin/messages/VoltageFrameCacheMessage.h>
+
+class VoltageFrameCacheExtractor
+{
+public:
+    static VoltageFrameCache& extract(brayns::Scene& scene, size_t modelId)
+    {
+        auto& descriptor = brayns::ExtractModel::fromId(scene, modelId);
+        auto& model = descriptor.getModel();
+        auto handler = std::dynamic_pointer_cast<VoltageSimulationHandler>(
+            model.getSimulationHandler());
+        if (!handler)
+        {
+            throw brayns::EntrypointException(
+                "Model " + std::to_string(modelId) +
+                " has no voltage simulation");
+        }
+        return handler->getFrameCache();
+    }
+};
+
+class GetVoltageFrameCacheEntrypoint
+    : public brayns::Entrypoint<GetVoltageFrameCacheMessage,
+                                VoltageFrameCacheMessage>
+{
+public:
+    virtual std::string getName() const override
+    {
+        return "get-voltage-frame-cache";
+    }
+
+    virtual std::string getDescription() const override
+    {
+        return "Get the settings and statistics of the voltage frame cache of "
+               "a model";
+    }
+
+    virtual void onRequest(const Request& request) override
+    {
+        auto params = request.getParams();
+        auto& scene = getApi().getScene();
+        auto modelId = params.model_id;
+        auto& cache = VoltageFrameCacheExtractor::extract(scene, modelId);
+        auto& settings = cache.getSettings();
+        auto statistics = cache.getStatistics();
+        VoltageFrameCacheMessage result;
+        result.capacity = settings.capacity;
+        result.read_ahead = settings.readAhead;
+        result.memory_budget = settings.memoryBudget;
+        result.hits = statistics.hits;
+        result.misses = statistics.misses;
+        result.cached_frames = statistics.cachedFrames;
+        result.pending_frames = statistics.pendingFrames;
+        result.memory_usage = statistics.memoryUsage;
+        request.reply(result);
+    }
+};
+
+class SetVoltageFrameCacheEntrypoint
+    : public brayns::Entrypoint<SetVoltageFrameCacheMessage,
+                                brayns::EmptyMessage>
+{
+public:
+    virtual std::string getName() const override
+    {
+        return "set-voltage-frame-cache";
+    }
+
+    virtual std::string getDescription() const override
+    {
+        return "Set the size and read-ahead of the voltage frame cache of a "
+               "model";
+    }
+
+    virtual void onRequest(const Request& request) override
+    {
+        auto params = request.getParams();
+        if (params.capacity == 0)
+        {
+            throw brayns::EntrypointException(
+                "The cache must hold at least one frame");
+        }
+        auto& scene = getApi().getScene();
+        auto modelId = params.model_id;
+        auto& cache = VoltageFrameCacheExtractor::extract(scene, modelId);
+        VoltageFrameCacheSettings settings;
+        settings.capacity = params.capacity;
+        settings.readAhead = params.read_ahead;
+        settings.memoryBudget = params.memory_budget;
+        cache.setSettings(settings);
+        request.reply(brayns::EmptyMessage());
+    }
+};
@@ -41,6 +41,8 @@
 #include <brayns/io/MeshLoader.h>
 #endif
 
+#include <algorithm>
+#include <exception>
 #include <unordered_set>
 
 namespace
@@ -51,6 +53,16 @@ const strings LOADER_EXTENSIONS{"BlueConfig",    "BlueConfig3",
                                 "circuit",       "CircuitConfig_nrn"};
 const std::string GID_PATTERN = "{gid}";
 const size_t NB_MATERIALS_PER_INSTANCE = 3;
+const size_t MORPHOLOGY_BATCH_SIZE = 1000;
+
+// Read through the const accessors of the model, the non-const ones flag all
+// its geometries as modified
+template <typename MapType>
+size_t _getGeometryCount(const MapType &geometries, const size_t materialId)
+{
+    const auto it = geometries.find(materialId);
+    return it == geometries.end() ? 0 : it->second.size();
+}
 } // namespace
 
 AbstractCircuitLoader::AbstractCircuitLoader(
@@ -245,9 +257,12 @@ CompartmentReportPtr AbstractCircuitLoader::_attachSimulationHandler(
         const auto &spikeReport = blueConfiguration.getSpikeSource();
         const auto transitionTime =
             properties[PROP_SPIKE_TRANSITION_TIME.getName()].as<double>();
+        const auto timeInterval =
+            properties.valueOr(PROP_SPIKE_TIME_INTERVAL.getName(), 0.01);
         PLUGIN_INFO << "Spike report: " << spikeReport << std::endl;
         auto handler = std::make_shared<SpikeSimulationHandler>(
-            spikeReport.getPath(), gids, static_cast<float>(transitionTime));
+            spikeReport.getPath(), gids, static_cast<float>(transitionTime),
+            static_cast<float>(timeInterval));
         model.setSimulationHandler(handler);
         simulationHandler = handler;
         setSimulationTransferFunction(_scene.getTransferFunction());
@@ -532,6 +547,26 @@ brayns::ModelDescriptorPtr AbstractCircuitLoader::importCircuitFromBlueConfig(
             plptr->releaseCircuitMapper(remMod.getModelID());
         });
 
+    // Morphologies whose primitive user data identifies their cell can be
+    // recolored through a palette, without rebuilding the model
+    if (meshFolder.empty() && userDataType != UserDataType::distance_to_soma)
+    {
+        if (!compartmentReport)
+            objMapper.enableColorPalette({});
+        else if (userDataType == UserDataType::simulation_offset)
+        {
+            brayns::uint64_ts cellOffsets;
+            const auto &offsets = compartmentReport->getOffsets();
+            for (size_t i = 0; i < allGids.size() && i < offsets.size(); ++i)
+                cellOffsets.push_back(
+                    offsets[i].empty()
+                        ? 0
+                        : *std::min_element(offsets[i].begin(),
+                                            offsets[i].end()));
+            objMapper.enableColorPalette(cellOffsets);
+        }
+    }
+
     objMapper.setSourceModel(modelDescriptor);
     objMapper.onCircuitColorFinish(colorScheme, morphologyScheme);
 
@@ -912,8 +947,15 @@ float AbstractCircuitLoader::_importMorphologies(
     if (!somasOnly)
         uris = circuit.getMorphologyURIs(gids);
 
-    brayns::PropertyMap morphologyProps(properties);
-    MorphologyLoader loader(_scene, std::move(morphologyProps));
+    // Material ids are resolved serially since the scheme data is shared
+    const size_t nbCells = gids.size();
+    const std::vector<uint32_t> gidList(gids.begin(), gids.end());
+    std::vector<size_t> materialIds;
+    materialIds.reserve(nbCells);
+    for (size_t i = 0; i < nbCells; ++i)
+        materialIds.push_back(
+            _getMaterialFromCircuitAttributes(properties, i, materialId, false,
+                                              &mapper.getSchemeData()));
 
     // Function to compute shape indexes within the model and store them into
     // the morphology map
@@ -928,54 +970,102 @@ float AbstractCircuitLoader::_importMorphologies(
             }
         };
 
-    size_t i = 0;
-    for (auto gid : gids)
+    // Morphologies are converted into per-cell containers by a pool of
+    // loaders, one batch at a time. Containers are then added to the model in
+    // gid order, so that the result is identical to a serial load
+    for (size_t batchStart = 0; batchStart < nbCells;
+         batchStart += MORPHOLOGY_BATCH_SIZE)
     {
-        const auto uri = somasOnly ? brain::URI() : uris[i];
-        const auto id =
-            _getMaterialFromCircuitAttributes(properties, i, materialId, false,
-                                              &mapper.getSchemeData());
+        const size_t batchEnd =
+            std::min(batchStart + MORPHOLOGY_BATCH_SIZE, nbCells);
+        std::vector<ParallelModelContainer> containers(batchEnd - batchStart);
+        std::exception_ptr error;
 
-        loader.setDefaultMaterialId(id);
-
-        // Start indices before adding the morphology
-        const size_t startSpheres = model.getSpheres()[id].size();
-        const size_t startCones = model.getCones()[id].size();
-        const size_t startCylinders = model.getCylinders()[id].size();
-        const size_t startSDFGeoms =
-            model.getSDFGeometryData().geometries.size();
-        const size_t startSDFBeziers = model.getSDFBeziers()[id].size();
-
-        MorphologyInfo morphologyInfo;
-        morphologyInfo = loader.importMorphology(morphologyProps, uri, model, i,
-                                                 transformations[i], nullptr,
-                                                 nullptr, compartmentReport);
-
-        // End indices after adding the morphology
-        const size_t endSpheres = model.getSpheres()[id].size();
-        const size_t endCones = model.getCones()[id].size();
-        const size_t endCylinders = model.getCylinders()[id].size();
-        const size_t endSDFGeoms = model.getSDFGeometryData().geometries.size();
-        const size_t endSDFBeziers = model.getSDFBeziers()[id].size();
-
-        // Map morphology
-        MorphologyMap newMap;
-        func(newMap._sphereMap, id, startSpheres, endSpheres);
-        func(newMap._coneMap, id, startCones, endCones);
-        func(newMap._cylinderMap, id, startCylinders, endCylinders);
-        func(newMap._sdfGeometryMap, id, startSDFGeoms, endSDFGeoms);
-        func(newMap._sdfBezierMap, id, startSDFBeziers, endSDFBeziers);
-        newMap._linealIndex = i;
-        mapper.add(gid, newMap);
-
-        maxDistanceToSoma =
-            std::max(morphologyInfo.maxDistanceToSoma, maxDistanceToSoma);
+#pragma omp parallel
+        {
+            // The default material id is loader state, hence one per thread
+            MorphologyLoader loader(_scene, brayns::PropertyMap(properties));
 
-        callback.updateProgress("Loading morphologies...",
-                                static_cast<float>(i) /
-                                    static_cast<float>(uris.size()));
+#pragma omp for schedule(dynamic)
+            for (size_t i = batchStart; i < batchEnd; ++i)
+            {
+                try
+                {
+                    const auto uri = somasOnly ? brain::URI() : uris[i];
+                    loader.setDefaultMaterialId(materialIds[i]);
+                    loader.importMorphology(properties, uri,
+                                            containers[i - batchStart], i,
+                                            transformations[i],
+                                            compartmentReport);
+                }
+                catch (...)
+                {
+#pragma omp critical
+                    if (!error)
+                        error = std::current_exception();
+                }
+            }
+        }
 
-        ++i;
+        if (error)
+            std::rethrow_exception(error);
+
+        for (size_t i = batchStart; i < batchEnd; ++i)
+        {
+            const auto id = materialIds[i];
+            auto &container = containers[i - batchStart];
+
+            // Start indices before adding the morphology
+            const brayns::Model &geometries = model;
+            const size_t startSpheres =
+                _getGeometryCount(geometries.getSpheres(), id);
+            const size_t startCones =
+                _getGeometryCount(geometries.getCones(), id);
+            const size_t startCylinders =
+                _getGeometryCount(geometries.getCylinders(), id);
+            const size_t startSDFGeoms =
+                geometries.getSDFGeometryData().geometries.size();
+            const size_t startSDFBeziers =
+                _getGeometryCount(geometries.getSDFBeziers(), id);
+
+            container.addSpheresToModel(model);
+            container.addCylindersToModel(model);
+            container.addConesToModel(model);
+            container.addSDFGeometriesToModel(model);
+
+            // End indices after adding the morphology
+            const size_t endSpheres =
+                _getGeometryCount(geometries.getSpheres(), id);
+            const size_t endCones =
+                _getGeometryCount(geometries.getCones(), id);
+            const size_t endCylinders =
+                _getGeometryCount(geometries.getCylinders(), id);
+            const size_t endSDFGeoms =
+                geometries.getSDFGeometryData().geometries.size();
+            const size_t endSDFBeziers =
+                _getGeometryCount(geometries.getSDFBeziers(), id);
+
+            // Map morphology
+            MorphologyMap newMap;
+            func(newMap._sphereMap, id, startSpheres, endSpheres);
+            func(newMap._coneMap, id, startCones, endCones);
+            func(newMap._cylinderMap, id, startCylinders, endCylinders);
+            func(newMap._sdfGeometryMap, id, startSDFGeoms, endSDFGeoms);
+            func(newMap._sdfBezierMap, id, startSDFBeziers, endSDFBeziers);
+            newMap._linealIndex = i;
+            mapper.add(gidList[i], newMap);
+
+            maxDistanceToSoma =
+                std::max(container.morphologyInfo.maxDistanceToSoma,
+                         maxDistanceToSoma);
+
+            // Release the geometry as soon as it has been copied
+            container = ParallelModelContainer();
+        }
+
+        callback.updateProgress("Loading morphologies...",
+                                static_cast<float>(batchEnd) /
+                                    static_cast<float>(nbCells));
     }
 
     // Synapses
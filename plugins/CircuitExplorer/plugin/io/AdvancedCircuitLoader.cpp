@@ -64,6 +64,7 @@ brayns::PropertyMap AdvancedCircuitLoader::getCLIProperties()
     pm.add(PROP_REPORT);
     pm.add(PROP_REPORT_TYPE);
     pm.add(PROP_SPIKE_TRANSITION_TIME);
+    pm.add(PROP_SPIKE_TIME_INTERVAL);
     pm.add(PROP_SYNCHRONOUS_MODE);
     pm.add(PROP_TARGETS);
     pm.add(PROP_GIDS);
@@ -30,11 +30,15 @@
 #include <brayns/engine/Material.h>
 #include <brayns/engine/Model.h>
 #include <brayns/engine/Scene.h>
+#include <brayns/io/MappedFile.h>
 
 #include <brain/brain.h>
 #include <brion/brion.h>
 
+#include <algorithm>
 #include <fstream>
+#include <limits>
+#include <sstream>
 
 namespace
 {
@@ -42,6 +46,7 @@ const size_t CACHE_VERSION_1 = 1;
 const size_t CACHE_VERSION_2 = 2;
 const size_t CACHE_VERSION_3 = 3;
 const size_t CACHE_VERSION_4 = 4;
+const size_t CACHE_VERSION_5 = 5;
 
 const std::string LOADER_NAME = "Pre-computed brick loader";
 const std::string SUPPORTED_EXTENTION_BRAYNS = "brayns";
@@ -60,98 +65,144 @@ const brayns::Property PROP_LOAD_SDF = {
     "sdf", true, {"Load signed distance field geometry"}};
 const brayns::Property PROP_LOAD_SIMULATION = {
     "simulation", true, {"Attach simulation data (if applicable"}};
-} // namespace
 
-BrickLoader::BrickLoader(brayns::Scene& scene,
-                         brayns::PropertyMap&& loaderParams)
-    : Loader(scene)
-    , _defaults(loaderParams)
-{
-    PLUGIN_INFO << "Registering " << LOADER_NAME << std::endl;
-}
+/*
+ * Version 5 layout: a header, a descriptor (metadata, materials, simulation
+ * and transfer function, serialized as in version 4), a table of blocks and
+ * the geometry blocks. Blocks are aligned on BLOCK_ALIGNMENT bytes and located
+ * by their offset, so they are read in place from a memory mapping of the
+ * file.
+ */
+const uint64_t BLOCK_ALIGNMENT = 64;
 
-std::string BrickLoader::getName() const
+enum class BlockType : uint32_t
 {
-    return LOADER_NAME;
-}
-
-std::vector<std::string> BrickLoader::getSupportedExtensions() const
+    spheres = 0,
+    cylinders = 1,
+    cones = 2,
+    meshVertices = 3,
+    meshIndices = 4,
+    meshNormals = 5,
+    meshTextureCoordinates = 6,
+    streamlineVertices = 7,
+    streamlineColors = 8,
+    streamlineIndices = 9,
+    sdfGeometries = 10,
+    sdfIndices = 11,
+    sdfNeighbours = 12
+};
+
+struct CacheHeader
 {
-    return {SUPPORTED_EXTENTION_BRAYNS, SUPPORTED_EXTENTION_BIN};
-}
-
-bool BrickLoader::isSupported(const std::string& /*filename*/,
-                              const std::string& extension) const
+    uint64_t version{CACHE_VERSION_5};
+    uint64_t descriptorOffset{0};
+    uint64_t descriptorSize{0};
+    uint64_t blockTableOffset{0};
+    uint64_t blockCount{0};
+};
+
+struct CacheBlock
 {
-    const std::set<std::string> types = {SUPPORTED_EXTENTION_BRAYNS,
-                                         SUPPORTED_EXTENTION_BIN};
-    return types.find(extension) != types.end();
+    BlockType type;
+    uint32_t reserved{0};
+    uint64_t key{0}; // Material ID, or streamline ID
+    uint64_t count{0};
+    uint64_t offset{0};
+};
+
+uint64_t alignBlockOffset(const uint64_t offset)
+{
+    return (offset + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
 }
 
-std::vector<brayns::ModelDescriptorPtr> BrickLoader::importFromBlob(
-    brayns::Blob&& /*blob*/, const brayns::LoaderProgress& /*callback*/,
-    const brayns::PropertyMap& /*properties*/) const
+/** Blocks of the memory mapped cache file, checked against its size */
+template <typename T>
+const T* getBlock(const brayns::MappedFile& file, const uint64_t offset,
+                  const uint64_t count = 1)
 {
-    throw std::runtime_error("Loading circuit from blob is not supported");
+    const uint64_t size = file.size();
+    if (offset > size || count > (size - offset) / sizeof(T))
+        PLUGIN_THROW("Cache file is truncated or corrupted");
+    return reinterpret_cast<const T*>(file.data() + offset);
 }
 
-std::string BrickLoader::_readString(std::ifstream& f) const
+template <typename T>
+void copyBlock(const brayns::MappedFile& file, const CacheBlock& block,
+               std::vector<T>& destination)
 {
-    size_t size;
-    f.read((char*)&size, sizeof(size_t));
-    char* str = new char[size + 1];
-    f.read(str, size);
-    str[size] = 0;
-    std::string s{str};
-    delete[] str;
-    return s;
+    const auto source = getBlock<T>(file, block.offset, block.count);
+    destination.assign(source, source + block.count);
+    file.release(block.offset, block.count * sizeof(T));
 }
 
-std::vector<brayns::ModelDescriptorPtr> BrickLoader::importFromFile(
-    const std::string& filename, const brayns::LoaderProgress& callback,
-    const brayns::PropertyMap& properties) const
+// Caches before version 5 store the number of neighbours of each geometry,
+// the lists being back to back in the same order as the geometries
+void setNeighbourRanges(brayns::SDFGeometryData& sdfData,
+                        const std::vector<uint64_t>& counts)
 {
-    brayns::PropertyMap props = _defaults;
-    props.merge(properties);
+    if (counts.size() != sdfData.geometries.size())
+        PLUGIN_THROW("Cache file is truncated or corrupted");
 
-    callback.updateProgress("Loading cache...", 0);
-    PLUGIN_INFO << "Loading model from cache file: " << filename << std::endl;
-    std::ifstream file(filename, std::ios::in | std::ios::binary);
-    if (!file.good())
+    const uint64_t maxCount = std::numeric_limits<uint8_t>::max();
+    uint64_t index = 0;
+    for (size_t i = 0; i < counts.size(); ++i)
     {
-        const std::string msg = "Could not open cache file " + filename;
-        PLUGIN_THROW(msg);
+        auto& geometry = sdfData.geometries[i];
+        geometry.neighboursIndex = index;
+        geometry.numNeighbours = uint8_t(std::min(counts[i], maxCount));
+        index += counts[i];
     }
 
-    // File version
-    size_t version;
-    file.read((char*)&version, sizeof(size_t));
-
-    PLUGIN_INFO << "Version: " << version << std::endl;
+    if (index != sdfData.neighbours.size())
+        PLUGIN_THROW("Cache file is truncated or corrupted");
+}
 
-    auto model = _scene.createModel();
+std::string readString(std::istream& file)
+{
+    size_t size;
+    file.read((char*)&size, sizeof(size_t));
+    std::string value(size, '\0');
+    file.read(&value[0], size);
+    return value;
+}
 
-    // Geometry
-    size_t nbSpheres = 0;
-    size_t nbCylinders = 0;
-    size_t nbCones = 0;
-    size_t nbMeshes = 0;
-    size_t nbVertices = 0;
-    size_t nbIndices = 0;
-    size_t nbNormals = 0;
-    size_t nbTexCoords = 0;
+void writeString(std::ostream& file, const std::string& value)
+{
+    const size_t size = value.length();
+    file.write((char*)&size, sizeof(size_t));
+    file.write(value.c_str(), size);
+}
 
-    // Metadata
+brayns::ModelMetadata readMetadata(std::istream& file)
+{
     size_t nbElements;
     brayns::ModelMetadata metadata;
     file.read((char*)&nbElements, sizeof(size_t));
     for (size_t i = 0; i < nbElements; ++i)
-        metadata[_readString(file)] = _readString(file);
+    {
+        auto key = readString(file);
+        metadata[key] = readString(file);
+    }
+    return metadata;
+}
+
+void writeMetadata(std::ostream& file, const brayns::ModelMetadata& metadata)
+{
+    const size_t nbElements = metadata.size();
+    file.write((char*)&nbElements, sizeof(size_t));
+    for (const auto& data : metadata)
+    {
+        writeString(file, data.first);
+        writeString(file, data.second);
+    }
+}
 
+void readMaterials(std::istream& file, const size_t version,
+                   brayns::Model& model, const brayns::LoaderProgress& callback)
+{
     size_t nbMaterials;
     file.read((char*)&nbMaterials, sizeof(size_t));
 
-    // Materials
     size_t materialId;
     for (size_t i = 0; i < nbMaterials; ++i)
     {
@@ -161,12 +212,12 @@ std::vector<brayns::ModelDescriptorPtr> BrickLoader::importFromFile(
         file.read((char*)&materialId, sizeof(size_t));
 
         brayns::PropertyMap materialProps;
-        auto name = _readString(file);
+        auto name = readString(file);
         materialProps.add({MATERIAL_PROPERTY_CAST_USER_DATA, false});
         materialProps.add({MATERIAL_PROPERTY_SHADING_MODE,
                            static_cast<int32_t>(MaterialShadingMode::diffuse)});
 
-        auto material = model->createMaterial(materialId, name, materialProps);
+        auto material = model.createMaterial(materialId, name, materialProps);
 
         brayns::Vector3f value3f;
         file.read((char*)&value3f, sizeof(brayns::Vector3f));
@@ -207,27 +258,403 @@ std::vector<brayns::ModelDescriptorPtr> BrickLoader::importFromFile(
             material->updateProperty(MATERIAL_PROPERTY_CAST_USER_DATA,
                                      static_cast<bool>(userData));
 
-            int32_t shadingMode;
-            file.read((char*)&shadingMode, sizeof(int32_t));
-            material->updateProperty(MATERIAL_PROPERTY_SHADING_MODE,
-                                     shadingMode);
-        }
+            int32_t shadingMode;
+            file.read((char*)&shadingMode, sizeof(int32_t));
+            material->updateProperty(MATERIAL_PROPERTY_SHADING_MODE,
+                                     shadingMode);
+        }
+
+        if (version == CACHE_VERSION_3)
+        {
+            bool clipped;
+            file.read((char*)&clipped, sizeof(bool));
+            material->updateProperty(MATERIAL_PROPERTY_CLIPPING_MODE, clipped);
+        }
+
+        if (version >= CACHE_VERSION_4)
+        {
+            int32_t clippingMode;
+            file.read((char*)&clippingMode, sizeof(int32_t));
+            material->updateProperty(MATERIAL_PROPERTY_CLIPPING_MODE,
+                                     clippingMode);
+        }
+    }
+}
+
+void writeMaterials(std::ostream& file, const brayns::Model& model)
+{
+    const auto& materials = model.getMaterials();
+    const auto nbMaterials = materials.size();
+    file.write((char*)&nbMaterials, sizeof(size_t));
+
+    for (const auto& material : materials)
+    {
+        file.write((char*)&material.first, sizeof(size_t));
+        writeString(file, material.second->getName());
+
+        brayns::Vector3f value3f;
+        value3f = material.second->getDiffuseColor();
+        file.write((char*)&value3f, sizeof(brayns::Vector3f));
+        value3f = material.second->getSpecularColor();
+        file.write((char*)&value3f, sizeof(brayns::Vector3f));
+        float value = material.second->getSpecularExponent();
+        file.write((char*)&value, sizeof(float));
+        value = material.second->getReflectionIndex();
+        file.write((char*)&value, sizeof(float));
+        value = material.second->getOpacity();
+        file.write((char*)&value, sizeof(float));
+        value = material.second->getRefractionIndex();
+        file.write((char*)&value, sizeof(float));
+        value = material.second->getEmission();
+        file.write((char*)&value, sizeof(float));
+        value = material.second->getGlossiness();
+        file.write((char*)&value, sizeof(float));
+        int32_t simulation = 0;
+        try
+        {
+            simulation = material.second->getProperty<int32_t>(
+                MATERIAL_PROPERTY_CAST_USER_DATA);
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+        file.write((char*)&simulation, sizeof(int32_t));
+
+        int32_t shadingMode = MaterialShadingMode::none;
+        try
+        {
+            shadingMode = material.second->getProperty<int32_t>(
+                MATERIAL_PROPERTY_SHADING_MODE);
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+        file.write((char*)&shadingMode, sizeof(int32_t));
+
+        int32_t clippingMode = 0;
+        try
+        {
+            clippingMode = material.second->getProperty<int32_t>(
+                MATERIAL_PROPERTY_CLIPPING_MODE);
+        }
+        catch (const std::runtime_error&)
+        {
+            try
+            {
+                clippingMode = material.second->getProperty<bool>(
+                    MATERIAL_PROPERTY_CLIPPING_MODE);
+            }
+            catch (const std::runtime_error&)
+            {
+            }
+        }
+        file.write((char*)&clippingMode, sizeof(int32_t));
+    }
+}
+
+brion::GIDSet readGIDs(std::istream& file)
+{
+    size_t nbElements;
+    file.read((char*)&nbElements, sizeof(size_t));
+    brion::GIDSet gids;
+    for (uint32_t i = 0; i < nbElements; ++i)
+    {
+        uint32_t gid;
+        file.read((char*)&gid, sizeof(uint32_t));
+        gids.insert(gid);
+    }
+    return gids;
+}
+
+void writeGIDs(std::ostream& file, const brion::GIDSet& gids)
+{
+    const size_t size = gids.size();
+    file.write((char*)&size, sizeof(size_t));
+    for (const auto gid : gids)
+        file.write((char*)&gid, sizeof(uint32_t));
+}
+
+void readSimulation(std::istream& file, brayns::Model& model,
+                    brayns::Scene& scene)
+{
+    // Simulation Handler
+    size_t reportType{0};
+    file.read((char*)&reportType, sizeof(size_t));
+
+    switch (static_cast<ReportType>(reportType))
+    {
+    case ReportType::voltages_from_file:
+    {
+        const auto reportPath = readString(file);
+        const auto gids = readGIDs(file);
+
+        // Synchronization
+        bool synchronized{false};
+        file.read((char*)&synchronized, sizeof(bool));
+
+        // Handler
+        auto handler =
+            std::make_shared<VoltageSimulationHandler>(reportPath, gids,
+                                                       synchronized);
+        model.setSimulationHandler(handler);
+        break;
+    }
+    case ReportType::spikes:
+    {
+        const auto reportPath = readString(file);
+        const auto gids = readGIDs(file);
+
+        // Handler
+        auto handler =
+            std::make_shared<SpikeSimulationHandler>(reportPath, gids);
+        model.setSimulationHandler(handler);
+        break;
+    }
+    default:
+    {
+        // No report in that brick!
+    }
+    }
+
+    // Transfer function
+    size_t nbElements;
+    file.read((char*)&nbElements, sizeof(size_t));
+    if (nbElements == 1)
+    {
+        auto& tf = scene.getTransferFunction();
+        // Values range
+        brayns::Vector2d valuesRange;
+        file.read((char*)&valuesRange, sizeof(brayns::Vector2d));
+        tf.setValuesRange(valuesRange);
+
+        // Control points
+        file.read((char*)&nbElements, sizeof(size_t));
+        brayns::Vector2ds controlPoints(nbElements);
+        file.read((char*)controlPoints.data(),
+                  nbElements * sizeof(brayns::Vector2d));
+        tf.setControlPoints(controlPoints);
+
+        // Color map
+        brayns::ColorMap colorMap;
+        colorMap.name = readString(file);
+        file.read((char*)&nbElements, sizeof(size_t));
+        auto& colors = colorMap.colors;
+        colors.resize(nbElements);
+        file.read((char*)colors.data(), nbElements * sizeof(brayns::Vector3f));
+        tf.setColorMap(colorMap);
+    }
+}
+
+void writeSimulation(std::ostream& file, const brayns::Model& model,
+                     const brayns::Scene& scene)
+{
+    // Simulation handler
+    const brayns::AbstractSimulationHandlerPtr handler =
+        model.getSimulationHandler();
+    if (handler)
+    {
+        VoltageSimulationHandler* vsh =
+            dynamic_cast<VoltageSimulationHandler*>(handler.get());
+        SpikeSimulationHandler* ssh =
+            dynamic_cast<SpikeSimulationHandler*>(handler.get());
+        if (vsh)
+        {
+            const size_t reportType{
+                static_cast<size_t>(ReportType::voltages_from_file)};
+            file.write((char*)&reportType, sizeof(size_t));
+            writeString(file, vsh->getReportPath());
+            writeGIDs(file, vsh->getReport()->getGIDs());
+
+            // Synchronization mode
+            const bool sync = vsh->isSynchronized();
+            file.write((char*)&sync, sizeof(bool));
+        }
+        else if (ssh)
+        {
+            const size_t reportType{static_cast<size_t>(ReportType::spikes)};
+            file.write((char*)&reportType, sizeof(size_t));
+            writeString(file, ssh->getReportPath());
+            writeGIDs(file, ssh->getGIDs());
+        }
+        else
+        {
+            // Handler is ignored. Only voltage simulation handler is
+            // currently supported
+            const size_t reportType{static_cast<size_t>(ReportType::undefined)};
+            file.write((char*)&reportType, sizeof(size_t));
+        }
+    }
+    else
+    {
+        // No handler
+        const size_t reportType{0};
+        file.write((char*)&reportType, sizeof(size_t));
+    }
+
+    // Transfer function
+    size_t nbElements = 1;
+    file.write((char*)&nbElements, sizeof(size_t));
+    const auto& tf = scene.getTransferFunction();
+
+    // Values range
+    const brayns::Vector2d& valuesRange = tf.getValuesRange();
+    file.write((char*)&valuesRange, sizeof(brayns::Vector2d));
+
+    // Control points
+    const brayns::Vector2ds& controlPoints = tf.getControlPoints();
+    nbElements = controlPoints.size();
+    file.write((char*)&nbElements, sizeof(size_t));
+    file.write((char*)controlPoints.data(),
+               nbElements * sizeof(brayns::Vector2d));
+
+    // Color map
+    const brayns::ColorMap& colorMap = tf.getColorMap();
+    writeString(file, colorMap.name);
+    nbElements = colorMap.colors.size();
+    file.write((char*)&nbElements, sizeof(size_t));
+    file.write((char*)colorMap.colors.data(),
+               nbElements * sizeof(brayns::Vector3f));
+}
+
+/** Geometry blocks of a model, in the order they are written to the file */
+class BlockWriter
+{
+public:
+    template <typename T>
+    void add(const BlockType type, const uint64_t key,
+             const std::vector<T>& data)
+    {
+        CacheBlock block;
+        block.type = type;
+        block.key = key;
+        block.count = data.size();
+        _blocks.push_back(block);
+        _buffers.emplace_back(data.data(), data.size() * sizeof(T));
+    }
+
+    void write(std::ostream& file, const std::string& descriptor)
+    {
+        CacheHeader header;
+        header.descriptorOffset = sizeof(CacheHeader);
+        header.descriptorSize = descriptor.size();
+        header.blockCount = _blocks.size();
+        header.blockTableOffset =
+            alignBlockOffset(header.descriptorOffset + header.descriptorSize);
+        uint64_t offset = header.blockTableOffset +
+                          _blocks.size() * sizeof(CacheBlock);
+        for (size_t i = 0; i < _blocks.size(); ++i)
+        {
+            offset = alignBlockOffset(offset);
+            _blocks[i].offset = offset;
+            offset += _buffers[i].second;
+        }
+
+        file.write((char*)&header, sizeof(CacheHeader));
+        file.write(descriptor.data(), descriptor.size());
+        _pad(file, header.blockTableOffset);
+        file.write((char*)_blocks.data(), _blocks.size() * sizeof(CacheBlock));
+        for (size_t i = 0; i < _blocks.size(); ++i)
+        {
+            _pad(file, _blocks[i].offset);
+            file.write((const char*)_buffers[i].first, _buffers[i].second);
+        }
+    }
+
+private:
+    static void _pad(std::ostream& file, const uint64_t offset)
+    {
+        const uint64_t position = file.tellp();
+        const std::vector<char> padding(offset - position, 0);
+        file.write(padding.data(), padding.size());
+    }
+
+    std::vector<CacheBlock> _blocks;
+    std::vector<std::pair<const void*, uint64_t>> _buffers;
+};
+} // namespace
+
+BrickLoader::BrickLoader(brayns::Scene& scene,
+                         brayns::PropertyMap&& loaderParams)
+    : Loader(scene)
+    , _defaults(loaderParams)
+{
+    PLUGIN_INFO << "Registering " << LOADER_NAME << std::endl;
+}
+
+std::string BrickLoader::getName() const
+{
+    return LOADER_NAME;
+}
+
+std::vector<std::string> BrickLoader::getSupportedExtensions() const
+{
+    return {SUPPORTED_EXTENTION_BRAYNS, SUPPORTED_EXTENTION_BIN};
+}
+
+bool BrickLoader::isSupported(const std::string& /*filename*/,
+                              const std::string& extension) const
+{
+    const std::set<std::string> types = {SUPPORTED_EXTENTION_BRAYNS,
+                                         SUPPORTED_EXTENTION_BIN};
+    return types.find(extension) != types.end();
+}
+
+std::vector<brayns::ModelDescriptorPtr> BrickLoader::importFromBlob(
+    brayns::Blob&& /*blob*/, const brayns::LoaderProgress& /*callback*/,
+    const brayns::PropertyMap& /*properties*/) const
+{
+    throw std::runtime_error("Loading circuit from blob is not supported");
+}
+
+
+std::vector<brayns::ModelDescriptorPtr> BrickLoader::importFromFile(
+    const std::string& filename, const brayns::LoaderProgress& callback,
+    const brayns::PropertyMap& properties) const
+{
+    brayns::PropertyMap props = _defaults;
+    props.merge(properties);
+
+    callback.updateProgress("Loading cache...", 0);
+    PLUGIN_INFO << "Loading model from cache file: " << filename << std::endl;
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file.good())
+    {
+        const std::string msg = "Could not open cache file " + filename;
+        PLUGIN_THROW(msg);
+    }
+
+    // File version
+    size_t version;
+    file.read((char*)&version, sizeof(size_t));
+
+    PLUGIN_INFO << "Version: " << version << std::endl;
+
+    if (version == CACHE_VERSION_5)
+    {
+        file.close();
+        return _importFromMappedFile(filename, callback, props);
+    }
+
+    auto model = _scene.createModel();
+
+    // Geometry
+    size_t nbSpheres = 0;
+    size_t nbCylinders = 0;
+    size_t nbCones = 0;
+    size_t nbMeshes = 0;
+    size_t nbVertices = 0;
+    size_t nbIndices = 0;
+    size_t nbNormals = 0;
+    size_t nbTexCoords = 0;
 
-        if (version == CACHE_VERSION_3)
-        {
-            bool clipped;
-            file.read((char*)&clipped, sizeof(bool));
-            material->updateProperty(MATERIAL_PROPERTY_CLIPPING_MODE, clipped);
-        }
+    // Metadata
+    const auto metadata = readMetadata(file);
 
-        if (version >= CACHE_VERSION_4)
-        {
-            int32_t clippingMode;
-            file.read((char*)&clippingMode, sizeof(int32_t));
-            material->updateProperty(MATERIAL_PROPERTY_CLIPPING_MODE,
-                                     clippingMode);
-        }
-    }
+    // Materials
+    readMaterials(file, version, *model, callback);
+
+    size_t nbElements;
+    size_t materialId;
 
     uint64_t bufferSize{0};
 
@@ -536,9 +963,9 @@ std::vector<brayns::ModelDescriptorPtr> BrickLoader::importFromFile(
                 file.ignore(bufferSize);
         }
 
-        // Neighbours
+        // Neighbours, one list per geometry
         file.read((char*)&nbElements, sizeof(size_t));
-        sdfData.neighbours.resize(nbElements);
+        std::vector<uint64_t> neighbourCounts(nbElements);
 
         if (load)
             callback.updateProgress("SDF geometries neighbours", 0.9f);
@@ -547,121 +974,155 @@ std::vector<brayns::ModelDescriptorPtr> BrickLoader::importFromFile(
         {
             size_t size;
             file.read((char*)&size, sizeof(size_t));
+            neighbourCounts[i] = size;
             bufferSize = size * sizeof(uint64_t);
             if (load)
             {
-                sdfData.neighbours[i].resize(size);
-                file.read((char*)sdfData.neighbours[i].data(), bufferSize);
+                auto& neighbours = sdfData.neighbours;
+                const auto offset = neighbours.size();
+                neighbours.resize(offset + size);
+                file.read((char*)(neighbours.data() + offset), bufferSize);
             }
             else
                 file.ignore(bufferSize);
         }
+        if (load)
+            setNeighbourRanges(sdfData, neighbourCounts);
 
-        // Neighbours flat
+        // Neighbours flat, as built by the engine at the time. Not needed as
+        // the lists above are already stored back to back.
         file.read((char*)&nbElements, sizeof(size_t));
-        bufferSize = nbElements * sizeof(uint64_t);
-        if (load)
-        {
-            sdfData.neighboursFlat.resize(nbElements);
-            file.read((char*)sdfData.neighboursFlat.data(), bufferSize);
-        }
-        else
-            file.ignore(bufferSize);
+        file.ignore(nbElements * sizeof(uint64_t));
     }
 
+
     load = props[PROP_LOAD_SIMULATION.getName()].as<bool>();
     if (version >= CACHE_VERSION_3 && load)
-    {
-        // Simulation Handler
-        size_t reportType{0};
-        file.read((char*)&reportType, sizeof(size_t));
+        readSimulation(file, *model, _scene);
 
-        switch (static_cast<ReportType>(reportType))
-        {
-        case ReportType::voltages_from_file:
-        {
-            // Report path
-            const auto reportPath = _readString(file);
+    callback.updateProgress("Done", 1.f);
 
-            // GIDs
-            file.read((char*)&nbElements, sizeof(size_t));
-            brion::GIDSet gids;
-            for (uint32_t i = 0; i < nbElements; ++i)
-            {
-                uint32_t gid;
-                file.read((char*)&gid, sizeof(uint32_t));
-                gids.insert(gid);
-            }
+    file.close();
 
-            // Synchronization
-            bool synchronized{false};
-            file.read((char*)&synchronized, sizeof(bool));
+    // Restore original circuit config file from cache metadata, if present
+    std::string path = filename;
+    auto cpIt = metadata.find("CircuitPath");
+    if (cpIt != metadata.end())
+        path = cpIt->second;
 
-            // Handler
-            auto handler =
-                std::make_shared<VoltageSimulationHandler>(reportPath, gids,
-                                                           synchronized);
-            model->setSimulationHandler(handler);
-            break;
-        }
-        case ReportType::spikes:
-        {
-            // Report path
-            const auto reportPath = _readString(file);
+    auto modelDescriptor =
+        std::make_shared<brayns::ModelDescriptor>(std::move(model), "Brick",
+                                                  path, metadata);
+    return {modelDescriptor};
+}
 
-            // GIDs
-            file.read((char*)&nbElements, sizeof(size_t));
-            brion::GIDSet gids;
-            for (uint32_t i = 0; i < nbElements; ++i)
-            {
-                uint32_t gid;
-                file.read((char*)&gid, sizeof(uint32_t));
-                gids.insert(gid);
-            }
+std::vector<brayns::ModelDescriptorPtr> BrickLoader::_importFromMappedFile(
+    const std::string& filename, const brayns::LoaderProgress& callback,
+    const brayns::PropertyMap& props) const
+{
+    const brayns::MappedFile file(filename);
+    const auto& header = *getBlock<CacheHeader>(file, 0);
 
-            // Handler
-            auto handler =
-                std::make_shared<SpikeSimulationHandler>(reportPath, gids);
-            model->setSimulationHandler(handler);
-            break;
-        }
-        default:
-        {
-            // No report in that brick!
-        }
-        }
+    auto model = _scene.createModel();
 
-        // Transfer function
-        file.read((char*)&nbElements, sizeof(size_t));
-        if (nbElements == 1)
+    // Metadata, materials and simulation
+    const auto descriptorData =
+        getBlock<char>(file, header.descriptorOffset, header.descriptorSize);
+    std::istringstream descriptor(
+        std::string(descriptorData, header.descriptorSize));
+    const auto metadata = readMetadata(descriptor);
+    readMaterials(descriptor, CACHE_VERSION_5, *model, callback);
+    if (props[PROP_LOAD_SIMULATION.getName()].as<bool>())
+        readSimulation(descriptor, *model, _scene);
+
+    // Geometry blocks
+    const bool loadSpheres = props[PROP_LOAD_SPHERES.getName()].as<bool>();
+    const bool loadCylinders = props[PROP_LOAD_CYLINDERS.getName()].as<bool>();
+    const bool loadCones = props[PROP_LOAD_CONES.getName()].as<bool>();
+    const bool loadMeshes = props[PROP_LOAD_MESHES.getName()].as<bool>();
+    const bool loadStreamlines =
+        props[PROP_LOAD_STREAMLINES.getName()].as<bool>();
+    const bool loadSDF = props[PROP_LOAD_SDF.getName()].as<bool>();
+
+    const auto blocks =
+        getBlock<CacheBlock>(file, header.blockTableOffset, header.blockCount);
+    for (uint64_t i = 0; i < header.blockCount; ++i)
+    {
+        callback.updateProgress("Geometry (" + std::to_string(i + 1) + "/" +
+                                    std::to_string(header.blockCount) + ")",
+                                0.2f + 0.8f * float(i) /
+                                           float(header.blockCount));
+        const auto& block = blocks[i];
+        switch (block.type)
         {
-            auto& tf = _scene.getTransferFunction();
-            // Values range
-            brayns::Vector2d valuesRange;
-            file.read((char*)&valuesRange, sizeof(brayns::Vector2d));
-            tf.setValuesRange(valuesRange);
-
-            // Control points
-            file.read((char*)&nbElements, sizeof(size_t));
-            brayns::Vector2ds controlPoints(nbElements);
-            file.read((char*)&controlPoints[0],
-                      nbElements * sizeof(brayns::Vector2d));
-            tf.setControlPoints(controlPoints);
-
-            // Color map
-            brayns::ColorMap colorMap;
-            colorMap.name = _readString(file);
-            file.read((char*)&nbElements, sizeof(size_t));
-            auto& colors = colorMap.colors;
-            colors.resize(nbElements);
-            file.read((char*)&colors[0], nbElements * sizeof(brayns::Vector3f));
-            tf.setColorMap(colorMap);
+        case BlockType::spheres:
+            if (loadSpheres)
+                copyBlock(file, block, model->getSpheres()[block.key]);
+            break;
+        case BlockType::cylinders:
+            if (loadCylinders)
+                copyBlock(file, block, model->getCylinders()[block.key]);
+            break;
+        case BlockType::cones:
+            if (loadCones)
+                copyBlock(file, block, model->getCones()[block.key]);
+            break;
+        case BlockType::meshVertices:
+            if (loadMeshes)
+                copyBlock(file, block,
+                          model->getTriangleMeshes()[block.key].vertices);
+            break;
+        case BlockType::meshIndices:
+            if (loadMeshes)
+                copyBlock(file, block,
+                          model->getTriangleMeshes()[block.key].indices);
+            break;
+        case BlockType::meshNormals:
+            if (loadMeshes)
+                copyBlock(file, block,
+                          model->getTriangleMeshes()[block.key].normals);
+            break;
+        case BlockType::meshTextureCoordinates:
+            if (loadMeshes)
+                copyBlock(file, block,
+                          model->getTriangleMeshes()[block.key]
+                              .textureCoordinates);
+            break;
+        case BlockType::streamlineVertices:
+            if (loadStreamlines)
+                copyBlock(file, block,
+                          model->getStreamlines()[block.key].vertex);
+            break;
+        case BlockType::streamlineColors:
+            if (loadStreamlines)
+                copyBlock(file, block,
+                          model->getStreamlines()[block.key].vertexColor);
+            break;
+        case BlockType::streamlineIndices:
+            if (loadStreamlines)
+                copyBlock(file, block,
+                          model->getStreamlines()[block.key].indices);
+            break;
+        case BlockType::sdfGeometries:
+            copyBlock(file, block, model->getSDFGeometryData().geometries);
+            break;
+        case BlockType::sdfIndices:
+            if (loadSDF)
+                copyBlock(file, block,
+                          model->getSDFGeometryData()
+                              .geometryIndices[block.key]);
+            break;
+        case BlockType::sdfNeighbours:
+            if (loadSDF)
+                copyBlock(file, block, model->getSDFGeometryData().neighbours);
+            break;
+        default:
+            PLUGIN_WARN << "Ignoring unknown cache block type "
+                        << uint32_t(block.type) << std::endl;
         }
     }
     callback.updateProgress("Done", 1.f);
 
-    file.close();
-
     // Restore original circuit config file from cache metadata, if present
     std::string path = filename;
     auto cpIt = metadata.find("CircuitPath");
@@ -677,10 +1138,10 @@ std::vector<brayns::ModelDescriptorPtr> BrickLoader::importFromFile(
 void BrickLoader::exportToFile(const brayns::ModelDescriptorPtr modelDescriptor,
                                const std::string& filename)
 {
-    exportToFile(modelDescriptor, filename);
+    exportToFile(*modelDescriptor, filename);
 }
 
-void BrickLoader::exportToFile(brayns::ModelDescriptor& modelDescriptor,
+void BrickLoader::exportToFile(const brayns::ModelDescriptor& modelDescriptor,
                                const std::string& filename)
 {
     PLUGIN_INFO << "Saving model to cache file: " << filename << std::endl;
@@ -691,338 +1152,59 @@ void BrickLoader::exportToFile(brayns::ModelDescriptor& modelDescriptor,
         PLUGIN_THROW(msg);
     }
 
-    const size_t version = CACHE_VERSION_3;
-    file.write((char*)&version, sizeof(size_t));
-
-    // Save geometry
-    auto& model = modelDescriptor.getModel();
-    uint64_t bufferSize{0};
-
-    // Metadata
-    auto metadata = modelDescriptor.getMetadata();
-    size_t nbElements = metadata.size();
-    file.write((char*)&nbElements, sizeof(size_t));
-    for (const auto& data : metadata)
-    {
-        size_t size = data.first.length();
-        file.write((char*)&size, sizeof(size_t));
-        file.write((char*)data.first.c_str(), size);
-        size = data.second.length();
-        file.write((char*)&size, sizeof(size_t));
-        file.write((char*)data.second.c_str(), size);
-    }
-
-    const auto& materials = model.getMaterials();
-    const auto nbMaterials = materials.size();
-    file.write((char*)&nbMaterials, sizeof(size_t));
-
-    // Save materials
-    for (const auto& material : materials)
-    {
-        file.write((char*)&material.first, sizeof(size_t));
-
-        auto name = material.second->getName();
-        size_t size = name.length();
-        file.write((char*)&size, sizeof(size_t));
-        file.write((char*)name.c_str(), size);
-
-        brayns::Vector3f value3f;
-        value3f = material.second->getDiffuseColor();
-        file.write((char*)&value3f, sizeof(brayns::Vector3f));
-        value3f = material.second->getSpecularColor();
-        file.write((char*)&value3f, sizeof(brayns::Vector3f));
-        float value = material.second->getSpecularExponent();
-        file.write((char*)&value, sizeof(float));
-        value = material.second->getReflectionIndex();
-        file.write((char*)&value, sizeof(float));
-        value = material.second->getOpacity();
-        file.write((char*)&value, sizeof(float));
-        value = material.second->getRefractionIndex();
-        file.write((char*)&value, sizeof(float));
-        value = material.second->getEmission();
-        file.write((char*)&value, sizeof(float));
-        value = material.second->getGlossiness();
-        file.write((char*)&value, sizeof(float));
-        int32_t simulation = 0;
-        try
-        {
-            simulation = material.second->getProperty<int32_t>(
-                MATERIAL_PROPERTY_CAST_USER_DATA);
-        }
-        catch (const std::runtime_error&)
-        {
-        }
-        file.write((char*)&simulation, sizeof(int32_t));
-
-        int32_t shadingMode = MaterialShadingMode::none;
-        try
-        {
-            shadingMode = material.second->getProperty<int32_t>(
-                MATERIAL_PROPERTY_SHADING_MODE);
-        }
-        catch (const std::runtime_error&)
-        {
-        }
-        file.write((char*)&shadingMode, sizeof(int32_t));
-
-        // TODO: Change bool to int32_t for Version 4
-        bool clipped = false;
-        try
-        {
-            clipped = material.second->getProperty<bool>(
-                MATERIAL_PROPERTY_CLIPPING_MODE);
-        }
-        catch (const std::runtime_error&)
-        {
-        }
-        file.write((char*)&clipped, sizeof(bool));
-    }
-
-    // Spheres
-    nbElements = model.getSpheres().size();
-    file.write((char*)&nbElements, sizeof(size_t));
-    for (auto& spheres : model.getSpheres())
-    {
-        const auto materialId = spheres.first;
-        file.write((char*)&materialId, sizeof(size_t));
-
-        const auto& data = spheres.second;
-        nbElements = data.size();
-        file.write((char*)&nbElements, sizeof(size_t));
-        bufferSize = nbElements * sizeof(brayns::Sphere);
-        file.write((char*)data.data(), bufferSize);
-    }
+    // Read through the const accessors, the non-const ones would mark the
+    // geometry of the saved model as modified
+    const auto& model = modelDescriptor.getModel();
 
-    // Cylinders
-    nbElements = model.getCylinders().size();
-    file.write((char*)&nbElements, sizeof(size_t));
-    for (auto& cylinders : model.getCylinders())
-    {
-        const auto materialId = cylinders.first;
-        file.write((char*)&materialId, sizeof(size_t));
-
-        const auto& data = cylinders.second;
-        nbElements = data.size();
-        file.write((char*)&nbElements, sizeof(size_t));
-        bufferSize = nbElements * sizeof(brayns::Cylinder);
-        file.write((char*)data.data(), bufferSize);
-    }
+    // Metadata, materials and simulation
+    std::ostringstream descriptor;
+    writeMetadata(descriptor, modelDescriptor.getMetadata());
+    writeMaterials(descriptor, model);
+    writeSimulation(descriptor, model, _scene);
 
-    // Cones
-    nbElements = model.getCones().size();
-    file.write((char*)&nbElements, sizeof(size_t));
-    for (auto& cones : model.getCones())
-    {
-        const auto materialId = cones.first;
-        file.write((char*)&materialId, sizeof(size_t));
-
-        const auto& data = cones.second;
-        nbElements = data.size();
-        file.write((char*)&nbElements, sizeof(size_t));
-        bufferSize = nbElements * sizeof(brayns::Cone);
-        file.write((char*)data.data(), bufferSize);
-    }
+    // Geometry
+    BlockWriter blocks;
+    for (const auto& spheres : model.getSpheres())
+        blocks.add(BlockType::spheres, spheres.first, spheres.second);
+    for (const auto& cylinders : model.getCylinders())
+        blocks.add(BlockType::cylinders, cylinders.first, cylinders.second);
+    for (const auto& cones : model.getCones())
+        blocks.add(BlockType::cones, cones.first, cones.second);
 
-    // Meshes
-    nbElements = model.getTriangleMeshes().size();
-    file.write((char*)&nbElements, sizeof(size_t));
     for (const auto& meshes : model.getTriangleMeshes())
     {
         const auto materialId = meshes.first;
-        file.write((char*)&materialId, sizeof(size_t));
-
         const auto& data = meshes.second;
-
-        // Vertices
-        nbElements = data.vertices.size();
-        file.write((char*)&nbElements, sizeof(size_t));
-        bufferSize = nbElements * sizeof(brayns::Vector3f);
-        file.write((char*)data.vertices.data(), bufferSize);
-
-        // Indices
-        nbElements = data.indices.size();
-        file.write((char*)&nbElements, sizeof(size_t));
-        bufferSize = nbElements * sizeof(brayns::Vector3ui);
-        file.write((char*)data.indices.data(), bufferSize);
-
-        // Normals
-        nbElements = data.normals.size();
-        file.write((char*)&nbElements, sizeof(size_t));
-        bufferSize = nbElements * sizeof(brayns::Vector3f);
-        file.write((char*)data.normals.data(), bufferSize);
-
-        // Texture coordinates
-        nbElements = data.textureCoordinates.size();
-        file.write((char*)&nbElements, sizeof(size_t));
-        bufferSize = nbElements * sizeof(brayns::Vector2f);
-        file.write((char*)data.textureCoordinates.data(), bufferSize);
+        blocks.add(BlockType::meshVertices, materialId, data.vertices);
+        blocks.add(BlockType::meshIndices, materialId, data.indices);
+        blocks.add(BlockType::meshNormals, materialId, data.normals);
+        blocks.add(BlockType::meshTextureCoordinates, materialId,
+                   data.textureCoordinates);
     }
 
-    // Streamlines
-    const auto& streamlines = model.getStreamlines();
-    nbElements = streamlines.size();
-    file.write((char*)&nbElements, sizeof(size_t));
-    for (const auto& streamline : streamlines)
+    for (const auto& streamline : model.getStreamlines())
     {
-        const auto& streamlineData = streamline.second;
-        // Id
-        size_t id = streamline.first;
-        file.write((char*)&id, sizeof(size_t));
-
-        // Vertex
-        nbElements = streamlineData.vertex.size();
-        file.write((char*)&nbElements, sizeof(size_t));
-        bufferSize = nbElements * sizeof(brayns::Vector4f);
-        file.write((char*)streamlineData.vertex.data(), bufferSize);
-
-        // Vertex Color
-        nbElements = streamlineData.vertexColor.size();
-        file.write((char*)&nbElements, sizeof(size_t));
-        bufferSize = nbElements * sizeof(brayns::Vector4f);
-        file.write((char*)streamlineData.vertexColor.data(), bufferSize);
-
-        // Indices
-        nbElements = streamlineData.indices.size();
-        file.write((char*)&nbElements, sizeof(size_t));
-        bufferSize = nbElements * sizeof(int32_t);
-        file.write((char*)streamlineData.indices.data(), bufferSize);
+        const auto id = streamline.first;
+        const auto& data = streamline.second;
+        blocks.add(BlockType::streamlineVertices, id, data.vertex);
+        blocks.add(BlockType::streamlineColors, id, data.vertexColor);
+        blocks.add(BlockType::streamlineIndices, id, data.indices);
     }
 
-    // SDF geometry
     const auto& sdfData = model.getSDFGeometryData();
-    nbElements = sdfData.geometries.size();
-    file.write((char*)&nbElements, sizeof(size_t));
-
-    if (nbElements > 0)
+    if (!sdfData.geometries.empty())
     {
-        // Geometries
-        bufferSize = nbElements * sizeof(brayns::SDFGeometry);
-        file.write((char*)sdfData.geometries.data(), bufferSize);
-
-        // SDF indices
-        nbElements = sdfData.geometryIndices.size();
-        file.write((char*)&nbElements, sizeof(size_t));
+        blocks.add(BlockType::sdfGeometries, 0, sdfData.geometries);
         for (const auto& geometryIndex : sdfData.geometryIndices)
-        {
-            size_t materialId = geometryIndex.first;
-            file.write((char*)&materialId, sizeof(size_t));
-            nbElements = geometryIndex.second.size();
-            file.write((char*)&nbElements, sizeof(size_t));
-            bufferSize = nbElements * sizeof(uint64_t);
-            file.write((char*)geometryIndex.second.data(), bufferSize);
-        }
-
-        // Neighbours
-        nbElements = sdfData.neighbours.size();
-        file.write((char*)&nbElements, sizeof(size_t));
-        for (const auto& neighbour : sdfData.neighbours)
-        {
-            nbElements = neighbour.size();
-            file.write((char*)&nbElements, sizeof(size_t));
-            bufferSize = nbElements * sizeof(size_t);
-            file.write((char*)neighbour.data(), bufferSize);
-        }
-
-        // Neighbours flat
-        nbElements = sdfData.neighboursFlat.size();
-        file.write((char*)&nbElements, sizeof(size_t));
-        bufferSize = nbElements * sizeof(uint64_t);
-        file.write((char*)sdfData.neighboursFlat.data(), bufferSize);
-    }
-
-    // Simulation handler
-    const brayns::AbstractSimulationHandlerPtr handler =
-        model.getSimulationHandler();
-    if (handler)
-    {
-        VoltageSimulationHandler* vsh =
-            dynamic_cast<VoltageSimulationHandler*>(handler.get());
-        SpikeSimulationHandler* ssh =
-            dynamic_cast<SpikeSimulationHandler*>(handler.get());
-        if (vsh)
-        {
-            const size_t reportType{
-                static_cast<size_t>(ReportType::voltages_from_file)};
-            file.write((char*)&reportType, sizeof(size_t));
-
-            // Report path
-            const auto& value = vsh->getReportPath();
-            size_t size = value.length();
-            file.write((char*)&size, sizeof(size_t));
-            file.write((char*)value.c_str(), size);
-
-            // Gids
-            const brion::GIDSet& gids = vsh->getReport()->getGIDs();
-            size = gids.size();
-            file.write((char*)&size, sizeof(size_t));
-            for (const auto gid : gids)
-                file.write((char*)&gid, sizeof(uint32_t));
-
-            // Synchronization mode
-            const bool sync = vsh->isSynchronized();
-            file.write((char*)&sync, sizeof(bool));
-        }
-        else if (ssh)
-        {
-            const size_t reportType{static_cast<size_t>(ReportType::spikes)};
-            file.write((char*)&reportType, sizeof(size_t));
-
-            // Report path
-            const auto& value = ssh->getReportPath();
-            size_t size = value.length();
-            file.write((char*)&size, sizeof(size_t));
-            file.write((char*)value.c_str(), size);
-
-            // Gids
-            const brion::GIDSet& gids = ssh->getGIDs();
-            size = gids.size();
-            file.write((char*)&size, sizeof(size_t));
-            for (const auto gid : gids)
-                file.write((char*)&gid, sizeof(uint32_t));
-        }
-        else
-        {
-            // Handler is ignored. Only voltage simulation handler is
-            // currently supported
-            const size_t reportType{static_cast<size_t>(ReportType::undefined)};
-            file.write((char*)&reportType, sizeof(size_t));
-        }
-    }
-    else
-    {
-        // No handler
-        nbElements = 0;
-        file.write((char*)&nbElements, sizeof(size_t));
-    }
-
-    // Transfer function
-    nbElements = 1;
-    file.write((char*)&nbElements, sizeof(size_t));
-    const auto& tf = _scene.getTransferFunction();
-    {
-        // Values range
-        const brayns::Vector2d& valuesRange = tf.getValuesRange();
-        file.write((char*)&valuesRange, sizeof(brayns::Vector2d));
-
-        // Control points
-        const brayns::Vector2ds& controlPoints = tf.getControlPoints();
-        nbElements = controlPoints.size();
-        file.write((char*)&nbElements, sizeof(size_t));
-        file.write((char*)&controlPoints[0],
-                   nbElements * sizeof(brayns::Vector2d));
-
-        // Color map
-        const brayns::ColorMap& colorMap = tf.getColorMap();
-        const std::string name = colorMap.name;
-        const size_t size = name.length();
-        file.write((char*)&size, sizeof(size_t));
-        file.write((char*)name.c_str(), size);
-        nbElements = colorMap.colors.size();
-        file.write((char*)&nbElements, sizeof(size_t));
-        file.write((char*)&colorMap.colors[0],
-                   nbElements * sizeof(brayns::Vector3f));
+            blocks.add(BlockType::sdfIndices, geometryIndex.first,
+                       geometryIndex.second);
+        // The geometries reference their range of the flat neighbour list
+        blocks.add(BlockType::sdfNeighbours, 0, sdfData.neighbours);
     }
 
+    blocks.write(file, descriptor.str());
+    if (!file.good())
+        PLUGIN_THROW("Could not write cache file " + filename);
     file.close();
 }
 
@@ -1043,3 +1225,4 @@ brayns::PropertyMap BrickLoader::getCLIProperties()
     pm.add(PROP_LOAD_SIMULATION);
     return pm;
 }
+
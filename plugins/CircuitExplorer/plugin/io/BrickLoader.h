@@ -60,10 +60,13 @@ public:
     void exportToFile(const brayns::ModelDescriptorPtr modelDescriptor,
                       const std::string& filename);
 
-    void exportToFile(brayns::ModelDescriptor& modelDescriptor,
+    void exportToFile(const brayns::ModelDescriptor& modelDescriptor,
                       const std::string& filename);
 
 private:
-    std::string _readString(std::ifstream& f) const;
+    std::vector<brayns::ModelDescriptorPtr> _importFromMappedFile(
+        const std::string& filename, const brayns::LoaderProgress& callback,
+        const brayns::PropertyMap& properties) const;
+
     brayns::PropertyMap _defaults;
 };
@@ -0,0 +1,183 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "FrameExporter.h"
+
+#include <common/log.h>
+
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+const size_t MAX_DEFAULT_THREADS = 4;
+
+size_t getDefaultThreadCount()
+{
+    // Encoders share the cores with the renderer
+    const size_t cores = std::thread::hardware_concurrency();
+    return std::max<size_t>(1, std::min(MAX_DEFAULT_THREADS, cores / 2));
+}
+} // namespace
+
+FrameExporter::FrameExporter(const size_t nbThreads, const size_t queueSize)
+{
+    const auto threads = nbThreads == 0 ? getDefaultThreadCount() : nbThreads;
+    _queueSize = queueSize == 0 ? 2 * threads : queueSize;
+    _threads.reserve(threads);
+    for (size_t i = 0; i < threads; ++i)
+        _threads.emplace_back([this] { _run(); });
+}
+
+FrameExporter::~FrameExporter()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _jobAvailable.notify_all();
+    for (auto& thread : _threads)
+        thread.join();
+}
+
+void FrameExporter::push(brayns::freeimage::ImagePtr image,
+                         const FREE_IMAGE_FORMAT format, const int flags,
+                         const std::string& filename)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _slotAvailable.wait(lock, [this] { return _jobs.size() < _queueSize; });
+    _jobs.push_back({std::move(image), format, flags, filename});
+    ++_statistics.queued;
+    lock.unlock();
+    _jobAvailable.notify_one();
+}
+
+void FrameExporter::wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idle.wait(lock, [this] { return _jobs.empty() && _busyThreads == 0; });
+}
+
+void FrameExporter::reset()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idle.wait(lock, [this] { return _jobs.empty() && _busyThreads == 0; });
+    _statistics = {};
+    _lastError.clear();
+}
+
+FrameExportStatistics FrameExporter::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
+}
+
+std::string FrameExporter::getLastError() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _lastError;
+}
+
+void FrameExporter::_run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        _jobAvailable.wait(lock,
+                           [this] { return _stopping || !_jobs.empty(); });
+        if (_jobs.empty())
+            return;
+
+        auto job = std::move(_jobs.front());
+        _jobs.pop_front();
+        --_statistics.queued;
+        ++_busyThreads;
+        lock.unlock();
+        _slotAvailable.notify_one();
+
+        _export(job);
+
+        lock.lock();
+        --_busyThreads;
+        if (_jobs.empty() && _busyThreads == 0)
+            _idle.notify_all();
+    }
+}
+
+void FrameExporter::_export(Job& job)
+{
+    if (job.format == FIF_JPEG)
+        job.image.reset(FreeImage_ConvertTo24Bits(job.image.get()));
+
+    brayns::freeimage::MemoryPtr memory(FreeImage_OpenMemory());
+    if (!job.image || !FreeImage_SaveToMemory(job.format, job.image.get(),
+                                              memory.get(), job.flags))
+    {
+        _fail("Failed to encode " + job.filename);
+        return;
+    }
+    job.image.reset();
+
+    BYTE* pixels = nullptr;
+    DWORD numPixels = 0;
+    FreeImage_AcquireMemory(memory.get(), &pixels, &numPixels);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_statistics.encoded;
+    }
+
+    std::ofstream file;
+    try
+    {
+        file.open(job.filename, std::ios_base::binary);
+    }
+    catch (const std::exception& e)
+    {
+        _fail(e.what());
+        return;
+    }
+
+    if (!file.is_open())
+    {
+        _fail("Failed to create " + job.filename);
+        return;
+    }
+
+    file.write((char*)pixels, numPixels);
+    file.close();
+    if (file.fail())
+    {
+        _fail("Failed to write " + job.filename);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_statistics.written;
+    }
+    PLUGIN_INFO << "Frame saved to " << job.filename << std::endl;
+}
+
+void FrameExporter::_fail(const std::string& message)
+{
+    PLUGIN_ERROR << message << std::endl;
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_statistics.failed;
+    _lastError = message;
+}
@@ -0,0 +1,115 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <brayns/common/utils/imageUtils.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct FrameExportStatistics
+{
+    // Frames waiting for an encoder
+    uint64_t queued{0};
+    // Frames encoded in the target image format
+    uint64_t encoded{0};
+    // Frames written to disk
+    uint64_t written{0};
+    // Frames that could not be encoded or written
+    uint64_t failed{0};
+};
+
+/**
+ * @brief The FrameExporter class encodes and writes rendered frames to disk
+ * with a pool of worker threads, so that the render loop only has to copy the
+ * frame buffer. The number of frames waiting for a worker is bounded, adding a
+ * frame blocks until a slot is available.
+ */
+class FrameExporter
+{
+public:
+    /**
+     * @brief Creates the worker threads
+     * @param nbThreads Number of encoder/writer threads, 0 for a default based
+     * on the number of cores
+     * @param queueSize Maximum number of frames waiting for a worker, 0 for
+     * twice the number of threads
+     */
+    FrameExporter(size_t nbThreads = 0, size_t queueSize = 0);
+
+    /**
+     * @brief Exports the frames still in the queue and stops the workers
+     */
+    ~FrameExporter();
+
+    /**
+     * @brief push queues a frame for export, blocks while the queue is full
+     * @param image Image copied from the frame buffer
+     * @param format FreeImage format of the file
+     * @param flags FreeImage save flags
+     * @param filename Path of the file to write
+     */
+    void push(brayns::freeimage::ImagePtr image, FREE_IMAGE_FORMAT format,
+              int flags, const std::string& filename);
+
+    /**
+     * @brief wait blocks until all queued frames are exported
+     */
+    void wait();
+
+    /**
+     * @brief reset waits for the queued frames and clears the statistics and
+     * the last error
+     */
+    void reset();
+
+    FrameExportStatistics getStatistics() const;
+    std::string getLastError() const;
+
+private:
+    struct Job
+    {
+        brayns::freeimage::ImagePtr image;
+        FREE_IMAGE_FORMAT format;
+        int flags;
+        std::string filename;
+    };
+
+    void _run();
+    void _export(Job& job);
+    void _fail(const std::string& message);
+
+    mutable std::mutex _mutex;
+    std::condition_variable _jobAvailable;
+    std::condition_variable _slotAvailable;
+    std::condition_variable _idle;
+    std::deque<Job> _jobs;
+    size_t _queueSize;
+    size_t _busyThreads{0};
+    bool _stopping{false};
+    FrameExportStatistics _statistics;
+    std::string _lastError;
+    std::vector<std::thread> _threads;
+};
@@ -102,6 +102,18 @@ MorphologyInfo MorphologyLoader::importMorphology(
     return modelContainer.morphologyInfo;
 }
 
+MorphologyInfo MorphologyLoader::importMorphology(
+    const brayns::PropertyMap& properties, const brion::URI& source,
+    ParallelModelContainer& container, const uint64_t index,
+    const brayns::Matrix4f& transformation,
+    CompartmentReportPtr compartmentReport) const
+{
+    _importMorphology(properties, source, index, container, transformation,
+                      compartmentReport);
+    container.applyTransformation(transformation);
+    return container.morphologyInfo;
+}
+
 void MorphologyLoader::_importMorphology(
     const brayns::PropertyMap& properties, const brion::URI& source,
     const uint64_t index, ParallelModelContainer& model,
@@ -106,6 +106,22 @@ public:
         brain::Synapses* efferentSynapses = nullptr,
         CompartmentReportPtr compartmentReport = nullptr) const;
 
+    /**
+     * @brief importMorphology imports a single morphology from a specified URI
+     * into a container, leaving the model untouched. Several loaders can import
+     * in parallel, the containers being added to the model afterwards
+     * @param uri URI of the morphology
+     * @param container Container receiving the transformed geometry
+     * @param index Index of the morphology
+     * @param compartmentReport Compartment report to map to the morphology
+     * @return Information about the morphology
+     */
+    MorphologyInfo importMorphology(
+        const brayns::PropertyMap& properties, const brion::URI& source,
+        ParallelModelContainer& container, const uint64_t index,
+        const brayns::Matrix4f& transformation,
+        CompartmentReportPtr compartmentReport) const;
+
     /**
      * @brief setDefaultMaterialId Set the default material for the morphology
      * @param materialId Id of the default material for the morphology
@@ -24,6 +24,11 @@
 #include "SpikeSimulationHandler.h"
 #include <brayns/parameters/AnimationParameters.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
 namespace
 {
 const float DEFAULT_REST_VALUE = -80.f;
@@ -34,28 +39,24 @@ const float DEFAULT_TIME_INTERVAL = 0.01f;
 
 SpikeSimulationHandler::SpikeSimulationHandler(const std::string& reportPath,
                                                const brion::GIDSet& gids,
-                                               const float transitionTime)
+                                               const float transitionTime,
+                                               const float timeInterval)
     : brayns::AbstractSimulationHandler()
     , _reportPath(reportPath)
     , _gids(gids)
     , _transition(transitionTime)
     , _spikeReport(new brain::SpikeReportReader(brain::URI(reportPath), gids))
 {
-    uint64_t c{0};
-    for (const auto gid : _gids)
-    {
-        _gidMap[gid] = c;
-        ++c;
-    }
-
     // Load simulation information from compartment reports
     _startTime = 0.0;
     _endTime = _spikeReport->getEndTime();
-    _nbFrames = _endTime / DEFAULT_TIME_INTERVAL;
-    _dt = DEFAULT_TIME_INTERVAL;
+    _dt = timeInterval > 0.f ? timeInterval : DEFAULT_TIME_INTERVAL;
+    _nbFrames = _endTime / _dt;
     _frameSize = _gids.size();
     _frameData.resize(_frameSize, DEFAULT_REST_VALUE);
 
+    _loadTimeline();
+
     PLUGIN_INFO << "-----------------------------------------------------------"
                 << std::endl;
     PLUGIN_INFO << "Spike simulation information" << std::endl;
@@ -63,10 +64,11 @@ SpikeSimulationHandler::SpikeSimulationHandler(const std::string& reportPath,
     PLUGIN_INFO << "Report path           : " << _reportPath << std::endl;
     PLUGIN_INFO << "Frame size (# of GIDs): " << _frameSize << std::endl;
     PLUGIN_INFO << "End time              : " << _endTime << std::endl;
-    PLUGIN_INFO << "Time interval         : " << DEFAULT_TIME_INTERVAL
-                << std::endl;
+    PLUGIN_INFO << "Time interval         : " << _dt << std::endl;
     PLUGIN_INFO << "Transition time       : " << _transition << std::endl;
     PLUGIN_INFO << "Number of frames      : " << _nbFrames << std::endl;
+    PLUGIN_INFO << "Number of spikes      : " << _timeline->size()
+                << std::endl;
     PLUGIN_INFO << "-----------------------------------------------------------"
                 << std::endl;
 }
@@ -78,47 +80,52 @@ SpikeSimulationHandler::SpikeSimulationHandler(
     , _gids(rhs._gids)
     , _transition(rhs._transition)
     , _spikeReport(rhs._spikeReport)
-    , _gidMap(rhs._gidMap)
+    , _timeline(rhs._timeline)
+    , _currentSpikes(rhs._currentSpikes)
 {
 }
 
 void* SpikeSimulationHandler::getFrameDataImpl(const uint32_t frame)
 {
-    if (_currentFrame != frame)
+    if (_currentFrame == frame)
+        return _frameData.data();
+
+    const auto& timeline = *_timeline;
+
+    // Only the cells spiking around the previous frame time are not at rest
+    for (size_t i = _currentSpikes.first; i < _currentSpikes.second; ++i)
+        _frameData[timeline[i].index] = DEFAULT_REST_VALUE;
+
+    // Spikes are sorted by time, the last spike of a cell in the window sets
+    // its value
+    const float currentFrameTime = static_cast<float>(frame * _dt);
+    _currentSpikes = _getSpikesInWindow(currentFrameTime);
+    for (size_t i = _currentSpikes.first; i < _currentSpikes.second; ++i)
     {
-        std::fill(_frameData.begin(), _frameData.end(), DEFAULT_REST_VALUE);
+        const auto& spike = timeline[i];
+        const auto spikeTime = spike.time;
 
-        const float currentFrameTime = static_cast<float>(frame) * _dt;
-        const auto trStart = currentFrameTime - _transition;
-        const auto trEnd = currentFrameTime + _transition;
-        const auto spikes = _spikeReport->getSpikes(trStart, trEnd);
-        for (const auto& spike : spikes)
+        // Spike in the future - start growth
+        if (spikeTime > currentFrameTime)
+        {
+            auto alpha = (spikeTime - currentFrameTime) / _transition;
+            alpha = std::min(std::max(0.f, alpha), 1.f);
+            _frameData[spike.index] = DEFAULT_REST_VALUE * alpha +
+                                      DEFAULT_SPIKING_VALUE * (1.f - alpha);
+        }
+        // Spike in the past - start fading
+        else if (spikeTime < currentFrameTime)
         {
-            const auto gid = _gidMap[spike.second];
-            const auto spikeTime = spike.first;
-
-            // Spike in the future - start growth
-            if (spikeTime > currentFrameTime)
-            {
-                auto alpha = (spikeTime - currentFrameTime) / _transition;
-                alpha = std::min(std::max(0.f, alpha), 1.f);
-                _frameData[gid] = DEFAULT_REST_VALUE * alpha +
-                                  DEFAULT_SPIKING_VALUE * (1.f - alpha);
-            }
-            // Spike in the past - start fading
-            else if (spikeTime < currentFrameTime)
-            {
-                auto alpha = (currentFrameTime - spikeTime) / _transition;
-                alpha = std::min(std::max(0.f, alpha), 1.f);
-                _frameData[gid] = DEFAULT_REST_VALUE * alpha +
-                                  DEFAULT_SPIKING_VALUE * (1.f - alpha);
-            }
-            // Spiking neuron
-            else
-                _frameData[gid] = DEFAULT_SPIKING_VALUE;
+            auto alpha = (currentFrameTime - spikeTime) / _transition;
+            alpha = std::min(std::max(0.f, alpha), 1.f);
+            _frameData[spike.index] = DEFAULT_REST_VALUE * alpha +
+                                      DEFAULT_SPIKING_VALUE * (1.f - alpha);
         }
-        _currentFrame = frame;
+        // Spiking neuron
+        else
+            _frameData[spike.index] = DEFAULT_SPIKING_VALUE;
     }
+    _currentFrame = frame;
 
     return _frameData.data();
 }
@@ -127,3 +134,47 @@ brayns::AbstractSimulationHandlerPtr SpikeSimulationHandler::clone() const
 {
     return std::make_shared<SpikeSimulationHandler>(*this);
 }
+
+void SpikeSimulationHandler::_loadTimeline()
+{
+    std::unordered_map<uint32_t, uint32_t> gidMap;
+    gidMap.reserve(_gids.size());
+    uint32_t c{0};
+    for (const auto gid : _gids)
+        gidMap[gid] = c++;
+
+    // The whole report is read once, spikes of unknown cells are dropped
+    const auto end = std::nextafter(_spikeReport->getEndTime(),
+                                    std::numeric_limits<float>::max());
+    const auto spikes = _spikeReport->getSpikes(0.f, end);
+
+    auto timeline = std::make_shared<Timeline>();
+    timeline->reserve(spikes.size());
+    for (const auto& spike : spikes)
+    {
+        const auto it = gidMap.find(spike.second);
+        if (it != gidMap.end())
+            timeline->push_back({spike.first, it->second});
+    }
+
+    std::stable_sort(timeline->begin(), timeline->end(),
+                     [](const TimelineSpike& a, const TimelineSpike& b) {
+                         return a.time < b.time;
+                     });
+    _timeline = std::move(timeline);
+}
+
+SpikeSimulationHandler::TimelineRange
+    SpikeSimulationHandler::_getSpikesInWindow(const float time) const
+{
+    const auto& timeline = *_timeline;
+    const auto compare = [](const TimelineSpike& spike, const float value) {
+        return spike.time < value;
+    };
+    const auto begin = std::lower_bound(timeline.begin(), timeline.end(),
+                                        time - _transition, compare);
+    const auto end =
+        std::lower_bound(begin, timeline.end(), time + _transition, compare);
+    return {static_cast<size_t>(begin - timeline.begin()),
+            static_cast<size_t>(end - timeline.begin())};
+}
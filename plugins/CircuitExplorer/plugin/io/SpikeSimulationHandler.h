@@ -27,14 +27,23 @@
 #include <brayns/common/types.h>
 #include <brayns/engine/Scene.h>
 
+#include <vector>
+
 typedef std::shared_ptr<brain::SpikeReportReader> SpikeReportReaderPtr;
 
+/**
+ * @brief The SpikeSimulationHandler class turns a spike report into frames of
+ * one value per cell. The spikes are read once into a timeline sorted by time,
+ * and frames are updated by only touching the cells that spike around the
+ * previous and the current frame times.
+ */
 class SpikeSimulationHandler : public brayns::AbstractSimulationHandler
 {
 public:
     SpikeSimulationHandler(const std::string& reportPath,
                            const brain::GIDSet& gids,
-                           const float transitionTime = 0.5f);
+                           const float transitionTime = 0.5f,
+                           const float timeInterval = 0.01f);
     SpikeSimulationHandler(const SpikeSimulationHandler& rhs);
 
     void* getFrameDataImpl(const uint32_t frame) final;
@@ -45,10 +54,24 @@ public:
     brayns::AbstractSimulationHandlerPtr clone() const final;
 
 private:
+    struct TimelineSpike
+    {
+        float time;
+        uint32_t index;
+    };
+    using Timeline = std::vector<TimelineSpike>;
+    using TimelineRange = std::pair<size_t, size_t>;
+
+    void _loadTimeline();
+    TimelineRange _getSpikesInWindow(const float time) const;
+
     std::string _reportPath;
     brain::GIDSet _gids;
     float _transition;
     SpikeReportReaderPtr _spikeReport;
 
-    std::map<uint64_t, uint64_t> _gidMap;
+    // Spikes of the report, sorted by time, with the frame index of their cell
+    std::shared_ptr<const Timeline> _timeline;
+    // Spikes that contributed to the current frame
+    TimelineRange _currentSpikes{0, 0};
 };
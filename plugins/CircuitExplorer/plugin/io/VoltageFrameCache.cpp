@@ -0,0 +1,223 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "VoltageFrameCache.h"
+
+#include <common/log.h>
+
+#include <algorithm>
+
+namespace
+{
+class CompartmentReportFrameSource : public VoltageFrameSource
+{
+public:
+    CompartmentReportFrameSource(CompartmentReportPtr report)
+        : _report(std::move(report))
+    {
+    }
+
+    size_t getFrameSize() const final { return _report->getFrameSize(); }
+
+    std::future<brion::Frame> loadFrame(const uint32_t frame) final
+    {
+        double timestamp =
+            _report->getStartTime() + frame * _report->getTimestep();
+        timestamp = std::min(_report->getEndTime(), timestamp);
+        return _report->loadFrame(timestamp);
+    }
+
+private:
+    CompartmentReportPtr _report;
+};
+} // namespace
+
+VoltageFrameCache::VoltageFrameCache(CompartmentReportPtr report,
+                                     const uint32_t nbFrames)
+    : VoltageFrameCache(std::make_unique<CompartmentReportFrameSource>(
+                            std::move(report)),
+                        nbFrames)
+{
+}
+
+VoltageFrameCache::VoltageFrameCache(std::unique_ptr<VoltageFrameSource> source,
+                                     const uint32_t nbFrames)
+    : _source(std::move(source))
+    , _nbFrames(nbFrames)
+{
+}
+
+VoltageFrameCache::~VoltageFrameCache()
+{
+    // Pending loads use the source, let them complete
+    for (auto& pending : _pending)
+        pending.second.wait();
+}
+
+void VoltageFrameCache::setSettings(const VoltageFrameCacheSettings& settings)
+{
+    _settings = settings;
+    _evict();
+}
+
+VoltageFrameCacheStatistics VoltageFrameCache::getStatistics() const
+{
+    VoltageFrameCacheStatistics statistics;
+    statistics.hits = _hits;
+    statistics.misses = _misses;
+    statistics.cachedFrames = static_cast<uint32_t>(_frames.size());
+    statistics.pendingFrames = static_cast<uint32_t>(_pending.size());
+    for (const auto& frame : _frames)
+        statistics.memoryUsage += frame.second.data->size() * sizeof(float);
+    return statistics;
+}
+
+VoltageFramePtr VoltageFrameCache::get(const uint32_t frame, const bool wait)
+{
+    _collect();
+
+    // Playback direction, looping from one end to the other keeps it
+    const bool newFrame = frame != _lastFrame;
+    if (newFrame && _lastFrame != std::numeric_limits<uint32_t>::max())
+    {
+        const auto lastIndex = _nbFrames > 0 ? _nbFrames - 1 : 0;
+        if (_lastFrame == lastIndex && frame == 0)
+            _direction = 1;
+        else if (_lastFrame == 0 && frame == lastIndex)
+            _direction = -1;
+        else
+            _direction = frame < _lastFrame ? -1 : 1;
+    }
+    _lastFrame = frame;
+
+    auto it = _frames.find(frame);
+    if (newFrame)
+    {
+        if (it != _frames.end())
+            ++_hits;
+        else
+            ++_misses;
+    }
+
+    if (it == _frames.end())
+    {
+        _request(frame);
+        if (wait)
+        {
+            _pending[frame].wait();
+            _collect();
+            it = _frames.find(frame);
+        }
+    }
+
+    _readAhead(frame);
+
+    if (it == _frames.end())
+        return nullptr;
+
+    _usage.splice(_usage.begin(), _usage, it->second.usage);
+    return it->second.data;
+}
+
+void VoltageFrameCache::clear()
+{
+    _frames.clear();
+    _usage.clear();
+    _hits = 0;
+    _misses = 0;
+}
+
+void VoltageFrameCache::_collect()
+{
+    for (auto it = _pending.begin(); it != _pending.end();)
+    {
+        auto& future = it->second;
+        if (future.wait_for(std::chrono::milliseconds(0)) !=
+            std::future_status::ready)
+        {
+            ++it;
+            continue;
+        }
+
+        try
+        {
+            _store(it->first, future.get().data);
+        }
+        catch (const std::exception& e)
+        {
+            PLUGIN_ERROR << "Error loading simulation frame " << it->first
+                         << ": " << e.what() << std::endl;
+        }
+        it = _pending.erase(it);
+    }
+}
+
+void VoltageFrameCache::_request(const uint32_t frame)
+{
+    if (_frames.count(frame) || _pending.count(frame))
+        return;
+
+    _pending.emplace(frame, _source->loadFrame(frame));
+}
+
+void VoltageFrameCache::_readAhead(const uint32_t frame)
+{
+    if (_nbFrames == 0)
+        return;
+
+    // Frames read ahead must fit in the cache with the current one
+    const auto count =
+        std::min<size_t>(_settings.readAhead, _getCapacity() - 1);
+    int64_t next = frame;
+    for (size_t i = 0; i < count; ++i)
+    {
+        next = (next + _direction + _nbFrames) % _nbFrames;
+        _request(static_cast<uint32_t>(next));
+    }
+}
+
+void VoltageFrameCache::_store(const uint32_t frame, VoltageFramePtr data)
+{
+    if (!data || _frames.count(frame))
+        return;
+
+    _usage.push_front(frame);
+    _frames[frame] = {std::move(data), _usage.begin()};
+    _evict();
+}
+
+void VoltageFrameCache::_evict()
+{
+    const auto capacity = _getCapacity();
+    while (_frames.size() > capacity)
+    {
+        _frames.erase(_usage.back());
+        _usage.pop_back();
+    }
+}
+
+size_t VoltageFrameCache::_getCapacity() const
+{
+    size_t capacity = _settings.capacity;
+    const auto frameBytes = _source->getFrameSize() * sizeof(float);
+    if (frameBytes > 0)
+        capacity = std::min<size_t>(capacity,
+                                    _settings.memoryBudget / frameBytes);
+    return std::max<size_t>(capacity, 1);
+}
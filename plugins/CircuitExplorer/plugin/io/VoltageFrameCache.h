@@ -0,0 +1,146 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <brion/brion.h>
+
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+typedef std::shared_ptr<brion::CompartmentReport> CompartmentReportPtr;
+typedef std::shared_ptr<std::vector<float>> VoltageFramePtr;
+
+struct VoltageFrameCacheSettings
+{
+    // Maximum number of decoded frames kept in memory
+    uint32_t capacity{64};
+    // Number of frames requested ahead of the current one
+    uint32_t readAhead{8};
+    // Maximum size of the decoded frames kept in memory, in bytes
+    uint64_t memoryBudget{uint64_t(1) << 30};
+};
+
+struct VoltageFrameCacheStatistics
+{
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint32_t cachedFrames{0};
+    uint32_t pendingFrames{0};
+    uint64_t memoryUsage{0};
+};
+
+/**
+ * @brief The VoltageFrameSource class loads the frames held by a
+ * VoltageFrameCache, usually from a compartment report
+ */
+class VoltageFrameSource
+{
+public:
+    virtual ~VoltageFrameSource() = default;
+
+    /**
+     * @return the number of values of a frame
+     */
+    virtual size_t getFrameSize() const = 0;
+
+    /**
+     * @brief loadFrame starts loading a frame in the background
+     * @param frame Index of the frame
+     * @return the frame once loaded
+     */
+    virtual std::future<brion::Frame> loadFrame(const uint32_t frame) = 0;
+};
+
+/**
+ * @brief The VoltageFrameCache class keeps the most recently used frames of a
+ * compartment report in memory, and requests the next ones ahead of time in
+ * the current playback direction. Frames are decoded by the report loading
+ * threads, the cache itself is meant to be used from the render loop only.
+ */
+class VoltageFrameCache
+{
+public:
+    /**
+     * @brief Creates a cache for the frames of a report
+     * @param report Report to read the frames from
+     * @param nbFrames Number of frames of the report
+     */
+    VoltageFrameCache(CompartmentReportPtr report, const uint32_t nbFrames);
+
+    /**
+     * @brief Creates a cache for the frames of a source
+     * @param source Source to read the frames from
+     * @param nbFrames Number of frames of the source
+     */
+    VoltageFrameCache(std::unique_ptr<VoltageFrameSource> source,
+                      const uint32_t nbFrames);
+    ~VoltageFrameCache();
+
+    void setSettings(const VoltageFrameCacheSettings& settings);
+    const VoltageFrameCacheSettings& getSettings() const { return _settings; }
+    VoltageFrameCacheStatistics getStatistics() const;
+
+    /**
+     * @brief get returns a frame if it is loaded, and requests it with the
+     * following ones in the playback direction
+     * @param frame Index of the frame
+     * @param wait Blocks until the frame is loaded if true
+     * @return the frame data, or null if the frame is not loaded yet
+     */
+    VoltageFramePtr get(const uint32_t frame, const bool wait);
+
+    /**
+     * @brief clear drops all cached frames and resets the statistics
+     */
+    void clear();
+
+private:
+    struct CachedFrame
+    {
+        VoltageFramePtr data;
+        std::list<uint32_t>::iterator usage;
+    };
+
+    void _collect();
+    void _request(const uint32_t frame);
+    void _readAhead(const uint32_t frame);
+    void _store(const uint32_t frame, VoltageFramePtr data);
+    void _evict();
+    size_t _getCapacity() const;
+
+    std::unique_ptr<VoltageFrameSource> _source;
+    uint32_t _nbFrames;
+    VoltageFrameCacheSettings _settings;
+
+    std::map<uint32_t, std::future<brion::Frame>> _pending;
+    std::map<uint32_t, CachedFrame> _frames;
+    // Most recently used frames first
+    std::list<uint32_t> _usage;
+
+    uint32_t _lastFrame{std::numeric_limits<uint32_t>::max()};
+    int32_t _direction{1};
+    uint64_t _hits{0};
+    uint64_t _misses{0};
+};
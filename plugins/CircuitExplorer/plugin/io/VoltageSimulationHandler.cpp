@@ -43,6 +43,8 @@ VoltageSimulationHandler::VoltageSimulationHandler(
     _nbFrames = _endTime / _dt;
     _unit = _compartmentReport->getTimeUnit();
     _frameSize = _compartmentReport->getFrameSize();
+    _frameCache =
+        std::make_unique<VoltageFrameCache>(_compartmentReport, _nbFrames);
 
     PLUGIN_INFO << "-----------------------------------------------------------"
                 << std::endl;
@@ -64,9 +66,13 @@ VoltageSimulationHandler::VoltageSimulationHandler(
     const VoltageSimulationHandler& rhs)
     : brayns::AbstractSimulationHandler(rhs)
     , _synchronousMode(rhs._synchronousMode)
+    , _reportPath(rhs._reportPath)
     , _compartmentReport(rhs._compartmentReport)
+    , _frameCache(
+          std::make_unique<VoltageFrameCache>(_compartmentReport, _nbFrames))
     , _ready(false)
 {
+    _frameCache->setSettings(rhs._frameCache->getSettings());
 }
 
 VoltageSimulationHandler::~VoltageSimulationHandler() {}
@@ -83,59 +89,16 @@ bool VoltageSimulationHandler::isReady() const
 
 void* VoltageSimulationHandler::getFrameDataImpl(const uint32_t frame)
 {
-    if (!_currentFrameFuture.valid() && _currentFrame != frame)
-        _triggerLoading(frame);
-
-    if (!_makeFrameReady(frame))
-        return nullptr;
-
-    return _frameData.data();
-}
-
-void VoltageSimulationHandler::_triggerLoading(const uint32_t frame)
-{
-    float timestamp = frame * _dt + _compartmentReport->getStartTime();
-    timestamp = std::min(static_cast<float>(_compartmentReport->getEndTime()),
-                         timestamp);
-
-    if (_currentFrameFuture.valid())
-        _currentFrameFuture.wait();
-
-    _ready = false;
-    _currentFrameFuture = _compartmentReport->loadFrame(timestamp);
-}
-
-bool VoltageSimulationHandler::_isFrameLoaded() const
-{
-    if (!_currentFrameFuture.valid())
-        return false;
-
-    if (_synchronousMode)
+    auto data = _frameCache->get(frame, _synchronousMode);
+    if (!data)
     {
-        _currentFrameFuture.wait();
-        return true;
+        // Keep the current frame until the requested one is loaded
+        _ready = false;
+        return _currentFrameData ? _currentFrameData->data() : nullptr;
     }
 
-    return _currentFrameFuture.wait_for(std::chrono::milliseconds(0)) ==
-           std::future_status::ready;
-}
-
-bool VoltageSimulationHandler::_makeFrameReady(const uint32_t frame)
-{
-    if (_isFrameLoaded())
-    {
-        try
-        {
-            _frameData = std::move(*_currentFrameFuture.get().data);
-        }
-        catch (const std::exception& e)
-        {
-            PLUGIN_ERROR << "Error loading simulation frame " << frame << ": "
-                         << e.what() << std::endl;
-            return false;
-        }
-        _currentFrame = frame;
-        _ready = true;
-    }
-    return true;
+    _currentFrameData = std::move(data);
+    _currentFrame = frame;
+    _ready = true;
+    return _currentFrameData->data();
 }
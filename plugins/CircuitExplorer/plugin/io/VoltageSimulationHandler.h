@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include "VoltageFrameCache.h"
+
 #include <brayns/common/simulation/AbstractSimulationHandler.h>
 #include <plugin/api/CircuitExplorerParams.h>
 
@@ -29,13 +31,12 @@
 #include <brayns/engine/Scene.h>
 #include <brion/brion.h>
 
-typedef std::shared_ptr<brion::CompartmentReport> CompartmentReportPtr;
-
 /**
  * @brief The VoltageSimulationHandler class handles simulation frames for the
  * current circuit. Frames are stored in a memory mapped file that is accessed
  * according to a specified timestamp. The VoltageSimulationHandler class is in
- * charge of keeping the handle to the memory mapped file.
+ * charge of keeping the handle to the memory mapped file. Decoded frames are
+ * kept in a cache that also reads ahead in the playback direction.
  */
 class VoltageSimulationHandler : public brayns::AbstractSimulationHandler
 {
@@ -61,15 +62,18 @@ public:
 
     brayns::AbstractSimulationHandlerPtr clone() const final;
 
+    VoltageFrameCache& getFrameCache() { return *_frameCache; }
+    size_t getSizeInBytes() const final
+    {
+        return _frameCache->getStatistics().memoryUsage;
+    }
+
 private:
-    void _triggerLoading(const uint32_t frame);
-    bool _isFrameLoaded() const;
-    bool _makeFrameReady(const uint32_t frame);
     bool _synchronousMode{false};
 
     std::string _reportPath;
     CompartmentReportPtr _compartmentReport;
-    std::future<brion::Frame> _currentFrameFuture;
-    std::map<uint64_t, std::vector<float>> _frames;
+    std::unique_ptr<VoltageFrameCache> _frameCache;
+    VoltageFramePtr _currentFrameData;
     bool _ready{false};
 };
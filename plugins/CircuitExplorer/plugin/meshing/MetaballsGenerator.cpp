@@ -28,8 +28,23 @@
 #include <brayns/common/log.h>
 #include <brayns/engine/Material.h>
 
+#include <algorithm>
+#include <cmath>
+
 const size_t NB_EDGES = 12;
 
+// Number of cells along each axis of a block of the grid
+const size_t METABALLS_BLOCK_SIZE = 8;
+
+// Fraction of the threshold below which the contribution of a metaball to the
+// scalar field is ignored. It defines the radius of influence of the balls
+const float METABALLS_MIN_CONTRIBUTION = 0.01f;
+
+// Vertices of a cube, as offsets from its first vertex
+const size_t METABALLS_CORNERS[8][3] = {{0, 0, 0}, {0, 0, 1}, {0, 1, 1},
+                                        {0, 1, 0}, {1, 0, 0}, {1, 0, 1},
+                                        {1, 1, 1}, {1, 1, 0}};
+
 const size_t METABALLS_VERTICES[24] = {0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6,
                                        6, 7, 7, 4, 0, 4, 1, 5, 2, 6, 3, 7};
 
@@ -317,14 +332,37 @@ const int8_t METABALLS_TRIANGLES[256][16] = {
     {0, 3, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
     {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}};
 
-MetaballsGenerator::~MetaballsGenerator()
+namespace
+{
+// Range of the grid vertices that are within the given distance of a
+// coordinate, along one axis. Returns false if no vertex is in range
+bool getVertexRange(const float coordinate, const float origin,
+                    const float size, const size_t gridSize,
+                    const float distance, size_t& first, size_t& last)
 {
-    _clear();
+    const float cellSize = size / gridSize;
+    if (cellSize <= 0.f)
+    {
+        if (std::abs(coordinate - origin) > distance)
+            return false;
+        first = 0;
+        last = gridSize;
+        return true;
+    }
+
+    const float lower = std::floor((coordinate - distance - origin) / cellSize);
+    const float upper = std::ceil((coordinate + distance - origin) / cellSize);
+    if (upper < 0.f || lower > static_cast<float>(gridSize))
+        return false;
+    first = static_cast<size_t>(std::max(lower, 0.f));
+    last = static_cast<size_t>(std::min(upper, static_cast<float>(gridSize)));
+    return true;
 }
+} // namespace
 
-void MetaballsGenerator::_buildVerticesAndCubes(
-    const brayns::Vector4fs& metaballs, const size_t gridSize,
-    const size_t defaultMaterialId, const float scale)
+void MetaballsGenerator::_buildGrid(const brayns::Vector4fs& metaballs,
+                                    const size_t gridSize,
+                                    const float threshold, const float scale)
 {
     // Determine bounding box
     brayns::Box<float> bounds;
@@ -333,239 +371,273 @@ void MetaballsGenerator::_buildVerticesAndCubes(
     const auto center = bounds.getCenter();
 
     // Upscale the bounding box to make sure there is no whole in the isosurface
-    auto rescaledBounds =
-        brayns::Box<float>(center - bounds.getSize() * scale / 2.f,
-                           center + bounds.getSize() * scale / 2.f);
-
-    const auto rescaledSize = rescaledBounds.getSize();
-    const size_t incrementedSize = gridSize + 1;
-    _vertices.resize(incrementedSize * incrementedSize * incrementedSize);
+    _size = bounds.getSize() * scale;
+    _origin = center - _size / 2.f;
+    _gridSize = gridSize;
+    _nbBlocks = (gridSize + METABALLS_BLOCK_SIZE - 1) / METABALLS_BLOCK_SIZE;
+
+    // Beyond its radius of influence, the contribution of a ball (r^2/d^2) is
+    // lower than METABALLS_MIN_CONTRIBUTION * threshold
+    const float factor =
+        1.f / std::sqrt(METABALLS_MIN_CONTRIBUTION * threshold);
+    _influenceRadii.resize(metaballs.size());
+    for (size_t i = 0; i < metaballs.size(); ++i)
+        _influenceRadii[i] = metaballs[i].w * factor;
+}
 
-    size_t x = 0;
-    for (x = 0; x < incrementedSize; ++x)
+void MetaballsGenerator::_hashMetaballs(const brayns::Vector4fs& metaballs)
+{
+    // Balls are added in order, which keeps the lists of the blocks sorted and
+    // the summation of the scalar field deterministic
+    _blockBalls.clear();
+    for (size_t i = 0; i < metaballs.size(); ++i)
     {
-        for (size_t y = 0; y < incrementedSize; ++y)
-        {
-            for (size_t z = 0; z < incrementedSize; ++z)
-            {
-                CubeGridVertex cgv;
-                cgv.position.x =
-                    rescaledBounds.getMin().x + x * rescaledSize.x / gridSize;
-                cgv.position.y =
-                    rescaledBounds.getMin().y + y * rescaledSize.y / gridSize;
-                cgv.position.z =
-                    rescaledBounds.getMin().z + z * rescaledSize.z / gridSize;
-
-                cgv.texCoords.x =
-                    static_cast<float>(x) / static_cast<float>(gridSize);
-                cgv.texCoords.y =
-                    static_cast<float>(y) / static_cast<float>(gridSize);
-                cgv.texCoords.z = 0.f;
-
-                cgv.value = 0.f;
-                cgv.normal = {0.f, 0.f, 0.f};
-
-                cgv.materialId = defaultMaterialId;
-
-                const size_t index = x * incrementedSize * incrementedSize +
-                                     y * incrementedSize + z;
+        const auto& ball = metaballs[i];
+        size_t first[3];
+        size_t last[3];
+        bool inRange = true;
+        for (size_t axis = 0; axis < 3 && inRange; ++axis)
+            inRange = getVertexRange(ball[axis], _origin[axis], _size[axis],
+                                     _gridSize, _influenceRadii[i],
+                                     first[axis], last[axis]);
+        if (!inRange)
+            continue;
 
-                _vertices[index] = cgv;
-            }
-        }
+        for (size_t x = _getBlockIndex(first[0]);
+             x <= _getBlockIndex(last[0]); ++x)
+            for (size_t y = _getBlockIndex(first[1]);
+                 y <= _getBlockIndex(last[1]); ++y)
+                for (size_t z = _getBlockIndex(first[2]);
+                     z <= _getBlockIndex(last[2]); ++z)
+                    _blockBalls[_getBlockKey(x, y, z)].push_back(
+                        static_cast<uint32_t>(i));
     }
+}
 
-    _cubes.resize(gridSize * gridSize * gridSize);
-    for (x = 0; x < gridSize; ++x)
+std::vector<MetaballsGenerator::Block> MetaballsGenerator::_getActiveBlocks()
+    const
+{
+    // The cubes on the upper faces of a block use the vertices of the next
+    // blocks, hence the blocks preceding a block reached by metaballs are
+    // polygonized as well
+    std::vector<uint64_t> keys;
+    keys.reserve(_blockBalls.size() * 8);
+    for (const auto& blockBalls : _blockBalls)
     {
-        for (size_t y = 0; y < gridSize; ++y)
-        {
-            for (size_t z = 0; z < gridSize; ++z)
-            {
-                CubeGridCube cgc;
-                cgc.vertices[0] =
-                    &_vertices[(x * incrementedSize + y) * incrementedSize + z];
-                cgc.vertices[1] =
-                    &_vertices[(x * incrementedSize + y) * incrementedSize + z +
-                               1];
-                cgc.vertices[2] = &_vertices[(x * incrementedSize + (y + 1)) *
-                                                 incrementedSize +
-                                             z + 1];
-                cgc.vertices[3] = &_vertices[(x * incrementedSize + (y + 1)) *
-                                                 incrementedSize +
-                                             z];
-                cgc.vertices[4] = &_vertices[((x + 1) * incrementedSize + y) *
-                                                 incrementedSize +
-                                             z];
-                cgc.vertices[5] = &_vertices[((x + 1) * incrementedSize + y) *
-                                                 incrementedSize +
-                                             z + 1];
-                cgc.vertices[6] =
-                    &_vertices[((x + 1) * incrementedSize + (y + 1)) *
-                                   incrementedSize +
-                               z + 1];
-                cgc.vertices[7] =
-                    &_vertices[((x + 1) * incrementedSize + (y + 1)) *
-                                   incrementedSize +
-                               z];
-
-                const size_t index = x * gridSize * gridSize + y * gridSize + z;
-                _cubes[index] = cgc;
-            }
-        }
+        const auto key = blockBalls.first;
+        const size_t z = key % _nbBlocks;
+        const size_t y = (key / _nbBlocks) % _nbBlocks;
+        const size_t x = key / _nbBlocks / _nbBlocks;
+        for (size_t dx = 0; dx <= std::min<size_t>(x, 1); ++dx)
+            for (size_t dy = 0; dy <= std::min<size_t>(y, 1); ++dy)
+                for (size_t dz = 0; dz <= std::min<size_t>(z, 1); ++dz)
+                    keys.push_back(_getBlockKey(x - dx, y - dy, z - dz));
     }
 
-    BRAYNS_DEBUG << "Nb metaballs   : " << metaballs.size() << std::endl;
-    BRAYNS_DEBUG << "Nb Vertices    : " << _vertices.size() << std::endl;
-    BRAYNS_DEBUG << "Nb Cubes       : " << _cubes.size() << std::endl;
-    BRAYNS_DEBUG << "Grid size      : " << gridSize << std::endl;
-    BRAYNS_DEBUG << "Grid dimensions: " << bounds << "/" << bounds.getSize()
-                 << std::endl;
+    // Sorted keys make the blocks ordered by slabs along the X axis,
+    // whatever the order of the hash map
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    std::vector<Block> blocks;
+    blocks.reserve(keys.size());
+    for (const auto key : keys)
+        blocks.push_back({key / _nbBlocks / _nbBlocks,
+                          (key / _nbBlocks) % _nbBlocks, key % _nbBlocks});
+    return blocks;
 }
 
-void MetaballsGenerator::_buildTriangles(const brayns::Vector4fs& metaballs,
-                                         const float threshold,
-                                         const size_t defaultMaterialId,
-                                         brayns::TriangleMeshMap& triangles)
+void MetaballsGenerator::_polygonizeBlock(const brayns::Vector4fs& metaballs,
+                                          const Block& block,
+                                          const float threshold,
+                                          brayns::TriangleMesh& mesh) const
 {
-    for (const auto metaball : metaballs)
-    {
-        const auto radius = metaball.w;
-        const auto squaredRadius = radius * radius;
-
-        for (auto& vertex : _vertices)
-        {
-            const auto ballToPoint =
-                vertex.position - brayns::Vector3f(metaball);
-
-            // get squared distance from ball to point
-            const auto distance = ballToPoint.length();
-            auto squaredDistance = distance * distance;
-
-            if (squaredDistance == 0.f)
-                continue;
-
-            const auto normalScale = squaredRadius / squaredDistance;
-            vertex.value += normalScale;
-
-            if (distance < threshold)
-                vertex.materialId = defaultMaterialId;
-
-            vertex.normal += ballToPoint * normalScale;
-        }
-    }
+    const size_t first[3] = {block.x * METABALLS_BLOCK_SIZE,
+                             block.y * METABALLS_BLOCK_SIZE,
+                             block.z * METABALLS_BLOCK_SIZE};
+    size_t nbCells[3];
+    for (size_t axis = 0; axis < 3; ++axis)
+        nbCells[axis] =
+            std::min(METABALLS_BLOCK_SIZE, _gridSize - first[axis]);
+    const size_t sizeY = nbCells[1] + 1;
+    const size_t sizeZ = nbCells[2] + 1;
+
+    // The vertices of the block belong either to this block or to the next
+    // ones along each axis. Their values are computed from the balls of the
+    // block they belong to, so that vertices shared by two blocks get the
+    // same value on both sides of the seam
+    const BlockBalls* balls[2][2][2] = {};
+    for (size_t dx = 0; dx < 2; ++dx)
+        for (size_t dy = 0; dy < 2; ++dy)
+            for (size_t dz = 0; dz < 2; ++dz)
+            {
+                if (block.x + dx >= _nbBlocks || block.y + dy >= _nbBlocks ||
+                    block.z + dz >= _nbBlocks)
+                    continue;
+                const auto it = _blockBalls.find(
+                    _getBlockKey(block.x + dx, block.y + dy, block.z + dz));
+                if (it != _blockBalls.end())
+                    balls[dx][dy][dz] = &it->second;
+            }
 
-    for (const auto& cube : _cubes)
+    std::vector<GridVertex> vertices((nbCells[0] + 1) * sizeY * sizeZ);
+    bool aboveThreshold = false;
+    for (size_t x = 0; x <= nbCells[0]; ++x)
     {
-        unsigned char cubeIndex = 0;
-
-        if (cube.vertices[0]->value > 0.f &&
-            cube.vertices[0]->value < threshold)
-            cubeIndex |= 1;
-        if (cube.vertices[1]->value > 0.f &&
-            cube.vertices[1]->value < threshold)
-            cubeIndex |= 2;
-        if (cube.vertices[2]->value > 0.f &&
-            cube.vertices[2]->value < threshold)
-            cubeIndex |= 4;
-        if (cube.vertices[3]->value > 0.f &&
-            cube.vertices[3]->value < threshold)
-            cubeIndex |= 8;
-        if (cube.vertices[4]->value > 0.f &&
-            cube.vertices[4]->value < threshold)
-            cubeIndex |= 16;
-        if (cube.vertices[5]->value > 0.f &&
-            cube.vertices[5]->value < threshold)
-            cubeIndex |= 32;
-        if (cube.vertices[6]->value > 0.f &&
-            cube.vertices[6]->value < threshold)
-            cubeIndex |= 64;
-        if (cube.vertices[7]->value > 0.f &&
-            cube.vertices[7]->value < threshold)
-            cubeIndex |= 128;
-
-        int usedEdges = METABALLS_EDGES[cubeIndex];
-
-        if (usedEdges == 0 || usedEdges == 255)
-            continue;
-
-        for (size_t currentEdge = 0; currentEdge < NB_EDGES; ++currentEdge)
+        const size_t gx = first[0] + x;
+        for (size_t y = 0; y <= nbCells[1]; ++y)
         {
-            // Check usedEdges against 1,2,4,8,16,...,2048
-            if (usedEdges & (1 << currentEdge))
+            const size_t gy = first[1] + y;
+            for (size_t z = 0; z <= nbCells[2]; ++z)
             {
-                CubeGridVertex* v1 =
-                    cube.vertices[METABALLS_VERTICES[currentEdge * 2]];
-                CubeGridVertex* v2 =
-                    cube.vertices[METABALLS_VERTICES[currentEdge * 2 + 1]];
-
-                const float denom = (v2->value - v1->value);
-                if (fabs(denom) < 0.00001f)
+                const size_t gz = first[2] + z;
+                const auto blockBalls =
+                    balls[_getBlockIndex(gx) - block.x]
+                         [_getBlockIndex(gy) - block.y]
+                         [_getBlockIndex(gz) - block.z];
+                if (!blockBalls)
                     continue;
 
-                auto delta = (threshold - v1->value) / denom;
-
-                brayns::Vector3f position;
-                position.x =
-                    v1->position.x + delta * (v2->position.x - v1->position.x);
-                position.y =
-                    v1->position.y + delta * (v2->position.y - v1->position.y);
-                position.z =
-                    v1->position.z + delta * (v2->position.z - v1->position.z);
-
-                brayns::Vector3f normal;
-                normal.x = v1->normal.x + delta * (v2->normal.x - v1->normal.x);
-                normal.y = v1->normal.y + delta * (v2->normal.y - v1->normal.y);
-                normal.z = v1->normal.z + delta * (v2->normal.z - v1->normal.z);
-
-                _edgeVertices[currentEdge].position = position;
-                _edgeVertices[currentEdge].normal = normal;
-                _edgeVertices[currentEdge].materialId = v1->materialId;
+                const auto position = _getPosition(gx, gy, gz);
+                auto& vertex = vertices[(x * sizeY + y) * sizeZ + z];
+                for (const auto index : *blockBalls)
+                {
+                    const auto& metaball = metaballs[index];
+                    const auto ballToPoint =
+                        position - brayns::Vector3f(metaball);
+
+                    // get squared distance from ball to point
+                    const auto squaredDistance =
+                        glm::dot(ballToPoint, ballToPoint);
+                    const auto radius = _influenceRadii[index];
+                    if (squaredDistance == 0.f ||
+                        squaredDistance >= radius * radius)
+                        continue;
+
+                    const auto normalScale =
+                        metaball.w * metaball.w / squaredDistance;
+                    vertex.value += normalScale;
+                    vertex.normal += ballToPoint * normalScale;
+                }
+                if (vertex.value >= threshold)
+                    aboveThreshold = true;
             }
         }
+    }
 
-        auto& vertices = triangles[defaultMaterialId].vertices;
-        auto& normals = triangles[defaultMaterialId].normals;
-        auto& indices = triangles[defaultMaterialId].indices;
+    if (!aboveThreshold)
+        return;
 
-        for (auto k = 0; METABALLS_TRIANGLES[cubeIndex][k] != -1; k += 3)
+    brayns::Vector3f edgePositions[NB_EDGES];
+    brayns::Vector3f edgeNormals[NB_EDGES];
+    for (size_t x = 0; x < nbCells[0]; ++x)
+    {
+        for (size_t y = 0; y < nbCells[1]; ++y)
         {
-            const auto verticesIndex = vertices.size();
-
-            // Create triangulated face
-            bool processFace = true;
-            for (auto f = 0; f < 3 && processFace; ++f)
+            for (size_t z = 0; z < nbCells[2]; ++z)
             {
-                const auto index = METABALLS_TRIANGLES[cubeIndex][k + f];
-                if (size_t(index) >= _edgeVertices.size())
-                    processFace = false;
-            }
-            if (!processFace)
-                continue;
-
-            for (auto f = 0; f < 3; ++f)
-            {
-                const auto index = METABALLS_TRIANGLES[cubeIndex][k + f];
-
-                const auto vertex = _edgeVertices[index].position;
-                vertices.push_back(vertex);
+                const GridVertex* corners[8];
+                unsigned char cubeIndex = 0;
+                for (size_t i = 0; i < 8; ++i)
+                {
+                    const auto& corner = METABALLS_CORNERS[i];
+                    corners[i] = &vertices[((x + corner[0]) * sizeY + y +
+                                            corner[1]) *
+                                               sizeZ +
+                                           z + corner[2]];
+                    if (corners[i]->value < threshold)
+                        cubeIndex |= 1 << i;
+                }
+
+                const auto usedEdges = METABALLS_EDGES[cubeIndex];
+                if (usedEdges == 0)
+                    continue;
 
-                const auto normal = normalize(_edgeVertices[index].normal);
-                normals.push_back(normal);
+                for (size_t edge = 0; edge < NB_EDGES; ++edge)
+                {
+                    // Check usedEdges against 1,2,4,8,16,...,2048
+                    if (!(usedEdges & (1 << edge)))
+                        continue;
+
+                    const auto i1 = METABALLS_VERTICES[edge * 2];
+                    const auto i2 = METABALLS_VERTICES[edge * 2 + 1];
+                    const auto& v1 = *corners[i1];
+                    const auto& v2 = *corners[i2];
+
+                    const float denom = v2.value - v1.value;
+                    const float delta = std::abs(denom) < 0.00001f
+                                            ? 0.5f
+                                            : (threshold - v1.value) / denom;
+
+                    const auto& c1 = METABALLS_CORNERS[i1];
+                    const auto& c2 = METABALLS_CORNERS[i2];
+                    const auto p1 =
+                        _getPosition(first[0] + x + c1[0],
+                                     first[1] + y + c1[1],
+                                     first[2] + z + c1[2]);
+                    const auto p2 =
+                        _getPosition(first[0] + x + c2[0],
+                                     first[1] + y + c2[1],
+                                     first[2] + z + c2[2]);
+
+                    edgePositions[edge] = p1 + delta * (p2 - p1);
+                    edgeNormals[edge] =
+                        v1.normal + delta * (v2.normal - v1.normal);
+                }
+
+                for (auto k = 0; METABALLS_TRIANGLES[cubeIndex][k] != -1;
+                     k += 3)
+                {
+                    // Create triangulated face
+                    bool processFace = true;
+                    for (auto f = 0; f < 3 && processFace; ++f)
+                    {
+                        const auto index =
+                            METABALLS_TRIANGLES[cubeIndex][k + f];
+                        if (size_t(index) >= NB_EDGES)
+                            processFace = false;
+                    }
+                    if (!processFace)
+                        continue;
+
+                    const auto verticesIndex = mesh.vertices.size();
+                    for (auto f = 0; f < 3; ++f)
+                    {
+                        const auto index =
+                            METABALLS_TRIANGLES[cubeIndex][k + f];
+                        mesh.vertices.push_back(edgePositions[index]);
+                        mesh.normals.push_back(
+                            glm::normalize(edgeNormals[index]));
+                    }
+
+                    mesh.indices.push_back(
+                        brayns::Vector3ui(verticesIndex, verticesIndex + 1,
+                                          verticesIndex + 2));
+                }
             }
-
-            indices.push_back(brayns::Vector3ui(verticesIndex,
-                                                verticesIndex + 1,
-                                                verticesIndex + 2));
         }
     }
 }
 
-void MetaballsGenerator::_clear()
+brayns::Vector3f MetaballsGenerator::_getPosition(const size_t x,
+                                                  const size_t y,
+                                                  const size_t z) const
+{
+    return {_origin.x + x * _size.x / _gridSize,
+            _origin.y + y * _size.y / _gridSize,
+            _origin.z + z * _size.z / _gridSize};
+}
+
+size_t MetaballsGenerator::_getBlockIndex(const size_t vertexIndex) const
 {
-    _edgeVertices.resize(NB_EDGES);
-    _vertices.clear();
-    _cubes.clear();
+    // The last vertices of the grid belong to the last block
+    return std::min(vertexIndex / METABALLS_BLOCK_SIZE, _nbBlocks - 1);
+}
+
+uint64_t MetaballsGenerator::_getBlockKey(const size_t x, const size_t y,
+                                          const size_t z) const
+{
+    return (x * _nbBlocks + y) * _nbBlocks + z;
 }
 
 void MetaballsGenerator::generateMesh(const brayns::Vector4fs& metaballs,
@@ -574,7 +646,46 @@ void MetaballsGenerator::generateMesh(const brayns::Vector4fs& metaballs,
                                       const size_t defaultMaterialId,
                                       brayns::TriangleMeshMap& triangles)
 {
-    _clear();
-    _buildVerticesAndCubes(metaballs, gridSize, defaultMaterialId);
-    _buildTriangles(metaballs, threshold, defaultMaterialId, triangles);
+    if (metaballs.empty() || gridSize == 0 || threshold <= 0.f)
+        return;
+
+    _buildGrid(metaballs, gridSize, threshold);
+    _hashMetaballs(metaballs);
+    const auto blocks = _getActiveBlocks();
+
+    std::vector<brayns::TriangleMesh> meshes(blocks.size());
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < blocks.size(); ++i)
+        _polygonizeBlock(metaballs, blocks[i], threshold, meshes[i]);
+
+    BRAYNS_DEBUG << "Nb metaballs   : " << metaballs.size() << std::endl;
+    BRAYNS_DEBUG << "Grid size      : " << gridSize << std::endl;
+    BRAYNS_DEBUG << "Active blocks  : " << blocks.size() << "/"
+                 << _nbBlocks * _nbBlocks * _nbBlocks << std::endl;
+
+    // Meshes are merged in block order, whatever the thread that built them
+    size_t nbVertices = 0;
+    size_t nbIndices = 0;
+    for (const auto& mesh : meshes)
+    {
+        nbVertices += mesh.vertices.size();
+        nbIndices += mesh.indices.size();
+    }
+    if (nbIndices == 0)
+        return;
+
+    auto& mesh = triangles[defaultMaterialId];
+    mesh.vertices.reserve(mesh.vertices.size() + nbVertices);
+    mesh.normals.reserve(mesh.normals.size() + nbVertices);
+    mesh.indices.reserve(mesh.indices.size() + nbIndices);
+    for (const auto& blockMesh : meshes)
+    {
+        const brayns::Vector3ui offset(mesh.vertices.size());
+        mesh.vertices.insert(mesh.vertices.end(), blockMesh.vertices.begin(),
+                             blockMesh.vertices.end());
+        mesh.normals.insert(mesh.normals.end(), blockMesh.normals.begin(),
+                            blockMesh.normals.end());
+        for (const auto& index : blockMesh.indices)
+            mesh.indices.push_back(index + offset);
+    }
 }
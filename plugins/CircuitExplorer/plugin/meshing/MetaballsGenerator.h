@@ -25,14 +25,20 @@
 
 #include <brayns/common/types.h>
 
+#include <unordered_map>
+
 /**
  * Generated a mesh according to given set of metaballs.
+ *
+ * Metaballs are hashed into blocks of the grid according to their radius of
+ * influence, and only blocks reached by at least one ball are polygonized.
+ * Blocks are processed in parallel and their triangles are merged in block
+ * order, so that the generated mesh does not depend on thread scheduling.
  */
 class MetaballsGenerator
 {
 public:
     MetaballsGenerator() {}
-    ~MetaballsGenerator();
 
     /** Generates a triangle based mesh model according to provided
      * metaballs, grid granularity and threshold
@@ -50,51 +56,46 @@ public:
                       brayns::TriangleMeshMap& triangles);
 
 private:
-    struct SurfaceVertex
+    struct GridVertex
     {
-        SurfaceVertex()
-            : materialId(0)
-        {
-        }
-
-        brayns::Vector3f position;
-        brayns::Vector3f normal;
-        brayns::Vector3f texCoords;
-        size_t materialId;
+        float value{0.f}; // Value of the scalar field
+        brayns::Vector3f normal{0.f, 0.f, 0.f};
     };
 
-    struct CubeGridVertex : public SurfaceVertex
+    struct Block
     {
-        CubeGridVertex()
-            : SurfaceVertex()
-            , value(0)
-        {
-        }
-
-        float value; // Value of the scalar field
+        size_t x;
+        size_t y;
+        size_t z;
     };
 
-    struct CubeGridCube
-    {
-        CubeGridVertex* vertices[8];
-    };
+    // Indices of the metaballs reaching the vertices of a block, sorted
+    typedef std::vector<uint32_t> BlockBalls;
+    typedef std::unordered_map<uint64_t, BlockBalls> BlockBallsMap;
+
+    void _buildGrid(const brayns::Vector4fs& metaballs, const size_t gridSize,
+                    const float threshold, const float scale = 5.f);
+
+    void _hashMetaballs(const brayns::Vector4fs& metaballs);
+
+    std::vector<Block> _getActiveBlocks() const;
 
-    typedef std::vector<CubeGridVertex> Vertices;
-    typedef std::vector<CubeGridCube> Cubes;
-    typedef std::vector<SurfaceVertex> SurfaceVertices;
+    void _polygonizeBlock(const brayns::Vector4fs& metaballs,
+                          const Block& block, const float threshold,
+                          brayns::TriangleMesh& mesh) const;
 
-    void _clear();
+    brayns::Vector3f _getPosition(const size_t x, const size_t y,
+                                  const size_t z) const;
 
-    void _buildVerticesAndCubes(const brayns::Vector4fs& metaballs,
-                                const size_t gridSize,
-                                const size_t defaultMaterialId,
-                                const float scale = 5.f);
+    size_t _getBlockIndex(const size_t vertexIndex) const;
 
-    void _buildTriangles(const brayns::Vector4fs& metaballs,
-                         const float threshold, const size_t defaultMaterialId,
-                         brayns::TriangleMeshMap& triangles);
+    uint64_t _getBlockKey(const size_t x, const size_t y,
+                          const size_t z) const;
 
-    SurfaceVertices _edgeVertices;
-    Vertices _vertices;
-    Cubes _cubes;
+    size_t _gridSize{0};
+    size_t _nbBlocks{0};
+    brayns::Vector3f _origin;
+    brayns::Vector3f _size;
+    std::vector<float> _influenceRadii;
+    BlockBallsMap _blockBalls;
 };
@@ -101,7 +101,7 @@ bool PointCloudMesher::toMetaballs(brayns::Model& model,
 
         model.createMaterial(point.first, std::to_string(point.first));
 
-        brayns::MetaballsGenerator metaballsGenerator;
+        MetaballsGenerator metaballsGenerator;
         metaballsGenerator.generateMesh(point.second, gridSize, threshold,
                                         point.first, triangles);
     }
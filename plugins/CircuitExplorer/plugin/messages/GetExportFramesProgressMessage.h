@@ -25,4 +25,11 @@
 
 BRAYNS_MESSAGE_BEGIN(GetExportFramesProgressMessage)
 BRAYNS_MESSAGE_ENTRY(double, progress, "Progress of the last export 0-1")
+BRAYNS_MESSAGE_ENTRY(uint64_t, queued_frames,
+                     "Number of frames waiting to be encoded")
+BRAYNS_MESSAGE_ENTRY(uint64_t, encoded_frames, "Number of frames encoded")
+BRAYNS_MESSAGE_ENTRY(uint64_t, written_frames,
+                     "Number of frames written to disk")
+BRAYNS_MESSAGE_ENTRY(uint64_t, failed_frames,
+                     "Number of frames that could not be encoded or written")
 BRAYNS_MESSAGE_END()
\ No newline at end of file
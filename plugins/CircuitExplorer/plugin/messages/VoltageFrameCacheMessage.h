@@ -0,0 +1,51 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <brayns/network/json/Message.h>
+
+BRAYNS_MESSAGE_BEGIN(GetVoltageFrameCacheMessage)
+BRAYNS_MESSAGE_ENTRY(size_t, model_id,
+                     "The model with the voltage simulation to inspect")
+BRAYNS_MESSAGE_END()
+
+BRAYNS_MESSAGE_BEGIN(VoltageFrameCacheMessage)
+BRAYNS_MESSAGE_ENTRY(uint32_t, capacity, "Maximum number of cached frames")
+BRAYNS_MESSAGE_ENTRY(uint32_t, read_ahead,
+                     "Number of frames loaded ahead in the playback direction")
+BRAYNS_MESSAGE_ENTRY(uint64_t, memory_budget,
+                     "Maximum size of the cached frames in bytes")
+BRAYNS_MESSAGE_ENTRY(uint64_t, hits, "Number of frames found in the cache")
+BRAYNS_MESSAGE_ENTRY(uint64_t, misses, "Number of frames read from the report")
+BRAYNS_MESSAGE_ENTRY(uint32_t, cached_frames, "Number of frames in the cache")
+BRAYNS_MESSAGE_ENTRY(uint32_t, pending_frames, "Number of frames being loaded")
+BRAYNS_MESSAGE_ENTRY(uint64_t, memory_usage,
+                     "Size of the cached frames in bytes")
+BRAYNS_MESSAGE_END()
+
+BRAYNS_MESSAGE_BEGIN(SetVoltageFrameCacheMessage)
+BRAYNS_MESSAGE_ENTRY(size_t, model_id,
+                     "The model with the voltage simulation to configure")
+BRAYNS_MESSAGE_ENTRY(uint32_t, capacity, "Maximum number of cached frames")
+BRAYNS_MESSAGE_ENTRY(uint32_t, read_ahead,
+                     "Number of frames loaded ahead in the playback direction")
+BRAYNS_MESSAGE_ENTRY(uint64_t, memory_budget,
+                     "Maximum size of the cached frames in bytes")
+BRAYNS_MESSAGE_END()
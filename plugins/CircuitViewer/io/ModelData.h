@@ -42,6 +42,7 @@ struct ModelData
         , cones(std::move(other.cones))
         , sdfBeziers(std::move(other.sdfBeziers))
         , sdfGeometries(std::move(other.sdfGeometries))
+        , sdfNeighbourOffsets(std::move(other.sdfNeighbourOffsets))
         , sdfNeighbours(std::move(other.sdfNeighbours))
         , sdfMaterials(std::move(other.sdfMaterials))
     {
@@ -72,7 +73,9 @@ struct ModelData
     {
         sdfMaterials.push_back(materialId);
         sdfGeometries.push_back(geom);
-        sdfNeighbours.push_back(neighbours);
+        sdfNeighbours.insert(sdfNeighbours.end(), neighbours.begin(),
+                             neighbours.end());
+        sdfNeighbourOffsets.push_back(sdfNeighbours.size());
     }
 
     void addTo(Model& model) const
@@ -105,28 +108,10 @@ struct ModelData
                 model.getSDFBeziers()[index].end(), sdfBezier.second.begin(),
                 sdfBezier.second.end());
         }
-        const size_t numGeoms = sdfGeometries.size();
-        std::vector<size_t> localToGlobalIndex(numGeoms, 0);
-
-        // Add geometries to Model. We do not know the indices of the neighbours
-        // yet so we leave them empty.
-        for (size_t i = 0; i < numGeoms; i++)
-            localToGlobalIndex[i] =
-                model.addSDFGeometry(sdfMaterials[i], sdfGeometries[i], {});
-
-        // Write the neighbours using global indices
-        std::vector<size_t> neighboursTmp;
-        for (size_t i = 0; i < numGeoms; i++)
-        {
-            const size_t globalIndex = localToGlobalIndex[i];
-            neighboursTmp.clear();
-
-            for (auto localNeighbourIndex : sdfNeighbours[i])
-                neighboursTmp.push_back(
-                    localToGlobalIndex[localNeighbourIndex]);
-
-            model.updateSDFGeometryNeighbours(globalIndex, neighboursTmp);
-        }
+        // Neighbour indices are local to this container, the model offsets
+        // them when appending the geometries
+        model.addSDFGeometries(sdfMaterials, sdfGeometries, sdfNeighbourOffsets,
+                               sdfNeighbours);
     }
 
     SpheresMap spheres;
@@ -134,7 +119,10 @@ struct ModelData
     ConesMap cones;
     SDFBeziersMap sdfBeziers;
     std::vector<SDFGeometry> sdfGeometries;
-    std::vector<std::vector<size_t>> sdfNeighbours;
+    // Neighbours of geometry i are in [sdfNeighbourOffsets[i],
+    // sdfNeighbourOffsets[i + 1])
+    std::vector<uint64_t> sdfNeighbourOffsets{0};
+    std::vector<uint64_t> sdfNeighbours;
     std::vector<size_t> sdfMaterials;
 };
 } // namespace brayns
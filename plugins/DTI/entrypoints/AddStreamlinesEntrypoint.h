@@ -99,7 +99,8 @@ public:
             // Load colors from points
             const auto colors =
                 DTILoader::getColorsFromPoints(points, opacity,
-                                               ColorScheme(colorScheme));
+                                               ColorScheme(colorScheme),
+                                               materialId);
 
             // Create streamlines
             brayns::Streamline streamline(points, colors, radii);
@@ -21,12 +21,17 @@
 
 #include "DTILoader.h"
 #include "../log.h"
+#include "StreamlineTable.h"
 #include "Utils.h"
 
+#include <brayns/common/geometry/Streamline.h>
 #include <brayns/engine/Material.h>
 #include <brayns/engine/Model.h>
 #include <brayns/engine/Scene.h>
 
+#include <async++.h>
+
+#include <algorithm>
 #include <fstream>
 
 namespace
@@ -37,6 +42,12 @@ const std::string LOADER_NAME = "DTI loader";
 /** Supported extensions */
 const std::string SUPPORTED_EXTENTION_DTI = "dti";
 
+/** Extension of the binary cache written next to the streamlines file */
+const std::string BINARY_CACHE_EXTENSION = ".bin";
+
+/** Number of gids whose streamlines are built in parallel at once */
+const size_t GID_BATCH_SIZE = 4096;
+
 template <>
 inline std::vector<std::pair<std::string, ColorScheme>> enumerateMap()
 {
@@ -63,7 +74,80 @@ const brayns::Property PROP_COLOR_SCHEME = {"colorscheme",
                                             {enumToString(ColorScheme::none),
                                              enumerateNames<ColorScheme>()},
                                             {"Color scheme"}};
+const brayns::Property PROP_BINARY_CACHE = {
+    "binarycache", true, {"Cache streamlines in a binary file"}};
+
+// Mixes an id into 64 random bits (splitmix64 finalizer)
+uint64_t _hash(uint64_t id)
+{
+    id += 0x9E3779B97F4A7C15ull;
+    id = (id ^ (id >> 30)) * 0xBF58476D1CE4E5B9ull;
+    id = (id ^ (id >> 27)) * 0x94D049BB133111EBull;
+    return id ^ (id >> 31);
+}
+
+void _appendColors(const Point* points, const size_t nbPoints,
+                   const float opacity, const ColorScheme colorScheme,
+                   const uint64_t id, Colors& colors)
+{
+    switch (colorScheme)
+    {
+    case ColorScheme::by_normal:
+        colors.push_back({0.f, 0.f, 0.f, opacity});
+        for (uint64_t i = 0; i + 1 < nbPoints; ++i)
+        {
+            const auto& p1 = points[i];
+            const auto& p2 = points[i + 1];
+            const auto dir = normalize(p2 - p1);
+            const brayns::Vector3f n = {0.5f + dir.x * 0.5f,
+                                        0.5f + dir.y * 0.5f,
+                                        0.5f + dir.z * 0.5f};
+            colors.push_back({n.x, n.y, n.z, opacity});
+        }
+        break;
+    case ColorScheme::by_id:
+    {
+        const auto hash = _hash(id);
+        colors.resize(colors.size() + nbPoints,
+                      {(hash & 0xFFFF) % 100 / 100.f,
+                       ((hash >> 16) & 0xFFFF) % 100 / 100.f,
+                       ((hash >> 32) & 0xFFFF) % 100 / 100.f, opacity});
+        break;
+    }
+    default:
+        colors.resize(colors.size() + nbPoints, {1.f, 1.f, 1.f, opacity});
+        break;
+    }
+}
+
+std::unique_ptr<dti::StreamlineTable> _loadStreamlines(
+    const std::string& filename, const std::vector<uint8_t>& rows,
+    const bool useCache)
+{
+    if (!useCache)
+        return dti::StreamlineTable::loadText(filename, rows);
 
+    // The cache holds all the rows, as it may be shared by several mappings
+    const auto cacheFilename = filename + BINARY_CACHE_EXTENSION;
+    auto table = dti::StreamlineTable::loadBinary(cacheFilename, filename);
+    if (table)
+    {
+        PLUGIN_INFO << "Mapped streamlines from " << cacheFilename
+                    << std::endl;
+        return table;
+    }
+
+    table = dti::StreamlineTable::loadText(filename, {});
+    try
+    {
+        table->saveBinary(cacheFilename, filename);
+    }
+    catch (const std::runtime_error& e)
+    {
+        PLUGIN_WARN << e.what() << std::endl;
+    }
+    return table;
+}
 } // namespace
 
 namespace dti
@@ -109,35 +193,15 @@ std::vector<brayns::ModelDescriptorPtr> DTILoader::importFromBlob(
     throw std::runtime_error("Loading DTI from blob is not supported");
 }
 
-Colors DTILoader::getColorsFromPoints(const brayns::Vector3fs& points,
+Colors DTILoader::getColorsFromPoints(const Points& points,
                                       const float opacity,
-                                      const ColorScheme colorScheme)
+                                      const ColorScheme colorScheme,
+                                      const uint64_t id)
 {
     Colors colors;
-    switch (colorScheme)
-    {
-    case ColorScheme::by_normal:
-        colors.push_back({0.f, 0.f, 0.f, opacity});
-        for (uint64_t i = 0; i < points.size() - 1; ++i)
-        {
-            const auto& p1 = points[i];
-            const auto& p2 = points[i + 1];
-            const auto dir = normalize(p2 - p1);
-            const brayns::Vector3f n = {0.5f + dir.x * 0.5f,
-                                        0.5f + dir.y * 0.5f,
-                                        0.5f + dir.z * 0.5f};
-            colors.push_back({n.x, n.y, n.z, opacity});
-        }
-        break;
-    case ColorScheme::by_id:
-        colors.resize(points.size(),
-                      {rand() % 100 / 100.f, rand() % 100 / 100.f,
-                       rand() % 100 / 100.f, opacity});
-        break;
-    default:
-        colors.resize(points.size(), {1.f, 1.f, 1.f, opacity});
-        break;
-    }
+    colors.reserve(points.size());
+    _appendColors(points.data(), points.size(), opacity, colorScheme, id,
+                  colors);
     return colors;
 }
 
@@ -153,95 +217,108 @@ std::vector<brayns::ModelDescriptorPtr> DTILoader::importFromFile(
     props.merge(properties);
 
     // Read loading properties
-    const auto radius = props[PROP_RADIUS.getName()].as<double>();
-    const auto opacity = props[PROP_OPACITY.getName()].as<double>();
+    const float radius = props[PROP_RADIUS.getName()].as<double>();
+    const float opacity = props[PROP_OPACITY.getName()].as<double>();
     const auto colorScheme = stringToEnum<ColorScheme>(
-        properties[PROP_COLOR_SCHEME.getName()].to<std::string>());
+        props[PROP_COLOR_SCHEME.getName()].to<std::string>());
+    const auto useCache = props[PROP_BINARY_CACHE.getName()].as<bool>();
 
-    // Check files
+    // Load mapping between GIDs and Rows
+    callback.updateProgress("Loading mapping ...", 0.f);
     std::ifstream gidRowfile(config.gid_to_streamline, std::ios::in);
     if (!gidRowfile.good())
         PLUGIN_THROW(std::runtime_error("Could not open gid/row mapping file " +
                                         config.gid_to_streamline));
-
-    std::ifstream streamlinesFile(config.streamlines, std::ios::in);
-    if (!streamlinesFile.good())
-        PLUGIN_THROW(std::runtime_error("Could not open streamlines file " +
-                                        config.streamlines));
-
-    // Load positions
-    callback.updateProgress("Loading positions ...", 0.f);
-
-    // Load mapping between GIDs and Rows
-    callback.updateProgress("Loading mapping ...", 0.2f);
     std::vector<GidRow> gidRows(std::istream_iterator<GidRow>(gidRowfile), {});
     gidRowfile.close();
 
     // Rows to load
-    std::set<u_int64_t> rowsToLoad;
+    std::vector<uint8_t> rowsToLoad;
     for (const auto& gidRow : gidRows)
-        rowsToLoad.insert(gidRow.row);
+    {
+        if (gidRow.row >= rowsToLoad.size())
+            rowsToLoad.resize(gidRow.row + 1, 0);
+        rowsToLoad[gidRow.row] = 1;
+    }
 
     // Load points
-    using Points = std::vector<brayns::Vector3f>;
-    std::map<uint64_t, Points> streamlines;
-    uint64_t count = 0;
-    callback.updateProgress("Loading streamlines ...", 0.4f);
-    while (streamlinesFile.good())
+    callback.updateProgress("Loading streamlines ...", 0.2f);
+    const auto table =
+        _loadStreamlines(config.streamlines, rowsToLoad, useCache);
+
+    // Keep the first occurrence of each row holding a valid streamline, and
+    // group them by gid in mapping order
+    const auto nbRows = table->getNbRows();
+    std::vector<uint8_t> rowAdded(nbRows, 0);
+    std::vector<GidRow> streamlineRows;
+    streamlineRows.reserve(gidRows.size());
+    for (const auto& gidRow : gidRows)
     {
-        std::string line;
-        std::getline(streamlinesFile, line);
-
-        if (rowsToLoad.find(count) != rowsToLoad.end())
-        {
-            std::istringstream in(line);
-            uint64_t nbPoints;
-            in >> nbPoints;
-            Points points;
-            for (uint64_t i = 0; i < nbPoints; ++i)
-            {
-                brayns::Vector3f point;
-                in >> point.x >> point.y >> point.z;
-                points.push_back(point);
-            }
-            streamlines[count] = points;
-        }
-        ++count;
+        if (gidRow.row >= nbRows || rowAdded[gidRow.row] ||
+            table->getNbPoints(gidRow.row) < 2)
+            continue;
+        rowAdded[gidRow.row] = 1;
+        streamlineRows.push_back(gidRow);
     }
-    streamlinesFile.close();
-
-    // Create model
+    std::vector<uint8_t>().swap(rowAdded);
+    std::stable_sort(streamlineRows.begin(), streamlineRows.end(),
+                     [](const GidRow& a, const GidRow& b) {
+                         return a.gid < b.gid;
+                     });
+
+    std::vector<size_t> gidStarts;
+    for (size_t i = 0; i < streamlineRows.size(); ++i)
+        if (i == 0 || streamlineRows[i].gid != streamlineRows[i - 1].gid)
+            gidStarts.push_back(i);
+    const size_t nbGids = gidStarts.size();
+    gidStarts.push_back(streamlineRows.size());
+
+    // Create model, building the streamlines of a batch of gids in parallel
     auto model = _scene.createModel();
-    const auto nbStreamlines = gidRows.size();
-    count = 0;
-    uint64_t i = 0;
-    std::set<u_int16_t> streamlineAdded;
-    for (const auto& gidRow : gidRows)
+    const size_t count = streamlineRows.size();
+    std::vector<brayns::StreamlinesData> batch;
+    for (size_t first = 0; first < nbGids; first += GID_BATCH_SIZE)
     {
-        const auto it = streamlines.find(gidRow.row);
-        if (it != streamlines.end() &&
-            streamlineAdded.find(gidRow.row) == streamlineAdded.end())
+        callback.updateProgress("Creating " + std::to_string(count) +
+                                    " streamlines ...",
+                                0.4f + 0.4f * float(first) / float(nbGids));
+
+        const size_t last = std::min(first + GID_BATCH_SIZE, nbGids);
+        batch.clear();
+        batch.resize(last - first);
+        async::parallel_for(
+            async::irange(first, last), [&](const size_t gidIndex) {
+                auto& data = batch[gidIndex - first];
+                size_t nbPoints = 0;
+                for (size_t i = gidStarts[gidIndex];
+                     i < gidStarts[gidIndex + 1]; ++i)
+                    nbPoints += table->getNbPoints(streamlineRows[i].row);
+                data.vertex.reserve(nbPoints);
+                data.vertexColor.reserve(nbPoints);
+                data.indices.reserve(nbPoints);
+
+                for (size_t i = gidStarts[gidIndex];
+                     i < gidStarts[gidIndex + 1]; ++i)
+                {
+                    const auto& gidRow = streamlineRows[i];
+                    const auto points = table->getPoints(gidRow.row);
+                    const auto size = table->getNbPoints(gidRow.row);
+                    const auto start = int32_t(data.vertex.size());
+                    for (size_t p = 0; p + 1 < size; ++p)
+                        data.indices.push_back(start + int32_t(p));
+                    for (size_t p = 0; p < size; ++p)
+                        data.vertex.emplace_back(points[p], radius);
+                    _appendColors(points, size, opacity, colorScheme,
+                                  gidRow.gid, data.vertexColor);
+                }
+            });
+
+        for (size_t gidIndex = first; gidIndex < last; ++gidIndex)
         {
-            streamlineAdded.insert(gidRow.row);
-            callback.updateProgress("Creating " + std::to_string(count) +
-                                        " streamlines ...",
-                                    0.6f +
-                                        0.2f * float(i) / float(nbStreamlines));
-
-            const auto& points = (*it).second;
-            const auto nbPoints = points.size();
-            const auto colors =
-                getColorsFromPoints(points, opacity, colorScheme);
-
-            std::vector<float> radii;
-            radii.resize(nbPoints, radius);
-
-            brayns::Streamline streamline(points, colors, radii);
-            model->createMaterial(gidRow.gid, std::to_string(gidRow.gid));
-            model->addStreamline(gidRow.gid, streamline);
-            ++count;
+            const auto gid = streamlineRows[gidStarts[gidIndex]].gid;
+            model->createMaterial(gid, std::to_string(gid));
+            model->addStreamlines(gid, batch[gidIndex - first]);
         }
-        ++i;
     }
 
     callback.updateProgress("Committing " + std::to_string(count) +
@@ -267,6 +344,7 @@ brayns::PropertyMap DTILoader::getCLIProperties()
     pm.add(PROP_RADIUS);
     pm.add(PROP_OPACITY);
     pm.add(PROP_COLOR_SCHEME);
+    pm.add(PROP_BINARY_CACHE);
     return pm;
 }
 } // namespace dti
@@ -57,8 +57,13 @@ public:
         const std::string& filename, const brayns::LoaderProgress& callback,
         const brayns::PropertyMap& properties) const final;
 
+    /**
+     * Returns the colors of the points of a streamline. Colors by id are
+     * derived from the given id, so that they are the same on every load.
+     */
     static Colors getColorsFromPoints(const Points& points, const float opacity,
-                                      const ColorScheme colorScheme);
+                                      const ColorScheme colorScheme,
+                                      const uint64_t id = 0);
 
 private:
     DTIConfiguration _readConfiguration(
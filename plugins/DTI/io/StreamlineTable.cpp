@@ -0,0 +1,305 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "StreamlineTable.h"
+
+#include <brayns/io/LineRange.h>
+#include <brayns/io/MappedFile.h>
+
+#include <async++.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include <sys/stat.h>
+
+namespace
+{
+// Number of chunks of lines parsed per thread
+const size_t CHUNKS_PER_THREAD = 4;
+
+const char BINARY_MAGIC[8] = {'B', 'R', 'D', 'T', 'I', 'S', 'L', '1'};
+
+struct BinaryHeader
+{
+    char magic[8];
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    uint64_t nbRows;
+    uint64_t nbPoints;
+};
+
+static_assert(sizeof(Point) == 3 * sizeof(float),
+              "Points are stored as packed float triplets");
+
+struct SourceStamp
+{
+    uint64_t size;
+    int64_t time;
+};
+
+SourceStamp _getSourceStamp(const std::string& filename)
+{
+    struct stat sb;
+    if (::stat(filename.c_str(), &sb) == -1)
+        throw std::runtime_error("Could not open streamlines file " +
+                                 filename);
+    return {uint64_t(sb.st_size), int64_t(sb.st_mtime)};
+}
+
+/** Lines of a text file parsed by one task */
+struct LineChunk
+{
+    const char* begin;
+    const char* end;
+    size_t firstRow{0};
+    size_t nbRows{0};
+    std::vector<uint64_t> counts;
+    Points points;
+};
+
+std::vector<LineChunk> _splitLines(const char* data, const size_t size)
+{
+    const auto ranges = brayns::splitLines(data, size, CHUNKS_PER_THREAD);
+    std::vector<LineChunk> chunks(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        chunks[i].begin = ranges[i].begin;
+        chunks[i].end = ranges[i].end;
+    }
+    return chunks;
+}
+
+bool _isSpace(const char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Copies the next token of a line into a null-terminated buffer, as the
+// mapped file is not null-terminated. Returns false at the end of the line.
+bool _nextToken(const char*& begin, const char* end, char (&token)[64])
+{
+    while (begin != end && _isSpace(*begin))
+        ++begin;
+    const char* tokenEnd = begin;
+    while (tokenEnd != end && !_isSpace(*tokenEnd))
+        ++tokenEnd;
+    if (tokenEnd == begin)
+        return false;
+
+    const size_t length =
+        std::min(size_t(tokenEnd - begin), sizeof(token) - 1);
+    std::memcpy(token, begin, length);
+    token[length] = '\0';
+    begin = tokenEnd;
+    return true;
+}
+
+// Parses the streamlines of the requested rows of a chunk. Lines that declare
+// more points than they hold keep the points that could be read.
+void _parseChunk(LineChunk& chunk, const std::vector<uint8_t>& rows)
+{
+    chunk.counts.resize(chunk.nbRows, 0);
+    size_t row = 0;
+    for (const char* begin = chunk.begin; begin < chunk.end; ++row)
+    {
+        auto lineEnd = static_cast<const char*>(
+            std::memchr(begin, '\n', chunk.end - begin));
+        if (!lineEnd)
+            lineEnd = chunk.end;
+
+        const auto globalRow = chunk.firstRow + row;
+        const bool requested =
+            rows.empty() || (globalRow < rows.size() && rows[globalRow]);
+        char token[64];
+        if (requested && _nextToken(begin, lineEnd, token))
+        {
+            const uint64_t nbPoints = std::strtoull(token, nullptr, 10);
+            uint64_t count = 0;
+            for (; count < nbPoints; ++count)
+            {
+                Point point;
+                size_t i = 0;
+                for (; i < 3 && _nextToken(begin, lineEnd, token); ++i)
+                    point[i] = std::strtof(token, nullptr);
+                if (i < 3)
+                    break;
+                chunk.points.push_back(point);
+            }
+            chunk.counts[row] = count;
+        }
+        begin = lineEnd + 1;
+    }
+}
+} // namespace
+
+namespace dti
+{
+StreamlineTable::StreamlineTable()
+    : _offsetsBuffer(1, 0)
+    , _offsets(_offsetsBuffer.data())
+{
+}
+
+StreamlineTable::~StreamlineTable() = default;
+
+std::unique_ptr<StreamlineTable> StreamlineTable::loadText(
+    const std::string& filename, const std::vector<uint8_t>& rows)
+{
+    const brayns::MappedFile file(filename);
+    auto chunks = _splitLines(file.data(), file.size());
+
+    // Count the rows of each chunk to know the index of their first row
+    async::parallel_for(async::irange(size_t(0), chunks.size()),
+                        [&](const size_t i) {
+                            auto& chunk = chunks[i];
+                            chunk.nbRows =
+                                brayns::countLines({chunk.begin, chunk.end});
+                        });
+    size_t nbRows = 0;
+    for (auto& chunk : chunks)
+    {
+        chunk.firstRow = nbRows;
+        nbRows += chunk.nbRows;
+    }
+
+    async::parallel_for(async::irange(size_t(0), chunks.size()),
+                        [&](const size_t i) { _parseChunk(chunks[i], rows); });
+
+    // Merge the chunks in row order
+    std::unique_ptr<StreamlineTable> table(new StreamlineTable());
+    auto& offsets = table->_offsetsBuffer;
+    offsets.resize(nbRows + 1);
+    std::vector<uint64_t> chunkOffsets;
+    chunkOffsets.reserve(chunks.size());
+    uint64_t nbPoints = 0;
+    for (const auto& chunk : chunks)
+    {
+        chunkOffsets.push_back(nbPoints);
+        for (size_t row = 0; row < chunk.nbRows; ++row)
+        {
+            offsets[chunk.firstRow + row] = nbPoints;
+            nbPoints += chunk.counts[row];
+        }
+    }
+    offsets[nbRows] = nbPoints;
+
+    auto& points = table->_pointsBuffer;
+    points.resize(nbPoints);
+    async::parallel_for(async::irange(size_t(0), chunks.size()),
+                        [&](const size_t i) {
+                            auto& chunk = chunks[i];
+                            std::copy(chunk.points.begin(), chunk.points.end(),
+                                      points.begin() + chunkOffsets[i]);
+                            Points().swap(chunk.points);
+                        });
+
+    table->_nbRows = nbRows;
+    table->_offsets = offsets.data();
+    table->_points = points.data();
+    return table;
+}
+
+std::unique_ptr<StreamlineTable> StreamlineTable::loadBinary(
+    const std::string& filename, const std::string& source)
+{
+    std::unique_ptr<brayns::MappedFile> file;
+    try
+    {
+        file.reset(new brayns::MappedFile(filename));
+    }
+    catch (const std::runtime_error&)
+    {
+        return nullptr;
+    }
+
+    if (file->size() < sizeof(BinaryHeader))
+        return nullptr;
+
+    BinaryHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    const auto stamp = _getSourceStamp(source);
+    if (std::memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0 ||
+        header.sourceSize != stamp.size || header.sourceTime != stamp.time)
+        return nullptr;
+
+    // Counts larger than the file would overflow the sizes below
+    if (header.nbRows >= file->size() / sizeof(uint64_t) ||
+        header.nbPoints > file->size() / sizeof(Point))
+        return nullptr;
+
+    const size_t offsetsSize = (header.nbRows + 1) * sizeof(uint64_t);
+    const size_t pointsSize = header.nbPoints * sizeof(Point);
+    if (file->size() != sizeof(BinaryHeader) + offsetsSize + pointsSize)
+        return nullptr;
+
+    // Rows index the points, a corrupted table would read out of the mapping
+    const auto data = file->data() + sizeof(BinaryHeader);
+    const auto offsets = reinterpret_cast<const uint64_t*>(data);
+    if (offsets[0] != 0 || offsets[header.nbRows] != header.nbPoints ||
+        !std::is_sorted(offsets, offsets + header.nbRows + 1))
+        return nullptr;
+
+    std::unique_ptr<StreamlineTable> table(new StreamlineTable());
+    table->_nbRows = header.nbRows;
+    table->_offsets = offsets;
+    table->_points = reinterpret_cast<const Point*>(data + offsetsSize);
+    table->_file = std::move(file);
+    return table;
+}
+
+void StreamlineTable::saveBinary(const std::string& filename,
+                                 const std::string& source) const
+{
+    const auto stamp = _getSourceStamp(source);
+    BinaryHeader header;
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.sourceSize = stamp.size;
+    header.sourceTime = stamp.time;
+    header.nbRows = _nbRows;
+    header.nbPoints = _offsets[_nbRows];
+
+    // Written aside and renamed, so that a partial file is never mapped
+    const auto tmpFilename = filename + ".tmp";
+    {
+        std::ofstream file(tmpFilename, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(_offsets),
+                   (_nbRows + 1) * sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(_points),
+                   header.nbPoints * sizeof(Point));
+        if (!file.good())
+        {
+            file.close();
+            std::remove(tmpFilename.c_str());
+            throw std::runtime_error("Could not write streamlines file " +
+                                     tmpFilename);
+        }
+    }
+    if (std::rename(tmpFilename.c_str(), filename.c_str()) != 0)
+    {
+        std::remove(tmpFilename.c_str());
+        throw std::runtime_error("Could not write streamlines file " +
+                                 filename);
+    }
+}
+} // namespace dti
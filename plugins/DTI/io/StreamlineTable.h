@@ -0,0 +1,94 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include "DTITypes.h"
+
+#include <memory>
+
+namespace brayns
+{
+class MappedFile;
+}
+
+namespace dti
+{
+/**
+ * Points of the streamlines of a DTI streamlines file, indexed by row.
+ *
+ * Text files hold one streamline per line: the number of points followed by
+ * their coordinates. A table can be saved to a compact binary file, which is
+ * memory mapped instead of parsed on later loads.
+ */
+class StreamlineTable
+{
+public:
+    StreamlineTable();
+    ~StreamlineTable();
+
+    StreamlineTable(const StreamlineTable&) = delete;
+    StreamlineTable& operator=(const StreamlineTable&) = delete;
+
+    /**
+     * Parses a text streamlines file, in parallel chunks of lines.
+     *
+     * @param filename Path of the text file
+     * @param rows Flags of the rows to load, indexed by row. All rows are
+     *        loaded if empty, rows beyond its size are skipped otherwise.
+     */
+    static std::unique_ptr<StreamlineTable> loadText(
+        const std::string& filename, const std::vector<uint8_t>& rows);
+
+    /**
+     * Maps a binary file saved by saveBinary().
+     *
+     * @return nullptr if the binary file is missing, invalid, or does not
+     *         match the current version of the text file
+     */
+    static std::unique_ptr<StreamlineTable> loadBinary(
+        const std::string& filename, const std::string& source);
+
+    /**
+     * Saves the table to a binary file, stamped with the size and modification
+     * time of the text file it was parsed from.
+     */
+    void saveBinary(const std::string& filename,
+                    const std::string& source) const;
+
+    size_t getNbRows() const { return _nbRows; }
+    size_t getNbPoints(const size_t row) const
+    {
+        return _offsets[row + 1] - _offsets[row];
+    }
+    const Point* getPoints(const size_t row) const
+    {
+        return _points + _offsets[row];
+    }
+
+private:
+    std::vector<uint64_t> _offsetsBuffer;
+    Points _pointsBuffer;
+    std::unique_ptr<brayns::MappedFile> _file;
+
+    size_t _nbRows{0};
+    const uint64_t* _offsets{nullptr};
+    const Point* _points{nullptr};
+};
+} // namespace dti
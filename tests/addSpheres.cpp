@@ -0,0 +1,65 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/geometry/Sphere.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+TEST_CASE("bulk_spheres_match_single_spheres")
+{
+    const char* argv[] = {"addSpheres"};
+    brayns::Brayns brayns(1, argv);
+    auto& scene = brayns.getEngine().getScene();
+
+    const brayns::Spheres spheres{{{0.f, 0.f, 0.f}, 1.f},
+                                  {{1.f, 0.f, 0.f}, 0.5f},
+                                  {{0.f, 2.f, 0.f}, 0.25f}};
+
+    auto single = scene.createModel();
+    for (const auto& sphere : spheres)
+        single->addSphere(0, sphere);
+    single->addSphere(0, spheres.front());
+
+    auto bulk = scene.createModel();
+    CHECK_EQ(bulk->addSpheres(0, spheres), 0);
+    CHECK_EQ(bulk->addSphere(0, spheres.front()), 3);
+    CHECK_EQ(bulk->addSpheres(1, {}), 0);
+
+    const auto& expected = single->getSpheres().at(0);
+    const auto& actual = bulk->getSpheres().at(0);
+    REQUIRE_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i)
+    {
+        CHECK_EQ(actual[i].center, expected[i].center);
+        CHECK_EQ(actual[i].radius, expected[i].radius);
+    }
+    CHECK_EQ(bulk->getSpheres().count(1), 0);
+    CHECK_EQ(bulk->getMemoryUsage().spheres,
+             single->getMemoryUsage().spheres);
+
+    single->updateBounds();
+    bulk->updateBounds();
+    CHECK_EQ(bulk->getBounds(), single->getBounds());
+}
@@ -0,0 +1,191 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/geometry/Sphere.h>
+#include <brayns/common/loader/LoaderRegistry.h>
+#include <brayns/common/utils/filesystem.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+#include <brayns/io/ArchiveLoader.h>
+#include <brayns/io/XYZBLoader.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <archive.h>
+#include <archive_entry.h>
+
+#include <thread>
+
+namespace
+{
+struct File
+{
+    std::string path;
+    size_t nbPoints;
+};
+
+// One sphere per line, so that each model tells which file it comes from
+std::string createPoints(const size_t nbPoints)
+{
+    std::string content;
+    for (size_t i = 0; i < nbPoints; ++i)
+        content += std::to_string(i) + " 0 0\n";
+    return content;
+}
+
+brayns::Blob createTar(const std::vector<File>& files)
+{
+    brayns::uint8_ts data(1024 * 1024);
+    size_t used = 0;
+    auto writer = archive_write_new();
+    archive_write_set_format_ustar(writer);
+    REQUIRE_EQ(archive_write_open_memory(writer, data.data(), data.size(),
+                                         &used),
+               ARCHIVE_OK);
+    for (const auto& file : files)
+    {
+        const auto content = createPoints(file.nbPoints);
+        auto entry = archive_entry_new();
+        archive_entry_set_pathname(entry, file.path.c_str());
+        archive_entry_set_size(entry, content.size());
+        archive_entry_set_filetype(entry, AE_IFREG);
+        archive_entry_set_perm(entry, 0644);
+        REQUIRE_EQ(archive_write_header(writer, entry), ARCHIVE_OK);
+        archive_write_data(writer, content.data(), content.size());
+        archive_entry_free(entry);
+    }
+    archive_write_close(writer);
+    archive_write_free(writer);
+    data.resize(used);
+    return {"tar", "files.tar", std::move(data)};
+}
+
+// Loads points from a path only, like the loaders of files referencing others
+class PointsFileLoader : public brayns::Loader
+{
+public:
+    PointsFileLoader(brayns::Scene& scene)
+        : brayns::Loader(scene)
+        , _loader(scene)
+    {
+    }
+
+    std::vector<std::string> getSupportedExtensions() const final
+    {
+        return {"pts"};
+    }
+    std::string getName() const final { return "points file"; }
+
+    bool isSupported(const std::string& /*filename*/,
+                     const std::string& extension) const final
+    {
+        return extension == "pts";
+    }
+
+    std::vector<brayns::ModelDescriptorPtr> importFromBlob(
+        brayns::Blob&&, const brayns::LoaderProgress&,
+        const brayns::PropertyMap&) const final
+    {
+        throw std::runtime_error("Points files can only be loaded from disk");
+    }
+
+    std::vector<brayns::ModelDescriptorPtr> importFromFile(
+        const std::string& filename, const brayns::LoaderProgress& callback,
+        const brayns::PropertyMap& properties) const final
+    {
+        REQUIRE(fs::exists(filename));
+        return _loader.importFromFile(filename, callback, properties);
+    }
+
+private:
+    brayns::XYZBLoader _loader;
+};
+
+struct ArchiveTest
+{
+    ArchiveTest()
+    {
+        auto& scene = brayns.getEngine().getScene();
+        registry.registerLoader(std::make_unique<brayns::XYZBLoader>(scene));
+        registry.registerLoader(std::make_unique<PointsFileLoader>(scene));
+    }
+
+    std::vector<brayns::ModelDescriptorPtr> load(
+        const std::vector<File>& files, const bool loadAllEntries)
+    {
+        brayns::PropertyMap properties;
+        properties.add({"loadAllEntries", loadAllEntries});
+        brayns::ArchiveLoader loader(brayns.getEngine().getScene(), registry);
+        return loader.importFromBlob(createTar(files), {}, properties);
+    }
+
+    const char* argv[1]{"archiveLoader"};
+    brayns::Brayns brayns{1, argv};
+    brayns::LoaderRegistry registry;
+};
+
+void checkModels(const std::vector<brayns::ModelDescriptorPtr>& models,
+                 const std::vector<File>& files)
+{
+    REQUIRE_EQ(models.size(), files.size());
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        CHECK_EQ(fs::path(models[i]->getName()).filename().string(),
+                 fs::path(files[i].path).filename().string());
+        CHECK_EQ(models[i]->getModel().getSpheres().at(0).size(),
+                 files[i].nbPoints);
+    }
+}
+} // namespace
+
+TEST_CASE("archive_loads_first_entry_at_root_by_default")
+{
+    ArchiveTest test;
+    const auto models = test.load({{"nested/first.xyz", 1},
+                                   {"second.xyz", 2},
+                                   {"third.xyz", 3}},
+                                  false);
+    checkModels(models, {{"second.xyz", 2}});
+}
+
+TEST_CASE("archive_loads_all_entries_in_archive_order")
+{
+    // More entries than loaded concurrently
+    std::vector<File> files;
+    for (size_t i = 1; i <= 2 * std::thread::hardware_concurrency() + 1; ++i)
+        files.push_back({"points" + std::to_string(i) + ".xyz", i});
+
+    ArchiveTest test;
+    checkModels(test.load(files, true), files);
+}
+
+TEST_CASE("archive_loads_disk_and_memory_entries_in_archive_order")
+{
+    const std::vector<File> files{{"first.pts", 1},
+                                  {"second.xyz", 2},
+                                  {"nested/third.pts", 3},
+                                  {"fourth.xyz", 4}};
+
+    ArchiveTest test;
+    checkModels(test.load(files, true), files);
+}
@@ -0,0 +1,264 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/network/socket/ConnectionManager.h>
+
+#include <Poco/Net/HTTPClientSession.h>
+#include <Poco/Net/HTTPRequest.h>
+#include <Poco/Net/HTTPRequestHandler.h>
+#include <Poco/Net/HTTPRequestHandlerFactory.h>
+#include <Poco/Net/HTTPResponse.h>
+#include <Poco/Net/HTTPServer.h>
+#include <Poco/Net/HTTPServerParams.h>
+#include <Poco/Net/HTTPServerRequest.h>
+#include <Poco/Net/HTTPServerResponse.h>
+#include <Poco/Net/ServerSocket.h>
+#include <Poco/Net/SocketAddress.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// WebSocket server on loopback handing the server side sockets to the test.
+// Connections stay open until the server is destroyed.
+class LoopbackServer
+{
+public:
+    LoopbackServer()
+        : _server(new HandlerFactory(*this),
+                  Poco::Net::ServerSocket(
+                      Poco::Net::SocketAddress("127.0.0.1", 0)),
+                  new Poco::Net::HTTPServerParams)
+    {
+        _server.start();
+    }
+
+    ~LoopbackServer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopped = true;
+        }
+        _condition.notify_all();
+        _server.stopAll(true);
+    }
+
+    Poco::UInt16 getPort() const { return _server.port(); }
+
+    brayns::NetworkSocketPtr accept()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this] { return !_sockets.empty(); });
+        auto socket = std::move(_sockets.front());
+        _sockets.pop_front();
+        return socket;
+    }
+
+private:
+    class Handler : public Poco::Net::HTTPRequestHandler
+    {
+    public:
+        Handler(LoopbackServer& server)
+            : _server(&server)
+        {
+        }
+
+        void handleRequest(Poco::Net::HTTPServerRequest& request,
+                           Poco::Net::HTTPServerResponse& response) override
+        {
+            _server->_serve(
+                std::make_shared<brayns::NetworkSocket>(request, response));
+        }
+
+    private:
+        LoopbackServer* _server;
+    };
+
+    class HandlerFactory : public Poco::Net::HTTPRequestHandlerFactory
+    {
+    public:
+        HandlerFactory(LoopbackServer& server)
+            : _server(&server)
+        {
+        }
+
+        Poco::Net::HTTPRequestHandler* createRequestHandler(
+            const Poco::Net::HTTPServerRequest&) override
+        {
+            return new Handler(*_server);
+        }
+
+    private:
+        LoopbackServer* _server;
+    };
+
+    void _serve(brayns::NetworkSocketPtr socket)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _sockets.push_back(std::move(socket));
+        _condition.notify_all();
+        _condition.wait(lock, [this] { return _stopped; });
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<brayns::NetworkSocketPtr> _sockets;
+    bool _stopped = false;
+    Poco::Net::HTTPServer _server;
+};
+
+// WebSocket client of the loopback server, the session must outlive the socket
+struct LoopbackClient
+{
+    LoopbackClient(LoopbackServer& server)
+        : session("127.0.0.1", server.getPort())
+        , request(Poco::Net::HTTPRequest::HTTP_1_1)
+        , socket(session, request, response)
+    {
+    }
+
+    Poco::Net::HTTPClientSession session;
+    Poco::Net::HTTPRequest request;
+    Poco::Net::HTTPResponse response;
+    brayns::NetworkSocket socket;
+};
+
+brayns::ConnectionStatistics getStatistics(
+    brayns::ConnectionManager& connections,
+    const brayns::NetworkSocketPtr& socket)
+{
+    const brayns::ConnectionHandle handle(socket);
+    for (const auto& statistics : connections.getStatistics())
+    {
+        if (statistics.first == handle)
+        {
+            return statistics.second;
+        }
+    }
+    FAIL("Connection not found");
+    return {};
+}
+} // namespace
+
+TEST_CASE("slow_client_does_not_block_broadcast_and_removal")
+{
+    LoopbackServer server;
+
+    // The client never reads so the server writer ends up blocked in send
+    LoopbackClient client(server);
+    auto socket = server.accept();
+
+    brayns::ConnectionManager connections;
+    connections.add(socket);
+    connections.update();
+
+    const std::string frame(8 << 20, 'x');
+    const brayns::OutputPacket packet(frame.data(), int(frame.size()));
+    const auto start = Clock::now();
+    for (size_t i = 0; i < 16; ++i)
+    {
+        connections.broadcast(packet);
+    }
+    connections.broadcast(brayns::OutputPacket("{}"));
+    CHECK(Clock::now() - start < std::chrono::seconds(1));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const auto statistics = connections.getStatistics();
+    REQUIRE_EQ(statistics.size(), 1);
+    const auto& queue = statistics[0].second;
+    CHECK_GT(queue.droppedFrames, 0);
+    CHECK_LE(queue.queueSize, 3);
+
+    // Removing the client must interrupt the blocked writer
+    connections.remove(socket);
+    auto update = std::async(std::launch::async, [&] { connections.update(); });
+    const auto status = update.wait_for(std::chrono::seconds(5));
+    if (status != std::future_status::ready)
+    {
+        // Unblock the writer so the test fails instead of hanging
+        client.socket.shutdown();
+    }
+    CHECK(status == std::future_status::ready);
+    update.get();
+    CHECK_EQ(connections.getConnectionCount(), 0);
+}
+
+TEST_CASE("slow_client_does_not_slow_down_other_clients")
+{
+    LoopbackServer server;
+    LoopbackClient slowClient(server);
+    auto slowSocket = server.accept();
+    LoopbackClient fastClient(server);
+    auto fastSocket = server.accept();
+
+    brayns::ConnectionManager connections;
+    connections.add(slowSocket);
+    connections.add(fastSocket);
+    connections.update();
+
+    // Frames are broadcasted at a steady rate, the fast client must get all of
+    // them while the slow one never reads and ends up dropping frames
+    constexpr size_t nbFrames = 32;
+    auto received = std::async(std::launch::async, [&] {
+        size_t frames = 0;
+        while (frames < nbFrames)
+        {
+            if (fastClient.socket.receive().isBinary())
+            {
+                ++frames;
+            }
+        }
+        return frames;
+    });
+
+    const std::string frame(1 << 20, 'x');
+    const brayns::OutputPacket packet(frame.data(), int(frame.size()));
+    for (size_t i = 0; i < nbFrames; ++i)
+    {
+        connections.broadcast(packet);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    const auto status = received.wait_for(std::chrono::seconds(10));
+    if (status != std::future_status::ready)
+    {
+        // Unblock the reader so the test fails instead of hanging
+        fastClient.socket.shutdown();
+    }
+    CHECK(status == std::future_status::ready);
+    size_t frames = 0;
+    CHECK_NOTHROW(frames = received.get());
+    CHECK_EQ(frames, nbFrames);
+
+    const auto fast = getStatistics(connections, fastSocket);
+    CHECK_EQ(fast.droppedFrames, 0);
+    const auto slow = getStatistics(connections, slowSocket);
+    CHECK_GT(slow.droppedFrames, 0);
+}
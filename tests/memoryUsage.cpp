@@ -0,0 +1,68 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/geometry/Cone.h>
+#include <brayns/common/geometry/Cylinder.h>
+#include <brayns/common/geometry/Sphere.h>
+#include <brayns/common/geometry/Streamline.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+TEST_CASE("memory_usage_follows_added_geometries")
+{
+    const char* argv[] = {"memoryUsage"};
+    brayns::Brayns brayns(1, argv);
+    auto& scene = brayns.getEngine().getScene();
+    auto model = scene.createModel();
+    model->createMaterial(0, "geometry");
+
+    model->addSphere(0, {{0.f, 0.f, 0.f}, 1.f});
+    model->addSphere(0, {{1.f, 0.f, 0.f}, 1.f});
+    model->addCylinder(0, {{0.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, 1.f});
+    model->addCone(0, {{0.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, 1.f, 0.5f});
+    model->addStreamline(0, {{{0.f, 0.f, 0.f}, {1.f, 0.f, 0.f}},
+                             {{1.f, 1.f, 1.f, 1.f}, {1.f, 1.f, 1.f, 1.f}},
+                             {1.f, 1.f}});
+
+    auto usage = model->getMemoryUsage();
+    CHECK_EQ(usage.spheres, 2 * sizeof(brayns::Sphere));
+    CHECK_EQ(usage.cylinders, sizeof(brayns::Cylinder));
+    CHECK_EQ(usage.cones, sizeof(brayns::Cone));
+    CHECK_EQ(usage.streamlines,
+             sizeof(int32_t) + 4 * sizeof(brayns::Vector4f));
+    CHECK_EQ(usage.getTotal(), model->getSizeInBytes());
+
+    // Geometries changed through the accessors are recomputed
+    model->getSpheres()[0].pop_back();
+    usage = model->getMemoryUsage();
+    CHECK_EQ(usage.spheres, sizeof(brayns::Sphere));
+
+    model->getSpheres().clear();
+    model->getStreamlines().clear();
+    usage = model->getMemoryUsage();
+    CHECK_EQ(usage.spheres, 0);
+    CHECK_EQ(usage.streamlines, 0);
+    CHECK_EQ(usage.cylinders, sizeof(brayns::Cylinder));
+}
@@ -0,0 +1,221 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/geometry/TriangleMesh.h>
+#include <brayns/common/propertymap/PropertyMap.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Material.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+#include <brayns/io/MeshLoader.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <sstream>
+
+namespace
+{
+// Rows of faces between two group and material statements
+constexpr size_t ROWS_PER_GROUP = 8;
+constexpr size_t NB_MATERIALS = 3;
+
+// Grid of size x size quads split in triangles, written row by row: the
+// vertices of a row are followed by the faces of the row before, so that
+// vertices, faces and statements are spread over all the chunks of the file
+struct Grid
+{
+    size_t size;
+    std::vector<brayns::Vector3f> vertices;
+    std::vector<brayns::Vector3ui> triangles;
+    std::vector<size_t> materials;
+};
+
+Grid createGrid(const size_t size)
+{
+    Grid grid;
+    grid.size = size;
+    for (size_t y = 0; y <= size; ++y)
+        for (size_t x = 0; x <= size; ++x)
+            grid.vertices.push_back({x / 8.f, y / 4.f, ((x * y) % 5) / 2.f});
+    for (size_t y = 0; y < size; ++y)
+        for (size_t x = 0; x < size; ++x)
+        {
+            const auto v = y * (size + 1) + x;
+            const auto material = (y / ROWS_PER_GROUP) % NB_MATERIALS;
+            grid.triangles.emplace_back(v, v + 1, v + size + 2);
+            grid.triangles.emplace_back(v, v + size + 2, v + size + 1);
+            grid.materials.push_back(material);
+            grid.materials.push_back(material);
+        }
+    return grid;
+}
+
+std::string getMaterialName(const size_t material)
+{
+    return "material" + std::to_string(material);
+}
+
+// The plain file uses line feeds and absolute indices. The other one uses
+// CRLF line ends, negative indices and splits some lines with a backslash.
+brayns::Blob createBlob(const Grid& grid, const bool plain)
+{
+    const std::string lineEnd = plain ? "\n" : "\r\n";
+    const std::string continuation = " \\" + lineEnd;
+    const size_t rowSize = grid.size + 1;
+
+    std::ostringstream data;
+    data << "# equivalence test" << lineEnd;
+    size_t nbLines = 0;
+    const auto writeVertices = [&](const size_t y) {
+        for (size_t x = 0; x < rowSize; ++x)
+        {
+            const auto& v = grid.vertices[y * rowSize + x];
+            data << "v " << v.x << " " << v.y;
+            data << (!plain && ++nbLines % 11 == 0 ? continuation : " ");
+            data << v.z << lineEnd;
+        }
+    };
+
+    writeVertices(0);
+    for (size_t y = 0; y < grid.size; ++y)
+    {
+        writeVertices(y + 1);
+        if (y % ROWS_PER_GROUP == 0)
+        {
+            const auto group = y / ROWS_PER_GROUP;
+            data << "g group" << group << lineEnd;
+            data << "usemtl " << getMaterialName(group % NB_MATERIALS)
+                 << lineEnd;
+        }
+        const int64_t nbVertices = (y + 2) * rowSize;
+        for (size_t i = 2 * y * grid.size; i < 2 * (y + 1) * grid.size; ++i)
+        {
+            data << "f";
+            for (size_t k = 0; k < 3; ++k)
+            {
+                const int64_t index = grid.triangles[i][k];
+                data << " " << (plain ? index + 1 : index - nbVertices);
+                if (!plain && k == 1 && ++nbLines % 7 == 0)
+                    data << continuation;
+            }
+            data << lineEnd;
+        }
+    }
+
+    const auto text = data.str();
+    return {"obj", "grid.obj", {text.begin(), text.end()}};
+}
+
+using Triangle = std::array<float, 9>;
+
+// Triangles of each material, as the positions of their corners. Assimp gives
+// every corner its own vertex and may reorder the meshes of a material, so
+// the triangles are sorted.
+std::map<std::string, std::vector<Triangle>> getTriangles(
+    const brayns::Model& model)
+{
+    std::map<std::string, std::vector<Triangle>> triangles;
+    for (const auto& i : model.getTriangleMeshes())
+    {
+        const auto& mesh = i.second;
+        if (mesh.indices.empty())
+            continue;
+        auto& list = triangles[model.getMaterial(i.first)->getName()];
+        for (const auto& indices : mesh.indices)
+        {
+            Triangle triangle;
+            for (size_t k = 0; k < 3; ++k)
+            {
+                REQUIRE_LT(indices[k], mesh.vertices.size());
+                const auto& vertex = mesh.vertices[indices[k]];
+                for (size_t c = 0; c < 3; ++c)
+                    triangle[3 * k + c] = vertex[c];
+            }
+            list.push_back(triangle);
+        }
+    }
+    for (auto& i : triangles)
+        std::sort(i.second.begin(), i.second.end());
+    return triangles;
+}
+
+std::map<std::string, std::vector<Triangle>> getExpectedTriangles(
+    const Grid& grid)
+{
+    std::map<std::string, std::vector<Triangle>> triangles;
+    for (size_t i = 0; i < grid.triangles.size(); ++i)
+    {
+        Triangle triangle;
+        for (size_t k = 0; k < 3; ++k)
+            for (size_t c = 0; c < 3; ++c)
+                triangle[3 * k + c] = grid.vertices[grid.triangles[i][k]][c];
+        triangles[getMaterialName(grid.materials[i])].push_back(triangle);
+    }
+    for (auto& i : triangles)
+        std::sort(i.second.begin(), i.second.end());
+    return triangles;
+}
+
+std::map<std::string, std::vector<Triangle>> load(brayns::Scene& scene,
+                                                  brayns::Blob&& blob)
+{
+    brayns::PropertyMap properties;
+    properties.add({"geometryQuality", std::string("low")});
+
+    brayns::MeshLoader loader(scene);
+    const auto models = loader.importFromBlob(std::move(blob), {}, properties);
+    REQUIRE_EQ(models.size(), 1u);
+    return getTriangles(models[0]->getModel());
+}
+
+void checkEquivalence(const size_t gridSize, const size_t minFileSize)
+{
+    const char* argv[] = {"objLoader"};
+    brayns::Brayns brayns(1, argv);
+    auto& scene = brayns.getEngine().getScene();
+    const auto grid = createGrid(gridSize);
+
+    auto plainBlob = createBlob(grid, true);
+    auto blob = createBlob(grid, false);
+    CHECK_GE(plainBlob.data.size(), minFileSize);
+    CHECK_GE(blob.data.size(), minFileSize);
+
+    const auto expected = getExpectedTriangles(grid);
+    REQUIRE_EQ(expected.size(), NB_MATERIALS);
+    CHECK(load(scene, std::move(plainBlob)) == expected);
+    CHECK(load(scene, std::move(blob)) == expected);
+}
+} // namespace
+
+TEST_CASE("obj_parsing_in_one_chunk")
+{
+    checkEquivalence(48, 0);
+}
+
+// Files are split in chunks of at least 1 MB
+TEST_CASE("obj_parsing_in_several_chunks")
+{
+    checkEquivalence(256, 2 << 20);
+}
@@ -0,0 +1,188 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/common/Timer.h>
+#include <brayns/common/utils/filesystem.h>
+#include <brayns/common/utils/imageUtils.h>
+
+#include <plugins/CircuitExplorer/plugin/io/FrameExporter.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../doctest.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+constexpr unsigned width = 1920;
+constexpr unsigned height = 1080;
+constexpr size_t nbFrames = 48;
+
+// Gradient with some noise so that the encoders have work to do
+brayns::freeimage::ImagePtr createFrameBuffer(const size_t frame)
+{
+    brayns::freeimage::ImagePtr image(FreeImage_Allocate(width, height, 32));
+    uint32_t seed = uint32_t(frame) * 2654435761u;
+    for (unsigned y = 0; y < height; ++y)
+    {
+        auto pixel = FreeImage_GetScanLine(image.get(), y);
+        for (unsigned x = 0; x < width; ++x, pixel += 4)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            const auto noise = BYTE(seed >> 28);
+            pixel[FI_RGBA_RED] = BYTE(x * 255 / width) ^ noise;
+            pixel[FI_RGBA_GREEN] = BYTE(y * 255 / height) ^ noise;
+            pixel[FI_RGBA_BLUE] = BYTE(frame * 8 + x / 16);
+            pixel[FI_RGBA_ALPHA] = 255;
+        }
+    }
+    return image;
+}
+
+std::string getFilename(const fs::path& folder, const size_t frame,
+                        const std::string& extension)
+{
+    return (folder / (std::to_string(frame) + "." + extension)).string();
+}
+
+// What the render loop did before the frames were handed to a pool
+void exportFrame(brayns::freeimage::ImagePtr image,
+                 const FREE_IMAGE_FORMAT format, const int flags,
+                 const std::string& filename)
+{
+    if (format == FIF_JPEG)
+        image.reset(FreeImage_ConvertTo24Bits(image.get()));
+
+    brayns::freeimage::MemoryPtr memory(FreeImage_OpenMemory());
+    FreeImage_SaveToMemory(format, image.get(), memory.get(), flags);
+
+    BYTE* pixels = nullptr;
+    DWORD numPixels = 0;
+    FreeImage_AcquireMemory(memory.get(), &pixels, &numPixels);
+
+    std::ofstream file(filename, std::ios_base::binary);
+    file.write((char*)pixels, numPixels);
+}
+
+std::string readFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios_base::binary);
+    return {std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>()};
+}
+
+// Lossy encoders may legitimately differ in their output bytes, so JPEG files
+// are compared on their decoded pixels
+bool sameContent(const std::string& filename, const std::string& reference,
+                 const FREE_IMAGE_FORMAT format)
+{
+    if (format != FIF_JPEG)
+        return readFile(filename) == readFile(reference);
+
+    brayns::freeimage::ImagePtr image(
+        FreeImage_Load(format, filename.c_str()));
+    brayns::freeimage::ImagePtr expected(
+        FreeImage_Load(format, reference.c_str()));
+    if (!image || !expected ||
+        FreeImage_GetWidth(image.get()) != FreeImage_GetWidth(expected.get()) ||
+        FreeImage_GetHeight(image.get()) !=
+            FreeImage_GetHeight(expected.get()) ||
+        FreeImage_GetBPP(image.get()) != FreeImage_GetBPP(expected.get()))
+        return false;
+
+    const auto lineSize = FreeImage_GetLine(image.get());
+    for (unsigned y = 0; y < FreeImage_GetHeight(image.get()); ++y)
+        if (!std::equal(FreeImage_GetScanLine(image.get(), y),
+                        FreeImage_GetScanLine(image.get(), y) + lineSize,
+                        FreeImage_GetScanLine(expected.get(), y)))
+            return false;
+    return true;
+}
+
+void compareExports(const FREE_IMAGE_FORMAT format, const int flags,
+                    const std::string& extension)
+{
+    std::vector<brayns::freeimage::ImagePtr> frameBuffers;
+    for (size_t i = 0; i < 4; ++i)
+        frameBuffers.push_back(createFrameBuffer(i));
+
+    const auto folder = fs::temp_directory_path() / "brayns_frameExport";
+    const auto serialFolder = folder / "serial";
+    const auto pooledFolder = folder / "pooled";
+    fs::create_directories(serialFolder);
+    fs::create_directories(pooledFolder);
+
+    // The frame buffer is copied in both cases, as the renderer reuses it
+    brayns::Timer timer;
+    timer.start();
+    for (size_t i = 0; i < nbFrames; ++i)
+    {
+        const auto& frameBuffer = frameBuffers[i % frameBuffers.size()];
+        exportFrame(brayns::freeimage::ImagePtr(
+                        FreeImage_Clone(frameBuffer.get())),
+                    format, flags, getFilename(serialFolder, i, extension));
+    }
+    timer.stop();
+    const auto serial = timer.milliseconds();
+
+    FrameExportStatistics statistics;
+    timer.start();
+    {
+        FrameExporter exporter;
+        for (size_t i = 0; i < nbFrames; ++i)
+        {
+            const auto& frameBuffer = frameBuffers[i % frameBuffers.size()];
+            exporter.push(brayns::freeimage::ImagePtr(
+                              FreeImage_Clone(frameBuffer.get())),
+                          format, flags,
+                          getFilename(pooledFolder, i, extension));
+        }
+        exporter.wait();
+        statistics = exporter.getStatistics();
+    }
+    timer.stop();
+    const auto pooled = timer.milliseconds();
+
+    MESSAGE(nbFrames << " " << extension << " frames of " << width << "x"
+                     << height << ": serial " << serial << "ms, pooled "
+                     << pooled << "ms");
+    CHECK_EQ(statistics.written, nbFrames);
+    CHECK_EQ(statistics.failed, 0);
+
+    size_t identicalFrames = 0;
+    for (size_t i = 0; i < nbFrames; ++i)
+        if (sameContent(getFilename(pooledFolder, i, extension),
+                        getFilename(serialFolder, i, extension), format))
+            ++identicalFrames;
+    CHECK_EQ(identicalFrames, nbFrames);
+    fs::remove_all(folder);
+}
+} // namespace
+
+TEST_CASE("png_frames")
+{
+    compareExports(FIF_PNG, PNG_DEFAULT, "png");
+}
+
+TEST_CASE("jpeg_frames")
+{
+    compareExports(FIF_JPEG, JPEG_QUALITYGOOD, "jpg");
+}
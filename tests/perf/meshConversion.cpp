@@ -0,0 +1,131 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/Timer.h>
+#include <brayns/common/geometry/TriangleMesh.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+#include <brayns/io/MeshLoader.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../doctest.h"
+
+#include <sstream>
+
+namespace
+{
+// Grids of size x size quads, each one being an OBJ object
+brayns::Blob createGrids(const size_t nbGrids, const size_t size)
+{
+    std::ostringstream obj;
+    size_t firstVertex = 1;
+    for (size_t g = 0; g < nbGrids; ++g)
+    {
+        obj << "o grid" << g << "\n";
+        for (size_t y = 0; y <= size; ++y)
+            for (size_t x = 0; x <= size; ++x)
+                obj << "v " << x << " " << y << " " << g << "\n";
+        for (size_t y = 0; y < size; ++y)
+            for (size_t x = 0; x < size; ++x)
+            {
+                const auto v = firstVertex + y * (size + 1) + x;
+                obj << "f " << v << " " << v + 1 << " " << v + size + 2 << " "
+                    << v + size + 1 << "\n";
+            }
+        firstVertex += (size + 1) * (size + 1);
+    }
+
+    const auto text = obj.str();
+    return {"obj", "grids.obj", {text.begin(), text.end()}};
+}
+
+struct ConversionResult
+{
+    size_t nbVertices{0};
+    size_t nbTriangles{0};
+    bool validIndices{true};
+};
+
+// Loads the blob and reports the time spent after assimp is done
+ConversionResult convert(brayns::Scene& scene, brayns::Blob&& blob,
+                         const std::string& name)
+{
+    brayns::Timer timer;
+    bool postProcessing = false;
+    const brayns::LoaderProgress progress(
+        [&](const std::string& message, const float) {
+            if (!postProcessing && message == "Post-processing...")
+            {
+                postProcessing = true;
+                timer.start();
+            }
+        });
+
+    brayns::MeshLoader loader(scene);
+    const auto models = loader.importFromBlob(std::move(blob), progress, {});
+    timer.stop();
+    MESSAGE(name << ": post-processing took " << timer.milliseconds()
+                 << "ms");
+
+    ConversionResult result;
+    const auto& model = models.front()->getModel();
+    for (const auto& entry : model.getTriangleMeshes())
+    {
+        const auto& mesh = entry.second;
+        result.nbVertices += mesh.vertices.size();
+        result.nbTriangles += mesh.indices.size();
+        for (const auto& triangle : mesh.indices)
+            for (size_t i = 0; i < 3; ++i)
+                if (triangle[i] >= mesh.vertices.size())
+                    result.validIndices = false;
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("single_large_mesh")
+{
+    const char* argv[] = {"meshConversion"};
+    brayns::Brayns brayns(1, argv);
+
+    constexpr size_t size = 1024;
+    const auto result = convert(brayns.getEngine().getScene(),
+                                createGrids(1, size), "1 mesh of 2M triangles");
+    CHECK_EQ(result.nbTriangles, 2 * size * size);
+    CHECK_GE(result.nbVertices, (size + 1) * (size + 1));
+    CHECK(result.validIndices);
+}
+
+TEST_CASE("many_small_meshes")
+{
+    const char* argv[] = {"meshConversion"};
+    brayns::Brayns brayns(1, argv);
+
+    constexpr size_t nbGrids = 20000;
+    constexpr size_t size = 8;
+    const auto result =
+        convert(brayns.getEngine().getScene(), createGrids(nbGrids, size),
+                "20000 meshes of 128 triangles");
+    CHECK_EQ(result.nbTriangles, nbGrids * 2 * size * size);
+    CHECK_GE(result.nbVertices, nbGrids * (size + 1) * (size + 1));
+    CHECK(result.validIndices);
+}
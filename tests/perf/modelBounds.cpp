@@ -0,0 +1,97 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/Timer.h>
+#include <brayns/common/geometry/Sphere.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../doctest.h"
+
+namespace
+{
+constexpr size_t nbSpheres = 1 << 22;
+constexpr size_t nbAppends = 10;
+
+brayns::ModelPtr createSphereModel(brayns::Scene& scene)
+{
+    auto model = scene.createModel();
+    model->createMaterial(0, "spheres");
+    auto& spheres = model->getSpheres()[0];
+    spheres.reserve(nbSpheres + nbAppends);
+    for (size_t i = 0; i < nbSpheres; ++i)
+        spheres.push_back({{float(i % 1024), float(i / 1024), 0.f}, 0.5f});
+    model->updateBounds();
+    return model;
+}
+} // namespace
+
+TEST_CASE("single_sphere_append_does_not_rescan_model")
+{
+    const char* argv[] = {"modelBounds"};
+    brayns::Brayns brayns(1, argv);
+    auto model = createSphereModel(brayns.getEngine().getScene());
+
+    // Full scan, like any update of the bounds before they were cached
+    brayns::Timer timer;
+    timer.start();
+    for (size_t i = 0; i < nbAppends; ++i)
+    {
+        model->getSpheres();
+        model->updateBounds();
+    }
+    timer.stop();
+    const auto fullScan = timer.milliseconds();
+
+    timer.start();
+    for (size_t i = 0; i < nbAppends; ++i)
+    {
+        model->addSphere(0, {{0.f, 0.f, float(i + 1)}, 0.5f});
+        model->updateBounds();
+    }
+    timer.stop();
+    const auto append = timer.milliseconds();
+
+    MESSAGE("Full scan: " << fullScan << "ms, append: " << append << "ms for "
+                          << nbAppends << " updates of " << nbSpheres
+                          << " spheres");
+
+    const auto& bounds = model->getBounds();
+    CHECK_EQ(bounds.getMin(), brayns::Vector3d(-0.5, -0.5, -0.5));
+    CHECK_EQ(bounds.getMax(),
+             brayns::Vector3d(1023.5, nbSpheres / 1024 - 0.5, nbAppends + 0.5));
+    CHECK_LT(append, fullScan);
+}
+
+TEST_CASE("invalidated_bounds_are_recomputed")
+{
+    const char* argv[] = {"modelBounds"};
+    brayns::Brayns brayns(1, argv);
+    auto model = createSphereModel(brayns.getEngine().getScene());
+
+    model->getSpheres()[0].resize(1);
+    model->updateBounds();
+    const auto& bounds = model->getBounds();
+    CHECK_EQ(bounds.getMin(), brayns::Vector3d(-0.5, -0.5, -0.5));
+    CHECK_EQ(bounds.getMax(), brayns::Vector3d(0.5, 0.5, 0.5));
+}
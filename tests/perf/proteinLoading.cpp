@@ -0,0 +1,130 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/Timer.h>
+#include <brayns/common/utils/filesystem.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+#include <brayns/io/ProteinLoader.h>
+#include <brayns/parameters/ParametersManager.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../doctest.h"
+
+#include <async++.h>
+
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+const char* elements[] = {"C", "N", "O", "S", "P", "H"};
+constexpr size_t nbElements = sizeof(elements) / sizeof(elements[0]);
+
+// ATOM records on a grid, cycling through the elements and chains
+std::string createPDB(const size_t nbAtoms)
+{
+    std::string pdb;
+    pdb.reserve(nbAtoms * 81);
+    char line[128];
+    for (size_t i = 0; i < nbAtoms; ++i)
+    {
+        std::snprintf(line, sizeof(line),
+                      "ATOM  %5zu  CA  ALA %c%4zu    %8.3f%8.3f%8.3f  1.00  "
+                      "0.00          %2s  \n",
+                      i % 100000, char('A' + i % 4), i % 10000,
+                      float(i % 100), float(i / 100 % 100),
+                      float(i / 10000) * 0.5f, elements[i % nbElements]);
+        pdb += line;
+    }
+    return pdb;
+}
+
+size_t countSpheres(const brayns::Model& model)
+{
+    size_t nbSpheres = 0;
+    for (const auto& spheres : model.getSpheres())
+        nbSpheres += spheres.second.size();
+    return nbSpheres;
+}
+} // namespace
+
+TEST_CASE("million_atom_file")
+{
+    const char* argv[] = {"proteinLoading"};
+    brayns::Brayns brayns(1, argv);
+
+    constexpr size_t nbAtoms = 1000000;
+    const auto path =
+        (fs::temp_directory_path() / "brayns_proteinLoading.pdb").string();
+    {
+        std::ofstream file(path);
+        file << createPDB(nbAtoms);
+    }
+
+    brayns::ProteinLoader loader(
+        brayns.getEngine().getScene(),
+        brayns.getParametersManager().getGeometryParameters());
+    brayns::Timer timer;
+    timer.start();
+    const auto models = loader.importFromFile(path, {}, {});
+    timer.stop();
+    fs::remove(path);
+    MESSAGE("1M atoms: loading took " << timer.milliseconds() << "ms");
+
+    REQUIRE_EQ(models.size(), 1);
+    const auto& model = models.front()->getModel();
+    CHECK_EQ(countSpheres(model), nbAtoms);
+    CHECK_EQ(model.getSpheres().size(), nbElements);
+}
+
+TEST_CASE("many_small_files_concurrently")
+{
+    const char* argv[] = {"proteinLoading"};
+    brayns::Brayns brayns(1, argv);
+
+    constexpr size_t nbFiles = 2000;
+    constexpr size_t nbAtoms = 500;
+    const auto pdb = createPDB(nbAtoms);
+
+    brayns::ProteinLoader loader(
+        brayns.getEngine().getScene(),
+        brayns.getParametersManager().getGeometryParameters());
+    std::vector<brayns::ModelDescriptorPtr> models(nbFiles);
+    brayns::Timer timer;
+    timer.start();
+    async::parallel_for(async::irange(size_t(0), nbFiles),
+                        [&](const size_t i) {
+                            brayns::Blob blob{"pdb",
+                                              std::to_string(i) + ".pdb",
+                                              {pdb.begin(), pdb.end()}};
+                            models[i] = loader.importFromBlob(std::move(blob),
+                                                              {}, {})
+                                            .front();
+                        });
+    timer.stop();
+    MESSAGE(nbFiles << " files of " << nbAtoms << " atoms: loading took "
+                    << timer.milliseconds() << "ms");
+
+    for (const auto& model : models)
+        CHECK_EQ(countSpheres(model->getModel()), nbAtoms);
+}
@@ -0,0 +1,172 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/Timer.h>
+#include <brayns/common/simulation/AbstractSimulationHandler.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+#include <brayns/parameters/ParametersManager.h>
+
+#include <engines/ospray/OSPRayScene.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../doctest.h"
+
+namespace
+{
+constexpr uint64_t frameSize = 1 << 24;
+constexpr uint32_t nbFrames = 100;
+
+class TestSimulationHandler : public brayns::AbstractSimulationHandler
+{
+public:
+    TestSimulationHandler()
+    {
+        _frameSize = frameSize;
+        _nbFrames = nbFrames;
+        _dt = 1.;
+        _endTime = nbFrames;
+        _frameData.resize(_frameSize);
+    }
+
+    brayns::AbstractSimulationHandlerPtr clone() const final
+    {
+        return std::make_shared<TestSimulationHandler>(*this);
+    }
+
+    void* getFrameDataImpl(const uint32_t frame) final
+    {
+        if (_currentFrame != frame)
+        {
+            std::fill(_frameData.begin(), _frameData.end(), float(frame));
+            _currentFrame = frame;
+        }
+        return _frameData.data();
+    }
+};
+
+brayns::ModelDescriptorPtr addSimulationModel(brayns::Scene& scene)
+{
+    auto model = scene.createModel();
+    model->createMaterial(0, "sphere");
+    model->addSphere(0, {{0.f, 0.f, 0.f}, 1.f});
+    model->setSimulationHandler(std::make_shared<TestSimulationHandler>());
+    auto descriptor =
+        std::make_shared<brayns::ModelDescriptor>(std::move(model),
+                                                  "simulation");
+    scene.addModel(descriptor);
+    return descriptor;
+}
+
+brayns::OSPRayScene& getScene(brayns::Brayns& brayns)
+{
+    return static_cast<brayns::OSPRayScene&>(brayns.getEngine().getScene());
+}
+
+// Frame data of a model, as currently provided by its handler
+const float* getFrameData(brayns::Brayns& brayns,
+                          const brayns::ModelDescriptor& descriptor)
+{
+    const auto frame =
+        brayns.getParametersManager().getAnimationParameters().getFrame();
+    auto handler = descriptor.getModel().getSimulationHandler();
+    return static_cast<const float*>(handler->getFrameData(frame));
+}
+
+struct Uploads
+{
+    size_t commits{0};
+    uint64_t bytesCopied{0};
+};
+
+Uploads commitFrames(brayns::Brayns& brayns, const size_t numCommits,
+                     const bool playing)
+{
+    auto& animationParameters =
+        brayns.getParametersManager().getAnimationParameters();
+    auto& scene = getScene(brayns);
+
+    const auto uploads = scene.getSimulationUploads();
+    const auto bytesCopied = scene.getSimulationBytesCopied();
+    brayns::Timer timer;
+    timer.start();
+    for (size_t i = 0; i < numCommits; ++i)
+    {
+        if (playing)
+            animationParameters.setFrame(animationParameters.getFrame() + 1);
+        brayns.commit();
+    }
+    timer.stop();
+    MESSAGE((playing ? "Playing: " : "Paused: ") << timer.milliseconds()
+                                                 << "ms for " << numCommits
+                                                 << " commits");
+    return {scene.getSimulationUploads() - uploads,
+            scene.getSimulationBytesCopied() - bytesCopied};
+}
+} // namespace
+
+TEST_CASE("single_simulation_is_shared_with_ospray")
+{
+    const char* argv[] = {"simulationUpload"};
+    brayns::Brayns brayns(1, argv);
+    const auto descriptor = addSimulationModel(brayns.getEngine().getScene());
+    brayns.commit();
+
+    constexpr size_t numCommits = 10;
+    const auto playing = commitFrames(brayns, numCommits, true);
+    CHECK_EQ(playing.commits, numCommits);
+    CHECK_EQ(playing.bytesCopied, 0);
+    CHECK_EQ(getScene(brayns).getSimulationData(),
+             getFrameData(brayns, *descriptor));
+
+    const auto paused = commitFrames(brayns, numCommits, false);
+    CHECK_EQ(paused.commits, 0);
+    CHECK_EQ(paused.bytesCopied, 0);
+}
+
+TEST_CASE("simulations_share_one_buffer_uploaded_once_per_frame")
+{
+    const char* argv[] = {"simulationUpload"};
+    brayns::Brayns brayns(1, argv);
+    auto& scene = brayns.getEngine().getScene();
+    const auto first = addSimulationModel(scene);
+    const auto second = addSimulationModel(scene);
+    brayns.commit();
+    const auto data = getScene(brayns).getSimulationData();
+    REQUIRE(data);
+
+    constexpr size_t numCommits = 10;
+    const auto playing = commitFrames(brayns, numCommits, true);
+    CHECK_EQ(playing.commits, numCommits);
+    CHECK_EQ(playing.bytesCopied, numCommits * 2 * frameSize * sizeof(float));
+
+    // Both models read the current frame from the same buffer, which is
+    // updated in place
+    CHECK_EQ(getScene(brayns).getSimulationData(), data);
+    CHECK_NE(data, getFrameData(brayns, *first));
+    CHECK_EQ(data[0], *getFrameData(brayns, *first));
+    CHECK_EQ(data[frameSize], *getFrameData(brayns, *second));
+
+    const auto paused = commitFrames(brayns, numCommits, false);
+    CHECK_EQ(paused.commits, 0);
+    CHECK_EQ(paused.bytesCopied, 0);
+}
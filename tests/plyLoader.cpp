@@ -0,0 +1,235 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/geometry/TriangleMesh.h>
+#include <brayns/common/propertymap/PropertyMap.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+#include <brayns/io/MeshLoader.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <iterator>
+#include <sstream>
+
+namespace
+{
+constexpr size_t GRID_SIZE = 64;
+
+// Grid of GRID_SIZE x GRID_SIZE quads split in triangles, coordinates and
+// colors are exactly represented in the ASCII format
+struct Grid
+{
+    std::vector<brayns::Vector3f> vertices;
+    std::vector<brayns::Vector3f> normals;
+    std::vector<uint8_t> colors;
+    std::vector<brayns::Vector3ui> triangles;
+};
+
+Grid createGrid()
+{
+    Grid grid;
+    for (size_t y = 0; y <= GRID_SIZE; ++y)
+        for (size_t x = 0; x <= GRID_SIZE; ++x)
+        {
+            grid.vertices.push_back({x / 8.f, y / 4.f, ((x * y) % 5) / 2.f});
+            grid.normals.push_back({0.f, (x % 2) * 0.5f, 1.f});
+            const size_t color[] = {x % 256, y % 256, (x + y) % 256, 128};
+            grid.colors.insert(grid.colors.end(), std::begin(color),
+                               std::end(color));
+        }
+    for (size_t y = 0; y < GRID_SIZE; ++y)
+        for (size_t x = 0; x < GRID_SIZE; ++x)
+        {
+            const auto v = y * (GRID_SIZE + 1) + x;
+            grid.triangles.emplace_back(v, v + 1, v + GRID_SIZE + 2);
+            grid.triangles.emplace_back(v, v + GRID_SIZE + 2,
+                                        v + GRID_SIZE + 1);
+        }
+    return grid;
+}
+
+std::string createHeader(const Grid& grid, const std::string& format,
+                         const bool withNormals)
+{
+    std::ostringstream header;
+    header << "ply\nformat " << format << " 1.0\ncomment parity test\n"
+           << "element vertex " << grid.vertices.size() << "\n"
+           << "property float x\nproperty float y\nproperty float z\n";
+    if (withNormals)
+        header << "property float nx\nproperty float ny\nproperty float nz\n";
+    header << "property uchar red\nproperty uchar green\n"
+           << "property uchar blue\nproperty uchar alpha\n"
+           << "element face " << grid.triangles.size() << "\n"
+           << "property list uchar int vertex_indices\nend_header\n";
+    return header.str();
+}
+
+template <typename T>
+void append(std::string& data, const T value)
+{
+    data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+brayns::Blob createBinaryBlob(const Grid& grid, const bool withNormals)
+{
+    auto data = createHeader(grid, "binary_little_endian", withNormals);
+    for (size_t i = 0; i < grid.vertices.size(); ++i)
+    {
+        for (size_t k = 0; k < 3; ++k)
+            append(data, grid.vertices[i][k]);
+        if (withNormals)
+            for (size_t k = 0; k < 3; ++k)
+                append(data, grid.normals[i][k]);
+        for (size_t k = 0; k < 4; ++k)
+            append(data, grid.colors[4 * i + k]);
+    }
+    for (const auto& triangle : grid.triangles)
+    {
+        append(data, uint8_t(3));
+        for (size_t k = 0; k < 3; ++k)
+            append(data, int32_t(triangle[k]));
+    }
+    return {"ply", "grid.ply", {data.begin(), data.end()}};
+}
+
+// ASCII files are always loaded by assimp
+brayns::Blob createAsciiBlob(const Grid& grid, const bool withNormals)
+{
+    std::ostringstream data;
+    data << createHeader(grid, "ascii", withNormals);
+    for (size_t i = 0; i < grid.vertices.size(); ++i)
+    {
+        const auto& v = grid.vertices[i];
+        data << v.x << " " << v.y << " " << v.z;
+        if (withNormals)
+        {
+            const auto& n = grid.normals[i];
+            data << " " << n.x << " " << n.y << " " << n.z;
+        }
+        for (size_t k = 0; k < 4; ++k)
+            data << " " << int(grid.colors[4 * i + k]);
+        data << "\n";
+    }
+    for (const auto& triangle : grid.triangles)
+        data << "3 " << triangle.x << " " << triangle.y << " " << triangle.z
+             << "\n";
+    const auto text = data.str();
+    return {"ply", "grid.ply", {text.begin(), text.end()}};
+}
+
+brayns::TriangleMesh load(brayns::Scene& scene, brayns::Blob&& blob,
+                          const std::string& quality)
+{
+    brayns::PropertyMap properties;
+    properties.add({"geometryQuality", quality});
+
+    brayns::MeshLoader loader(scene);
+    const auto models = loader.importFromBlob(std::move(blob), {}, properties);
+    REQUIRE_EQ(models.size(), 1u);
+    const auto& meshes = models[0]->getModel().getTriangleMeshes();
+    REQUIRE_EQ(meshes.size(), 1u);
+    return meshes.begin()->second;
+}
+
+// Assimp gives every triangle corner its own vertex, compare the attributes
+// of the corners
+void checkParity(const brayns::TriangleMesh& mesh,
+                 const brayns::TriangleMesh& reference)
+{
+    REQUIRE_EQ(mesh.indices.size(), reference.indices.size());
+    REQUIRE_EQ(mesh.normals.empty(), reference.normals.empty());
+    REQUIRE_EQ(mesh.colors.empty(), reference.colors.empty());
+    CHECK_LT(mesh.vertices.size(), reference.vertices.size());
+
+    for (size_t i = 0; i < mesh.indices.size(); ++i)
+        for (size_t k = 0; k < 3; ++k)
+        {
+            const auto i1 = mesh.indices[i][k];
+            const auto i2 = reference.indices[i][k];
+            REQUIRE_LT(i1, mesh.vertices.size());
+            REQUIRE_EQ(mesh.vertices[i1], reference.vertices[i2]);
+            if (!mesh.colors.empty())
+                REQUIRE_EQ(mesh.colors[i1], reference.colors[i2]);
+            if (!mesh.normals.empty())
+                REQUIRE_LT(glm::distance(mesh.normals[i1],
+                                         reference.normals[i2]),
+                           1e-5f);
+        }
+}
+} // namespace
+
+TEST_CASE("binary_ply_matches_assimp_without_normals")
+{
+    const char* argv[] = {"plyLoader"};
+    brayns::Brayns brayns(1, argv);
+    auto& scene = brayns.getEngine().getScene();
+    const auto grid = createGrid();
+
+    for (const std::string quality : {"low", "high"})
+    {
+        const auto mesh = load(scene, createBinaryBlob(grid, false), quality);
+        const auto reference =
+            load(scene, createAsciiBlob(grid, false), quality);
+        CHECK_EQ(mesh.vertices.size(), grid.vertices.size());
+        CHECK_EQ(mesh.normals.empty(), quality == "low");
+        checkParity(mesh, reference);
+    }
+}
+
+TEST_CASE("binary_ply_matches_assimp_with_normals")
+{
+    const char* argv[] = {"plyLoader"};
+    brayns::Brayns brayns(1, argv);
+    auto& scene = brayns.getEngine().getScene();
+    const auto grid = createGrid();
+
+    const auto mesh = load(scene, createBinaryBlob(grid, true), "high");
+    const auto reference = load(scene, createAsciiBlob(grid, true), "high");
+    CHECK_EQ(mesh.normals[1], grid.normals[1]);
+    checkParity(mesh, reference);
+}
+
+TEST_CASE("binary_ply_with_polygons_falls_back_to_assimp")
+{
+    const char* argv[] = {"plyLoader"};
+    brayns::Brayns brayns(1, argv);
+
+    std::string data =
+        "ply\nformat binary_little_endian 1.0\nelement vertex 4\n"
+        "property float x\nproperty float y\nproperty float z\n"
+        "element face 1\nproperty list uchar int vertex_indices\n"
+        "end_header\n";
+    for (const auto& v : {brayns::Vector3f(0.f, 0.f, 0.f), {1.f, 0.f, 0.f},
+                          {1.f, 1.f, 0.f}, {0.f, 1.f, 0.f}})
+        for (size_t k = 0; k < 3; ++k)
+            append(data, v[k]);
+    append(data, uint8_t(4));
+    for (const int32_t index : {0, 1, 2, 3})
+        append(data, index);
+
+    const auto mesh = load(brayns.getEngine().getScene(),
+                           {"ply", "quad.ply", {data.begin(), data.end()}},
+                           "low");
+    CHECK_EQ(mesh.indices.size(), 2u);
+}
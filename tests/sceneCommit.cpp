@@ -0,0 +1,137 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+
+#include <engines/ospray/OSPRayModel.h>
+#include <engines/ospray/OSPRayScene.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+namespace
+{
+size_t addSphereModel(brayns::Scene& scene, const brayns::Vector3f& center)
+{
+    auto model = scene.createModel();
+    model->createMaterial(0, "sphere");
+    model->addSphere(0, {center, 0.5f});
+    return scene.addModel(
+        std::make_shared<brayns::ModelDescriptor>(std::move(model), "sphere"));
+}
+} // namespace
+
+TEST_CASE("incremental_instance_updates")
+{
+    const char* argv[] = {"sceneCommit"};
+    brayns::Brayns brayns(1, argv);
+    auto& scene = brayns.getEngine().getScene();
+    auto& ospScene = dynamic_cast<brayns::OSPRayScene&>(scene);
+
+    constexpr size_t numModels = 100;
+    std::vector<size_t> modelIDs;
+    for (size_t i = 0; i < numModels; ++i)
+        modelIDs.push_back(addSphereModel(scene, {float(i), 0.f, 0.f}));
+    brayns.commit();
+
+    // Nothing changed, nothing is re-added
+    auto numInstances = ospScene.getNumInstancesAdded();
+    scene.markModified();
+    brayns.commit();
+    CHECK_EQ(ospScene.getNumInstancesAdded(), numInstances);
+
+    // Moving one model only re-adds its instance
+    auto modelDescriptor = scene.getModel(modelIDs[numModels / 2]);
+    auto transformation = modelDescriptor->getTransformation();
+    transformation.setTranslation({0., 1., 0.});
+    modelDescriptor->setTransformation(transformation);
+    scene.markModified();
+    brayns.commit();
+    CHECK_EQ(ospScene.getNumInstancesAdded(), numInstances + 1);
+
+    // Hiding one model does not re-add any instance
+    numInstances = ospScene.getNumInstancesAdded();
+    modelDescriptor->setVisible(false);
+    scene.markModified();
+    brayns.commit();
+    CHECK_EQ(ospScene.getNumInstancesAdded(), numInstances);
+
+    // Showing it again re-adds its instance only
+    modelDescriptor->setVisible(true);
+    scene.markModified();
+    brayns.commit();
+    CHECK_EQ(ospScene.getNumInstancesAdded(), numInstances + 1);
+
+    // Adding a model only adds its instance
+    numInstances = ospScene.getNumInstancesAdded();
+    addSphereModel(scene, {0.f, 2.f, 0.f});
+    brayns.commit();
+    CHECK_EQ(ospScene.getNumInstancesAdded(), numInstances + 1);
+
+    // Removing a model does not re-add any instance
+    numInstances = ospScene.getNumInstancesAdded();
+    scene.removeModel(modelIDs.front());
+    brayns.commit();
+    CHECK_EQ(ospScene.getNumInstancesAdded(), numInstances);
+}
+
+TEST_CASE("incremental_geometry_updates")
+{
+    const char* argv[] = {"sceneCommit"};
+    brayns::Brayns brayns(1, argv);
+    auto& scene = brayns.getEngine().getScene();
+
+    constexpr size_t numMaterials = 100;
+    auto model = scene.createModel();
+    for (size_t i = 0; i < numMaterials; ++i)
+    {
+        model->createMaterial(i, "sphere");
+        model->addSphere(i, {{float(i), 0.f, 0.f}, 0.5f});
+    }
+    auto& ospModel = dynamic_cast<brayns::OSPRayModel&>(*model);
+    scene.addModel(
+        std::make_shared<brayns::ModelDescriptor>(std::move(model), "spheres"));
+    brayns.commit();
+
+    // Adding a sphere to one material only recreates the geometry of that
+    // material
+    auto numGeometries = ospModel.getNumGeometriesCreated();
+    ospModel.addSphere(numMaterials / 2, {{0.f, 1.f, 0.f}, 0.5f});
+    scene.markModified();
+    brayns.commit();
+    CHECK_EQ(ospModel.getNumGeometriesCreated(), numGeometries + 1);
+
+    // Nothing changed, nothing is recreated
+    numGeometries = ospModel.getNumGeometriesCreated();
+    scene.markModified();
+    brayns.commit();
+    CHECK_EQ(ospModel.getNumGeometriesCreated(), numGeometries);
+
+    // Editing through the map accessor may touch any material
+    auto& spheres = ospModel.getSpheres();
+    spheres[0].front().radius = 1.f;
+    scene.markModified();
+    brayns.commit();
+    CHECK_EQ(ospModel.getNumGeometriesCreated(),
+             numGeometries + spheres.size());
+}
@@ -20,10 +20,47 @@
  */
 
 #include <brayns/common/geometry/SDFGeometry.h>
+#include <brayns/engine/Model.h>
+#include <brayns/parameters/AnimationParameters.h>
+#include <brayns/parameters/VolumeParameters.h>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
+namespace
+{
+// Only the engine independent geometry storage is tested
+class GeometryModel : public brayns::Model
+{
+public:
+    using brayns::Model::Model;
+
+    void commitGeometry() final {}
+
+    brayns::SharedDataVolumePtr createSharedDataVolume(
+        const brayns::Vector3ui&, const brayns::Vector3f&,
+        const brayns::DataType) const final
+    {
+        return nullptr;
+    }
+
+    brayns::BrickedVolumePtr createBrickedVolume(
+        const brayns::Vector3ui&, const brayns::Vector3f&,
+        const brayns::DataType) const final
+    {
+        return nullptr;
+    }
+
+    void buildBoundingBox() final {}
+
+protected:
+    brayns::MaterialPtr createMaterialImpl(const brayns::PropertyMap&) final
+    {
+        return nullptr;
+    }
+};
+} // namespace
+
 TEST_CASE("bounding_box")
 {
     const auto sphere = brayns::createSDFSphere({1.0f, 1.0f, 1.0f}, 1.0f);
@@ -46,3 +83,58 @@ TEST_CASE("bounding_box")
     CHECK_EQ(boxPill.getMin(), brayns::Vector3d(-2.0, -2.0, -2.0));
     CHECK_EQ(boxPill.getMax(), brayns::Vector3d(3.0, 3.0, 3.0));
 }
+
+TEST_CASE("bulk_sdf_geometries_match_single_sdf_geometries")
+{
+    brayns::AnimationParameters animation;
+    brayns::VolumeParameters volume;
+
+    const auto first = brayns::createSDFSphere({0.f, 0.f, 0.f}, 1.f);
+    const auto second =
+        brayns::createSDFPill({0.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, 0.5f);
+    const auto third =
+        brayns::createSDFPill({0.f, 1.f, 0.f}, {0.f, 2.f, 0.f}, 0.5f);
+
+    GeometryModel single(animation, volume);
+    single.addSDFGeometry(0, first, {});
+    single.addSDFGeometry(0, second, {});
+    single.addSDFGeometry(1, third, {1});
+    single.addSDFGeometry(0, first, {1, 2});
+
+    // Neighbour indices of a batch are relative to its first geometry
+    GeometryModel bulk(animation, volume);
+    bulk.addSDFGeometry(0, first, {});
+    CHECK_EQ(bulk.addSDFGeometries({0, 1, 0}, {second, third, first},
+                                   {0, 0, 1, 3}, {0, 0, 1}),
+             1);
+
+    const auto& expected = single.getSDFGeometryData();
+    const auto& actual = bulk.getSDFGeometryData();
+    CHECK(actual.neighbours == expected.neighbours);
+    CHECK(actual.geometryIndices == expected.geometryIndices);
+    REQUIRE_EQ(actual.geometries.size(), expected.geometries.size());
+    for (size_t i = 0; i < actual.geometries.size(); ++i)
+    {
+        CHECK_EQ(actual.geometries[i].neighboursIndex,
+                 expected.geometries[i].neighboursIndex);
+        CHECK_EQ(actual.geometries[i].numNeighbours,
+                 expected.geometries[i].numNeighbours);
+    }
+    CHECK_EQ(bulk.getMemoryUsage().sdfGeometries,
+             single.getMemoryUsage().sdfGeometries);
+
+    // A longer list does not fit in place and is appended
+    bulk.updateSDFGeometryNeighbours(2, {0, 1, 3});
+    const auto& updated = bulk.getSDFGeometryData();
+    const auto& geometry = updated.geometries[2];
+    CHECK_EQ(geometry.numNeighbours, 3);
+    CHECK_EQ(geometry.neighboursIndex, 3);
+    CHECK(std::vector<uint64_t>(updated.neighbours.begin() + 3,
+                                updated.neighbours.end()) ==
+          std::vector<uint64_t>{0, 1, 3});
+    const auto usage = bulk.getMemoryUsage().sdfGeometries;
+    bulk.getSDFGeometryData();
+    CHECK_EQ(bulk.getMemoryUsage().sdfGeometries, usage);
+
+    CHECK_THROWS(bulk.addSDFGeometries({0}, {first}, {0, 1}, {1}));
+}
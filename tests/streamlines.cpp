@@ -21,6 +21,7 @@
 #include <brayns/Brayns.h>
 #include <tests/paths.h>
 
+#include <brayns/common/geometry/Streamline.h>
 #include <brayns/common/types.h>
 #include <brayns/engine/Camera.h>
 #include <brayns/engine/Engine.h>
@@ -104,3 +105,51 @@ TEST_CASE("streamlines")
     CHECK(compareTestImage("streamlines.png",
                            brayns.getEngine().getFrameBuffer()));
 }
+
+TEST_CASE("bulk_streamlines_match_single_streamlines")
+{
+    const char* argv[] = {"streamlines"};
+    brayns::Brayns brayns(1, argv);
+    auto& scene = brayns.getEngine().getScene();
+
+    const brayns::Vector4f color{1.f, 0.f, 0.f, 1.f};
+    const brayns::Streamline first({{0.f, 0.f, 0.f}, {1.f, 0.f, 0.f},
+                                    {2.f, 0.f, 0.f}},
+                                   {color, color, color}, {1.f, 1.f, 1.f});
+    const brayns::Streamline second({{0.f, 1.f, 0.f}, {0.f, 2.f, 0.f}},
+                                    {color, color}, {0.5f, 0.5f});
+
+    auto single = scene.createModel();
+    single->addStreamline(0, first);
+    single->addStreamline(0, second);
+    single->addStreamline(0, first);
+
+    brayns::StreamlinesData data;
+    for (const auto& streamline : {first, second})
+    {
+        const auto start = int32_t(data.vertex.size());
+        for (size_t i = 0; i < streamline.position.size(); ++i)
+        {
+            if (i + 1 < streamline.position.size())
+                data.indices.push_back(start + int32_t(i));
+            data.vertex.emplace_back(streamline.position[i],
+                                     streamline.radius[i]);
+            data.vertexColor.push_back(streamline.color[i]);
+        }
+    }
+
+    auto bulk = scene.createModel();
+    bulk->addStreamlines(0, data);
+    bulk->addStreamline(0, first);
+
+    const auto& expected = single->getStreamlines().at(0);
+    const auto& actual = bulk->getStreamlines().at(0);
+    CHECK(actual.vertex == expected.vertex);
+    CHECK(actual.vertexColor == expected.vertexColor);
+    CHECK(actual.indices == expected.indices);
+    CHECK_EQ(bulk->getMemoryUsage().streamlines,
+             single->getMemoryUsage().streamlines);
+
+    data.indices.push_back(int32_t(data.vertex.size() - 1));
+    CHECK_THROWS(bulk->addStreamlines(0, data));
+}
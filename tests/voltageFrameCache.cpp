@@ -0,0 +1,154 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <plugins/CircuitExplorer/plugin/io/VoltageFrameCache.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+namespace
+{
+// Frames filled with their index, loaded immediately
+class FakeFrameSource : public VoltageFrameSource
+{
+public:
+    FakeFrameSource(std::vector<uint32_t>& requests, const size_t frameSize)
+        : _requests(&requests)
+        , _frameSize(frameSize)
+    {
+    }
+
+    size_t getFrameSize() const final { return _frameSize; }
+
+    std::future<brion::Frame> loadFrame(const uint32_t frame) final
+    {
+        _requests->push_back(frame);
+        brion::Frame data;
+        data.timestamp = frame;
+        data.data = std::make_shared<brion::floats>(_frameSize, float(frame));
+        std::promise<brion::Frame> promise;
+        promise.set_value(std::move(data));
+        return promise.get_future();
+    }
+
+private:
+    std::vector<uint32_t>* _requests;
+    size_t _frameSize;
+};
+
+struct CacheFixture
+{
+    CacheFixture(const uint32_t nbFrames, const size_t frameSize = 4)
+        : cache(std::make_unique<FakeFrameSource>(requests, frameSize),
+                nbFrames)
+    {
+    }
+
+    void configure(const uint32_t capacity, const uint32_t readAhead,
+                   const uint64_t memoryBudget = uint64_t(1) << 30)
+    {
+        VoltageFrameCacheSettings settings;
+        settings.capacity = capacity;
+        settings.readAhead = readAhead;
+        settings.memoryBudget = memoryBudget;
+        cache.setSettings(settings);
+    }
+
+    std::vector<uint32_t> requests;
+    VoltageFrameCache cache;
+};
+} // namespace
+
+TEST_CASE("voltage_frame_cache_evicts_least_recently_used_frames")
+{
+    CacheFixture fixture(10);
+    auto& cache = fixture.cache;
+    fixture.configure(3, 0);
+
+    for (const uint32_t frame : {0, 1, 2})
+    {
+        const auto data = cache.get(frame, true);
+        REQUIRE(data);
+        CHECK_EQ(data->front(), float(frame));
+    }
+    CHECK(cache.get(0, false));
+    CHECK(cache.get(3, true));
+
+    // Frame 1 was the least recently used one
+    const auto statistics = cache.getStatistics();
+    CHECK_EQ(statistics.cachedFrames, 3);
+    CHECK_EQ(statistics.hits, 1);
+    CHECK_EQ(statistics.misses, 4);
+    CHECK(cache.get(2, false));
+    CHECK(cache.get(0, false));
+    fixture.requests.clear();
+    CHECK(cache.get(1, true));
+    CHECK(fixture.requests == std::vector<uint32_t>{1});
+}
+
+TEST_CASE("voltage_frame_cache_reads_ahead_in_playback_direction")
+{
+    CacheFixture fixture(10);
+    auto& cache = fixture.cache;
+    fixture.configure(64, 2);
+
+    cache.get(5, true);
+    CHECK(fixture.requests == std::vector<uint32_t>{5, 6, 7});
+
+    // Backwards, the frames before the current one are requested
+    fixture.requests.clear();
+    cache.get(4, true);
+    CHECK(fixture.requests == std::vector<uint32_t>{4, 3, 2});
+
+    // Read ahead wraps around the ends of the report
+    fixture.requests.clear();
+    cache.get(1, true);
+    CHECK(fixture.requests == std::vector<uint32_t>{1, 0, 9});
+
+    // Looping from the last frame to the first one keeps playing forward
+    CacheFixture looping(10);
+    looping.configure(64, 2);
+    looping.cache.get(8, true);
+    CHECK(looping.requests == std::vector<uint32_t>{8, 9, 0});
+    looping.requests.clear();
+    looping.cache.get(9, true);
+    looping.cache.get(0, true);
+    CHECK(looping.requests == std::vector<uint32_t>{1, 2});
+}
+
+TEST_CASE("voltage_frame_cache_stays_within_memory_budget")
+{
+    const size_t frameSize = 1000;
+    const uint64_t frameBytes = frameSize * sizeof(float);
+    CacheFixture fixture(10, frameSize);
+    auto& cache = fixture.cache;
+    fixture.configure(64, 4, 2 * frameBytes);
+
+    for (uint32_t frame = 0; frame < 10; ++frame)
+    {
+        CHECK(cache.get(frame, true));
+        const auto statistics = cache.getStatistics();
+        CHECK_LE(statistics.cachedFrames, 2);
+        CHECK_LE(statistics.memoryUsage, 2 * frameBytes);
+    }
+
+    // Lowering the budget evicts immediately
+    fixture.configure(64, 4, frameBytes);
+    CHECK_EQ(cache.getStatistics().memoryUsage, frameBytes);
+}
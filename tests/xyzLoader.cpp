@@ -0,0 +1,104 @@
+/* Copyright (c) 2015-2021 EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/geometry/Sphere.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+#include <brayns/io/XYZBLoader.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+namespace
+{
+brayns::Blob createBlob(const std::string& content)
+{
+    return {"xyz", "points.xyz", {content.begin(), content.end()}};
+}
+} // namespace
+
+TEST_CASE("xyz_loader_keeps_points_in_file_order")
+{
+    const char* argv[] = {"xyzLoader"};
+    brayns::Brayns brayns(1, argv);
+    brayns::XYZBLoader loader(brayns.getEngine().getScene());
+
+    // Large enough to be parsed by several tasks
+    const size_t nbPoints = 200000;
+    std::string content;
+    for (size_t i = 0; i < nbPoints; ++i)
+        content += std::to_string(i) + " -" + std::to_string(i % 7) +
+                   ".5\t" + std::to_string(i % 3) + "e1\r\n";
+
+    const auto models = loader.importFromBlob(createBlob(content), {}, {});
+    REQUIRE_EQ(models.size(), 1u);
+
+    const auto& model = models[0]->getModel();
+    const auto& spheres = model.getSpheres().at(0);
+    REQUIRE_EQ(spheres.size(), nbPoints);
+    for (size_t i = 0; i < nbPoints; i += 997)
+    {
+        CHECK_EQ(spheres[i].center.x, float(i));
+        CHECK_EQ(spheres[i].center.y, -(float(i % 7) + 0.5f));
+        CHECK_EQ(spheres[i].center.z, float(i % 3) * 10.f);
+    }
+
+    const auto radius = models[0]->getProperties()["radius"].as<double>();
+    CHECK_EQ(spheres.front().radius, float(radius));
+    CHECK_EQ(spheres.back().radius, float(radius));
+}
+
+TEST_CASE("xyz_loader_radius_property_resizes_all_points")
+{
+    const char* argv[] = {"xyzLoader"};
+    brayns::Brayns brayns(1, argv);
+    brayns::XYZBLoader loader(brayns.getEngine().getScene());
+
+    const auto models =
+        loader.importFromBlob(createBlob("0 0 0\n1 0 0\n0 1 0\n0 0 1"), {},
+                              {});
+    auto& modelDescriptor = *models[0];
+    auto properties = modelDescriptor.getProperties();
+    properties.update("radius", 0.25);
+    modelDescriptor.setProperties(properties);
+
+    const auto& spheres = modelDescriptor.getModel().getSpheres().at(0);
+    REQUIRE_EQ(spheres.size(), 4u);
+    for (const auto& sphere : spheres)
+        CHECK_EQ(sphere.radius, 0.25f);
+}
+
+TEST_CASE("xyz_loader_reports_first_invalid_line")
+{
+    const char* argv[] = {"xyzLoader"};
+    brayns::Brayns brayns(1, argv);
+    brayns::XYZBLoader loader(brayns.getEngine().getScene());
+
+    CHECK_THROWS_WITH(loader.importFromBlob(
+                          createBlob("0 0 0\n1 0 0\n1 2\n1 2 3 4\n"), {}, {}),
+                      "Invalid content in line 3: 1 2");
+    CHECK_THROWS_WITH(loader.importFromBlob(createBlob("0 0 0\n\n1 0 0\n"),
+                                            {}, {}),
+                      "Invalid content in line 2: ");
+    CHECK_THROWS(
+        loader.importFromBlob(createBlob("0 0 0\n1 0 1e\n"), {}, {}));
+}